@@ -0,0 +1,51 @@
+#include "utilities/ASCIIStrings.hpp"  // for ascii_to_lower_copy, ascii_trim
+
+#include <benchmark/benchmark.h>  // for State, BENCHMARK, DoNotOptimize
+
+#include <cstddef>  // for size_t
+#include <string>   // for string
+
+namespace {
+
+// A mixed case word repeated up to length, surrounded by whitespace to trim
+std::string makeInput(std::size_t length) {
+  std::string result = " \t ";
+  while (result.size() < length) {
+    result += "HVAC:Zone Equipment ";
+  }
+  result.resize(length);
+  result += " \r\n";
+  return result;
+}
+
+void BM_AsciiToLowerCopy(benchmark::State& state) {
+  const std::string input = makeInput(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    auto result = utilities::ascii_to_lower_copy(input);
+    benchmark::DoNotOptimize(result);
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input.size()));
+}
+BENCHMARK(BM_AsciiToLowerCopy)->RangeMultiplier(8)->Range(8, 4096);
+
+void BM_AsciiTrimView(benchmark::State& state) {
+  const std::string input = makeInput(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    auto result = utilities::ascii_trim(std::string_view{input});
+    benchmark::DoNotOptimize(result);
+  }
+}
+BENCHMARK(BM_AsciiTrimView)->RangeMultiplier(8)->Range(8, 4096);
+
+void BM_AsciiTrimInPlace(benchmark::State& state) {
+  const std::string input = makeInput(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    // The copy is part of the measurement, as in reload_results where each line is trimmed once
+    std::string s = input;
+    utilities::ascii_trim(s);
+    benchmark::DoNotOptimize(s);
+  }
+}
+BENCHMARK(BM_AsciiTrimInPlace)->RangeMultiplier(8)->Range(8, 4096);
+
+}  // namespace
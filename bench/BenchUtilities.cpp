@@ -0,0 +1,214 @@
+#include "BenchUtilities.hpp"
+
+#include "sqlite/PreparedStatement.hpp"  // for PreparedStatement
+
+#include <EnergyPlus/api/TypeDefs.h>  // for Error
+
+#include <fmt/format.h>  // for format
+
+#include <sqlite3.h>  // for sqlite3_open_v2, sqlite3_exec, sqlite3_close
+
+#include <array>          // for array
+#include <fstream>        // for ofstream
+#include <stdexcept>      // for runtime_error
+#include <string_view>    // for string_view
+#include <unordered_map>  // for unordered_map
+
+namespace bench {
+
+namespace {
+  void execScript(sqlite3* db, const std::string& script) {
+    char* err = nullptr;
+    if (sqlite3_exec(db, script.c_str(), nullptr, nullptr, &err) != SQLITE_OK) {
+      const std::string message = (err != nullptr) ? err : "unknown error";
+      sqlite3_free(err);
+      throw std::runtime_error("Could not generate the benchmark database: " + message);
+    }
+  }
+
+  // The subset of the EnergyPlus SQL schema that SQLiteReports and the sidecar index read
+  constexpr auto schema = R"sql(
+    CREATE TABLE Simulations (SimulationIndex INTEGER PRIMARY KEY, EnergyPlusVersion TEXT, TimeStamp TEXT, NumTimestepsPerHour INTEGER,
+                              Completed INT, CompletedSuccessfully INT);
+    CREATE TABLE Strings (StringIndex INTEGER PRIMARY KEY, StringTypeIndex INTEGER, Value TEXT);
+    CREATE TABLE TabularData (TabularDataIndex INTEGER PRIMARY KEY, ReportNameIndex INTEGER, ReportForStringIndex INTEGER,
+                              TableNameIndex INTEGER, RowNameIndex INTEGER, ColumnNameIndex INTEGER, UnitsIndex INTEGER,
+                              SimulationIndex INTEGER, RowId INTEGER, ColumnId INTEGER, Value TEXT);
+    CREATE VIEW TabularDataWithStrings AS SELECT
+      td.TabularDataIndex, td.Value AS Value, reportn.Value AS ReportName, fs.Value AS ReportForString, tn.Value AS TableName,
+      rn.Value AS RowName, cn.Value AS ColumnName, u.Value AS Units
+      FROM TabularData AS td
+      INNER JOIN Strings AS reportn ON reportn.StringIndex = td.ReportNameIndex
+      INNER JOIN Strings AS fs ON fs.StringIndex = td.ReportForStringIndex
+      INNER JOIN Strings AS tn ON tn.StringIndex = td.TableNameIndex
+      INNER JOIN Strings AS rn ON rn.StringIndex = td.RowNameIndex
+      INNER JOIN Strings AS cn ON cn.StringIndex = td.ColumnNameIndex
+      INNER JOIN Strings AS u ON u.StringIndex = td.UnitsIndex;
+    INSERT INTO Simulations VALUES (1, 'EnergyPlus, Version 22.2.0-c249759bad, YMD=2022.12.20 10:00', '', 4, 1, 1);)sql";
+
+  class TabularWriter
+  {
+   public:
+    explicit TabularWriter(sqlite3* db)
+      : m_insertString("INSERT INTO Strings VALUES (?, 1, ?);", db, false),
+        m_insertCell("INSERT INTO TabularData VALUES (NULL, ?, ?, ?, ?, ?, ?, 1, ?, ?, ?);", db, false) {}
+
+    void cell(const std::string& reportName, const std::string& reportFor, const std::string& tableName, const std::string& rowName,
+              const std::string& columnName, const std::string& units, int rowId, int columnId, const std::string& value) {
+      m_insertCell.bindAll(intern(reportName), intern(reportFor), intern(tableName), intern(rowName), intern(columnName), intern(units), rowId,
+                           columnId, value);
+      m_insertCell.execAndThrowOnError();
+    }
+
+   private:
+    int intern(const std::string& value) {
+      auto [it, inserted] = m_strings.try_emplace(value, static_cast<int>(m_strings.size()) + 1);
+      if (inserted) {
+        m_insertString.bindAll(it->second, value);
+        m_insertString.execAndThrowOnError();
+      }
+      return it->second;
+    }
+
+    sql::PreparedStatement m_insertString;
+    sql::PreparedStatement m_insertCell;
+    std::unordered_map<std::string, int> m_strings;
+  };
+}  // namespace
+
+std::filesystem::path scratchDirectory() {
+  auto dir = std::filesystem::temp_directory_path() / "epcli_bench";
+  std::filesystem::create_directories(dir);
+  return dir;
+}
+
+std::filesystem::path syntheticErrDirectory(std::size_t numLines) {
+  const auto dir = scratchDirectory() / fmt::format("err_{}", numLines);
+  const auto errPath = dir / "eplusout.err";
+  if (std::filesystem::is_regular_file(errPath)) {
+    return dir;
+  }
+  std::filesystem::create_directories(dir);
+
+  // Written to a temporary file first, so an interrupted generation doesn't leave a truncated file to be reused
+  const auto tmpPath = dir / "eplusout.err.tmp";
+  {
+    std::ofstream ofs(tmpPath, std::ios::trunc);
+    ofs << "Program Version,EnergyPlus, Version 22.2.0-c249759bad, YMD=2022.12.20 10:00,\n";
+    for (std::size_t i = 1; i + 1 < numLines; ++i) {
+      switch (i % 8) {
+        case 0:
+          ofs << "   ** Severe  ** GetSurfaceData: Surface=\"ZONE " << i << " WALL\" has a vertex out of plane\n";
+          break;
+        case 1:
+        case 4:
+          ofs << "   ** Warning ** CheckUsedConstructions: There are " << i % 97 << " nominally unused constructions in input.\n";
+          break;
+        case 2:
+        case 5:
+          ofs << "   **   ~~~   ** For explicit details on each unused construction, use Output:Diagnostics,DisplayExtraWarnings;\n";
+          break;
+        default:
+          ofs << "   ************* Testing Individual Branch Integrity\n";
+          break;
+      }
+    }
+    ofs << "   ************* EnergyPlus Completed Successfully-- 2 Warning; 1 Severe Errors; Elapsed Time=00hr 00min  3.21sec\n";
+    if (!ofs) {
+      throw std::runtime_error("Could not write " + tmpPath.string());
+    }
+  }
+  std::filesystem::rename(tmpPath, errPath);
+  return dir;
+}
+
+std::vector<std::string> syntheticStdoutLines(std::size_t numLines) {
+  std::vector<std::string> result;
+  result.reserve(numLines);
+  for (std::size_t i = 0; i < numLines; ++i) {
+    result.emplace_back(fmt::format("Continuing Simulation at {:02}/{:02} for RUN PERIOD 1", 1 + (i / 28) % 12, 1 + i % 28));
+  }
+  return result;
+}
+
+std::vector<ErrorMessage> syntheticErrors(std::size_t numErrors) {
+  static constexpr std::array<EnergyPlus::Error, 5> levels{EnergyPlus::Error::Warning, EnergyPlus::Error::Continue, EnergyPlus::Error::Info,
+                                                           EnergyPlus::Error::Severe, EnergyPlus::Error::Continue};
+  std::vector<ErrorMessage> result;
+  result.reserve(numErrors);
+  for (std::size_t i = 0; i < numErrors; ++i) {
+    result.emplace_back(levels[i % levels.size()], fmt::format("CheckUsedConstructions: There are {} nominally unused constructions", i));
+  }
+  return result;
+}
+
+std::filesystem::path syntheticDatabase(int numZones, int numTables) {
+  const auto path = scratchDirectory() / fmt::format("eplusout_{}_{}.sql", numZones, numTables);
+  if (std::filesystem::is_regular_file(path)) {
+    return path;
+  }
+
+  const auto tmpPath = scratchDirectory() / fmt::format("eplusout_{}_{}.sql.tmp", numZones, numTables);
+  std::filesystem::remove(tmpPath);
+  sqlite3* db = nullptr;
+  if (sqlite3_open_v2(tmpPath.string().c_str(), &db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, nullptr) != SQLITE_OK) {
+    sqlite3_close(db);
+    throw std::runtime_error("Could not create " + tmpPath.string());
+  }
+
+  try {
+    execScript(db, schema);
+    execScript(db, "BEGIN;");
+    {
+      TabularWriter writer(db);
+      const std::string abups = "AnnualBuildingUtilityPerformanceSummary";
+      const std::string facility = "Entire Facility";
+
+      writer.cell(abups, facility, "Site and Source Energy", "Net Site Energy", "Total Energy", "GJ", 1, 1, "123.45");
+
+      static constexpr std::array<std::string_view, 6> fuels{"Electricity", "Natural Gas", "Gasoline", "District Cooling", "District Heating",
+                                                             "Water"};
+      static constexpr std::array<std::string_view, 14> endUses{
+        "Heating",        "Cooling",        "Interior Lighting", "Exterior Lighting", "Interior Equipment", "Exterior Equipment", "Fans",
+        "Pumps",          "Heat Rejection", "Humidification",    "Heat Recovery",     "Water Systems",      "Refrigeration",      "Generators"};
+      for (int row = 0; row <= static_cast<int>(endUses.size()); ++row) {
+        const std::string endUse = (row < static_cast<int>(endUses.size())) ? std::string{endUses[row]} : "Total End Uses";
+        for (int col = 0; col < static_cast<int>(fuels.size()); ++col) {
+          const std::string fuel{fuels[col]};
+          writer.cell(abups, facility, "End Uses", endUse, fuel, (fuel == "Water") ? "m3" : "GJ", row + 1, col + 1,
+                      fmt::format("{:.2f}", static_cast<double>((row + 1) * (col + 1))));
+        }
+      }
+
+      static constexpr std::array<std::string_view, 4> unmetColumns{"During Heating", "During Cooling", "During Occupied Heating",
+                                                                    "During Occupied Cooling"};
+      for (int zone = 0; zone < numZones; ++zone) {
+        for (int col = 0; col < static_cast<int>(unmetColumns.size()); ++col) {
+          writer.cell("SystemSummary", facility, "Time Setpoint Not Met", fmt::format("THERMAL ZONE {}", zone + 1), std::string{unmetColumns[col]},
+                      "hr", zone + 1, col + 1, fmt::format("{:.2f}", zone * 0.25 + col));
+        }
+      }
+
+      for (int table = 0; table < numTables; ++table) {
+        const std::string reportName = fmt::format("Report {}", table / 10);
+        const std::string tableName = fmt::format("Table {}", table);
+        for (int row = 0; row < 10; ++row) {
+          for (int col = 0; col < 10; ++col) {
+            writer.cell(reportName, facility, tableName, fmt::format("Row {}", row), fmt::format("Column {}", col), "W", row + 1, col + 1,
+                        fmt::format("{}", table * 100 + row * 10 + col));
+          }
+        }
+      }
+    }
+    execScript(db, "COMMIT;");
+  } catch (...) {
+    sqlite3_close(db);
+    throw;
+  }
+  sqlite3_close(db);
+
+  std::filesystem::rename(tmpPath, path);
+  return path;
+}
+
+}  // namespace bench
@@ -0,0 +1,29 @@
+#ifndef BENCH_BENCHUTILITIES_HPP
+#define BENCH_BENCHUTILITIES_HPP
+
+#include "ErrorMessage.hpp"  // for ErrorMessage
+
+#include <cstddef>     // for size_t
+#include <filesystem>  // for path
+#include <string>      // for string
+#include <vector>      // for vector
+
+namespace bench {
+
+/// Where the generated inputs go: temp_directory_path() / "epcli_bench". They are kept across runs, since writing the largest ones takes
+/// longer than benchmarking them
+std::filesystem::path scratchDirectory();
+
+/// A directory holding an eplusout.err of numLines lines, with warnings, severes and continuation lines in the proportions of a real one
+std::filesystem::path syntheticErrDirectory(std::size_t numLines);
+
+std::vector<std::string> syntheticStdoutLines(std::size_t numLines);
+std::vector<ErrorMessage> syntheticErrors(std::size_t numErrors);
+
+/// An eplusout.sql with the tables SQLiteReports reads: numZones zones in the unmet hours table, the end uses by fuel, and numTables
+/// additional 10x10 tabular reports
+std::filesystem::path syntheticDatabase(int numZones, int numTables);
+
+}  // namespace bench
+
+#endif  // BENCH_BENCHUTILITIES_HPP
@@ -0,0 +1,72 @@
+#include "VariableSampler.hpp"                 // for VariableSampler
+#include "utilities/ColumnarRingBuffer.hpp"  // for ColumnarRingBuffer
+
+#include <benchmark/benchmark.h>  // for State, BENCHMARK, DoNotOptimize
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for int64_t
+#include <vector>   // for vector
+
+// The sampling overhead of VariableSampler: at each zone timestep, besides one getVariableValue per variable, its callback pushes one row
+// into the ring buffer, while the UI thread copies a column of it at each frame. Ranges: the number of sampled variables
+namespace {
+
+void BM_RingBufferPush(benchmark::State& state) {
+  const auto numColumns = static_cast<std::size_t>(state.range(0));
+  utilities::ColumnarRingBuffer buffer(numColumns, epcli::VariableSampler::defaultCapacity);
+  std::vector<double> row(numColumns, 21.5);
+  double time = 0.0;
+  for (auto _ : state) {
+    buffer.push(time, row);
+    time += 0.25;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RingBufferPush)->RangeMultiplier(4)->Range(1, 64);
+
+// A year of samples, as charted at each frame once the run is over
+void BM_RingBufferCopyColumn(benchmark::State& state) {
+  const auto numColumns = static_cast<std::size_t>(state.range(0));
+  utilities::ColumnarRingBuffer buffer(numColumns, epcli::VariableSampler::defaultCapacity);
+  std::vector<double> row(numColumns, 21.5);
+  for (std::size_t i = 0; i < buffer.capacity(); ++i) {
+    buffer.push(static_cast<double>(i) * 0.25, row);
+  }
+  std::vector<double> times;
+  std::vector<double> values;
+  for (auto _ : state) {
+    buffer.copyColumn(numColumns - 1, times, values, buffer.capacity());
+    benchmark::DoNotOptimize(values.data());
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(buffer.capacity()));
+}
+BENCHMARK(BM_RingBufferCopyColumn)->RangeMultiplier(4)->Range(1, 64)->Unit(benchmark::kMicrosecond);
+
+// Thread 0 samples while thread 1 redraws: how much the lock held by each copy costs the pushes
+void BM_RingBufferPushWhileCopying(benchmark::State& state) {
+  static utilities::ColumnarRingBuffer* buffer = nullptr;
+  const std::size_t numColumns = 8;
+  if (state.thread_index() == 0) {
+    buffer = new utilities::ColumnarRingBuffer(numColumns, epcli::VariableSampler::defaultCapacity);  // NOLINT(cppcoreguidelines-owning-memory)
+  }
+  std::vector<double> row(numColumns, 21.5);
+  std::vector<double> times;
+  std::vector<double> values;
+  double time = 0.0;
+  for (auto _ : state) {
+    if (state.thread_index() == 0) {
+      buffer->push(time, row);
+      time += 0.25;
+    } else {
+      buffer->copyColumn(0, times, values, 2000);
+      benchmark::DoNotOptimize(values.data());
+    }
+  }
+  if (state.thread_index() == 0) {
+    delete buffer;  // NOLINT(cppcoreguidelines-owning-memory)
+    buffer = nullptr;
+  }
+}
+BENCHMARK(BM_RingBufferPushWhileCopying)->Threads(2);
+
+}  // namespace
@@ -0,0 +1,53 @@
+#include "BenchUtilities.hpp"  // for syntheticStdoutLines, syntheticErrors
+#include "ErrorMessage.hpp"    // for ErrorMessage
+#include "LogDisplayer.hpp"    // for LogDisplayer
+
+#include <benchmark/benchmark.h>  // for State, BENCHMARK, DoNotOptimize
+
+#include <ftxui/component/component.hpp>  // for Make
+#include <ftxui/dom/node.hpp>             // for Render
+#include <ftxui/screen/screen.hpp>        // for Screen, Dimension
+
+#include <cstddef>  // for size_t
+#include <string>   // for string
+#include <vector>   // for vector
+
+namespace {
+
+// A frame: build the element tree, then lay it out and draw it on a terminal sized screen
+template <typename Lines>
+void renderFrame(LogDisplayer& displayer, const Lines& lines, ftxui::Screen& screen) {
+  auto document = displayer.RenderLines(lines);
+  ftxui::Render(screen, document);
+  benchmark::DoNotOptimize(screen.PixelAt(0, 0));
+}
+
+void BM_RenderStdoutLines(benchmark::State& state) {
+  const auto lines = bench::syntheticStdoutLines(static_cast<std::size_t>(state.range(0)));
+  auto displayer = ftxui::Make<LogDisplayer>();
+  auto screen = ftxui::Screen::Create(ftxui::Dimension::Fixed(200), ftxui::Dimension::Fixed(60));
+  for (auto _ : state) {
+    renderFrame(*displayer, lines, screen);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * lines.size()));
+}
+BENCHMARK(BM_RenderStdoutLines)->RangeMultiplier(10)->Range(100, 1'000'000)->Unit(benchmark::kMillisecond);
+
+void BM_RenderErrorLines(benchmark::State& state) {
+  auto errors = bench::syntheticErrors(static_cast<std::size_t>(state.range(0)));
+  // As MainComponent passes them, once filtered by level
+  std::vector<ErrorMessage*> lines;
+  lines.reserve(errors.size());
+  for (auto& error : errors) {
+    lines.push_back(&error);
+  }
+  auto displayer = ftxui::Make<LogDisplayer>();
+  auto screen = ftxui::Screen::Create(ftxui::Dimension::Fixed(200), ftxui::Dimension::Fixed(60));
+  for (auto _ : state) {
+    renderFrame(*displayer, lines, screen);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * lines.size()));
+}
+BENCHMARK(BM_RenderErrorLines)->RangeMultiplier(10)->Range(100, 1'000'000)->Unit(benchmark::kMillisecond);
+
+}  // namespace
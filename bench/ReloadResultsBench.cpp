@@ -0,0 +1,37 @@
+#include "BenchUtilities.hpp"  // for syntheticErrDirectory
+#include "EnergyPlus.hpp"      // for RunOptions
+#include "ErrorMessage.hpp"    // for ErrorMessage
+#include "MainComponent.hpp"   // for MainComponent
+
+#include <benchmark/benchmark.h>  // for State, BENCHMARK
+
+#include <ftxui/component/component.hpp>  // for Button
+#include <ftxui/component/receiver.hpp>   // for MakeReceiver
+
+#include <atomic>      // for atomic
+#include <cstddef>     // for size_t
+#include <filesystem>  // for file_size, path
+#include <string>      // for string
+
+namespace {
+
+// MainComponent::reload_results: parses <output directory>/eplusout.err line by line with the ctre matchers
+void BM_ReloadResults(benchmark::State& state) {
+  const auto numLines = static_cast<std::size_t>(state.range(0));
+  const auto outputDirectory = bench::syntheticErrDirectory(numLines);
+
+  std::atomic<int> progress = 0;
+  const epcli::RunOptions runOptions;
+  MainComponent mainComponent(ftxui::MakeReceiver<std::string>(), ftxui::MakeReceiver<ErrorMessage>(), ftxui::Button("Run", [] {}),
+                              ftxui::Button("Quit", [] {}), &progress, outputDirectory, runOptions);
+
+  for (auto _ : state) {
+    mainComponent.reload_results();
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * numLines));
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * std::filesystem::file_size(outputDirectory / "eplusout.err")));
+}
+// The 10M lines file is ~700 MB, generated once in bench::scratchDirectory()
+BENCHMARK(BM_ReloadResults)->RangeMultiplier(10)->Range(10'000, 10'000'000)->Unit(benchmark::kMillisecond);
+
+}  // namespace
@@ -0,0 +1,81 @@
+#include "BenchUtilities.hpp"  // for syntheticStdoutLines
+#include "EnergyPlus.hpp"      // for forwardRunOutput
+#include "RuntimeMetrics.hpp"  // for RuntimeMetrics
+
+#include <benchmark/benchmark.h>  // for State, BENCHMARK, DoNotOptimize
+
+#include <ftxui/component/receiver.hpp>  // for MakeReceiver, Receiver, Sender
+
+#include <cstddef>  // for size_t
+#include <string>   // for string
+#include <thread>   // for thread
+#include <utility>  // for move
+#include <vector>   // for vector
+
+// The stdout callback to MainComponent path: forwardRunOutput on the EnergyPlus thread, then MainComponent::OnEvent draining the receiver.
+// Waking up the screen (ScreenInteractive::PostEvent) is left out, it needs a running screen loop
+namespace {
+
+// What OnEvent does with each pending line, minus the LogDisplayer bookkeeping
+std::size_t drain(ftxui::Receiver<std::string>& receiver, epcli::RuntimeMetrics& metrics, std::vector<std::string>& lines) {
+  std::size_t count = 0;
+  while (receiver->HasPending()) {
+    std::string line;
+    receiver->Receive(&line);
+    metrics.stdoutReceived.inc();
+    lines.emplace_back(std::move(line));
+    ++count;
+  }
+  return count;
+}
+
+// Send a batch, then drain it, on a single thread: the cost per message without contention
+void BM_RunOutputBatch(benchmark::State& state) {
+  const auto messages = bench::syntheticStdoutLines(static_cast<std::size_t>(state.range(0)));
+  epcli::RuntimeMetrics metrics;
+  auto receiver = ftxui::MakeReceiver<std::string>();
+  auto sender = receiver->MakeSender();
+  std::vector<std::string> lines;
+
+  for (auto _ : state) {
+    for (const auto& message : messages) {
+      epcli::forwardRunOutput(sender, &metrics, message);
+    }
+    drain(receiver, metrics, lines);
+    state.PauseTiming();
+    lines.clear();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * messages.size()));
+}
+BENCHMARK(BM_RunOutputBatch)->RangeMultiplier(10)->Range(100, 100'000);
+
+// A producer thread sends while this one drains concurrently, as during a run: end to end throughput
+void BM_RunOutputConcurrent(benchmark::State& state) {
+  const auto messages = bench::syntheticStdoutLines(static_cast<std::size_t>(state.range(0)));
+  epcli::RuntimeMetrics metrics;
+  auto receiver = ftxui::MakeReceiver<std::string>();
+  std::vector<std::string> lines;
+  lines.reserve(messages.size());
+
+  for (auto _ : state) {
+    auto sender = receiver->MakeSender();
+    std::thread producer([&messages, &metrics, sender = std::move(sender)]() mutable {
+      for (const auto& message : messages) {
+        epcli::forwardRunOutput(sender, &metrics, message);
+      }
+    });
+    std::size_t received = 0;
+    while (received < messages.size()) {
+      received += drain(receiver, metrics, lines);
+    }
+    producer.join();
+    state.PauseTiming();
+    lines.clear();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * messages.size()));
+}
+BENCHMARK(BM_RunOutputConcurrent)->RangeMultiplier(10)->Range(1'000, 100'000)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+}  // namespace
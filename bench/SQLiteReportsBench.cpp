@@ -0,0 +1,92 @@
+#include "BenchUtilities.hpp"       // for syntheticDatabase
+#include "sqlite/SQLiteReports.hpp"  // for SQLiteReports
+
+#include <benchmark/benchmark.h>  // for State, BENCHMARK, DoNotOptimize
+
+#include <cstdint>  // for int64_t
+#include <memory>   // for unique_ptr, make_unique
+
+// Each SQLiteReports query on generated databases: (zones in the unmet hours table, extra 10x10 tabular reports).
+// The first open of each database builds its sidecar index in the epcli cache directory, outside of the measurements
+namespace {
+
+void sizes(benchmark::internal::Benchmark* b) {
+  b->Args({10, 10})->Args({100, 100})->Args({1000, 1000});
+}
+
+std::unique_ptr<sql::SQLiteReports> openReport(const benchmark::State& state) {
+  const auto path = bench::syntheticDatabase(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+  // In place, read-only: the run is over
+  return std::make_unique<sql::SQLiteReports>(path, false);
+}
+
+void BM_Open(benchmark::State& state) {
+  openReport(state);
+  for (auto _ : state) {
+    auto report = openReport(state);
+    benchmark::DoNotOptimize(report);
+  }
+}
+BENCHMARK(BM_Open)->Apply(sizes)->Unit(benchmark::kMillisecond);
+
+void BM_EnergyPlusVersion(benchmark::State& state) {
+  auto report = openReport(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(report->energyPlusVersion());
+  }
+}
+BENCHMARK(BM_EnergyPlusVersion)->Apply(sizes);
+
+void BM_NetSiteEnergy(benchmark::State& state) {
+  auto report = openReport(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(report->netSiteEnergy());
+  }
+}
+BENCHMARK(BM_NetSiteEnergy)->Apply(sizes);
+
+void BM_UnmetHoursTable(benchmark::State& state) {
+  auto report = openReport(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(report->unmetHoursTable());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_UnmetHoursTable)->Apply(sizes)->Unit(benchmark::kMicrosecond);
+
+void BM_EndUseByFuelTable(benchmark::State& state) {
+  auto report = openReport(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(report->endUseByFuelTable());
+  }
+}
+BENCHMARK(BM_EndUseByFuelTable)->Apply(sizes)->Unit(benchmark::kMicrosecond);
+
+void BM_TabularIndex(benchmark::State& state) {
+  // Cached for the lifetime of the connection, so each iteration needs a fresh one
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto report = openReport(state);
+    state.ResumeTiming();
+    benchmark::DoNotOptimize(report->tabularIndex().size());
+    state.PauseTiming();
+    report.reset();
+    state.ResumeTiming();
+  }
+}
+BENCHMARK(BM_TabularIndex)->Apply(sizes)->Unit(benchmark::kMicrosecond);
+
+void BM_TabularPage(benchmark::State& state) {
+  auto report = openReport(state);
+  const auto& index = report->tabularIndex();
+  // A 10x10 table from the middle of TabularData, and its last page, partial: the query must stop at the last cell of the table rather
+  // than look for more up to the end of TabularData, which only the last table of the file would hide
+  const auto& table = index[index.size() / 2];
+  constexpr int pageSize = 64;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(report->tabularPage(table, table.firstKey - 1 + pageSize, pageSize));
+  }
+}
+BENCHMARK(BM_TabularPage)->Apply(sizes)->Unit(benchmark::kMicrosecond);
+
+}  // namespace
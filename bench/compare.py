@@ -0,0 +1,83 @@
+#!/usr/bin/env python3
+"""Compare two Google Benchmark JSON outputs of epcli_bench, and fail on regressions.
+
+Usage: compare.py baseline.json current.json [--threshold 0.10] [--metric real_time|cpu_time]
+
+When the runs used --benchmark_repetitions, the median of each benchmark is compared. Exits with 1 if any benchmark got slower than the
+baseline by more than the threshold (a fraction: 0.10 is 10%), 0 otherwise.
+"""
+
+import argparse
+import json
+import sys
+
+TO_NS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def load(path, metric):
+    with open(path) as f:
+        data = json.load(f)
+
+    results = {}
+    medians = {}
+    for benchmark in data.get("benchmarks", []):
+        if benchmark.get("error_occurred"):
+            continue
+        value = benchmark[metric] * TO_NS[benchmark.get("time_unit", "ns")]
+        if benchmark.get("run_type") == "aggregate":
+            if benchmark.get("aggregate_name") == "median":
+                medians[benchmark["run_name"]] = value
+        else:
+            # Without repetitions there is a single iteration run per name, otherwise the median wins below
+            results.setdefault(benchmark.get("run_name", benchmark["name"]), value)
+    results.update(medians)
+    return results
+
+
+def format_ns(ns):
+    for unit, factor in (("s", 1e9), ("ms", 1e6), ("us", 1e3)):
+        if ns >= factor:
+            return f"{ns / factor:.2f} {unit}"
+    return f"{ns:.1f} ns"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=0.10, help="Allowed slowdown, as a fraction (default: 0.10)")
+    parser.add_argument("--metric", choices=["real_time", "cpu_time"], default="real_time")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline, args.metric)
+    current = load(args.current, args.metric)
+
+    regressions = []
+    width = max((len(name) for name in current), default=10)
+    print(f"{'Benchmark':<{width}}  {'Baseline':>12}  {'Current':>12}  {'Change':>8}")
+    for name, value in current.items():
+        if name not in baseline:
+            print(f"{name:<{width}}  {'-':>12}  {format_ns(value):>12}  {'new':>8}")
+            continue
+        change = value / baseline[name] - 1.0 if baseline[name] > 0 else 0.0
+        flag = ""
+        if change > args.threshold:
+            flag = "  REGRESSION"
+            regressions.append(name)
+        print(f"{name:<{width}}  {format_ns(baseline[name]):>12}  {format_ns(value):>12}  {change:>+8.1%}{flag}")
+
+    for name in baseline:
+        if name not in current:
+            print(f"{name:<{width}}  {format_ns(baseline[name]):>12}  {'-':>12}  {'missing':>8}")
+
+    if regressions:
+        print(f"\n{len(regressions)} benchmark(s) slower than the baseline by more than {args.threshold:.0%}:")
+        for name in regressions:
+            print(f"  {name}")
+        return 1
+    print(f"\nNo regression beyond {args.threshold:.0%}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,59 @@
+// Example controller plugin: outdoor air reset of a zone cooling setpoint.
+//
+// The cooling setpoint is 24C while it's cooler than 24C outside, then rises linearly to 26C at 32C outside. The heating setpoint is left
+// to EnergyPlus. The zone is EPCLI_RESET_ZONE if set, otherwise SPACE1-1 (as in 5ZoneAirCooled.idf)
+//
+//   epcli --controller ./libepcli_outdoor_air_reset.so 5ZoneAirCooled.idf
+
+#include "epcli_controller.h"
+
+#include <algorithm>  // for clamp
+#include <array>      // for array
+#include <cstdlib>    // for getenv
+#include <string>     // for string
+
+namespace {
+
+std::string zoneName() {
+  const char* zone = std::getenv("EPCLI_RESET_ZONE");  // NOLINT(concurrency-mt-unsafe)
+  return (zone != nullptr && *zone != '\0') ? zone : "SPACE1-1";
+}
+
+// Resolved once, at load time: the descriptions must outlive the controller
+const std::string zone = zoneName();
+
+const std::array<EpcliSensor, 1> sensors{{
+  {EPCLI_SENSOR_VARIABLE, "Site Outdoor Air Drybulb Temperature", "Environment"},
+}};
+
+const std::array<EpcliActuator, 1> actuators{{
+  {"Zone Temperature Control", "Cooling Setpoint", zone.c_str()},
+}};
+
+void step(void* /*self*/, const EpcliStepInfo* /*info*/, const double* inputs, double* outputs) {
+  constexpr double lowOutdoor = 24.0;
+  constexpr double highOutdoor = 32.0;
+  constexpr double lowSetpoint = 24.0;
+  constexpr double highSetpoint = 26.0;
+
+  const double fraction = std::clamp((inputs[0] - lowOutdoor) / (highOutdoor - lowOutdoor), 0.0, 1.0);
+  outputs[0] = lowSetpoint + fraction * (highSetpoint - lowSetpoint);
+}
+
+const EpcliController controller{
+  EPCLI_CONTROLLER_API_VERSION,
+  "Outdoor Air Reset",
+  sensors.size(),
+  sensors.data(),
+  actuators.size(),
+  actuators.data(),
+  nullptr,
+  nullptr,
+  step,
+};
+
+}  // namespace
+
+extern "C" EPCLI_CONTROLLER_EXPORT const EpcliController* epcli_controller() {
+  return &controller;
+}
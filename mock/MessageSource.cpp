@@ -0,0 +1,231 @@
+#include "MessageSource.hpp"
+
+#include <algorithm>     // for shuffle
+#include <array>         // for array
+#include <charconv>      // for from_chars
+#include <fstream>       // for ifstream
+#include <limits>        // for numeric_limits
+#include <stdexcept>     // for runtime_error
+#include <string_view>   // for string_view
+#include <system_error>  // for errc
+#include <utility>       // for pair, move
+
+namespace epcli::mock {
+
+namespace {
+  std::string_view trim(std::string_view s) {
+    const auto first = s.find_first_not_of(" \t\r");
+    if (first == std::string_view::npos) {
+      return {};
+    }
+    const auto last = s.find_last_not_of(" \t\r");
+    return s.substr(first, last - first + 1);
+  }
+
+  std::runtime_error syntaxError(std::size_t lineNumber, std::string_view what) {
+    return std::runtime_error("Mock script, line " + std::to_string(lineNumber) + ": " + std::string(what));
+  }
+
+  std::uint64_t parseCount(std::string_view s, std::size_t lineNumber, std::uint64_t max) {
+    std::uint64_t value = 0;
+    const auto* last = s.data() + s.size();
+    auto [ptr, ec] = std::from_chars(s.data(), last, value);
+    if (ec != std::errc{} || ptr != last || value > max) {
+      throw syntaxError(lineNumber, "expected an integer between 0 and " + std::to_string(max) + ", got '" + std::string(s) + "'");
+    }
+    return value;
+  }
+
+  constexpr std::array<std::pair<std::string_view, EnergyPlus::Error>, 5> errorKeywords{{
+    {"info", EnergyPlus::Error::Info},
+    {"warning", EnergyPlus::Error::Warning},
+    {"severe", EnergyPlus::Error::Severe},
+    {"fatal", EnergyPlus::Error::Fatal},
+    {"continue", EnergyPlus::Error::Continue},
+  }};
+}  // namespace
+
+ScriptSource::ScriptSource(std::istream& script) {
+  // The blocks being parsed, innermost last
+  std::vector<std::vector<Step>*> blocks{&m_steps};
+  std::string line;
+  std::size_t lineNumber = 0;
+  while (std::getline(script, line)) {
+    ++lineNumber;
+    const auto content = trim(line);
+    if (content.empty() || content.front() == '#') {
+      continue;
+    }
+    const auto space = content.find_first_of(" \t");
+    const auto keyword = content.substr(0, space);
+    const auto argument = space == std::string_view::npos ? std::string_view{} : trim(content.substr(space));
+    auto& steps = *blocks.back();
+
+    if (keyword == "end") {
+      if (blocks.size() == 1) {
+        throw syntaxError(lineNumber, "'end' without 'repeat'");
+      }
+      blocks.pop_back();
+      continue;
+    }
+    if (keyword == "repeat") {
+      Step step;
+      step.repeat = parseCount(argument, lineNumber, std::numeric_limits<std::uint64_t>::max());
+      if (step.repeat == 0) {
+        throw syntaxError(lineNumber, "'repeat' needs a count of at least 1");
+      }
+      steps.push_back(std::move(step));
+      blocks.push_back(&steps.back().body);
+      continue;
+    }
+
+    Step step;
+    auto& message = step.message;
+    if (keyword == "stdout") {
+      message.kind = Message::Kind::Stdout;
+      message.text = argument;
+    } else if (keyword == "progress") {
+      message.kind = Message::Kind::Progress;
+      message.value = static_cast<int>(parseCount(argument, lineNumber, 100));
+      m_reportsProgress = true;
+    } else if (keyword == "sleep") {
+      message.kind = Message::Kind::Sleep;
+      message.value = static_cast<int>(parseCount(argument, lineNumber, 3'600'000));
+    } else {
+      const auto* it = std::find_if(errorKeywords.cbegin(), errorKeywords.cend(), [&keyword](const auto& p) { return p.first == keyword; });
+      if (it == errorKeywords.cend()) {
+        throw syntaxError(lineNumber, "unknown keyword '" + std::string(keyword) + "'");
+      }
+      message.kind = Message::Kind::Error;
+      message.level = it->second;
+      message.text = argument;
+    }
+    steps.push_back(std::move(step));
+  }
+  if (blocks.size() != 1) {
+    throw syntaxError(lineNumber, "'repeat' without 'end'");
+  }
+
+  m_size = countMessages(m_steps);
+  m_stack.push_back(Frame{&m_steps, 0, 0});
+}
+
+std::unique_ptr<ScriptSource> ScriptSource::fromFile(const std::filesystem::path& path) {
+  std::ifstream file(path);
+  if (!file) {
+    throw std::runtime_error("Cannot open the mock script at '" + path.string() + "'");
+  }
+  return std::make_unique<ScriptSource>(file);
+}
+
+std::uint64_t ScriptSource::countMessages(const std::vector<Step>& steps) {
+  std::uint64_t count = 0;
+  for (const auto& step : steps) {
+    count += step.repeat > 0 ? step.repeat * countMessages(step.body) : 1;
+  }
+  return count;
+}
+
+std::uint64_t ScriptSource::size() const {
+  return m_size;
+}
+
+const Message* ScriptSource::next() {
+  while (!m_stack.empty()) {
+    auto& frame = m_stack.back();
+    if (frame.index == frame.steps->size()) {
+      if (frame.remaining > 0) {
+        --frame.remaining;
+        frame.index = 0;
+      } else {
+        m_stack.pop_back();
+      }
+      continue;
+    }
+    const auto& step = (*frame.steps)[frame.index++];
+    if (step.repeat == 0) {
+      return &step.message;
+    }
+    if (!step.body.empty()) {
+      m_stack.push_back(Frame{&step.body, 0, step.repeat - 1});
+    }
+  }
+  return nullptr;
+}
+
+bool ScriptSource::reportsProgress() const {
+  return m_reportsProgress;
+}
+
+RandomSource::RandomSource(std::uint64_t count, double errorFraction, std::uint64_t seed) : m_random(seed), m_count(count) {
+  const auto numErrors = static_cast<std::size_t>(std::clamp(errorFraction, 0.0, 1.0) * static_cast<double>(poolSize) + 0.5);
+  m_pool.reserve(poolSize);
+  for (std::size_t i = 0; i < poolSize; ++i) {
+    const auto n = std::to_string(i + 1);
+    const auto day = std::to_string(1 + i % 28);
+    Message message;
+    if (i < numErrors) {
+      message.kind = Message::Kind::Error;
+      // 10% Info, 70% Warning, 10% Severe, 10% Continue
+      switch (i % 20) {
+        case 0:
+        case 1:
+          message.level = EnergyPlus::Error::Info;
+          message.text = "Zone " + n + ": Weather file location will be used rather than entered (IDF) Location object.";
+          break;
+        case 16:
+        case 17:
+          message.level = EnergyPlus::Error::Severe;
+          message.text = "Temperature (low) out of bounds [-" + n + ".25] for zone=\"ZONE " + n + "\", for surface=\"WALL " + n + "\"";
+          break;
+        case 18:
+        case 19:
+          message.level = EnergyPlus::Error::Continue;
+          message.text = "...Environment(RunPeriod)=\"RUN PERIOD 1\", at Simulation time=01/" + day + " 08:00 - 08:15";
+          break;
+        default:
+          message.level = EnergyPlus::Error::Warning;
+          message.text = (i % 3 == 0)   ? "Calculated design cooling load for zone=ZONE " + n + " is zero."
+                         : (i % 3 == 1) ? "Output:Meter: invalid Key Name=\"ELECTRICITY:ZONE " + n + "\" - not found."
+                                        : "CheckUsedConstructions: There are " + n + " nominally unused constructions in input.";
+          break;
+      }
+    } else {
+      message.kind = Message::Kind::Stdout;
+      switch (i % 4) {
+        case 0:
+          message.text = "Continuing Simulation at 01/" + day + " for RUN PERIOD 1";
+          break;
+        case 1:
+          message.text = "Updating Shadowing Calculations, Start Date=01/" + day;
+          break;
+        case 2:
+          message.text = "Calculating Detailed Daylighting Factors, Start Date=01/" + day;
+          break;
+        default:
+          message.text = "Simulating HVAC System " + n;
+          break;
+      }
+    }
+    m_pool.push_back(std::move(message));
+  }
+  std::shuffle(m_pool.begin(), m_pool.end(), m_random);
+}
+
+std::uint64_t RandomSource::size() const {
+  return m_count;
+}
+
+const Message* RandomSource::next() {
+  if (m_returned == m_count) {
+    return nullptr;
+  }
+  ++m_returned;
+  return &m_pool[m_random() & (poolSize - 1)];
+}
+
+bool RandomSource::reportsProgress() const {
+  return false;
+}
+
+}  // namespace epcli::mock
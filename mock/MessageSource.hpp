@@ -0,0 +1,112 @@
+#ifndef MOCK_MESSAGESOURCE_HPP
+#define MOCK_MESSAGESOURCE_HPP
+
+#include <EnergyPlus/api/TypeDefs.h>  // for Error
+
+#include <cstddef>     // for size_t
+#include <cstdint>     // for uint64_t
+#include <filesystem>  // for path
+#include <istream>     // for istream
+#include <memory>      // for unique_ptr
+#include <random>      // for mt19937_64
+#include <string>      // for string
+#include <vector>      // for vector
+
+namespace epcli::mock {
+
+struct Message
+{
+  enum class Kind
+  {
+    Stdout,
+    Error,
+    Progress,
+    Sleep,
+  };
+  Kind kind = Kind::Stdout;
+  EnergyPlus::Error level = EnergyPlus::Error::Info;  // Kind::Error only
+  int value = 0;                                      // Percent for Kind::Progress, milliseconds for Kind::Sleep
+  std::string text;
+};
+
+/// What the mock energyplus() replays, spread evenly over the simulated timesteps
+class MessageSource
+{
+ public:
+  MessageSource() = default;
+  MessageSource(const MessageSource&) = delete;
+  MessageSource& operator=(const MessageSource&) = delete;
+  virtual ~MessageSource() = default;
+
+  /// Number of messages next() returns in total, progress and sleeps included
+  [[nodiscard]] virtual std::uint64_t size() const = 0;
+  /// Valid until the following call, nullptr once all were returned
+  virtual const Message* next() = 0;
+  /// If false, energyplus() reports the progress itself, once per simulated day
+  [[nodiscard]] virtual bool reportsProgress() const = 0;
+};
+
+/// A script, one message per line:
+///   stdout|info|warning|severe|fatal|continue <text>
+///   progress <percent>
+///   sleep <milliseconds>
+///   repeat <count> ... end       (can be nested)
+/// Blank lines and lines starting with # are ignored. A fatal ends the run, as EnergyPlus would
+class ScriptSource : public MessageSource
+{
+ public:
+  /// Throws std::runtime_error with the line number on a syntax error
+  explicit ScriptSource(std::istream& script);
+  /// Throws std::runtime_error if the file cannot be read
+  static std::unique_ptr<ScriptSource> fromFile(const std::filesystem::path& path);
+
+  [[nodiscard]] std::uint64_t size() const override;
+  const Message* next() override;
+  [[nodiscard]] bool reportsProgress() const override;
+
+ private:
+  struct Step
+  {
+    Message message;
+    std::uint64_t repeat = 0;  // Non zero for a repeat block, whose steps are body
+    std::vector<Step> body;
+  };
+  struct Frame
+  {
+    const std::vector<Step>* steps;
+    std::size_t index;
+    std::uint64_t remaining;  // Iterations left after the current one
+  };
+
+  static std::uint64_t countMessages(const std::vector<Step>& steps);
+
+  std::vector<Step> m_steps;
+  std::vector<Frame> m_stack;
+  std::uint64_t m_size = 0;
+  bool m_reportsProgress = false;
+};
+
+/// count messages drawn from a pool of realistic EnergyPlus stdout lines and errors (Info, Warning, Severe and Continue, never Fatal), with a
+/// fixed seed for reproducible runs. Drawing one is a random number and an index, so this can produce millions per second
+class RandomSource : public MessageSource
+{
+ public:
+  /// errorFraction is the share of errors among the messages, between 0 and 1
+  RandomSource(std::uint64_t count, double errorFraction, std::uint64_t seed);
+
+  [[nodiscard]] std::uint64_t size() const override;
+  const Message* next() override;
+  [[nodiscard]] bool reportsProgress() const override;
+
+ private:
+  static constexpr std::size_t poolSize = 1024;  // A power of two, for the mask
+
+  std::vector<Message> m_pool;
+  std::mt19937_64 m_random;
+  std::uint64_t m_count;
+  std::uint64_t m_returned = 0;
+};
+
+}  // namespace epcli::mock
+
+#endif  // MOCK_MESSAGESOURCE_HPP
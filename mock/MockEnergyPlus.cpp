@@ -0,0 +1,672 @@
+#include "MessageSource.hpp"  // for MessageSource, ScriptSource, RandomSource, Message
+#include "MockState.hpp"      // for MockState, Config, Hook
+
+#include <EnergyPlus/api/datatransfer.h>  // for the data transfer API
+#include <EnergyPlus/api/func.h>          // for registerErrorCallback
+#include <EnergyPlus/api/runtime.h>       // for energyplus, callback*, register*Callback, issue*, stopSimulation
+#include <EnergyPlus/api/state.h>         // for stateNew, stateReset, stateDelete
+
+#include <array>         // for array
+#include <chrono>        // for steady_clock, duration, milliseconds
+#include <cmath>         // for sin, isfinite
+#include <cstdint>       // for uint64_t
+#include <cstdio>        // for snprintf
+#include <cstdlib>       // for getenv, strtod, strtoull
+#include <exception>     // for exception
+#include <filesystem>    // for path, create_directories
+#include <fstream>       // for ofstream
+#include <functional>    // for function
+#include <iostream>      // for cout
+#include <limits>        // for numeric_limits
+#include <memory>        // for unique_ptr, make_unique
+#include <stdexcept>     // for runtime_error
+#include <string>        // for string, to_string
+#include <system_error>  // for error_code
+#include <thread>        // for sleep_for, sleep_until
+#include <utility>       // for move
+
+// A fake of the EnergyPlus API, for load testing epcli without the simulation engine: energyplus() walks through a simulated timeline
+// (input processing, sizing, warmup days then the run period, with all the callbacks at each zone timestep) and replays the messages of
+// a MessageSource through the registered callbacks, spread evenly over the timesteps, at the configured rate. The data transfer API hands
+// out a handle for any name, and returns synthetic values. See Config for the settings
+
+namespace epcli::mock {
+
+namespace {
+
+  MockState& mockState(EnergyPlusState state) {
+    return *static_cast<MockState*>(state);
+  }
+
+  const char* environmentValue(const char* name) {
+    const char* value = std::getenv(name);  // NOLINT(concurrency-mt-unsafe)
+    return (value != nullptr && *value != '\0') ? value : nullptr;
+  }
+
+  std::uint64_t environmentInteger(const char* name, std::uint64_t defaultValue, std::uint64_t min, std::uint64_t max) {
+    const char* value = environmentValue(name);
+    if (value == nullptr) {
+      return defaultValue;
+    }
+    char* end = nullptr;
+    const auto result = std::strtoull(value, &end, 10);
+    if (*end != '\0' || *value == '-' || result < min || result > max) {
+      throw std::runtime_error(std::string(name) + " must be an integer between " + std::to_string(min) + " and " + std::to_string(max));
+    }
+    return result;
+  }
+
+  double environmentDouble(const char* name, double defaultValue, double min, double max) {
+    const char* value = environmentValue(name);
+    if (value == nullptr) {
+      return defaultValue;
+    }
+    char* end = nullptr;
+    const auto result = std::strtod(value, &end);
+    if (*end != '\0' || !std::isfinite(result) || result < min || result > max) {
+      throw std::runtime_error(std::string(name) + " must be a number between " + std::to_string(min) + " and " + std::to_string(max));
+    }
+    return result;
+  }
+
+  constexpr std::array<int, 12> daysInMonth{31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+
+  // 1 to 12, and the day in it. The mock calendar is 2017, which isn't a leap year and starts on a Sunday
+  int monthOf(int dayOfYear, int* dayOfMonth) {
+    int month = 0;
+    while (dayOfYear > daysInMonth[month]) {
+      dayOfYear -= daysInMonth[month];
+      ++month;
+    }
+    *dayOfMonth = dayOfYear;
+    return month + 1;
+  }
+
+  std::string formatElapsed(std::chrono::steady_clock::duration elapsed) {
+    const double seconds = std::chrono::duration<double>(elapsed).count();
+    const int hours = static_cast<int>(seconds / 3600.0);
+    const int minutes = static_cast<int>((seconds - hours * 3600.0) / 60.0);
+    std::array<char, 64> buffer{};
+    std::snprintf(buffer.data(), buffer.size(), "%02dhr %02dmin %5.2fsec", hours, minutes, seconds - hours * 3600.0 - minutes * 60.0);
+    return buffer.data();
+  }
+
+  /// Holds the messages to the configured rate with a deadline per message, from the start: it only sleeps once a millisecond or more
+  /// ahead, so rates far above the sleep granularity are met on average
+  class Pacer
+  {
+   public:
+    explicit Pacer(double rate) : m_rate(rate) {}
+
+    void wait() {
+      if (m_rate <= 0.0) {
+        return;
+      }
+      const auto deadline = m_start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                        std::chrono::duration<double>(static_cast<double>(m_count++) / m_rate));
+      if (deadline - std::chrono::steady_clock::now() >= std::chrono::milliseconds(1)) {
+        std::this_thread::sleep_until(deadline);
+      }
+    }
+
+    /// After a pause that isn't the pacer's doing, so that it doesn't catch up with a burst
+    void restart() {
+      m_start = std::chrono::steady_clock::now();
+      m_count = 0;
+    }
+
+   private:
+    double m_rate;
+    std::chrono::steady_clock::time_point m_start = std::chrono::steady_clock::now();
+    std::uint64_t m_count = 0;
+  };
+
+  std::filesystem::path outputDirectory(int argc, const char* argv[]) {  // NOLINT(modernize-avoid-c-arrays)
+    for (int i = 1; i < argc - 1; ++i) {
+      const std::string arg = argv[i];  // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      if (arg == "-d" || arg == "--output-directory") {
+        return argv[i + 1];  // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      }
+    }
+    return ".";
+  }
+
+  // As in eplusout.err
+  const char* errorPrefix(EnergyPlus::Error level) {
+    switch (level) {
+      case EnergyPlus::Error::Info:
+        return "   ************* ";
+      case EnergyPlus::Error::Warning:
+        return "   ** Warning ** ";
+      case EnergyPlus::Error::Severe:
+        return "   ** Severe  ** ";
+      case EnergyPlus::Error::Fatal:
+        return "   **  Fatal  ** ";
+      case EnergyPlus::Error::Continue:
+        return "   **   ~~~   ** ";
+    }
+    return "";
+  }
+
+  enum class Outcome
+  {
+    Running,
+    Fatal,
+    Stopped,
+  };
+
+  class Replay
+  {
+   public:
+    Replay(MockState& state, const Config& config, MessageSource& source)
+      : m_state(state), m_config(config), m_source(source), m_pacer(config.rate), m_narrate(config.script.empty()) {}
+
+    Outcome run() {
+      narrate("EnergyPlus Starting");
+      narrate("EnergyPlus, Version 22.2.0-mock");
+      narrate("Processing Data Dictionary");
+      narrate("Processing Input File");
+      m_state.fire(Hook::EndOfAfterComponentGetInput);
+      narrate("Initializing Simulation");
+      m_state.fire(Hook::EndOfZoneSizing);
+      m_state.fire(Hook::EndOfSystemSizing);
+
+      m_state.environment = 1;
+      m_state.kindOfSim = 3;  // Run Period
+      m_state.dataReady = true;
+      m_state.warmup = m_config.warmupDays > 0;
+      m_state.fire(Hook::BeginNewEnvironment);
+      narrate("Initializing New Environment Parameters");
+      if (m_state.warmup) {
+        narrate("Warming up {1}");
+      }
+      for (int day = 1; day <= m_config.warmupDays; ++day) {
+        if (day > 1) {
+          narrate("Warming up {" + std::to_string(day) + "}");
+        }
+        // Warmup repeats the first day
+        if (!simulateDay(1, 0) || m_state.stopRequested.load(std::memory_order_relaxed)) {
+          return m_outcome;
+        }
+      }
+      m_state.warmup = false;
+      m_state.fire(Hook::AfterNewEnvironmentWarmupComplete);
+      narrate("Starting Simulation at 01/01/2017 for RUN PERIOD 1");
+
+      for (int day = 1; day <= m_config.days; ++day) {
+        const int dayOfYear = (day - 1) % 365 + 1;
+        int dayOfMonth = 0;
+        const int month = monthOf(dayOfYear, &dayOfMonth);
+        if (day > 1 && dayOfMonth == 1) {
+          narrate("Continuing Simulation at " + std::to_string(month) + "/01/2017 for RUN PERIOD 1");
+        }
+        if (!simulateDay(dayOfYear, day - 1)) {
+          return m_outcome;
+        }
+        if (!m_source.reportsProgress()) {
+          m_state.sendProgress(day * 100 / m_config.days);
+        }
+      }
+
+      narrate("Writing tabular output file results using comma format.");
+      narrate("Writing final SQL reports");
+      return m_outcome;
+    }
+
+   private:
+    bool simulateDay(int dayOfYear, int dayIndex) {
+      m_state.dayOfYear = dayOfYear;
+      for (int hour = 0; hour < 24; ++hour) {
+        m_state.hour = hour;
+        for (int timeStep = 1; timeStep <= m_config.timeStepsPerHour; ++timeStep) {
+          m_state.timeStepInHour = timeStep;
+          m_state.simTime = dayIndex * 24.0 + hour + static_cast<double>(timeStep) / m_config.timeStepsPerHour;
+          if (!zoneTimeStep()) {
+            return false;
+          }
+        }
+      }
+      return true;
+    }
+
+    // The callbacks of a zone timestep with a single system timestep, in the order EnergyPlus calls them, then this timestep's share of
+    // the messages
+    bool zoneTimeStep() {
+      m_state.fire(Hook::BeginZoneTimeStepBeforeSetCurrentWeather);
+      m_state.fire(Hook::BeginZoneTimeStepBeforeInitHeatBalance);
+      m_state.fire(Hook::BeginZoneTimeStepAfterInitHeatBalance);
+      m_state.fire(Hook::BeginTimeStepBeforePredictor);
+      m_state.fire(Hook::BeginSystemTimestepBeforePredictor);
+      m_state.fire(Hook::AfterPredictorBeforeHVACManagers);
+      m_state.fire(Hook::InsideSystemIterationLoop);
+      m_state.fire(Hook::AfterPredictorAfterHVACManagers);
+      m_state.fire(Hook::EndOfSystemTimeStepBeforeHVACReporting);
+      m_state.fire(Hook::EndOfSystemTimeStepAfterHVACReporting);
+      m_state.fire(Hook::EndOfZoneTimeStepBeforeZoneReporting);
+      m_state.fire(Hook::EndOfZoneTimeStepAfterZoneReporting);
+
+      ++m_timeStep;
+      const auto totalTimeSteps = static_cast<std::uint64_t>(m_config.warmupDays + m_config.days) * 24 * m_config.timeStepsPerHour;
+      const auto total = m_source.size();
+      // total * m_timeStep / totalTimeSteps, without overflowing
+      const auto target = total / totalTimeSteps * m_timeStep + total % totalTimeSteps * m_timeStep / totalTimeSteps;
+      return replayUntil(target);
+    }
+
+    bool replayUntil(std::uint64_t target) {
+      while (m_sent < target) {
+        if (m_state.stopRequested.load(std::memory_order_relaxed)) {
+          m_outcome = Outcome::Stopped;
+          return false;
+        }
+        const Message* message = m_source.next();
+        if (message == nullptr) {
+          m_sent = target;
+          break;
+        }
+        ++m_sent;
+        switch (message->kind) {
+          case Message::Kind::Stdout:
+            m_pacer.wait();
+            m_state.sendStdout(message->text);
+            break;
+          case Message::Kind::Error:
+            m_pacer.wait();
+            m_state.sendError(message->level, message->text);
+            if (message->level == EnergyPlus::Error::Fatal) {
+              m_outcome = Outcome::Fatal;
+              return false;
+            }
+            break;
+          case Message::Kind::Progress:
+            m_state.sendProgress(message->value);
+            break;
+          case Message::Kind::Sleep:
+            std::this_thread::sleep_for(std::chrono::milliseconds(message->value));
+            m_pacer.restart();
+            break;
+        }
+      }
+      if (m_state.stopRequested.load(std::memory_order_relaxed)) {
+        m_outcome = Outcome::Stopped;
+        return false;
+      }
+      return true;
+    }
+
+    // The milestones EnergyPlus prints, in random mode only: a script is replayed as is
+    void narrate(const std::string& line) {
+      if (m_narrate) {
+        m_state.sendStdout(line);
+      }
+    }
+
+    MockState& m_state;
+    const Config& m_config;
+    MessageSource& m_source;
+    Pacer m_pacer;
+    bool m_narrate;
+    std::uint64_t m_timeStep = 0;
+    std::uint64_t m_sent = 0;
+    Outcome m_outcome = Outcome::Running;
+  };
+
+  // Synthetic values: a daily sine, offset by handle so that they differ
+  Real64 syntheticValue(const MockState& state, int handle) {
+    constexpr double pi = 3.14159265358979323846;
+    const double time = state.hour + static_cast<double>(state.timeStepInHour) / state.timeStepsPerHour;
+    return 20.0 + 10.0 * std::sin(2.0 * pi * (time - 9.0) / 24.0) + handle % 7;
+  }
+
+  int handleFor(MockState& state, std::string name) {
+    const auto [it, inserted] = state.handles.try_emplace(std::move(name), static_cast<int>(state.handles.size()) + 1);
+    return it->second;
+  }
+
+  std::string handleName(const char* kind, const char* a, const char* b, const char* c = "") {
+    return std::string(kind) + '\x1f' + (a != nullptr ? a : "") + '\x1f' + (b != nullptr ? b : "") + '\x1f' + (c != nullptr ? c : "");
+  }
+
+}  // namespace
+
+Config Config::fromEnvironment() {
+  Config config;
+  if (const char* script = environmentValue("EPCLI_MOCK_SCRIPT")) {
+    config.script = script;
+  }
+  config.messages = environmentInteger("EPCLI_MOCK_MESSAGES", config.messages, 0, std::numeric_limits<std::uint64_t>::max());
+  config.errorFraction = environmentDouble("EPCLI_MOCK_ERROR_FRACTION", config.errorFraction, 0.0, 1.0);
+  config.seed = environmentInteger("EPCLI_MOCK_SEED", config.seed, 0, std::numeric_limits<std::uint64_t>::max());
+  config.rate = environmentDouble("EPCLI_MOCK_RATE", config.rate, 0.0, 1e12);
+  config.days = static_cast<int>(environmentInteger("EPCLI_MOCK_DAYS", config.days, 1, 3650));
+  config.warmupDays = static_cast<int>(environmentInteger("EPCLI_MOCK_WARMUP_DAYS", config.warmupDays, 0, 25));
+  config.timeStepsPerHour = static_cast<int>(environmentInteger("EPCLI_MOCK_TIMESTEPS", config.timeStepsPerHour, 1, 60));
+  return config;
+}
+
+void MockState::reset() {
+  stdoutCallback = nullptr;
+  progressCallback = nullptr;
+  errorCallback = nullptr;
+  for (auto& callbacks : hooks) {
+    callbacks.clear();
+  }
+  consoleOutput = true;
+  rootDirectory.clear();
+  stopRequested = false;
+  errorFlag = false;
+  environment = 0;
+  kindOfSim = 0;
+  warmup = false;
+  dataReady = false;
+  dayOfYear = 1;
+  hour = 0;
+  timeStepInHour = 1;
+  timeStepsPerHour = 4;
+  simTime = 0.0;
+  handles.clear();
+  actuatorValues.clear();
+  errFile.reset();
+  numWarnings = 0;
+  numSeveres = 0;
+}
+
+void MockState::fire(Hook hook) {
+  for (const auto& callback : hooks[static_cast<std::size_t>(hook)]) {
+    callback(this);
+  }
+}
+
+void MockState::sendStdout(const std::string& message) {
+  if (consoleOutput) {
+    std::cout << message << '\n';
+  }
+  if (stdoutCallback) {
+    stdoutCallback(message);
+  }
+}
+
+void MockState::sendError(EnergyPlus::Error level, const std::string& message) {
+  if (level == EnergyPlus::Error::Warning) {
+    ++numWarnings;
+  } else if (level == EnergyPlus::Error::Severe || level == EnergyPlus::Error::Fatal) {
+    ++numSeveres;
+  }
+  if (errFile) {
+    *errFile << errorPrefix(level) << message << '\n';
+  }
+  if (errorCallback) {
+    errorCallback(level, message);
+  }
+}
+
+void MockState::sendProgress(int percent) {
+  if (progressCallback) {
+    progressCallback(percent);
+  }
+}
+
+}  // namespace epcli::mock
+
+namespace mock = epcli::mock;
+
+using mock::Hook;
+using mock::mockState;
+
+EnergyPlusState stateNew() {
+  return new mock::MockState;  // NOLINT(cppcoreguidelines-owning-memory)
+}
+
+void stateReset(EnergyPlusState state) {
+  mockState(state).reset();
+}
+
+void stateDelete(EnergyPlusState state) {
+  delete static_cast<mock::MockState*>(state);  // NOLINT(cppcoreguidelines-owning-memory)
+}
+
+int energyplus(EnergyPlusState state, int argc, const char* argv[]) {  // NOLINT(modernize-avoid-c-arrays)
+  auto& s = mockState(state);
+  const auto start = std::chrono::steady_clock::now();
+
+  mock::Config config;
+  std::unique_ptr<mock::MessageSource> source;
+  try {
+    config = mock::Config::fromEnvironment();
+    if (config.script.empty()) {
+      source = std::make_unique<mock::RandomSource>(config.messages, config.errorFraction, config.seed);
+    } else {
+      source = mock::ScriptSource::fromFile(config.script);
+    }
+  } catch (const std::exception& e) {
+    s.sendError(EnergyPlus::Error::Fatal, e.what());
+    return 1;
+  }
+
+  const auto directory = mock::outputDirectory(argc, argv);
+  std::error_code ec;
+  std::filesystem::create_directories(directory, ec);
+  s.errFile = std::make_unique<std::ofstream>(directory / "eplusout.err");
+  *s.errFile << "Program Version,EnergyPlus, Version 22.2.0-mock, YMD=2017.01.01 00:00,\n";
+  s.timeStepsPerHour = config.timeStepsPerHour;
+  s.numWarnings = 0;
+  s.numSeveres = 0;
+
+  mock::Replay replay(s, config, *source);
+  const auto outcome = replay.run();
+
+  const auto elapsed = mock::formatElapsed(std::chrono::steady_clock::now() - start);
+  const auto counts = std::to_string(s.numWarnings) + " Warning; " + std::to_string(s.numSeveres) + " Severe Errors; Elapsed Time=" + elapsed;
+  if (outcome == mock::Outcome::Running) {
+    *s.errFile << "   ************* EnergyPlus Completed Successfully-- " << counts << '\n';
+  } else if (outcome == mock::Outcome::Fatal) {
+    *s.errFile << "   ************* EnergyPlus Terminated--Fatal Error Detected. " << counts << '\n';
+  } else {
+    *s.errFile << "   ************* EnergyPlus Terminated--Error(s) Detected. " << counts << '\n';
+  }
+  s.errFile.reset();
+
+  s.sendStdout("EnergyPlus Run Time=" + elapsed);
+  if (outcome == mock::Outcome::Running) {
+    s.sendStdout("EnergyPlus Completed Successfully.");
+    return 0;
+  }
+  s.sendStdout("EnergyPlus Terminated--Error(s) Detected.");
+  return 1;
+}
+
+void issueWarning(EnergyPlusState state, const char* message) {
+  mockState(state).sendError(EnergyPlus::Error::Warning, message);
+}
+
+void issueSevere(EnergyPlusState state, const char* message) {
+  mockState(state).sendError(EnergyPlus::Error::Severe, message);
+}
+
+void issueText(EnergyPlusState state, const char* message) {
+  mockState(state).sendError(EnergyPlus::Error::Continue, message);
+}
+
+void stopSimulation(EnergyPlusState state) {
+  mockState(state).stopRequested.store(true, std::memory_order_relaxed);
+}
+
+void setConsoleOutputState(EnergyPlusState state, int state_) {
+  mockState(state).consoleOutput = state_ != 0;
+}
+
+void setEnergyPlusRootDirectory(EnergyPlusState state, const char* path) {
+  mockState(state).rootDirectory = path;
+}
+
+void registerProgressCallback(EnergyPlusState state, void (*f)(int const)) {
+  mockState(state).progressCallback = f;
+}
+
+void registerProgressCallback(EnergyPlusState state, std::function<void(int const)> f) {
+  mockState(state).progressCallback = std::move(f);
+}
+
+void registerStdOutCallback(EnergyPlusState state, void (*f)(const char*)) {
+  mockState(state).stdoutCallback = [f](const std::string& message) { f(message.c_str()); };
+}
+
+void registerStdOutCallback(EnergyPlusState state, std::function<void(const std::string&)> f) {
+  mockState(state).stdoutCallback = std::move(f);
+}
+
+void registerErrorCallback(EnergyPlusState state, void (*f)(int, const char*)) {
+  mockState(state).errorCallback = [f](EnergyPlus::Error level, const std::string& message) { f(static_cast<int>(level), message.c_str()); };
+}
+
+void registerErrorCallback(EnergyPlusState state, std::function<void(EnergyPlus::Error, const std::string&)> f) {
+  mockState(state).errorCallback = std::move(f);
+}
+
+// EnergyPlus calls each of them with the state as argument: both overloads of callback<Hook> append to the hook's callbacks
+#define EPCLI_MOCK_CALLBACK(hook)                                                                                                       \
+  void callback##hook(EnergyPlusState state, void (*f)(EnergyPlusState)) {                                                              \
+    mockState(state).hooks[static_cast<std::size_t>(Hook::hook)].emplace_back(f);                                                       \
+  }                                                                                                                                      \
+  void callback##hook(EnergyPlusState state, std::function<void(EnergyPlusState)> f) {                                                  \
+    mockState(state).hooks[static_cast<std::size_t>(Hook::hook)].push_back(std::move(f));                                               \
+  }
+
+EPCLI_MOCK_CALLBACK(BeginNewEnvironment)
+EPCLI_MOCK_CALLBACK(AfterNewEnvironmentWarmupComplete)
+EPCLI_MOCK_CALLBACK(BeginZoneTimeStepBeforeInitHeatBalance)
+EPCLI_MOCK_CALLBACK(BeginZoneTimeStepAfterInitHeatBalance)
+EPCLI_MOCK_CALLBACK(BeginTimeStepBeforePredictor)
+EPCLI_MOCK_CALLBACK(BeginZoneTimeStepBeforeSetCurrentWeather)
+EPCLI_MOCK_CALLBACK(BeginSystemTimestepBeforePredictor)
+EPCLI_MOCK_CALLBACK(AfterPredictorBeforeHVACManagers)
+EPCLI_MOCK_CALLBACK(AfterPredictorAfterHVACManagers)
+EPCLI_MOCK_CALLBACK(InsideSystemIterationLoop)
+EPCLI_MOCK_CALLBACK(EndOfZoneTimeStepBeforeZoneReporting)
+EPCLI_MOCK_CALLBACK(EndOfZoneTimeStepAfterZoneReporting)
+EPCLI_MOCK_CALLBACK(EndOfSystemTimeStepBeforeHVACReporting)
+EPCLI_MOCK_CALLBACK(EndOfSystemTimeStepAfterHVACReporting)
+EPCLI_MOCK_CALLBACK(EndOfZoneSizing)
+EPCLI_MOCK_CALLBACK(EndOfSystemSizing)
+EPCLI_MOCK_CALLBACK(EndOfAfterComponentGetInput)
+
+#undef EPCLI_MOCK_CALLBACK
+
+int apiDataFullyReady(EnergyPlusState state) {
+  return mockState(state).dataReady ? 1 : 0;
+}
+
+int apiErrorFlag(EnergyPlusState state) {
+  return mockState(state).errorFlag ? 1 : 0;
+}
+
+void resetErrorFlag(EnergyPlusState state) {
+  mockState(state).errorFlag = false;
+}
+
+void requestVariable(EnergyPlusState /*state*/, const char* /*type*/, const char* /*key*/) {}
+
+int getVariableHandle(EnergyPlusState state, const char* type, const char* key) {
+  return mock::handleFor(mockState(state), mock::handleName("variable", type, key));
+}
+
+Real64 getVariableValue(EnergyPlusState state, int handle) {
+  return mock::syntheticValue(mockState(state), handle);
+}
+
+int getMeterHandle(EnergyPlusState state, const char* meterName) {
+  return mock::handleFor(mockState(state), mock::handleName("meter", meterName, ""));
+}
+
+Real64 getMeterValue(EnergyPlusState state, int handle) {
+  return 1e5 * mock::syntheticValue(mockState(state), handle);
+}
+
+int getActuatorHandle(EnergyPlusState state, const char* componentType, const char* controlType, const char* uniqueKey) {
+  return mock::handleFor(mockState(state), mock::handleName("actuator", componentType, controlType, uniqueKey));
+}
+
+void resetActuator(EnergyPlusState state, int handle) {
+  mockState(state).actuatorValues.erase(handle);
+}
+
+void setActuatorValue(EnergyPlusState state, int handle, Real64 value) {
+  mockState(state).actuatorValues[handle] = value;
+}
+
+Real64 getActuatorValue(EnergyPlusState state, int handle) {
+  const auto& values = mockState(state).actuatorValues;
+  const auto it = values.find(handle);
+  return it != values.end() ? it->second : 0.0;
+}
+
+int getInternalVariableHandle(EnergyPlusState state, const char* type, const char* key) {
+  return mock::handleFor(mockState(state), mock::handleName("internal", type, key));
+}
+
+Real64 getInternalVariableValue(EnergyPlusState /*state*/, int handle) {
+  // Sizes and areas: constant over the run
+  return 100.0 * handle;
+}
+
+int year(EnergyPlusState /*state*/) {
+  return 2017;
+}
+
+int month(EnergyPlusState state) {
+  int day = 0;
+  return mock::monthOf(mockState(state).dayOfYear, &day);
+}
+
+int dayOfMonth(EnergyPlusState state) {
+  int day = 0;
+  mock::monthOf(mockState(state).dayOfYear, &day);
+  return day;
+}
+
+int dayOfWeek(EnergyPlusState state) {
+  // 1 is Sunday, like 01/01/2017
+  return (mockState(state).dayOfYear - 1) % 7 + 1;
+}
+
+int dayOfYear(EnergyPlusState state) {
+  return mockState(state).dayOfYear;
+}
+
+int hour(EnergyPlusState state) {
+  return mockState(state).hour;
+}
+
+Real64 currentTime(EnergyPlusState state) {
+  const auto& s = mockState(state);
+  return s.hour + static_cast<double>(s.timeStepInHour) / s.timeStepsPerHour;
+}
+
+int minutes(EnergyPlusState state) {
+  const auto& s = mockState(state);
+  return s.timeStepInHour * 60 / s.timeStepsPerHour;
+}
+
+Real64 systemTimeStep(EnergyPlusState state) {
+  return 1.0 / mockState(state).timeStepsPerHour;
+}
+
+Real64 zoneTimeStep(EnergyPlusState state) {
+  return 1.0 / mockState(state).timeStepsPerHour;
+}
+
+int currentEnvironmentNum(EnergyPlusState state) {
+  return mockState(state).environment;
+}
+
+int warmupFlag(EnergyPlusState state) {
+  return mockState(state).warmup ? 1 : 0;
+}
+
+int kindOfSim(EnergyPlusState state) {
+  return mockState(state).kindOfSim;
+}
+
+Real64 currentSimTime(EnergyPlusState state) {
+  return mockState(state).simTime;
+}
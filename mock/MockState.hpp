@@ -0,0 +1,113 @@
+#ifndef MOCK_MOCKSTATE_HPP
+#define MOCK_MOCKSTATE_HPP
+
+#include "MessageSource.hpp"  // for MessageSource
+
+#include <EnergyPlus/api/TypeDefs.h>  // for Error, Real64
+#include <EnergyPlus/api/state.h>     // for EnergyPlusState
+
+#include <array>       // for array
+#include <atomic>      // for atomic
+#include <cstddef>     // for size_t
+#include <cstdint>     // for uint64_t
+#include <filesystem>  // for path
+#include <fstream>     // for ofstream
+#include <functional>  // for function
+#include <map>         // for map
+#include <memory>      // for unique_ptr
+#include <string>      // for string
+#include <vector>      // for vector
+
+namespace epcli::mock {
+
+/// Read from the environment by each energyplus() call:
+///   EPCLI_MOCK_SCRIPT          replay this script (see ScriptSource), instead of random messages
+///   EPCLI_MOCK_MESSAGES        number of random messages (default: 100000)
+///   EPCLI_MOCK_ERROR_FRACTION  share of errors among the random messages (default: 0.1)
+///   EPCLI_MOCK_SEED            seed of the random messages (default: 1)
+///   EPCLI_MOCK_RATE            messages per second, 0 for as fast as possible (default: 0)
+///   EPCLI_MOCK_DAYS            simulated days of the run period (default: 365)
+///   EPCLI_MOCK_WARMUP_DAYS     warmup days before it (default: 6)
+///   EPCLI_MOCK_TIMESTEPS       zone timesteps per hour (default: 4)
+struct Config
+{
+  std::filesystem::path script;
+  std::uint64_t messages = 100'000;
+  double errorFraction = 0.1;
+  std::uint64_t seed = 1;
+  double rate = 0.0;
+  int days = 365;
+  int warmupDays = 6;
+  int timeStepsPerHour = 4;
+
+  /// Throws std::runtime_error on an invalid value
+  static Config fromEnvironment();
+};
+
+enum class Hook
+{
+  BeginNewEnvironment,
+  AfterNewEnvironmentWarmupComplete,
+  BeginZoneTimeStepBeforeInitHeatBalance,
+  BeginZoneTimeStepAfterInitHeatBalance,
+  BeginTimeStepBeforePredictor,
+  BeginZoneTimeStepBeforeSetCurrentWeather,
+  BeginSystemTimestepBeforePredictor,
+  AfterPredictorBeforeHVACManagers,
+  AfterPredictorAfterHVACManagers,
+  InsideSystemIterationLoop,
+  EndOfZoneTimeStepBeforeZoneReporting,
+  EndOfZoneTimeStepAfterZoneReporting,
+  EndOfSystemTimeStepBeforeHVACReporting,
+  EndOfSystemTimeStepAfterHVACReporting,
+  EndOfZoneSizing,
+  EndOfSystemSizing,
+  EndOfAfterComponentGetInput,
+};
+constexpr std::size_t numHooks = 17;
+
+/// What an EnergyPlusState points to. Only stopSimulation may be called from another thread than the one running energyplus()
+struct MockState
+{
+  std::function<void(const std::string&)> stdoutCallback;
+  std::function<void(int)> progressCallback;
+  std::function<void(EnergyPlus::Error, const std::string&)> errorCallback;
+  std::array<std::vector<std::function<void(EnergyPlusState)>>, numHooks> hooks;
+
+  bool consoleOutput = true;
+  std::string rootDirectory;
+  std::atomic<bool> stopRequested = false;
+  bool errorFlag = false;
+
+  // Where the simulated timeline is
+  int environment = 0;
+  int kindOfSim = 0;
+  bool warmup = false;
+  bool dataReady = false;
+  int dayOfYear = 1;
+  int hour = 0;            // 0 to 23
+  int timeStepInHour = 1;  // 1 to timeStepsPerHour
+  int timeStepsPerHour = 4;
+  Real64 simTime = 0.0;  // Hours since the start of the environment
+
+  // Names of the variables, meters, actuators and internal variables, to the handle given out for them
+  std::map<std::string, int> handles;
+  std::map<int, Real64> actuatorValues;
+
+  // The error file of the run being replayed, if any, and its counts for the final line
+  std::unique_ptr<std::ofstream> errFile;
+  std::uint64_t numWarnings = 0;
+  std::uint64_t numSeveres = 0;
+
+  /// Back to a fresh state, callbacks included, as stateReset does
+  void reset();
+
+  void fire(Hook hook);
+  void sendStdout(const std::string& message);
+  void sendError(EnergyPlus::Error level, const std::string& message);
+  void sendProgress(int percent);
+};
+
+}  // namespace epcli::mock
+
+#endif  // MOCK_MOCKSTATE_HPP
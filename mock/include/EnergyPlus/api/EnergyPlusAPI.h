@@ -0,0 +1,16 @@
+#ifndef EPCLI_MOCK_ENERGYPLUSAPI_H
+#define EPCLI_MOCK_ENERGYPLUSAPI_H
+
+// The mock EnergyPlus API: same headers and signatures as the subset of the EnergyPlus C API that epcli uses, see mock/MockEnergyPlus.cpp
+
+#if defined(_WIN32) || defined(_MSC_VER)
+#  ifdef epcli_mock_energyplusapi_EXPORTS
+#    define ENERGYPLUSLIB_API __declspec(dllexport)
+#  else
+#    define ENERGYPLUSLIB_API __declspec(dllimport)
+#  endif
+#else
+#  define ENERGYPLUSLIB_API __attribute__((visibility("default")))
+#endif
+
+#endif  // EPCLI_MOCK_ENERGYPLUSAPI_H
@@ -0,0 +1,19 @@
+#ifndef EPCLI_MOCK_TYPEDEFS_H
+#define EPCLI_MOCK_TYPEDEFS_H
+
+typedef double Real64;  // NOLINT(modernize-use-using)
+
+#ifdef __cplusplus
+namespace EnergyPlus {
+enum class Error
+{
+  Info,
+  Warning,
+  Severe,
+  Fatal,
+  Continue
+};
+}  // namespace EnergyPlus
+#endif
+
+#endif  // EPCLI_MOCK_TYPEDEFS_H
@@ -0,0 +1,52 @@
+#ifndef EPCLI_MOCK_DATATRANSFER_H
+#define EPCLI_MOCK_DATATRANSFER_H
+
+#include "EnergyPlusAPI.h"
+#include "TypeDefs.h"
+#include "state.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Handles are handed out on demand for any name, and the values are synthetic: see mock/MockEnergyPlus.cpp
+
+ENERGYPLUSLIB_API int apiDataFullyReady(EnergyPlusState state);
+ENERGYPLUSLIB_API int apiErrorFlag(EnergyPlusState state);
+ENERGYPLUSLIB_API void resetErrorFlag(EnergyPlusState state);
+
+ENERGYPLUSLIB_API void requestVariable(EnergyPlusState state, const char* type, const char* key);
+ENERGYPLUSLIB_API int getVariableHandle(EnergyPlusState state, const char* type, const char* key);
+ENERGYPLUSLIB_API Real64 getVariableValue(EnergyPlusState state, int handle);
+
+ENERGYPLUSLIB_API int getMeterHandle(EnergyPlusState state, const char* meterName);
+ENERGYPLUSLIB_API Real64 getMeterValue(EnergyPlusState state, int handle);
+
+ENERGYPLUSLIB_API int getActuatorHandle(EnergyPlusState state, const char* componentType, const char* controlType, const char* uniqueKey);
+ENERGYPLUSLIB_API void resetActuator(EnergyPlusState state, int handle);
+ENERGYPLUSLIB_API void setActuatorValue(EnergyPlusState state, int handle, Real64 value);
+ENERGYPLUSLIB_API Real64 getActuatorValue(EnergyPlusState state, int handle);
+
+ENERGYPLUSLIB_API int getInternalVariableHandle(EnergyPlusState state, const char* type, const char* key);
+ENERGYPLUSLIB_API Real64 getInternalVariableValue(EnergyPlusState state, int handle);
+
+ENERGYPLUSLIB_API int year(EnergyPlusState state);
+ENERGYPLUSLIB_API int month(EnergyPlusState state);
+ENERGYPLUSLIB_API int dayOfMonth(EnergyPlusState state);
+ENERGYPLUSLIB_API int dayOfWeek(EnergyPlusState state);
+ENERGYPLUSLIB_API int dayOfYear(EnergyPlusState state);
+ENERGYPLUSLIB_API int hour(EnergyPlusState state);
+ENERGYPLUSLIB_API Real64 currentTime(EnergyPlusState state);
+ENERGYPLUSLIB_API int minutes(EnergyPlusState state);
+ENERGYPLUSLIB_API Real64 systemTimeStep(EnergyPlusState state);
+ENERGYPLUSLIB_API Real64 zoneTimeStep(EnergyPlusState state);
+ENERGYPLUSLIB_API int currentEnvironmentNum(EnergyPlusState state);
+ENERGYPLUSLIB_API int warmupFlag(EnergyPlusState state);
+ENERGYPLUSLIB_API int kindOfSim(EnergyPlusState state);
+ENERGYPLUSLIB_API Real64 currentSimTime(EnergyPlusState state);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // EPCLI_MOCK_DATATRANSFER_H
@@ -0,0 +1,23 @@
+#ifndef EPCLI_MOCK_FUNC_H
+#define EPCLI_MOCK_FUNC_H
+
+#include "EnergyPlusAPI.h"
+#include "TypeDefs.h"
+#include "state.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+ENERGYPLUSLIB_API void registerErrorCallback(EnergyPlusState state, void (*f)(int, const char*));
+
+#ifdef __cplusplus
+}
+
+#  include <functional>
+#  include <string>
+
+ENERGYPLUSLIB_API void registerErrorCallback(EnergyPlusState state, std::function<void(EnergyPlus::Error, const std::string&)> f);
+#endif
+
+#endif  // EPCLI_MOCK_FUNC_H
@@ -0,0 +1,72 @@
+#ifndef EPCLI_MOCK_RUNTIME_H
+#define EPCLI_MOCK_RUNTIME_H
+
+#include "EnergyPlusAPI.h"
+#include "state.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Replays the messages configured by the EPCLI_MOCK_* environment variables instead of simulating anything. Returns 0, or 1 when the
+/// script issued a Fatal or stopSimulation was called
+ENERGYPLUSLIB_API int energyplus(EnergyPlusState state, int argc, const char* argv[]);
+
+ENERGYPLUSLIB_API void issueWarning(EnergyPlusState state, const char* message);
+ENERGYPLUSLIB_API void issueSevere(EnergyPlusState state, const char* message);
+ENERGYPLUSLIB_API void issueText(EnergyPlusState state, const char* message);
+ENERGYPLUSLIB_API void stopSimulation(EnergyPlusState state);
+
+ENERGYPLUSLIB_API void setConsoleOutputState(EnergyPlusState state, int state_);
+ENERGYPLUSLIB_API void setEnergyPlusRootDirectory(EnergyPlusState state, const char* path);
+
+ENERGYPLUSLIB_API void registerProgressCallback(EnergyPlusState state, void (*f)(int const));
+ENERGYPLUSLIB_API void registerStdOutCallback(EnergyPlusState state, void (*f)(const char*));
+
+ENERGYPLUSLIB_API void callbackBeginNewEnvironment(EnergyPlusState state, void (*f)(EnergyPlusState));
+ENERGYPLUSLIB_API void callbackAfterNewEnvironmentWarmupComplete(EnergyPlusState state, void (*f)(EnergyPlusState));
+ENERGYPLUSLIB_API void callbackBeginZoneTimeStepBeforeInitHeatBalance(EnergyPlusState state, void (*f)(EnergyPlusState));
+ENERGYPLUSLIB_API void callbackBeginZoneTimeStepAfterInitHeatBalance(EnergyPlusState state, void (*f)(EnergyPlusState));
+ENERGYPLUSLIB_API void callbackBeginTimeStepBeforePredictor(EnergyPlusState state, void (*f)(EnergyPlusState));
+ENERGYPLUSLIB_API void callbackBeginZoneTimeStepBeforeSetCurrentWeather(EnergyPlusState state, void (*f)(EnergyPlusState));
+ENERGYPLUSLIB_API void callbackBeginSystemTimestepBeforePredictor(EnergyPlusState state, void (*f)(EnergyPlusState));
+ENERGYPLUSLIB_API void callbackAfterPredictorBeforeHVACManagers(EnergyPlusState state, void (*f)(EnergyPlusState));
+ENERGYPLUSLIB_API void callbackAfterPredictorAfterHVACManagers(EnergyPlusState state, void (*f)(EnergyPlusState));
+ENERGYPLUSLIB_API void callbackInsideSystemIterationLoop(EnergyPlusState state, void (*f)(EnergyPlusState));
+ENERGYPLUSLIB_API void callbackEndOfZoneTimeStepBeforeZoneReporting(EnergyPlusState state, void (*f)(EnergyPlusState));
+ENERGYPLUSLIB_API void callbackEndOfZoneTimeStepAfterZoneReporting(EnergyPlusState state, void (*f)(EnergyPlusState));
+ENERGYPLUSLIB_API void callbackEndOfSystemTimeStepBeforeHVACReporting(EnergyPlusState state, void (*f)(EnergyPlusState));
+ENERGYPLUSLIB_API void callbackEndOfSystemTimeStepAfterHVACReporting(EnergyPlusState state, void (*f)(EnergyPlusState));
+ENERGYPLUSLIB_API void callbackEndOfZoneSizing(EnergyPlusState state, void (*f)(EnergyPlusState));
+ENERGYPLUSLIB_API void callbackEndOfSystemSizing(EnergyPlusState state, void (*f)(EnergyPlusState));
+ENERGYPLUSLIB_API void callbackEndOfAfterComponentGetInput(EnergyPlusState state, void (*f)(EnergyPlusState));
+
+#ifdef __cplusplus
+}
+
+#  include <functional>
+#  include <string>
+
+ENERGYPLUSLIB_API void registerProgressCallback(EnergyPlusState state, std::function<void(int const)> f);
+ENERGYPLUSLIB_API void registerStdOutCallback(EnergyPlusState state, std::function<void(const std::string&)> f);
+
+ENERGYPLUSLIB_API void callbackBeginNewEnvironment(EnergyPlusState state, std::function<void(EnergyPlusState)> f);
+ENERGYPLUSLIB_API void callbackAfterNewEnvironmentWarmupComplete(EnergyPlusState state, std::function<void(EnergyPlusState)> f);
+ENERGYPLUSLIB_API void callbackBeginZoneTimeStepBeforeInitHeatBalance(EnergyPlusState state, std::function<void(EnergyPlusState)> f);
+ENERGYPLUSLIB_API void callbackBeginZoneTimeStepAfterInitHeatBalance(EnergyPlusState state, std::function<void(EnergyPlusState)> f);
+ENERGYPLUSLIB_API void callbackBeginTimeStepBeforePredictor(EnergyPlusState state, std::function<void(EnergyPlusState)> f);
+ENERGYPLUSLIB_API void callbackBeginZoneTimeStepBeforeSetCurrentWeather(EnergyPlusState state, std::function<void(EnergyPlusState)> f);
+ENERGYPLUSLIB_API void callbackBeginSystemTimestepBeforePredictor(EnergyPlusState state, std::function<void(EnergyPlusState)> f);
+ENERGYPLUSLIB_API void callbackAfterPredictorBeforeHVACManagers(EnergyPlusState state, std::function<void(EnergyPlusState)> f);
+ENERGYPLUSLIB_API void callbackAfterPredictorAfterHVACManagers(EnergyPlusState state, std::function<void(EnergyPlusState)> f);
+ENERGYPLUSLIB_API void callbackInsideSystemIterationLoop(EnergyPlusState state, std::function<void(EnergyPlusState)> f);
+ENERGYPLUSLIB_API void callbackEndOfZoneTimeStepBeforeZoneReporting(EnergyPlusState state, std::function<void(EnergyPlusState)> f);
+ENERGYPLUSLIB_API void callbackEndOfZoneTimeStepAfterZoneReporting(EnergyPlusState state, std::function<void(EnergyPlusState)> f);
+ENERGYPLUSLIB_API void callbackEndOfSystemTimeStepBeforeHVACReporting(EnergyPlusState state, std::function<void(EnergyPlusState)> f);
+ENERGYPLUSLIB_API void callbackEndOfSystemTimeStepAfterHVACReporting(EnergyPlusState state, std::function<void(EnergyPlusState)> f);
+ENERGYPLUSLIB_API void callbackEndOfZoneSizing(EnergyPlusState state, std::function<void(EnergyPlusState)> f);
+ENERGYPLUSLIB_API void callbackEndOfSystemSizing(EnergyPlusState state, std::function<void(EnergyPlusState)> f);
+ENERGYPLUSLIB_API void callbackEndOfAfterComponentGetInput(EnergyPlusState state, std::function<void(EnergyPlusState)> f);
+#endif
+
+#endif  // EPCLI_MOCK_RUNTIME_H
@@ -0,0 +1,20 @@
+#ifndef EPCLI_MOCK_STATE_H
+#define EPCLI_MOCK_STATE_H
+
+#include "EnergyPlusAPI.h"
+
+typedef void* EnergyPlusState;  // NOLINT(modernize-use-using)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+ENERGYPLUSLIB_API EnergyPlusState stateNew();
+ENERGYPLUSLIB_API void stateReset(EnergyPlusState state);
+ENERGYPLUSLIB_API void stateDelete(EnergyPlusState state);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // EPCLI_MOCK_STATE_H
@@ -0,0 +1,186 @@
+#include "CallbackFilter.hpp"
+
+#include <fmt/format.h>  // for format, join
+
+#include <algorithm>  // for any_of, max, min
+#include <array>      // for array
+#include <stdexcept>  // for runtime_error
+#include <utility>    // for move
+#include <vector>     // for vector
+
+namespace epcli {
+
+namespace {
+  // The stdout lines EnergyPlus prints as it goes through the days
+  constexpr std::array<std::string_view, 4> progressPrefixes{
+    "Continuing Simulation at",
+    "Warming up",
+    "Updating Shadowing Calculations",
+    "Calculating Detailed Daylighting Factors",
+  };
+
+  bool isProgressLine(std::string_view message) {
+    return std::any_of(progressPrefixes.cbegin(), progressPrefixes.cend(),
+                       [&message](std::string_view prefix) { return message.substr(0, prefix.size()) == prefix; });
+  }
+
+  constexpr std::uint64_t fnvOffset = 0xcbf29ce484222325ULL;
+  constexpr std::uint64_t fnvPrime = 0x100000001b3ULL;
+
+  constexpr std::uint64_t mix(std::uint64_t hash, char c) {
+    return (hash ^ static_cast<unsigned char>(c)) * fnvPrime;
+  }
+
+  const char* levelName(EnergyPlus::Error level) {
+    switch (level) {
+      case EnergyPlus::Error::Warning:
+        return "Warning";
+      case EnergyPlus::Error::Severe:
+        return "Severe";
+      case EnergyPlus::Error::Fatal:
+        return "Fatal";
+      default:
+        return "Info";
+    }
+  }
+}  // namespace
+
+bool FilterOptions::enabled() const {
+  return minimumLevel != EnergyPlus::Error::Info || templateRate > 0.0 || progressSampling > 1;
+}
+
+EnergyPlus::Error FilterOptions::parseLevel(std::string_view level) {
+  if (level == "info") {
+    return EnergyPlus::Error::Info;
+  }
+  if (level == "warning") {
+    return EnergyPlus::Error::Warning;
+  }
+  if (level == "severe") {
+    return EnergyPlus::Error::Severe;
+  }
+  if (level == "fatal") {
+    return EnergyPlus::Error::Fatal;
+  }
+  throw std::runtime_error(fmt::format("Invalid level '{}', expected info, warning, severe or fatal", level));
+}
+
+CallbackFilter::CallbackFilter(FilterOptions options) : m_options(std::move(options)) {}
+
+void CallbackFilter::reset() {
+  m_buckets.clear();
+  m_lastErrorVerdict = Verdict::Keep;
+  m_counts = Counts{};
+}
+
+CallbackFilter::Verdict CallbackFilter::stdoutLine(std::string_view message) {
+  if (m_options.progressSampling > 1 && isProgressLine(message)) {
+    // The first one is kept
+    if (m_counts.progressLines++ % m_options.progressSampling != 0) {
+      ++m_counts.sampledOut;
+      return Verdict::SampledOut;
+    }
+  }
+  return rateLimit(message);
+}
+
+CallbackFilter::Verdict CallbackFilter::error(EnergyPlus::Error level, std::string_view message) {
+  if (level == EnergyPlus::Error::Continue) {
+    if (m_lastErrorVerdict == Verdict::BelowLevel) {
+      ++m_counts.belowLevel;
+    } else if (m_lastErrorVerdict == Verdict::RateLimited) {
+      ++m_counts.rateLimited;
+    }
+    return m_lastErrorVerdict;
+  }
+  if (level == EnergyPlus::Error::Fatal) {
+    m_lastErrorVerdict = Verdict::Keep;
+  } else if (level < m_options.minimumLevel) {
+    ++m_counts.belowLevel;
+    m_lastErrorVerdict = Verdict::BelowLevel;
+  } else {
+    m_lastErrorVerdict = rateLimit(message);
+  }
+  return m_lastErrorVerdict;
+}
+
+CallbackFilter::Verdict CallbackFilter::rateLimit(std::string_view message) {
+  if (m_options.templateRate <= 0.0) {
+    return Verdict::Keep;
+  }
+  // A token bucket per template, which allows a burst of one second's worth
+  const double capacity = std::max(1.0, m_options.templateRate);
+  const auto now = std::chrono::steady_clock::now();
+  auto [it, inserted] = m_buckets.try_emplace(templateKey(message));
+  auto& bucket = it->second;
+  if (inserted) {
+    bucket.tokens = capacity;
+  } else {
+    bucket.tokens = std::min(capacity, bucket.tokens + std::chrono::duration<double>(now - bucket.last).count() * m_options.templateRate);
+  }
+  bucket.last = now;
+  if (bucket.tokens < 1.0) {
+    if (!bucket.limited) {
+      bucket.limited = true;
+      ++m_counts.templatesLimited;
+    }
+    ++m_counts.rateLimited;
+    return Verdict::RateLimited;
+  }
+  bucket.tokens -= 1.0;
+  return Verdict::Keep;
+}
+
+const FilterOptions& CallbackFilter::options() const {
+  return m_options;
+}
+
+const CallbackFilter::Counts& CallbackFilter::counts() const {
+  return m_counts;
+}
+
+std::string CallbackFilter::summary() const {
+  std::vector<std::string> parts;
+  if (m_counts.belowLevel > 0) {
+    parts.push_back(fmt::format("{} errors below {}", m_counts.belowLevel, levelName(m_options.minimumLevel)));
+  }
+  if (m_counts.rateLimited > 0) {
+    parts.push_back(fmt::format("{} messages over {}/s for {} templates", m_counts.rateLimited, m_options.templateRate,
+                                m_counts.templatesLimited));
+  }
+  if (m_counts.sampledOut > 0) {
+    parts.push_back(fmt::format("{} of {} progress lines", m_counts.sampledOut, m_counts.progressLines));
+  }
+  if (parts.empty()) {
+    return {};
+  }
+  return fmt::format("Suppressed at the source: {}", fmt::join(parts, ", "));
+}
+
+std::uint64_t CallbackFilter::templateKey(std::string_view message) {
+  std::uint64_t hash = fnvOffset;
+  bool inNumber = false;
+  bool inQuotes = false;
+  for (const char c : message) {
+    if (inQuotes) {
+      if (c == '"') {
+        inQuotes = false;
+        hash = mix(mix(hash, '*'), '"');
+      }
+      continue;
+    }
+    const bool isDigit = c >= '0' && c <= '9';
+    if (isDigit) {
+      if (!inNumber) {
+        hash = mix(hash, '#');
+      }
+    } else {
+      hash = mix(hash, c);
+      inQuotes = c == '"';
+    }
+    inNumber = isDigit;
+  }
+  return hash;
+}
+
+}  // namespace epcli
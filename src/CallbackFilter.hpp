@@ -0,0 +1,89 @@
+#ifndef CALLBACK_FILTER_HPP
+#define CALLBACK_FILTER_HPP
+
+#include <EnergyPlus/api/TypeDefs.h>  // for Error
+
+#include <chrono>         // for steady_clock
+#include <cstdint>        // for uint64_t
+#include <string>         // for string
+#include <string_view>    // for string_view
+#include <unordered_map>  // for unordered_map
+
+namespace epcli {
+
+struct FilterOptions
+{
+  /// Errors below it are dropped, along with their Continue lines. Fatal always goes through
+  EnergyPlus::Error minimumLevel = EnergyPlus::Error::Info;
+  /// Messages per second allowed for each template (the message with its numbers and quoted names blanked out), 0 for no limit
+  double templateRate = 0.0;
+  /// Keep 1 in this many stdout progress lines (Continuing Simulation, Warming up...)
+  unsigned progressSampling = 1;
+
+  /// Whether any of them would drop something
+  [[nodiscard]] bool enabled() const;
+
+  /// "info", "warning", "severe" or "fatal", throws std::runtime_error otherwise
+  static EnergyPlus::Error parseLevel(std::string_view level);
+};
+
+/// Decides, inside the EnergyPlus callbacks, whether a stdout line or an error is worth queuing to the UI at all: for models that issue
+/// the same warning millions of times, most messages are dropped before they cost a copy, a queue push and a redraw. What is dropped is
+/// counted, and summarized at the end of the run. Not thread-safe: it is only used from the EnergyPlus thread
+class CallbackFilter
+{
+ public:
+  enum class Verdict
+  {
+    Keep,
+    BelowLevel,
+    RateLimited,
+    SampledOut,
+  };
+
+  struct Counts
+  {
+    std::uint64_t belowLevel = 0;
+    std::uint64_t rateLimited = 0;
+    std::uint64_t sampledOut = 0;
+    std::uint64_t progressLines = 0;
+    std::uint64_t templatesLimited = 0;
+  };
+
+  explicit CallbackFilter(FilterOptions options);
+
+  /// Clears the counts and rate limits, before a new run
+  void reset();
+
+  Verdict stdoutLine(std::string_view message);
+  Verdict error(EnergyPlus::Error level, std::string_view message);
+
+  [[nodiscard]] const FilterOptions& options() const;
+  [[nodiscard]] const Counts& counts() const;
+  /// What was dropped during the run, empty if nothing was
+  [[nodiscard]] std::string summary() const;
+
+  /// FNV-1a of the message with each run of digits replaced by # and each "quoted name" by "*", so that "Zone 12 ..." and "Zone 7 ..."
+  /// share the same rate limit
+  static std::uint64_t templateKey(std::string_view message);
+
+ private:
+  Verdict rateLimit(std::string_view message);
+
+  struct Bucket
+  {
+    double tokens = 0.0;
+    std::chrono::steady_clock::time_point last;
+    bool limited = false;
+  };
+
+  FilterOptions m_options;
+  std::unordered_map<std::uint64_t, Bucket> m_buckets;
+  // What happened to the last error that wasn't a Continue: its Continue lines share its fate
+  Verdict m_lastErrorVerdict = Verdict::Keep;
+  Counts m_counts;
+};
+
+}  // namespace epcli
+
+#endif  // CALLBACK_FILTER_HPP
@@ -0,0 +1,130 @@
+#include "ComparisonComponent.hpp"
+
+#include <ftxui/component/component.hpp>  // for Radiobox, Container
+#include <ftxui/dom/elements.hpp>         // for text, separator, operator|, color, window, hbox, vbox, size
+#include <ftxui/screen/color.hpp>         // for Color
+
+#include <fmt/format.h>  // for format
+
+#include <algorithm>  // for max, clamp
+#include <utility>    // for move
+
+ComparisonComponent::ComparisonComponent(const std::vector<std::filesystem::path>& databasePaths, Component quitButton, int baselineIndex)
+  : m_summaries(sql::collectRunSummaries(databasePaths)), m_alignedTables(sql::alignEndUseTables(m_summaries)), m_quitButton(std::move(quitButton)) {
+
+  m_runLabels.reserve(m_summaries.size());
+  for (const auto& summary : m_summaries) {
+    // eplusout.sql files are typically in their own run directory, which is more telling than the file name
+    const auto parent = summary.databasePath.parent_path().filename();
+    m_runLabels.emplace_back(parent.empty() ? summary.databasePath.string() : parent.string());
+  }
+
+  m_baselineIndex = std::clamp(baselineIndex, 0, std::max(0, static_cast<int>(m_summaries.size()) - 1));
+  m_selectedIndex = std::min(m_baselineIndex + 1, std::max(0, static_cast<int>(m_summaries.size()) - 1));
+
+  m_baselineSelector = Radiobox(&m_runLabels, &m_baselineIndex);
+  m_runSelector = Radiobox(&m_runLabels, &m_selectedIndex);
+
+  Add(Container::Vertical({
+    m_quitButton,
+    Container::Horizontal({
+      m_baselineSelector,
+      m_runSelector,
+    }),
+  }));
+}
+
+Element ComparisonComponent::RenderNetSiteEnergy() const {
+  const auto& baseline = m_summaries[m_baselineIndex];
+
+  size_t size_label = 20;
+  for (const auto& label : m_runLabels) {
+    size_label = std::max(size_label, label.size());
+  }
+  const int size_value = 15;
+
+  auto header = hbox({
+    text("Run") | ftxui::size(WIDTH, EQUAL, size_label),
+    separator(),
+    hcenter(text("Net Site Energy [GJ]")) | ftxui::size(WIDTH, EQUAL, 2 * size_value),
+    separator(),
+    hcenter(text("Delta [GJ]")) | ftxui::size(WIDTH, EQUAL, size_value),
+    separator(),
+    hcenter(text("Delta [%]")) | ftxui::size(WIDTH, EQUAL, size_value),
+  });
+
+  Elements rowList;
+  for (size_t i = 0; i < m_summaries.size(); ++i) {
+    const auto& summary = m_summaries[i];
+    std::string value = summary.errorMessage.empty() ? "N/A" : summary.errorMessage;
+    std::string delta;
+    std::string deltaPercent;
+    Decorator delta_decorator = nothing;
+    if (summary.netSiteEnergy) {
+      value = fmt::format("{:.2f}", *summary.netSiteEnergy);
+      if (baseline.netSiteEnergy) {
+        const double diff = *summary.netSiteEnergy - *baseline.netSiteEnergy;
+        delta = fmt::format("{:+.2f}", diff);
+        if (*baseline.netSiteEnergy != 0.0) {
+          deltaPercent = fmt::format("{:+.1f}", 100.0 * diff / *baseline.netSiteEnergy);
+        }
+        if (diff > 0.0) {
+          delta_decorator = color(Color::Red);
+        } else if (diff < 0.0) {
+          delta_decorator = color(Color::Green);
+        }
+      }
+    }
+
+    Decorator line_decorator = nothing;
+    if (static_cast<int>(i) == m_baselineIndex) {
+      line_decorator = bold;
+    }
+    rowList.push_back(hbox({
+                        text(m_runLabels[i]) | ftxui::size(WIDTH, EQUAL, size_label),
+                        separator(),
+                        hcenter(text(value)) | ftxui::size(WIDTH, EQUAL, 2 * size_value),
+                        separator(),
+                        hcenter(text(delta)) | ftxui::size(WIDTH, EQUAL, size_value) | delta_decorator,
+                        separator(),
+                        hcenter(text(deltaPercent)) | ftxui::size(WIDTH, EQUAL, size_value) | delta_decorator,
+                      })
+                      | line_decorator);
+  }
+
+  return window(text("Net Site Energy"), vbox({
+                                           header,  //
+                                           separator(),
+                                           vbox(rowList) | vscroll_indicator | yframe,
+                                         }));
+}
+
+Element ComparisonComponent::Render() {
+  auto header = hbox({
+    text(fmt::format("Comparing {} runs", m_summaries.size())),
+    filler(),
+    m_quitButton->Render(),
+  });
+
+  if (m_summaries.empty()) {
+    return vbox({header, separator(), text("NOTHING TO COMPARE") | center});
+  }
+
+  const auto& selected = m_alignedTables[m_selectedIndex];
+  const auto& baseline = m_alignedTables[m_baselineIndex];
+
+  return  //
+    vbox({
+      header,
+      separator(),
+      hbox({
+        window(text("Baseline"), m_baselineSelector->Render() | vscroll_indicator | yframe) | notflex,
+        window(text("Run"), m_runSelector->Render() | vscroll_indicator | yframe) | notflex,
+        vbox({
+          RenderNetSiteEnergy(),
+          RenderEndUseByFuel(selected, &baseline,
+                             fmt::format("End Use by Fuel: {} vs {} (baseline)", m_runLabels[m_selectedIndex], m_runLabels[m_baselineIndex])),
+        }) | flex,
+      }),
+    });
+}
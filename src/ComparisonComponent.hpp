@@ -0,0 +1,38 @@
+#ifndef COMPARISON_COMPONENT_HPP
+#define COMPARISON_COMPONENT_HPP
+
+#include "sqlite/RunComparison.hpp"  // for RunSummary
+#include "sqlite/SQLiteReports.hpp"  // for EndUseTable
+
+#include <ftxui/component/component_base.hpp>  // for ComponentBase, Component
+#include <ftxui/dom/elements.hpp>              // for Element
+
+#include <filesystem>  // for path
+#include <string>      // for string
+#include <vector>      // for vector
+
+using namespace ftxui;
+
+/// Side by side comparison of the Net Site Energy and End Use by Fuel tables of several runs, with deltas against a chosen baseline
+class ComparisonComponent : public ComponentBase
+{
+ public:
+  ComparisonComponent(const std::vector<std::filesystem::path>& databasePaths, Component quitButton, int baselineIndex = 0);
+  Element Render() override;
+
+ private:
+  Element RenderNetSiteEnergy() const;
+
+  std::vector<sql::RunSummary> m_summaries;
+  std::vector<sql::EndUseTable> m_alignedTables;
+  std::vector<std::string> m_runLabels;
+
+  int m_baselineIndex = 0;
+  int m_selectedIndex = 0;
+
+  Component m_baselineSelector;
+  Component m_runSelector;
+  Component m_quitButton;
+};
+
+#endif  // COMPARISON_COMPONENT_HPP
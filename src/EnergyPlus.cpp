@@ -1,57 +1,257 @@
 #include "EnergyPlus.hpp"
 
-#include "ErrorMessage.hpp"            // for ErrorMessage
-#include "utilities/ASCIIStrings.hpp"  // for ascii_to_lower_copy
+#include "CallbackFilter.hpp"              // for CallbackFilter
+#include "ErrorMessage.hpp"                // for ErrorMessage
+#include "EventLog.hpp"                    // for EventLogWriter, EventLogReader, RunEvent
+#include "PhaseProfiler.hpp"               // for PhaseProfiler
+#include "RuntimeMetrics.hpp"              // for RuntimeMetrics
+#include "TerminationPolicy.hpp"           // for TerminationGuard
+#include "VariableSampler.hpp"             // for VariableSampler
+#include "controllers/ControllerHost.hpp"  // for ControllerHost
+#include "utilities/ASCIIStrings.hpp"      // for ascii_to_lower_copy
+#include "utilities/Metrics.hpp"           // for ScopedTimer
+#include "utilities/Trace.hpp"             // for EPCLI_TRACE_SCOPE, EPCLI_TRACE_COUNTER, EPCLI_TRACE_THREAD_NAME
 
 #include <EnergyPlus/api/TypeDefs.h>  // for Error
 #include <EnergyPlus/api/func.h>      // for registerErrorCallback
-#include <EnergyPlus/api/runtime.h>   // for energyplus, registerStdOut/ProgressCallback, setConsoleOutputState, setEnergyPlusRootDirectory
+#include <EnergyPlus/api/runtime.h>   // for energyplus, register*Callback, setConsoleOutputState, setEnergyPlusRootDirectory, stopSimulation
 #include <EnergyPlus/api/state.h>     // for stateDelete, stateNew, EnergyPlusState
 
 #include <ftxui/component/event.hpp>               // for Event, Event::Custom
 #include <ftxui/component/screen_interactive.hpp>  // for ScreenInteractive
 
+#include <fmt/format.h>  // for format
+
 #include <algorithm>    // for find
 #include <atomic>       // for atomic
 #include <array>        // for array
-#include <memory>       // for unique_ptr
+#include <chrono>       // for steady_clock, duration
+#include <memory>       // for unique_ptr, make_unique
+#include <stdexcept>    // for runtime_error
 #include <string_view>  // for string_view
+#include <thread>       // for sleep_until
+#include <utility>      // for move
 
 namespace epcli {
 
+namespace {
+  std::chrono::steady_clock::time_point beginRunMetrics(RuntimeMetrics* metrics) {
+    if (metrics != nullptr) {
+      metrics->runsStarted.inc();
+      metrics->activeRuns.add(1);
+    }
+    return std::chrono::steady_clock::now();
+  }
+
+  void endRunMetrics(RuntimeMetrics* metrics, bool success, std::chrono::steady_clock::time_point runStart) {
+    if (metrics != nullptr) {
+      (success ? metrics->runsCompleted : metrics->runsFailed).inc();
+      metrics->runDuration.observe(std::chrono::duration<double>(std::chrono::steady_clock::now() - runStart).count());
+      metrics->activeRuns.add(-1);
+      metrics->runsFinished.fetch_add(1, std::memory_order_release);
+    }
+  }
+
+  // Whether the filter lets a message through, counting it as suppressed otherwise
+  bool admitted(RuntimeMetrics* metrics, CallbackFilter::Verdict verdict) {
+    if (verdict == CallbackFilter::Verdict::Keep) {
+      return true;
+    }
+    if (metrics != nullptr) {
+      if (verdict == CallbackFilter::Verdict::BelowLevel) {
+        metrics->suppressedBelowLevel.inc();
+      } else if (verdict == CallbackFilter::Verdict::RateLimited) {
+        metrics->suppressedRateLimited.inc();
+      } else {
+        metrics->suppressedSampledOut.inc();
+      }
+    }
+    return false;
+  }
+
+  bool admitStdout(CallbackFilter* filter, RuntimeMetrics* metrics, const std::string& message) {
+    return filter == nullptr || admitted(metrics, filter->stdoutLine(message));
+  }
+
+  bool admitError(CallbackFilter* filter, RuntimeMetrics* metrics, EnergyPlus::Error level, const std::string& message) {
+    return filter == nullptr || admitted(metrics, filter->error(level, message));
+  }
+
+  // At the end of a run, what the filter dropped
+  // Also into the recording of a live run, so that its replay shows why messages are missing
+  void forwardFilterSummary(CallbackFilter* filter, ftxui::Sender<std::string>& senderRunOutput, RuntimeMetrics* metrics,
+                            EventLogWriter* recorder = nullptr) {
+    if (filter != nullptr) {
+      if (auto summary = filter->summary(); !summary.empty()) {
+        if (recorder != nullptr) {
+          recorder->stdoutLine(summary);
+        }
+        forwardRunOutput(senderRunOutput, metrics, summary);
+      }
+    }
+  }
+
+  // Sweeps run without a screen to wake up
+  void requestRedraw(ftxui::ScreenInteractive* screen) {
+    if (screen != nullptr) {
+      screen->PostEvent(ftxui::Event::Custom);
+    }
+  }
+}  // namespace
+
+void forwardRunOutput(ftxui::Sender<std::string>& senderRunOutput, RuntimeMetrics* metrics, const std::string& message) {
+  if (metrics != nullptr) {
+    metrics->stdoutSent.inc();
+  }
+  senderRunOutput->Send(message);
+}
+
 void runEnergyPlus(int argc, const char* argv[],  // NOLINT(modernize-avoid-c-arrays)
                    ftxui::Sender<std::string>* senderRunOutput, ftxui::Sender<ErrorMessage>* senderErrorOutput, std::atomic<int>* progress,
-                   ftxui::ScreenInteractive* screen) {
+                   ftxui::ScreenInteractive* screen, const RunOptions& options) {
+  EPCLI_TRACE_THREAD_NAME("EnergyPlus");
+  EPCLI_TRACE_SCOPE("runEnergyPlus");
+
+  RuntimeMetrics* metrics = options.metrics;
+  const auto runStart = beginRunMetrics(metrics);
+
+  CallbackFilter* filter = options.filter;
+  if (filter != nullptr) {
+    filter->reset();
+  }
+  TerminationGuard* guard = options.guard;
+
+  std::unique_ptr<EventLogWriter> recorder;
+  if (!options.recordPath.empty()) {
+    try {
+      recorder = std::make_unique<EventLogWriter>(options.recordPath);
+    } catch (const std::runtime_error& e) {
+      forwardRunOutput(*senderRunOutput, metrics, e.what());
+    }
+  }
 
   EnergyPlusState state = stateNew();
   setEnergyPlusRootDirectory(state, ENERGYPLUS_ROOT);
 
   // callbackBeginNewEnvironment(state, BeginNewEnvironmentHandler);
-  registerProgressCallback(state, [&progress, &screen](int const t_progress) {
+  registerProgressCallback(state, [&progress, &screen, metrics, guard, state, recorder = recorder.get()](int const t_progress) {
+    const utilities::metrics::ScopedTimer timer(metrics != nullptr ? &metrics->progressCallbackDuration : nullptr);
+    if (recorder != nullptr) {
+      recorder->progress(t_progress);
+    }
+    if (guard != nullptr) {
+      guard->onProgress(state);
+    }
     // The |progress| variable belong to the main thread. `screen.Post(task)`
     // will execute the update on the thread where |screen| lives (e.g. the
     // main thread). Using `screen.Post(task)` is threadsafe.
     *progress = t_progress;
+    EPCLI_TRACE_COUNTER("progress", t_progress);
 
     // After updating the state, request a new frame to be drawn. This is done
     // by simulating a new "custom" event to be handled.
-    screen->PostEvent(ftxui::Event::Custom);
+    requestRedraw(screen);
   });
 
   setConsoleOutputState(state, 0);
-  registerStdOutCallback(state, [&senderRunOutput, &screen](const std::string& message) {
-    (*senderRunOutput)->Send(message);
-    screen->PostEvent(ftxui::Event::Custom);
+  registerStdOutCallback(state, [&senderRunOutput, &screen, metrics, filter, recorder = recorder.get()](const std::string& message) {
+    EPCLI_TRACE_SCOPE("stdout callback");
+    const utilities::metrics::ScopedTimer timer(metrics != nullptr ? &metrics->stdoutCallbackDuration : nullptr);
+    // The recording is of everything EnergyPlus sent, so that a replay can apply other filters
+    if (recorder != nullptr) {
+      recorder->stdoutLine(message);
+    }
+    if (!admitStdout(filter, metrics, message)) {
+      return;
+    }
+    forwardRunOutput(*senderRunOutput, metrics, message);
+    requestRedraw(screen);
   });
 
-  registerErrorCallback(state, [&senderErrorOutput, &screen](EnergyPlus::Error error, const std::string& message) {
+  registerErrorCallback(state, [&senderErrorOutput, &screen, metrics, filter, guard, state,
+                                recorder = recorder.get()](EnergyPlus::Error error, const std::string& message) {
     // fmt::print("[{}%] {}\n", progress, msg);
+    EPCLI_TRACE_SCOPE("error callback");
+    const utilities::metrics::ScopedTimer timer(metrics != nullptr ? &metrics->errorCallbackDuration : nullptr);
+    if (recorder != nullptr) {
+      recorder->error(error, message);
+    }
+    // Policies see every error, filtered or not
+    if (guard != nullptr) {
+      guard->onError(state, error, message);
+    }
+    if (!admitError(filter, metrics, error, message)) {
+      return;
+    }
+    if (metrics != nullptr) {
+      metrics->errorsSent.inc();
+    }
 
     (*senderErrorOutput)->Send(ErrorMessage{error, message});
-    screen->PostEvent(ftxui::Event::Custom);
+    requestRedraw(screen);
   });
 
-  const int success = energyplus(state, argc, argv);
+  if (options.sampler != nullptr) {
+    options.sampler->registerCallbacks(state);
+  }
+  for (auto* controller : options.controllers) {
+    controller->registerCallbacks(state);
+  }
+  if (guard != nullptr) {
+    guard->registerCallbacks(state);
+  }
+  if (options.cancel != nullptr) {
+    callbackEndOfZoneTimeStepAfterZoneReporting(state, [cancel = options.cancel](EnergyPlusState s) {
+      if (cancel->load(std::memory_order_relaxed)) {
+        stopSimulation(s);
+      }
+    });
+  }
+  // Last, since it starts the clock
+  if (options.profiler != nullptr) {
+    options.profiler->registerCallbacks(state);
+  }
+
+  int success = 0;
+  {
+    EPCLI_TRACE_SCOPE("energyplus");
+    success = energyplus(state, argc, argv);
+  }
+
+  if (options.profiler != nullptr) {
+    options.profiler->endRun(success == 0);
+  }
+
+  for (auto* controller : options.controllers) {
+    controller->endRun();
+    const auto summary = controller->summary();
+    if (recorder != nullptr) {
+      recorder->stdoutLine(summary);
+    }
+    forwardRunOutput(*senderRunOutput, metrics, summary);
+  }
+  forwardFilterSummary(filter, *senderRunOutput, metrics, recorder.get());
+  if (guard != nullptr && guard->triggered()) {
+    if (metrics != nullptr) {
+      metrics->runsStopped.inc();
+    }
+    const auto summary = guard->summary();
+    if (recorder != nullptr) {
+      recorder->stdoutLine(summary);
+    }
+    forwardRunOutput(*senderRunOutput, metrics, summary);
+  }
+  if (options.cancel != nullptr && options.cancel->load(std::memory_order_relaxed)) {
+    if (recorder != nullptr) {
+      recorder->stdoutLine("Run cancelled");
+    }
+    forwardRunOutput(*senderRunOutput, metrics, "Run cancelled");
+  }
+  if (recorder != nullptr && !recorder->end(success)) {
+    forwardRunOutput(*senderRunOutput, metrics,
+                     fmt::format("Writing the recording '{}' failed (disk full?), it is incomplete", options.recordPath.string()));
+  }
+
   if (success == 0) {
     *progress = 100;
   } else {
@@ -59,7 +259,73 @@ void runEnergyPlus(int argc, const char* argv[],  // NOLINT(modernize-avoid-c-ar
   }
   stateDelete(state);
 
-  screen->PostEvent(ftxui::Event::Custom);
+  endRunMetrics(metrics, success == 0, runStart);
+
+  requestRedraw(screen);
+}
+
+void replayRun(const std::filesystem::path& logPath, double speed, ftxui::Sender<std::string>* senderRunOutput,
+               ftxui::Sender<ErrorMessage>* senderErrorOutput, std::atomic<int>* progress, ftxui::ScreenInteractive* screen,
+               const RunOptions& options) {
+  EPCLI_TRACE_THREAD_NAME("Replay");
+  EPCLI_TRACE_SCOPE("replayRun");
+
+  RuntimeMetrics* metrics = options.metrics;
+  const auto runStart = beginRunMetrics(metrics);
+
+  CallbackFilter* filter = options.filter;
+  if (filter != nullptr) {
+    filter->reset();
+  }
+
+  // A log without its End event is a failed run
+  int returnCode = 1;
+  try {
+    EventLogReader reader(logPath);
+    RunEvent event;
+    while (reader.next(event)) {
+      if (speed > 0.0) {
+        std::this_thread::sleep_until(runStart + std::chrono::duration_cast<std::chrono::steady_clock::duration>(event.time / speed));
+      }
+      switch (event.kind) {
+        case RunEvent::Kind::Stdout:
+          if (!admitStdout(filter, metrics, event.text)) {
+            continue;
+          }
+          forwardRunOutput(*senderRunOutput, metrics, event.text);
+          break;
+        case RunEvent::Kind::Error:
+          if (!admitError(filter, metrics, event.level, event.text)) {
+            continue;
+          }
+          if (metrics != nullptr) {
+            metrics->errorsSent.inc();
+          }
+          (*senderErrorOutput)->Send(ErrorMessage{event.level, std::move(event.text)});
+          break;
+        case RunEvent::Kind::Progress:
+          *progress = event.value;
+          EPCLI_TRACE_COUNTER("progress", event.value);
+          break;
+        case RunEvent::Kind::End:
+          returnCode = event.value;
+          break;
+      }
+      requestRedraw(screen);
+    }
+    if (reader.truncated()) {
+      forwardRunOutput(*senderRunOutput, metrics, fmt::format("The event log ends {:.3f}s into the run, with an incomplete event",
+                                                              std::chrono::duration<double>(event.time).count()));
+    }
+  } catch (const std::runtime_error& e) {
+    forwardRunOutput(*senderRunOutput, metrics, e.what());
+  }
+  forwardFilterSummary(filter, *senderRunOutput, metrics);
+
+  *progress = returnCode == 0 ? 100 : -1;
+  endRunMetrics(metrics, returnCode == 0, runStart);
+
+  requestRedraw(screen);
 }
 
 static constexpr std::array<std::string_view, 4> acceptedExtensions{".epjson", ".json", ".idf", ".imf"};
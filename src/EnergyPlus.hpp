@@ -6,6 +6,7 @@
 #include <atomic>      // for atomic
 #include <filesystem>  // for path
 #include <string>      // for string
+#include <vector>      // for vector
 
 struct ErrorMessage;
 
@@ -14,8 +15,43 @@ class ScreenInteractive;
 }
 
 namespace epcli {
+class CallbackFilter;
+class ControllerHost;
+class PhaseProfiler;
+class TerminationGuard;
+class VariableSampler;
+struct RuntimeMetrics;
+
+/// Optional hooks registered on each new EnergyPlus state, all owned by the caller
+struct RunOptions
+{
+  VariableSampler* sampler = nullptr;
+  PhaseProfiler* profiler = nullptr;
+  RuntimeMetrics* metrics = nullptr;
+  /// Drops messages in the callbacks, before they are queued. Reset at the start of each run
+  CallbackFilter* filter = nullptr;
+  /// Stops the run once one of its policies triggers
+  TerminationGuard* guard = nullptr;
+  std::vector<ControllerHost*> controllers;
+  /// --record: where to write the EventLog of each run, empty to not record
+  std::filesystem::path recordPath;
+  /// Set from any thread to stop the run at its next timestep (--watch, once the input changed). Never reset by the run
+  const std::atomic<bool>* cancel = nullptr;
+};
+
+/// What the stdout callback does with each line besides waking up the screen: counts it, and sends it to MainComponent.
+/// Split out so that epcli_bench measures the same path
+void forwardRunOutput(ftxui::Sender<std::string>& senderRunOutput, RuntimeMetrics* metrics, const std::string& message);
+
+/// screen is woken up after each message, it may be null to run headless (--sweep)
 void runEnergyPlus(int argc, const char* argv[], ftxui::Sender<std::string>* senderRunOutput, ftxui::Sender<ErrorMessage>* senderErrorOutput,
-                   std::atomic<int>* progress, ftxui::ScreenInteractive* screen);
+                   std::atomic<int>* progress, ftxui::ScreenInteractive* screen, const RunOptions& options = {});
+
+/// --replay: feeds the events of a log written by --record to the receivers, as runEnergyPlus would, instead of running EnergyPlus.
+/// speed multiplies the recorded pace, 0 replays as fast as possible. Only the metrics and filter of options are used
+void replayRun(const std::filesystem::path& logPath, double speed, ftxui::Sender<std::string>* senderRunOutput,
+               ftxui::Sender<ErrorMessage>* senderErrorOutput, std::atomic<int>* progress, ftxui::ScreenInteractive* screen,
+               const RunOptions& options = {});
 
 bool validateFileType(const std::filesystem::path& filePath);
 
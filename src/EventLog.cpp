@@ -0,0 +1,178 @@
+#include "EventLog.hpp"
+
+#include <array>        // for array
+#include <cstddef>      // for size_t
+#include <cstdint>      // for int64_t
+#include <ios>          // for ios, streamsize
+#include <stdexcept>    // for runtime_error
+#include <string_view>  // for string_view
+
+namespace epcli {
+
+namespace {
+  // Bumped on any change to the format
+  constexpr std::string_view magic = "EPCLIEV1";
+
+  std::uint64_t zigzag(int value) {
+    return (static_cast<std::uint64_t>(value) << 1U) ^ static_cast<std::uint64_t>(static_cast<std::int64_t>(value) >> 63);
+  }
+
+  int unzigzag(std::uint64_t value) {
+    return static_cast<int>(static_cast<std::int64_t>(value >> 1U) ^ -static_cast<std::int64_t>(value & 1U));
+  }
+}  // namespace
+
+EventLogWriter::EventLogWriter(const std::filesystem::path& path) : m_file(path, std::ios::binary | std::ios::trunc) {
+  if (!m_file) {
+    throw std::runtime_error("Cannot open '" + path.string() + "' to record the run");
+  }
+  m_file.write(magic.data(), static_cast<std::streamsize>(magic.size()));
+}
+
+void EventLogWriter::stdoutLine(const std::string& message) {
+  beginEvent(RunEvent::Kind::Stdout);
+  putText(message);
+}
+
+void EventLogWriter::error(EnergyPlus::Error level, const std::string& message) {
+  beginEvent(RunEvent::Kind::Error);
+  m_file.put(static_cast<char>(level));
+  putText(message);
+}
+
+void EventLogWriter::progress(int percent) {
+  beginEvent(RunEvent::Kind::Progress);
+  putSigned(percent);
+}
+
+bool EventLogWriter::end(int returnCode) {
+  beginEvent(RunEvent::Kind::End);
+  putSigned(returnCode);
+  m_file.flush();
+  // Once a write fails the stream ignores all the next ones, so checking once at the end covers the whole run
+  return m_file.good();
+}
+
+void EventLogWriter::beginEvent(RunEvent::Kind kind) {
+  const auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start);
+  m_file.put(static_cast<char>(kind));
+  putVarint(static_cast<std::uint64_t>((now - m_last).count()));
+  m_last = now;
+}
+
+void EventLogWriter::putVarint(std::uint64_t value) {
+  std::array<char, 10> buffer{};
+  std::size_t size = 0;
+  while (value >= 0x80) {
+    buffer[size++] = static_cast<char>((value & 0x7FU) | 0x80U);
+    value >>= 7U;
+  }
+  buffer[size++] = static_cast<char>(value);
+  m_file.write(buffer.data(), static_cast<std::streamsize>(size));
+}
+
+void EventLogWriter::putSigned(int value) {
+  putVarint(zigzag(value));
+}
+
+void EventLogWriter::putText(const std::string& text) {
+  putVarint(text.size());
+  m_file.write(text.data(), static_cast<std::streamsize>(text.size()));
+}
+
+EventLogReader::EventLogReader(const std::filesystem::path& path) : m_file(path, std::ios::binary) {
+  if (!m_file) {
+    throw std::runtime_error("Cannot open the event log at '" + path.string() + "'");
+  }
+  std::array<char, magic.size()> header{};
+  m_file.read(header.data(), static_cast<std::streamsize>(header.size()));
+  if (!m_file || std::string_view(header.data(), header.size()) != magic) {
+    throw std::runtime_error("'" + path.string() + "' is not an epcli event log, or was recorded by another version");
+  }
+}
+
+bool EventLogReader::next(RunEvent& event) {
+  std::uint8_t kind = 0;
+  if (!getByte(kind)) {
+    // A clean end of file
+    return false;
+  }
+  std::uint64_t delta = 0;
+  bool complete = getVarint(delta);
+  if (complete) {
+    event.kind = static_cast<RunEvent::Kind>(kind);
+    m_time += std::chrono::nanoseconds(static_cast<std::int64_t>(delta));
+    event.time = m_time;
+    switch (event.kind) {
+      case RunEvent::Kind::Stdout:
+        complete = getText(event.text);
+        break;
+      case RunEvent::Kind::Error: {
+        std::uint8_t level = 0;
+        complete = getByte(level) && level <= static_cast<std::uint8_t>(EnergyPlus::Error::Continue) && getText(event.text);
+        event.level = static_cast<EnergyPlus::Error>(level);
+        break;
+      }
+      case RunEvent::Kind::Progress:
+      case RunEvent::Kind::End:
+        complete = getSigned(event.value);
+        break;
+      default:
+        complete = false;
+        break;
+    }
+  }
+  if (!complete) {
+    m_truncated = true;
+  }
+  return complete;
+}
+
+bool EventLogReader::truncated() const {
+  return m_truncated;
+}
+
+bool EventLogReader::getByte(std::uint8_t& byte) {
+  const auto c = m_file.rdbuf()->sbumpc();
+  if (c == std::char_traits<char>::eof()) {
+    return false;
+  }
+  byte = static_cast<std::uint8_t>(c);
+  return true;
+}
+
+bool EventLogReader::getVarint(std::uint64_t& value) {
+  value = 0;
+  for (unsigned shift = 0; shift < 64; shift += 7) {
+    std::uint8_t byte = 0;
+    if (!getByte(byte)) {
+      return false;
+    }
+    value |= static_cast<std::uint64_t>(byte & 0x7FU) << shift;
+    if ((byte & 0x80U) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool EventLogReader::getSigned(int& value) {
+  std::uint64_t encoded = 0;
+  if (!getVarint(encoded)) {
+    return false;
+  }
+  value = unzigzag(encoded);
+  return true;
+}
+
+bool EventLogReader::getText(std::string& text) {
+  std::uint64_t size = 0;
+  // A garbled length must not allocate gigabytes
+  if (!getVarint(size) || size > (std::uint64_t{1} << 30U)) {
+    return false;
+  }
+  text.resize(size);
+  return m_file.rdbuf()->sgetn(text.data(), static_cast<std::streamsize>(size)) == static_cast<std::streamsize>(size);
+}
+
+}  // namespace epcli
@@ -0,0 +1,81 @@
+#ifndef EVENTLOG_HPP
+#define EVENTLOG_HPP
+
+#include <EnergyPlus/api/TypeDefs.h>  // for Error
+
+#include <chrono>      // for steady_clock, nanoseconds
+#include <cstdint>     // for uint8_t, uint64_t
+#include <filesystem>  // for path
+#include <fstream>     // for ifstream, ofstream
+#include <string>      // for string
+
+namespace epcli {
+
+/// What the EnergyPlus callbacks of a run delivered, in order, with the time since the start of the run
+struct RunEvent
+{
+  enum class Kind : std::uint8_t
+  {
+    Stdout = 1,
+    Error = 2,
+    Progress = 3,
+    End = 4,  // value is what energyplus() returned
+  };
+  Kind kind = Kind::Stdout;
+  std::chrono::nanoseconds time{0};
+  EnergyPlus::Error level = EnergyPlus::Error::Info;  // Kind::Error only
+  int value = 0;                                      // Kind::Progress and Kind::End
+  std::string text;                                   // Kind::Stdout and Kind::Error
+};
+
+/// Binary log of the RunEvents of a run, for --record and --replay. After an 8 bytes magic, each event is its kind byte, the nanoseconds
+/// since the previous event as a LEB128 varint, then for Stdout: length varint and bytes, Error: level byte, length varint and bytes,
+/// Progress and End: zigzag varint. About 3 bytes of overhead per message
+class EventLogWriter
+{
+ public:
+  /// Truncates the file. Throws std::runtime_error if it cannot be opened
+  explicit EventLogWriter(const std::filesystem::path& path);
+
+  /// Not thread-safe: all the callbacks of a run come from the EnergyPlus thread
+  void stdoutLine(const std::string& message);
+  void error(EnergyPlus::Error level, const std::string& message);
+  void progress(int percent);
+  /// Flushes, the log is complete. False if any write failed (disk full...): the log then stops somewhere before its End event
+  [[nodiscard]] bool end(int returnCode);
+
+ private:
+  void beginEvent(RunEvent::Kind kind);
+  void putVarint(std::uint64_t value);
+  void putSigned(int value);
+  void putText(const std::string& text);
+
+  std::ofstream m_file;
+  std::chrono::steady_clock::time_point m_start = std::chrono::steady_clock::now();
+  std::chrono::nanoseconds m_last{0};
+};
+
+class EventLogReader
+{
+ public:
+  /// Throws std::runtime_error if the file cannot be opened, or isn't an event log
+  explicit EventLogReader(const std::filesystem::path& path);
+
+  /// False at the end of the log. A log cut short (epcli killed while recording) ends at its last complete event, see truncated()
+  bool next(RunEvent& event);
+  [[nodiscard]] bool truncated() const;
+
+ private:
+  bool getByte(std::uint8_t& byte);
+  bool getVarint(std::uint64_t& value);
+  bool getSigned(int& value);
+  bool getText(std::string& text);
+
+  std::ifstream m_file;
+  std::chrono::nanoseconds m_time{0};
+  bool m_truncated = false;
+};
+
+}  // namespace epcli
+
+#endif  // EVENTLOG_HPP
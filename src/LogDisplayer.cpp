@@ -1,5 +1,6 @@
 #include "LogDisplayer.hpp"
-#include "ErrorMessage.hpp"  // for ErrorMessage
+#include "ErrorMessage.hpp"       // for ErrorMessage
+#include "utilities/Trace.hpp"  // for EPCLI_TRACE_SCOPE
 
 #include <EnergyPlus/api/TypeDefs.h>  // for Error, Error::Continue, Error::Fatal, Error::Info
 
@@ -29,6 +30,7 @@ std::map<EnergyPlus::Error, LogStyle> log_style = {
 }  // namespace
 
 Element LogDisplayer::RenderLines(std::vector<ErrorMessage*> lines) {
+  EPCLI_TRACE_SCOPE("LogDisplayer::RenderLines(errors)");
   m_size = lines.size();
 
   Elements elementList;
@@ -90,6 +92,7 @@ Element LogDisplayer::RenderLines(std::vector<ErrorMessage*> lines) {
 }
 
 Element LogDisplayer::RenderLines(const std::vector<std::string>& lines) {
+  EPCLI_TRACE_SCOPE("LogDisplayer::RenderLines(stdout)");
   m_size = lines.size();
 
   Elements elementList;
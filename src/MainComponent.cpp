@@ -1,7 +1,11 @@
 #include "MainComponent.hpp"
 
+#include "EnergyPlus.hpp"                 // for RunOptions
+#include "RuntimeMetrics.hpp"             // for RuntimeMetrics
 #include "sqlite/SQLiteReports.hpp"       // for SQLiteComponent
 #include "utilities/ASCIIStrings.hpp"     // for ascii_trim
+#include "utilities/Eta.hpp"              // for remainingSeconds, formatDuration
+#include "utilities/Trace.hpp"            // for EPCLI_TRACE_SCOPE
                                           //
 #include <EnergyPlus/api/TypeDefs.h>      // for Error
                                           //
@@ -16,7 +20,7 @@
 #include <fmt/std.h>                      // for formatting std::filesystem::path // IWYU pragma: keep
                                           //
 #include <algorithm>                      // for max, min
-#include <chrono>                         // for filesystem
+#include <chrono>                         // for steady_clock, duration_cast
 #include <cstdlib>                        // for system
 #include <filesystem>                     // path, operator/, is_regular_file, weakly_canonical
 #include <fstream>                        // for ifstream
@@ -30,13 +34,20 @@ namespace fs = std::filesystem;
 static constexpr auto programName = "EnergyPlus-Cpp-Demo";
 
 MainComponent::MainComponent(Receiver<std::string> receiverRunOutput, Receiver<ErrorMessage> receiverErrorOutput, Component runButton,
-                             Component quitButton, std::atomic<int>* progress, std::filesystem::path outputDirectory)
+                             Component quitButton, std::atomic<int>* progress, std::filesystem::path outputDirectory,
+                             std::filesystem::path weatherFile, std::function<void()> requestRedraw, const epcli::RunOptions& runOptions)
   : m_receiverRunOutput(std::move(receiverRunOutput)),
     m_receiverErrorOutput(std::move(receiverErrorOutput)),
     m_runButton(std::move(runButton)),
     m_quitButton(std::move(quitButton)),
     m_progress(progress),
-    m_outputDirectory(std::move(outputDirectory)) {
+    m_outputDirectory(std::move(outputDirectory)),
+    m_output_browser(Make<OutputBrowserComponent>(std::move(requestRedraw))),
+    m_time_series(Make<TimeSeriesComponent>(runOptions.sampler)),
+    m_profile_component(Make<ProfileComponent>(runOptions.profiler)),
+    m_weather_component(Make<WeatherComponent>(std::move(weatherFile))),
+    m_metrics(runOptions.metrics),
+    m_perf_hud(runOptions.metrics) {
 
   m_openHTMLButton = Button(
     &m_outputHTMLButtonText,
@@ -77,8 +88,21 @@ MainComponent::MainComponent(Receiver<std::string> receiverRunOutput, Receiver<E
             container_level_filter_,
             m_error_displayer,
           }),
-          // Sqlite reports
-          m_sqlite_component,
+          // Sqlite reports, or the ESO when there is no SQL output
+          Container::Tab(
+            {
+              m_sqlite_component,
+              m_output_browser,
+            },
+            &m_sql_tab_source),
+          // All tabular reports
+          m_tabular_browser,
+          // Variables sampled during the run
+          m_time_series,
+          // Where the run time goes
+          m_profile_component,
+          // The weather file of the run
+          m_weather_component,
           // About
           info_component_,
         },
@@ -88,14 +112,37 @@ MainComponent::MainComponent(Receiver<std::string> receiverRunOutput, Receiver<E
 
 void MainComponent::clear_state() {
   m_stdout_lines.clear();
+  m_stdout_bytes = 0;
   m_errors.clear();
+  m_error_bytes = 0;
   *m_progress = 0;
   m_numWarnings = 0;
   m_numSeveres = 0;
   m_hasAlreadyRun = false;
+  m_runClockStarted = false;
+  m_sqlite_component->reset();
+  m_output_browser->reset();
+  m_tabular_browser->reset();
+  m_weather_component->reset();
+}
+
+void MainComponent::startRunClock(std::optional<double> predictedSeconds) {
+  m_runClockStarted = true;
+  m_runStart = std::chrono::steady_clock::now();
+  m_predictedSeconds = predictedSeconds;
+}
+
+std::optional<double> MainComponent::remainingSeconds() const {
+  const int progress = *m_progress;
+  if (!m_runClockStarted || progress < 0 || progress >= 100) {
+    return std::nullopt;
+  }
+  const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_runStart).count();
+  return utilities::remainingSeconds(m_predictedSeconds, elapsed, progress / 100.0);
 }
 
 void MainComponent::reload_results() {
+  EPCLI_TRACE_SCOPE("MainComponent::reload_results");
   clear_state();
 
   m_stdout_lines.emplace_back("=========================================");
@@ -171,6 +218,13 @@ void MainComponent::reload_results() {
     RegisterLogLevel(errorType);
     m_errors.emplace_back(errorType, std::move(message));
   }
+
+  for (const auto& stdoutLine : m_stdout_lines) {
+    m_stdout_bytes += stdoutLine.size();
+  }
+  for (const auto& error : m_errors) {
+    m_error_bytes += error.message.size();
+  }
 }
 
 bool MainComponent::hasAlreadyRun() const {
@@ -178,9 +232,17 @@ bool MainComponent::hasAlreadyRun() const {
 }
 
 bool MainComponent::OnEvent(Event event) {
+  EPCLI_TRACE_SCOPE("MainComponent::OnEvent");
+  // Loaded before draining the receivers: once a run is counted as finished, all of its messages are already queued
+  const std::uint64_t runsFinished = (m_metrics != nullptr) ? m_metrics->runsFinished.load(std::memory_order_acquire) : 0;
+
   while (m_receiverRunOutput->HasPending()) {
     std::string line;
     m_receiverRunOutput->Receive(&line);
+    if (m_metrics != nullptr) {
+      m_metrics->stdoutReceived.inc();
+    }
+    m_stdout_bytes += line.size();
     m_stdout_lines.emplace_back(std::move(line));
     m_stdout_displayer->setSelected(m_stdout_lines.size());
     m_stdout_displayer->TakeFocus();
@@ -189,9 +251,26 @@ bool MainComponent::OnEvent(Event event) {
   while (m_receiverErrorOutput->HasPending()) {
     ErrorMessage errorMsg;
     m_receiverErrorOutput->Receive(&errorMsg);
+    if (m_metrics != nullptr) {
+      m_metrics->errorsReceived.inc();
+    }
     ProcessErrorMessage(std::move(errorMsg));
   }
-  return ComponentBase::OnEvent(event);
+
+  // Before the children handle the event, since the run button clears the counters for the next run
+  if (runsFinished != m_runs_recorded) {
+    m_metrics->runWarnings.observe(static_cast<double>(m_numWarnings));
+    m_metrics->runSeveres.observe(static_cast<double>(m_numSeveres));
+    m_runs_recorded = runsFinished;
+  }
+
+  const bool handled = ComponentBase::OnEvent(event);
+  // Only when no child used it, so typing a 'P' in an input still works
+  if (!handled && event == Event::Character('P')) {
+    m_show_perf_hud = !m_show_perf_hud;
+    return true;
+  }
+  return handled;
 }
 
 void MainComponent::ProcessErrorMessage(ErrorMessage&& errorMsg) {
@@ -199,9 +278,10 @@ void MainComponent::ProcessErrorMessage(ErrorMessage&& errorMsg) {
     ++m_numWarnings;
   }
   if (errorMsg.error == EnergyPlus::Error::Severe) {
-    ++m_numWarnings;
+    ++m_numSeveres;
   }
   RegisterLogLevel(errorMsg.error);
+  m_error_bytes += errorMsg.message.size();
   m_errors.emplace_back(errorMsg);
 }
 
@@ -215,6 +295,27 @@ void MainComponent::RegisterLogLevel(EnergyPlus::Error log_level) {
 }
 
 Element MainComponent::Render() {
+  EPCLI_TRACE_SCOPE("MainComponent::Render");
+  const auto start = std::chrono::steady_clock::now();
+
+  Element document = RenderTab();
+
+  if (m_show_perf_hud) {
+    m_perf_hud.setStoredCounts(m_stdout_lines.size(), m_stdout_bytes, m_errors.size(), m_error_bytes);
+    document = dbox({
+      document,
+      vbox({
+        hbox({filler(), m_perf_hud.Render()}),
+        filler(),
+      }),
+    });
+  }
+
+  m_perf_hud.recordFrame(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start));
+  return document;
+}
+
+Element MainComponent::RenderTab() {
   static int i = 0;
 
   const int current_line = (std::min(tab_selected_, 1) == 0 ? m_stdout_displayer : m_error_displayer)->selected();
@@ -260,6 +361,7 @@ Element MainComponent::Render() {
       }
     };
 
+    const auto remaining = remainingSeconds();
     auto runGaugeRow = ftxui::hbox({
       text("Status"),
       separator(),
@@ -268,9 +370,10 @@ Element MainComponent::Render() {
       ftxui::gauge(*m_progress / 100.f) | ftxui::flex,
       ftxui::text(fmt::format("{} %", *m_progress)),
       separator(),
+      remaining ? hbox({text(fmt::format("{} left", utilities::formatDuration(*remaining))), separator()}) : text(""),
       text(fmt::format("{} warnings", m_numWarnings)) | ((m_numWarnings > 0) ? color(Color::Yellow) : color(Color::GrayLight)),
       separator(),
-      text(fmt::format("{} severes", m_numSeveres)) | ((m_numWarnings > 0) ? color(Color::Red) : color(Color::GrayLight)),
+      text(fmt::format("{} severes", m_numSeveres)) | ((m_numSeveres > 0) ? color(Color::Red) : color(Color::GrayLight)),
 
     });
 
@@ -362,11 +465,29 @@ Element MainComponent::Render() {
     });
 
     Element content = text("NOTHING TO SHOW");
+    m_sql_tab_source = 0;
 
     if (*m_progress == 100) {
-      fs::path databasePath = m_outputDirectory / "eplusout.sql";
+      const fs::path databasePath = m_outputDirectory / "eplusout.sql";
+      // The meters are in both, the ESO also has the variables. The CSVs are written from them, when asked for
+      fs::path textOutputPath;
+      for (const auto* fileName : {"eplusout.eso", "eplusout.mtr", "eplusout.csv", "eplusmtr.csv"}) {
+        if (fs::is_regular_file(m_outputDirectory / fileName)) {
+          textOutputPath = m_outputDirectory / fileName;
+          break;
+        }
+      }
       if (fs::is_regular_file(databasePath)) {
-        content = m_sqlite_component->RenderDatabase(std::move(databasePath));
+        content = m_sqlite_component->RenderDatabase(databasePath);
+      } else if (!textOutputPath.empty()) {
+        m_sql_tab_source = 1;
+        m_output_browser->setFile(textOutputPath);
+        return  //
+          vbox({
+            header,
+            separator(),
+            m_output_browser->Render() | flex,
+          });
       } else {
         content = vbox({
           text(fmt::format("The Run appears to have been successful but I cannot find the SQLFile at {}", fs::weakly_canonical(databasePath))),
@@ -389,6 +510,102 @@ Element MainComponent::Render() {
       });
   }
 
+  if (tab_selected_ == 3) {
+
+    auto header = hbox({
+      text(programName),
+      filler(),
+      separator(),
+      hcenter(toggle_->Render()) | color(Color::Yellow),
+      separator(),
+      filler(),
+      spinner(5, i++),
+      m_quitButton->Render(),
+    });
+
+    Element content = text("NOTHING TO SHOW") | center;
+
+    if (*m_progress == 100) {
+      const fs::path databasePath = m_outputDirectory / "eplusout.sql";
+      if (fs::is_regular_file(databasePath)) {
+        m_tabular_browser->setDatabase(databasePath);
+        content = m_tabular_browser->Render();
+      } else {
+        content = text(fmt::format("Cannot find the SQLFile at {}", fs::weakly_canonical(databasePath))) | center;
+      }
+    }
+
+    return  //
+      vbox({
+        header,
+        separator(),
+        content | flex,
+      });
+  }
+
+  if (tab_selected_ == 4) {
+
+    auto header = hbox({
+      text(programName),
+      filler(),
+      separator(),
+      hcenter(toggle_->Render()) | color(Color::Yellow),
+      separator(),
+      filler(),
+      spinner(5, i++),
+      m_quitButton->Render(),
+    });
+
+    return  //
+      vbox({
+        header,
+        separator(),
+        m_time_series->Render() | flex,
+      });
+  }
+
+  if (tab_selected_ == 5) {
+
+    auto header = hbox({
+      text(programName),
+      filler(),
+      separator(),
+      hcenter(toggle_->Render()) | color(Color::Yellow),
+      separator(),
+      filler(),
+      spinner(5, i++),
+      m_quitButton->Render(),
+    });
+
+    return  //
+      vbox({
+        header,
+        separator(),
+        m_profile_component->Render() | flex,
+      });
+  }
+
+  if (tab_selected_ == 6) {
+
+    auto header = hbox({
+      text(programName),
+      filler(),
+      separator(),
+      hcenter(toggle_->Render()) | color(Color::Yellow),
+      separator(),
+      filler(),
+      spinner(5, i++),
+      m_quitButton->Render(),
+    });
+
+    return  //
+      vbox({
+        header,
+        separator(),
+        m_weather_component->Render() | flex,
+      });
+  }
+
   // About
 
   auto header = hbox({
@@ -4,7 +4,13 @@
 #include "AboutComponent.hpp"                     // for AboutComponent
 #include "ErrorMessage.hpp"                       // for ErrorMessage
 #include "LogDisplayer.hpp"                       // for LogDisplayer
+#include "PerfHud.hpp"                            // for PerfHud
+#include "ProfileComponent.hpp"                   // for ProfileComponent
+#include "TimeSeriesComponent.hpp"                // for TimeSeriesComponent
+#include "WeatherComponent.hpp"                   // for WeatherComponent
+#include "outputs/OutputBrowser.hpp"              // for OutputBrowserComponent
 #include "sqlite/SQLiteReports.hpp"               // for SQLiteComponent
+#include "sqlite/TabularBrowser.hpp"              // for TabularBrowserComponent
                                                   //
 #include <EnergyPlus/api/TypeDefs.h>              // for Error
                                                   //
@@ -16,35 +22,55 @@
 #include <ftxui/dom/elements.hpp>                 // for Element
                                                   //
 #include <atomic>                                 // for atomic
+#include <chrono>                                 // for steady_clock
+#include <cstddef>                                // for size_t
+#include <cstdint>                                // for uint64_t
 #include <filesystem>                             // for path
+#include <functional>                             // for function
 #include <map>                                    // for map
 #include <memory>                                 // for shared_ptr
+#include <optional>                               // for optional
 #include <string>                                 // for string, allocator
 #include <vector>                                 // for vector
 
 using namespace ftxui;
 
+namespace epcli {
+struct RunOptions;
+struct RuntimeMetrics;
+}
+
 class MainComponent : public ComponentBase
 {
  public:
   MainComponent(Receiver<std::string> receiverRunOutput, Receiver<ErrorMessage> receiverErrorOutput, Component runButton, Component quitButton,
-                std::atomic<int>* progress, std::filesystem::path outputDirectory);
+                std::atomic<int>* progress, std::filesystem::path outputDirectory, std::filesystem::path weatherFile,
+                std::function<void()> requestRedraw, const epcli::RunOptions& runOptions);
   Element Render() override;
   bool OnEvent(Event event) override;
 
   void clear_state();
   bool hasAlreadyRun() const;
 
+  /// To be called when a run starts, with its predicted wall time if known: the status row shows the time left, from the prediction
+  /// blended with the observed progress rate
+  void startRunClock(std::optional<double> predictedSeconds);
+
   void reload_results();
 
  private:
+  // The content of the selected tab
+  Element RenderTab();
+
   Receiver<std::string> m_receiverRunOutput;
   Receiver<ErrorMessage> m_receiverErrorOutput;
 
   std::vector<std::string> m_stdout_lines;
+  std::size_t m_stdout_bytes = 0;
 
   void ProcessErrorMessage(ErrorMessage&& errorMsg);
   std::vector<ErrorMessage> m_errors;
+  std::size_t m_error_bytes = 0;
   unsigned m_numSeveres = 0;
   unsigned m_numWarnings = 0;
   void RegisterLogLevel(EnergyPlus::Error log_level);
@@ -64,11 +90,21 @@ class MainComponent : public ComponentBase
 
   std::atomic<int>* m_progress;
 
+  bool m_runClockStarted = false;
+  std::chrono::steady_clock::time_point m_runStart;
+  std::optional<double> m_predictedSeconds;
+  // The time left in the run, if it is running and there is anything to tell it from
+  std::optional<double> remainingSeconds() const;
+
   int tab_selected_ = 0;
   std::vector<std::string> tab_entries_ = {
     "Stdout",
     "eplusout.err",
     "SQL Reports",
+    "Tabular Reports",
+    "Live Variables",
+    "Profile",
+    "Weather",
     "About",
   };
 
@@ -88,6 +124,20 @@ class MainComponent : public ComponentBase
     &m_clearResultsButtonText, [this]() { this->clear_state(); }, ButtonOption::Simple());
 
   std::shared_ptr<SQLiteComponent> m_sqlite_component = Make<SQLiteComponent>();
+  // In the SQL Reports tab, when the run wrote eplusout.eso, eplusout.mtr or a CSV output but no eplusout.sql
+  std::shared_ptr<OutputBrowserComponent> m_output_browser;
+  // 0: m_sqlite_component, 1: m_output_browser
+  int m_sql_tab_source = 0;
+  std::shared_ptr<TabularBrowserComponent> m_tabular_browser = Make<TabularBrowserComponent>();
+  std::shared_ptr<TimeSeriesComponent> m_time_series;
+  std::shared_ptr<ProfileComponent> m_profile_component;
+  std::shared_ptr<WeatherComponent> m_weather_component;
+
+  epcli::RuntimeMetrics* m_metrics;
+  PerfHud m_perf_hud;
+  bool m_show_perf_hud = false;
+  // Runs whose warnings and severes were already recorded in m_metrics
+  std::uint64_t m_runs_recorded = 0;
 };
 
 #endif  // MAIN_COMPONENT_HPP
@@ -0,0 +1,123 @@
+#include "PerfHud.hpp"
+
+#include "RuntimeMetrics.hpp"     // for RuntimeMetrics
+#include "utilities/Process.hpp"  // for residentSetSize
+
+#include <ftxui/dom/elements.hpp>  // for text, vbox, hbox, window, filler, separator, operator|, color, clear_under, size
+#include <ftxui/screen/color.hpp>  // for Color
+
+#include <fmt/format.h>  // for format
+
+#include <algorithm>  // for min, nth_element, max_element
+#include <cstddef>    // for ptrdiff_t
+#include <string>     // for string, to_string
+#include <utility>    // for move
+#include <vector>     // for vector
+
+using namespace ftxui;
+
+namespace {
+std::string formatBytes(std::size_t bytes) {
+  constexpr double kiB = 1024.0;
+  if (bytes < 1024) {
+    return fmt::format("{} B", bytes);
+  }
+  if (static_cast<double>(bytes) < kiB * kiB) {
+    return fmt::format("{:.1f} KiB", static_cast<double>(bytes) / kiB);
+  }
+  if (static_cast<double>(bytes) < kiB * kiB * kiB) {
+    return fmt::format("{:.1f} MiB", static_cast<double>(bytes) / (kiB * kiB));
+  }
+  return fmt::format("{:.2f} GiB", static_cast<double>(bytes) / (kiB * kiB * kiB));
+}
+
+std::string formatMs(std::int64_t ns) {
+  return fmt::format("{:.2f} ms", static_cast<double>(ns) / 1e6);
+}
+
+Element row(const std::string& label, const std::string& value) {
+  return hbox({
+    text(label),
+    filler(),
+    text(value),
+  });
+}
+}  // namespace
+
+PerfHud::PerfHud(const epcli::RuntimeMetrics* metrics) : m_metrics(metrics) {}
+
+void PerfHud::recordFrame(std::chrono::nanoseconds renderTime) {
+  m_frameTimes[m_numFrames % frameWindow] = renderTime.count();
+  ++m_numFrames;
+
+  const auto now = Clock::now();
+  m_frameTimestamps.push_back(now);
+  while (!m_frameTimestamps.empty() && now - m_frameTimestamps.front() > std::chrono::seconds(1)) {
+    m_frameTimestamps.pop_front();
+  }
+}
+
+void PerfHud::setStoredCounts(std::size_t stdoutLines, std::size_t stdoutBytes, std::size_t errorLines, std::size_t errorBytes) {
+  m_stdoutLines = stdoutLines;
+  m_stdoutBytes = stdoutBytes;
+  m_errorLines = errorLines;
+  m_errorBytes = errorBytes;
+}
+
+Element PerfHud::Render() {
+  const auto now = Clock::now();
+
+  // Percentiles over the last frameWindow frames
+  std::vector<std::int64_t> frames(m_frameTimes.begin(), m_frameTimes.begin() + static_cast<std::ptrdiff_t>(std::min(m_numFrames, frameWindow)));
+  auto percentile = [&frames](double p) -> std::int64_t {
+    if (frames.empty()) {
+      return 0;
+    }
+    const auto index = static_cast<std::size_t>(p * static_cast<double>(frames.size() - 1));
+    std::nth_element(frames.begin(), frames.begin() + static_cast<std::ptrdiff_t>(index), frames.end());
+    return frames[index];
+  };
+  const auto p50 = percentile(0.50);
+  const auto p90 = percentile(0.90);
+  const auto p99 = percentile(0.99);
+  const auto maxFrame = frames.empty() ? 0 : *std::max_element(frames.begin(), frames.end());
+
+  if (now - m_lastRssSample > std::chrono::milliseconds(500)) {
+    m_rss = utilities::residentSetSize();
+    m_lastRssSample = now;
+  }
+
+  Elements rows{
+    row("Frame p50 / p90", fmt::format("{} / {}", formatMs(p50), formatMs(p90))),
+    row("Frame p99 / max", fmt::format("{} / {}", formatMs(p99), formatMs(maxFrame))),
+    row("Renders/s", std::to_string(m_frameTimestamps.size())),
+    separator(),
+  };
+
+  if (m_metrics != nullptr) {
+    const auto stdoutSent = m_metrics->stdoutSent.value();
+    const auto stdoutReceived = m_metrics->stdoutReceived.value();
+    const auto errorsSent = m_metrics->errorsSent.value();
+    const auto errorsReceived = m_metrics->errorsReceived.value();
+
+    const auto received = stdoutReceived + errorsReceived;
+    const std::chrono::duration<double> elapsed = now - m_lastRateSample;
+    if (elapsed.count() >= 1.0) {
+      m_ingestRate = static_cast<double>(received - m_lastReceived) / elapsed.count();
+      m_lastReceived = received;
+      m_lastRateSample = now;
+    }
+
+    rows.push_back(row("Stdout queue", std::to_string(stdoutSent - std::min(stdoutSent, stdoutReceived))));
+    rows.push_back(row("Error queue", std::to_string(errorsSent - std::min(errorsSent, errorsReceived))));
+    rows.push_back(row("Ingest", fmt::format("{:.0f} msg/s", m_ingestRate)));
+    rows.push_back(row("Active runs", fmt::format("{}", m_metrics->activeRuns.value())));
+    rows.push_back(separator());
+  }
+
+  rows.push_back(row("Stdout lines", fmt::format("{} ({})", m_stdoutLines, formatBytes(m_stdoutBytes))));
+  rows.push_back(row("Error lines", fmt::format("{} ({})", m_errorLines, formatBytes(m_errorBytes))));
+  rows.push_back(row("RSS", (m_rss > 0) ? formatBytes(m_rss) : "n/a"));
+
+  return window(text("Perf (P)") | color(Color::Yellow), vbox(std::move(rows))) | ftxui::size(WIDTH, EQUAL, 42) | clear_under;
+}
@@ -0,0 +1,53 @@
+#ifndef PERF_HUD_HPP
+#define PERF_HUD_HPP
+
+#include <ftxui/dom/elements.hpp>  // for Element
+
+#include <array>    // for array
+#include <chrono>   // for steady_clock, nanoseconds
+#include <cstddef>  // for size_t
+#include <cstdint>  // for int64_t, uint64_t
+#include <deque>    // for deque
+
+namespace epcli {
+struct RuntimeMetrics;
+}
+
+/// Performance overlay for MainComponent, toggled with 'P': frame time percentiles, renders/sec, receiver queue depths, ingest rate,
+/// stored lines and bytes, RSS and active runs. Everything here is UI thread only, the cross thread counters come from RuntimeMetrics
+class PerfHud
+{
+ public:
+  explicit PerfHud(const epcli::RuntimeMetrics* metrics);
+
+  /// Time spent building the last frame's element tree
+  void recordFrame(std::chrono::nanoseconds renderTime);
+  void setStoredCounts(std::size_t stdoutLines, std::size_t stdoutBytes, std::size_t errorLines, std::size_t errorBytes);
+
+  ftxui::Element Render();
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  const epcli::RuntimeMetrics* m_metrics;
+
+  static constexpr std::size_t frameWindow = 256;
+  std::array<std::int64_t, frameWindow> m_frameTimes{};
+  std::size_t m_numFrames = 0;
+  // Frames rendered over the last second
+  std::deque<Clock::time_point> m_frameTimestamps;
+
+  Clock::time_point m_lastRateSample = Clock::now();
+  std::uint64_t m_lastReceived = 0;
+  double m_ingestRate = 0.0;
+
+  Clock::time_point m_lastRssSample;
+  std::size_t m_rss = 0;
+
+  std::size_t m_stdoutLines = 0;
+  std::size_t m_stdoutBytes = 0;
+  std::size_t m_errorLines = 0;
+  std::size_t m_errorBytes = 0;
+};
+
+#endif  // PERF_HUD_HPP
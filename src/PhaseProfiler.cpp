@@ -0,0 +1,235 @@
+#include "PhaseProfiler.hpp"
+
+#include <EnergyPlus/api/datatransfer.h>  // for currentEnvironmentNum, kindOfSim, warmupFlag, currentTime
+#include <EnergyPlus/api/runtime.h>       // for callbackBeginNewEnvironment, callbackAfterNewEnvironmentWarmupComplete, callbackEndOf*
+
+#include <fmt/format.h>  // for format, format_to
+
+#include <fstream>   // for ofstream
+#include <iterator>  // for back_inserter
+#include <utility>   // for move
+
+namespace epcli {
+
+namespace {
+  // EnergyPlus' KindOfSim
+  const char* kindOfSimName(int kind) {
+    switch (kind) {
+      case 1:
+        return "Design Day";
+      case 2:
+        return "Run Period Design";
+      case 3:
+        return "Run Period";
+      case 4:
+        return "HVAC Sizing Design Day";
+      case 5:
+        return "HVAC Sizing Run Period";
+      case 6:
+        return "Weather File Read";
+      default:
+        return "Environment";
+    }
+  }
+
+  double toSeconds(std::chrono::nanoseconds ns) {
+    return std::chrono::duration<double>(ns).count();
+  }
+
+  std::string escapeJson(const std::string& s) {
+    std::string result;
+    result.reserve(s.size());
+    for (const char c : s) {
+      if (c == '"' || c == '\\') {
+        result += '\\';
+        result += c;
+      } else if (static_cast<unsigned char>(c) < 0x20) {
+        result += fmt::format("\\u{:04x}", static_cast<int>(c));
+      } else {
+        result += c;
+      }
+    }
+    return result;
+  }
+}  // namespace
+
+const char* PhaseProfiler::callbackName(Callback callback) {
+  switch (callback) {
+    case Callback::BeginNewEnvironment:
+      return "BeginNewEnvironment";
+    case Callback::AfterNewEnvironmentWarmupComplete:
+      return "AfterNewEnvironmentWarmupComplete";
+    case Callback::EndOfZoneSizing:
+      return "EndOfZoneSizing";
+    case Callback::EndOfSystemSizing:
+      return "EndOfSystemSizing";
+    case Callback::EndOfAfterComponentGetInput:
+      return "EndOfAfterComponentGetInput";
+    case Callback::EndOfZoneTimeStep:
+      return "EndOfZoneTimeStepAfterZoneReporting";
+  }
+  return "";
+}
+
+PhaseProfiler::PhaseProfiler(std::filesystem::path outputDirectory) : m_outputDirectory(std::move(outputDirectory)) {}
+
+std::filesystem::path PhaseProfiler::summaryPath() const {
+  return m_outputDirectory / "epcli_profile.json";
+}
+
+void PhaseProfiler::registerCallbacks(EnergyPlusState state) {
+  {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    m_phases.clear();
+    m_phases.push_back(Phase{"Input processing"});
+    m_runStart = Clock::now();
+    m_running = true;
+    m_success = false;
+    for (auto& count : m_callbackCounts) {
+      count = 0;
+    }
+  }
+  m_openZoneTimeSteps = 0;
+  m_openWarmupDays = 0;
+  m_openIsWarmup = false;
+  m_inputProcessing = true;
+
+  callbackBeginNewEnvironment(state, [this](EnergyPlusState s) { onCallback(Callback::BeginNewEnvironment, s); });
+  callbackAfterNewEnvironmentWarmupComplete(state, [this](EnergyPlusState s) { onCallback(Callback::AfterNewEnvironmentWarmupComplete, s); });
+  callbackEndOfZoneSizing(state, [this](EnergyPlusState s) { onCallback(Callback::EndOfZoneSizing, s); });
+  callbackEndOfSystemSizing(state, [this](EnergyPlusState s) { onCallback(Callback::EndOfSystemSizing, s); });
+  callbackEndOfAfterComponentGetInput(state, [this](EnergyPlusState s) { onCallback(Callback::EndOfAfterComponentGetInput, s); });
+  callbackEndOfZoneTimeStepAfterZoneReporting(state, [this](EnergyPlusState s) { onZoneTimeStep(s); });
+}
+
+void PhaseProfiler::onCallback(Callback callback, EnergyPlusState state) {
+  m_callbackCounts[static_cast<std::size_t>(callback)].fetch_add(1, std::memory_order_relaxed);
+
+  switch (callback) {
+    case Callback::BeginNewEnvironment: {
+      const int environment = currentEnvironmentNum(state);
+      transition(fmt::format("Warmup: {} {}", kindOfSimName(kindOfSim(state)), environment), environment, true);
+      break;
+    }
+    case Callback::AfterNewEnvironmentWarmupComplete: {
+      const int environment = currentEnvironmentNum(state);
+      transition(fmt::format("Simulation: {} {}", kindOfSimName(kindOfSim(state)), environment), environment, false);
+      break;
+    }
+    case Callback::EndOfZoneSizing:
+      transition("System sizing", -1, false);
+      break;
+    case Callback::EndOfSystemSizing:
+      transition("Setup", -1, false);
+      break;
+    case Callback::EndOfAfterComponentGetInput:
+    case Callback::EndOfZoneTimeStep:
+      // Just counted
+      break;
+  }
+}
+
+void PhaseProfiler::onZoneTimeStep(EnergyPlusState state) {
+  m_callbackCounts[static_cast<std::size_t>(Callback::EndOfZoneTimeStep)].fetch_add(1, std::memory_order_relaxed);
+
+  if (m_inputProcessing) {
+    // The first zone timestep before any environment is the zone sizing design days starting
+    transition("Zone sizing", -1, false);
+  }
+  m_openZoneTimeSteps.fetch_add(1, std::memory_order_relaxed);
+
+  if (m_openIsWarmup && warmupFlag(state) != 0) {
+    // The time of day wrapping around is a new day. Design days are repeated as is during warmup, so the day of year can't be used
+    const double time = currentTime(state);
+    if (time < m_lastCurrentTime) {
+      m_openWarmupDays.fetch_add(1, std::memory_order_relaxed);
+    }
+    m_lastCurrentTime = time;
+  }
+}
+
+void PhaseProfiler::closePhase(Clock::time_point now) {
+  auto& phase = m_phases.back();
+  phase.duration = std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_runStart) - phase.start;
+  phase.zoneTimeSteps = m_openZoneTimeSteps.exchange(0, std::memory_order_relaxed);
+  phase.warmupDays = m_openWarmupDays.exchange(0, std::memory_order_relaxed);
+}
+
+void PhaseProfiler::transition(std::string nextName, int environment, bool isWarmup) {
+  const auto now = Clock::now();
+  {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    closePhase(now);
+    Phase next;
+    next.name = std::move(nextName);
+    next.environment = environment;
+    next.isWarmup = isWarmup;
+    next.start = std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_runStart);
+    m_phases.emplace_back(std::move(next));
+  }
+  m_inputProcessing = false;
+  m_openIsWarmup = isWarmup;
+  // So the first warmup timestep counts as a day
+  m_lastCurrentTime = 24.0;
+}
+
+void PhaseProfiler::endRun(bool success) {
+  {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_running) {
+      return;
+    }
+    closePhase(Clock::now());
+    m_running = false;
+    m_success = success;
+  }
+
+  std::ofstream ofs(summaryPath(), std::ios::trunc);
+  if (ofs) {
+    ofs << toJson(snapshot());
+  }
+}
+
+PhaseProfiler::Snapshot PhaseProfiler::snapshot() const {
+  Snapshot result;
+  const auto now = Clock::now();
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  result.phases = m_phases;
+  result.running = m_running;
+  result.success = m_success;
+  for (std::size_t i = 0; i < numCallbacks; ++i) {
+    result.callbackCounts[i] = m_callbackCounts[i].load(std::memory_order_relaxed);
+  }
+  if (m_running && !result.phases.empty()) {
+    auto& open = result.phases.back();
+    open.duration = std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_runStart) - open.start;
+    open.zoneTimeSteps = m_openZoneTimeSteps.load(std::memory_order_relaxed);
+    open.warmupDays = m_openWarmupDays.load(std::memory_order_relaxed);
+  }
+  if (!result.phases.empty()) {
+    result.total = result.phases.back().start + result.phases.back().duration;
+  }
+  return result;
+}
+
+std::string PhaseProfiler::toJson(const Snapshot& snapshot) {
+  std::string json;
+  auto out = std::back_inserter(json);
+  fmt::format_to(out, "{{\n  \"success\": {},\n  \"total_seconds\": {:.6f},\n  \"phases\": [", snapshot.success, toSeconds(snapshot.total));
+  for (std::size_t i = 0; i < snapshot.phases.size(); ++i) {
+    const auto& phase = snapshot.phases[i];
+    fmt::format_to(out,
+                   "{}\n    {{\"name\": \"{}\", \"environment\": {}, \"warmup\": {}, \"start_seconds\": {:.6f}, \"duration_seconds\": {:.6f}, "
+                   "\"zone_timesteps\": {}, \"warmup_days\": {}}}",
+                   (i == 0) ? "" : ",", escapeJson(phase.name), phase.environment, phase.isWarmup, toSeconds(phase.start),
+                   toSeconds(phase.duration), phase.zoneTimeSteps, phase.warmupDays);
+  }
+  fmt::format_to(out, "\n  ],\n  \"callbacks\": {{");
+  for (std::size_t i = 0; i < numCallbacks; ++i) {
+    fmt::format_to(out, "{}\n    \"{}\": {}", (i == 0) ? "" : ",", callbackName(static_cast<Callback>(i)), snapshot.callbackCounts[i]);
+  }
+  fmt::format_to(out, "\n  }}\n}}\n");
+  return json;
+}
+
+}  // namespace epcli
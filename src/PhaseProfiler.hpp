@@ -0,0 +1,105 @@
+#ifndef PHASE_PROFILER_HPP
+#define PHASE_PROFILER_HPP
+
+#include <EnergyPlus/api/state.h>  // for EnergyPlusState
+
+#include <array>       // for array
+#include <atomic>      // for atomic
+#include <chrono>      // for steady_clock, nanoseconds
+#include <cstddef>     // for size_t
+#include <cstdint>     // for uint64_t
+#include <filesystem>  // for path
+#include <mutex>       // for mutex
+#include <string>      // for string
+#include <vector>      // for vector
+
+namespace epcli {
+
+/// Where the wall time of a run goes: input processing, sizing, then warmup and simulation of each environment.
+/// Phase boundaries come from the EnergyPlus callbacks, timed with a monotonic clock: input processing ends at the first zone timestep
+/// (zone sizing) or environment, then end of zone sizing, end of system sizing, begin new environment and warmup complete.
+/// Zone timesteps and warmup days are counted per phase. The callbacks run on the EnergyPlus thread, snapshot() can be called from any thread
+class PhaseProfiler
+{
+ public:
+  enum class Callback
+  {
+    BeginNewEnvironment,
+    AfterNewEnvironmentWarmupComplete,
+    EndOfZoneSizing,
+    EndOfSystemSizing,
+    EndOfAfterComponentGetInput,
+    EndOfZoneTimeStep,
+  };
+  static constexpr std::size_t numCallbacks = 6;
+  static const char* callbackName(Callback callback);
+
+  struct Phase
+  {
+    std::string name;
+    // -1 outside of the environments
+    int environment = -1;
+    bool isWarmup = false;
+    std::chrono::nanoseconds start{0};  // Since the start of the run
+    std::chrono::nanoseconds duration{0};
+    std::uint64_t zoneTimeSteps = 0;
+    int warmupDays = 0;
+  };
+
+  struct Snapshot
+  {
+    std::vector<Phase> phases;  // The last one is still open if running
+    std::array<std::uint64_t, numCallbacks> callbackCounts{};
+    std::chrono::nanoseconds total{0};
+    bool running = false;
+    bool success = false;  // Only meaningful once !running
+  };
+
+  /// Warmup that takes this many days is flagged: EnergyPlus gives up on convergence at 25 by default
+  static constexpr int slowWarmupDays = 20;
+
+  /// The JSON summary of each run is written to outputDirectory / "epcli_profile.json"
+  explicit PhaseProfiler(std::filesystem::path outputDirectory);
+
+  /// To be called on a fresh state, right before energyplus(): resets, starts the clock and registers the callbacks
+  void registerCallbacks(EnergyPlusState state);
+  /// To be called once energyplus() returned: closes the last phase and writes the JSON summary
+  void endRun(bool success);
+
+  [[nodiscard]] Snapshot snapshot() const;
+  [[nodiscard]] std::filesystem::path summaryPath() const;
+
+  /// Serialized Snapshot
+  static std::string toJson(const Snapshot& snapshot);
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  void onCallback(Callback callback, EnergyPlusState state);
+  void onZoneTimeStep(EnergyPlusState state);
+  // Closes the open phase, and opens the next one
+  void transition(std::string nextName, int environment, bool isWarmup);
+  // m_mutex must be held
+  void closePhase(Clock::time_point now);
+
+  std::filesystem::path m_outputDirectory;
+
+  mutable std::mutex m_mutex;
+  Clock::time_point m_runStart;
+  std::vector<Phase> m_phases;
+  bool m_running = false;
+  bool m_success = false;
+  std::array<std::atomic<std::uint64_t>, numCallbacks> m_callbackCounts{};
+
+  // Open phase counters, only written on the EnergyPlus thread
+  std::atomic<std::uint64_t> m_openZoneTimeSteps = 0;
+  std::atomic<int> m_openWarmupDays = 0;
+  // EnergyPlus thread only
+  bool m_openIsWarmup = false;
+  bool m_inputProcessing = false;
+  double m_lastCurrentTime = 0.0;
+};
+
+}  // namespace epcli
+
+#endif  // PHASE_PROFILER_HPP
@@ -0,0 +1,641 @@
+#include "Preflight.hpp"
+
+#include "utilities/ASCIIStrings.hpp"  // for ascii_to_lower_copy
+#include "utilities/MappedFile.hpp"    // for MappedFile
+#include "utilities/ThreadPool.hpp"    // for ThreadPool
+
+#include <fmt/format.h>  // for format
+
+#include <algorithm>      // for min, max, sort, stable_sort, lower_bound, count, equal, find_if, any_of
+#include <array>          // for array
+#include <cstdint>        // for uint64_t
+#include <future>         // for future
+#include <iterator>       // for make_move_iterator
+#include <thread>         // for thread
+#include <unordered_map>  // for unordered_map
+#include <utility>        // for move, pair
+
+namespace epcli {
+
+namespace {
+  constexpr auto npos = std::string_view::npos;
+
+  // Below, one thread scans a chunk faster than it takes to start another
+  constexpr std::size_t minChunkBytes = std::size_t{4} << 20;
+
+  // IDF types whose first field isn't a name unique within the type: Output:Variable "*", an Output:Meter per frequency, one
+  // FluidProperties:Saturated per property of a fluid...
+  constexpr std::array<std::string_view, 5> unnamedPrefixes{"output:", "outputcontrol:", "fluidproperties:", "parametric:", "outdoorair:nodelist"};
+
+  // IDF types whose first field is a name EnergyPlus refuses to see twice. Without the IDD, that of the other types may be something else
+  // (Outside or Inside in SurfaceControl:MovableInsulation, a key in the ExternalInterface variables): their repeated names are only
+  // warned about. An entry ending in ':' is a family of types
+  constexpr std::array<std::string_view, 47> namedTypes{
+    "zone", "zonelist", "space", "spacelist", "construction", "construction:", "material", "material:", "windowmaterial:", "schedule:",
+    "scheduletypelimits", "buildingsurface:detailed", "fenestrationsurface:detailed", "wall:", "roofceiling:", "floor:", "window", "window:",
+    "door", "door:", "glazeddoor", "glazeddoor:", "internalmass", "shading:", "people", "lights", "electricequipment", "gasequipment",
+    "otherequipment", "zoneinfiltration:", "zoneventilation:", "designspecification:outdoorair", "sizingperiod:designday", "runperiod",
+    "airloophvac", "plantloop", "condenserloop", "branch", "branchlist", "zonehvac:", "airterminal:", "coil:", "fan:", "pump:", "curve:",
+    "thermostatsetpoint:", "zonecontrol:thermostat"};
+
+  // Lowercase
+  constexpr std::array<std::string_view, 2> requiredTypes{"building", "globalgeometryrules"};
+  constexpr std::array<std::string_view, 2> requiredSpellings{"Building", "GlobalGeometryRules"};
+
+  struct RawIssue
+  {
+    std::size_t offset = npos;
+    std::string message;
+    // Where the object a duplicate repeats is, added to the message once its line is known
+    std::size_t firstOffset = npos;
+  };
+
+  // A name of an object, not copied: duplicates are found by sorting the hashes, then comparing the names of equal hashes only
+  struct NameRef
+  {
+    std::uint64_t hash = 0;
+    std::string_view name;
+    std::size_t offset = 0;
+  };
+
+  struct TypeStats
+  {
+    // As first written
+    std::string_view spelling;
+    std::size_t count = 0;
+    std::vector<NameRef> names;
+    // Whether its repeated names are errors rather than warnings
+    bool knownNamed = false;
+  };
+
+  // What the scan of a part of the input found
+  struct ScanResult
+  {
+    // By lowercase type
+    std::unordered_map<std::string, TypeStats> types;
+    std::vector<RawIssue> errors;
+  };
+
+  bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+  }
+
+  // What the IDF tokenizer does with each byte: a table lookup rather than a chain of comparisons in the inner loop
+  enum class CharClass : unsigned char
+  {
+    Ordinary,
+    Blank,
+    Newline,
+    Separator,
+    Terminator,
+    Comment
+  };
+
+  constexpr std::array<CharClass, 256> charClasses = []() {
+    std::array<CharClass, 256> classes{};
+    classes[static_cast<unsigned char>(' ')] = CharClass::Blank;
+    classes[static_cast<unsigned char>('\t')] = CharClass::Blank;
+    classes[static_cast<unsigned char>('\r')] = CharClass::Blank;
+    classes[static_cast<unsigned char>('\n')] = CharClass::Newline;
+    classes[static_cast<unsigned char>(',')] = CharClass::Separator;
+    classes[static_cast<unsigned char>(';')] = CharClass::Terminator;
+    classes[static_cast<unsigned char>('!')] = CharClass::Comment;
+    return classes;
+  }();
+
+  CharClass charClass(char c) {
+    return charClasses[static_cast<unsigned char>(c)];
+  }
+
+  char toLower(char c) {
+    return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+  }
+
+  // fnv1a64 of the lowercase name, without the lowercase copy
+  std::uint64_t lowerHash(std::string_view name) {
+    std::uint64_t hash = 0xcbf29ce484222325ULL;
+    for (const char c : name) {
+      hash ^= static_cast<unsigned char>(toLower(c));
+      hash *= 0x100000001b3ULL;
+    }
+    return hash;
+  }
+
+  bool equalsIgnoringCase(std::string_view a, std::string_view b) {
+    return a.size() == b.size() && std::equal(a.cbegin(), a.cend(), b.cbegin(), [](char x, char y) { return toLower(x) == toLower(y); });
+  }
+
+  bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+  }
+
+  bool hasUnnamedPrefix(std::string_view loweredType) {
+    return std::any_of(unnamedPrefixes.cbegin(), unnamedPrefixes.cend(),
+                       [loweredType](std::string_view prefix) { return loweredType.substr(0, prefix.size()) == prefix; });
+  }
+
+  bool isKnownNamed(std::string_view loweredType) {
+    return std::any_of(namedTypes.cbegin(), namedTypes.cend(), [loweredType](std::string_view named) {
+      return named.back() == ':' ? loweredType.starts_with(named) : loweredType == named;
+    });
+  }
+
+  // Objects of a type are usually written together: the type of the previous object is looked up again only if this one differs
+  class ObjectCounter
+  {
+   public:
+    ObjectCounter(ScanResult& result, bool allNamed) : m_result(result), m_allNamed(allNamed) {}
+
+    void add(std::string_view type, std::string_view name, std::size_t offset) {
+      if (m_stats == nullptr || type != m_type) {
+        auto lowered = utilities::ascii_to_lower_copy(type);
+        m_named = m_allNamed || !hasUnnamedPrefix(lowered);
+        // Every epJSON object is named: its name is its key
+        const bool knownNamed = m_allNamed || isKnownNamed(lowered);
+        m_stats = &m_result.types[std::move(lowered)];
+        m_type = type;
+        if (m_stats->count == 0) {
+          m_stats->spelling = type;
+          m_stats->knownNamed = knownNamed;
+        }
+      }
+      ++m_stats->count;
+      if (m_named && !name.empty()) {
+        m_stats->names.push_back({lowerHash(name), name, offset});
+      }
+    }
+
+   private:
+    ScanResult& m_result;
+    bool m_allNamed;
+    std::string_view m_type;
+    TypeStats* m_stats = nullptr;
+    bool m_named = false;
+  };
+
+  // For messages: the token at i, up to the next separator or whitespace
+  std::string_view tokenAt(std::string_view text, std::size_t i) {
+    const auto end = std::min(text.find_first_of(",;! \t\r\n", i), i + 40);
+    return text.substr(i, end - i);
+  }
+
+  // Scans the IDF objects that start in [begin, end). begin is right after a `;` or at the start of the text, so that it is between
+  // objects and out of a comment
+  void scanIdfRange(std::string_view text, std::size_t begin, std::size_t end, ScanResult& result) {
+    ObjectCounter counter(result, false);
+    std::string_view type;
+    std::string_view name;
+    std::size_t objectStart = begin;
+    std::size_t fieldIndex = 0;
+    // The missing separator of an object is reported once
+    bool reported = false;
+    std::size_t i = begin;
+    while (i < end) {
+      while (i < end) {
+        const auto c = charClass(text[i]);
+        if (c == CharClass::Comment) {
+          i = std::min(end, text.find('\n', i));
+        } else if (c == CharClass::Blank || c == CharClass::Newline) {
+          ++i;
+        } else {
+          break;
+        }
+      }
+      if (i >= end) {
+        break;
+      }
+      const std::size_t fieldBegin = i;
+      std::size_t fieldEnd = i;
+      // A value never spans lines: content on the next line means that the separator was forgotten
+      bool newline = false;
+      while (i < end) {
+        const auto c = charClass(text[i]);
+        if (c == CharClass::Ordinary) {
+          if (newline && !reported) {
+            result.errors.push_back({i, fmt::format("missing ',' or ';' before '{}'", tokenAt(text, i))});
+            reported = true;
+          }
+          do {
+            ++i;
+          } while (i < end && charClass(text[i]) == CharClass::Ordinary);
+          fieldEnd = i;
+        } else if (c == CharClass::Separator || c == CharClass::Terminator) {
+          break;
+        } else if (c == CharClass::Comment) {
+          i = std::min(end, text.find('\n', i));
+        } else {
+          newline = newline || c == CharClass::Newline;
+          ++i;
+        }
+      }
+      if (fieldIndex == 0) {
+        type = text.substr(fieldBegin, fieldEnd - fieldBegin);
+        objectStart = fieldBegin;
+      } else if (fieldIndex == 1) {
+        name = text.substr(fieldBegin, fieldEnd - fieldBegin);
+      }
+      ++fieldIndex;
+      if (i >= end) {
+        break;
+      }
+      if (text[i++] == ';') {
+        if (!type.empty()) {
+          counter.add(type, fieldIndex > 1 ? name : std::string_view(), objectStart);
+        } else if (fieldIndex > 1) {
+          // A lone `;` is harmless
+          result.errors.push_back({objectStart, "an object has no type"});
+        }
+        type = {};
+        name = {};
+        fieldIndex = 0;
+        reported = false;
+      }
+    }
+    if (fieldIndex > 0) {
+      result.errors.push_back({objectStart, fmt::format("'{}' isn't terminated by ';'", type)});
+    }
+  }
+
+  // The first object boundary after from: right after the first `;` that follows the next line start, out of a comment
+  std::size_t objectBoundaryAfter(std::string_view text, std::size_t from) {
+    std::size_t i = text.find('\n', from);
+    while (i != npos) {
+      i = text.find_first_of(";!", i);
+      if (i == npos) {
+        break;
+      }
+      if (text[i] == ';') {
+        return i + 1;
+      }
+      i = text.find('\n', i);
+    }
+    return text.size();
+  }
+
+  std::vector<ScanResult> scanIdf(std::string_view text) {
+    const std::size_t numChunks = std::min<std::size_t>(std::max(1U, std::thread::hardware_concurrency()), text.size() / minChunkBytes);
+    std::vector<ScanResult> results(std::max<std::size_t>(numChunks, 1));
+    if (numChunks <= 1) {
+      scanIdfRange(text, 0, text.size(), results.front());
+      return results;
+    }
+
+    std::vector<std::size_t> boundaries{0};
+    for (std::size_t k = 1; k < numChunks; ++k) {
+      boundaries.push_back(std::max(boundaries.back(), objectBoundaryAfter(text, k * text.size() / numChunks)));
+    }
+    boundaries.push_back(text.size());
+
+    utilities::ThreadPool pool(static_cast<unsigned>(numChunks));
+    std::vector<std::future<void>> scans;
+    scans.reserve(numChunks);
+    for (std::size_t k = 0; k < numChunks; ++k) {
+      scans.push_back(pool.submit([text, begin = boundaries[k], end = boundaries[k + 1], &result = results[k]]() {
+        scanIdfRange(text, begin, end, result);
+      }));
+    }
+    for (auto& scan : scans) {
+      scan.get();
+    }
+    return results;
+  }
+
+  // Where the number starting at i ends, npos if it isn't a valid JSON number
+  std::size_t numberEnd(std::string_view text, std::size_t i) {
+    const auto digitsEnd = [text](std::size_t j) {
+      while (j < text.size() && isDigit(text[j])) {
+        ++j;
+      }
+      return j;
+    };
+    if (text[i] == '-') {
+      ++i;
+    }
+    if (i >= text.size() || !isDigit(text[i])) {
+      return npos;
+    }
+    i = text[i] == '0' ? i + 1 : digitsEnd(i);
+    if (i < text.size() && text[i] == '.') {
+      const auto end = digitsEnd(i + 1);
+      if (end == i + 1) {
+        return npos;
+      }
+      i = end;
+    }
+    if (i < text.size() && (text[i] == 'e' || text[i] == 'E')) {
+      ++i;
+      if (i < text.size() && (text[i] == '+' || text[i] == '-')) {
+        ++i;
+      }
+      const auto end = digitsEnd(i);
+      if (end == i) {
+        return npos;
+      }
+      i = end;
+    }
+    return i;
+  }
+
+  // The closing quote of the string opening at i, npos if it isn't closed on its line
+  std::size_t stringEnd(std::string_view text, std::size_t i) {
+    for (++i; i < text.size(); ++i) {
+      const char c = text[i];
+      if (c == '"') {
+        return i;
+      }
+      if (c == '\\') {
+        ++i;
+      } else if (static_cast<unsigned char>(c) < 0x20) {
+        return npos;
+      }
+    }
+    return npos;
+  }
+
+  // A SAX pass over the whole JSON syntax, without building anything: the keys of the root are object types, and the keys of their values
+  // object names. Stops at the first error, the rest would only be its consequences
+  ScanResult scanEpJson(std::string_view text) {
+    enum class Expect
+    {
+      Value,
+      ValueOrClose,
+      Key,
+      KeyOrClose,
+      Colon,
+      CommaOrClose,
+      End
+    };
+    ScanResult result;
+    ObjectCounter counter(result, true);
+    std::vector<char> open;
+    std::string_view type;
+    Expect expect = Expect::Value;
+    const auto found = [text](std::size_t i) { return i < text.size() ? fmt::format("'{}'", text[i]) : std::string("the end of the input"); };
+    const auto afterValue = [&]() { expect = open.empty() ? Expect::End : Expect::CommaOrClose; };
+    const auto close = [&]() {
+      open.pop_back();
+      afterValue();
+    };
+
+    std::size_t i = 0;
+    while (true) {
+      while (i < text.size() && isSpace(text[i])) {
+        ++i;
+      }
+      if (i == text.size() && expect == Expect::End) {
+        return result;
+      }
+      const char c = i < text.size() ? text[i] : '\0';
+      switch (expect) {
+        case Expect::End:
+          result.errors.push_back({i, fmt::format("unexpected {} after the root object", found(i))});
+          return result;
+        case Expect::Colon:
+          if (c != ':') {
+            result.errors.push_back({i, fmt::format("expected ':' after a key, found {}", found(i))});
+            return result;
+          }
+          ++i;
+          expect = Expect::Value;
+          break;
+        case Expect::CommaOrClose: {
+          const char closer = open.back() == '{' ? '}' : ']';
+          if (c == ',') {
+            ++i;
+            expect = open.back() == '{' ? Expect::Key : Expect::Value;
+          } else if (c == closer) {
+            ++i;
+            close();
+          } else {
+            result.errors.push_back({i, fmt::format("expected ',' or '{}', found {}", closer, found(i))});
+            return result;
+          }
+          break;
+        }
+        case Expect::Key:
+        case Expect::KeyOrClose: {
+          if (c == '}' && expect == Expect::KeyOrClose) {
+            ++i;
+            close();
+            break;
+          }
+          const auto end = c == '"' ? stringEnd(text, i) : npos;
+          if (end == npos) {
+            result.errors.push_back({i, c == '"' ? std::string("unterminated string") : fmt::format("expected a key, found {}", found(i))});
+            return result;
+          }
+          const auto key = text.substr(i + 1, end - i - 1);
+          if (open.size() == 1) {
+            type = key;
+          } else if (open.size() == 2) {
+            // Duplicate keys are valid JSON, but the last one silently wins: all types are checked
+            counter.add(type, key, i);
+          }
+          i = end + 1;
+          expect = Expect::Colon;
+          break;
+        }
+        case Expect::Value:
+        case Expect::ValueOrClose: {
+          if (c == ']' && expect == Expect::ValueOrClose) {
+            ++i;
+            close();
+            break;
+          }
+          if (c == '{' || c == '[') {
+            open.push_back(c);
+            ++i;
+            expect = c == '{' ? Expect::KeyOrClose : Expect::ValueOrClose;
+            break;
+          }
+          std::size_t end = npos;
+          if (c == '"') {
+            end = stringEnd(text, i);
+            end = end == npos ? npos : end + 1;
+          } else if (c == '-' || isDigit(c)) {
+            end = numberEnd(text, i);
+          } else {
+            for (const std::string_view literal : {"true", "false", "null"}) {
+              if (text.substr(i, literal.size()) == literal) {
+                end = i + literal.size();
+              }
+            }
+          }
+          if (end == npos) {
+            result.errors.push_back({i, c == '"' ? std::string("unterminated string") : fmt::format("expected a value, found {}", found(i))});
+            return result;
+          }
+          i = end;
+          afterValue();
+          break;
+        }
+      }
+    }
+  }
+
+  // The 1-based line of each offset, npos staying npos
+  std::vector<std::size_t> lineNumbers(std::string_view text, const std::vector<std::size_t>& offsets) {
+    std::vector<std::size_t> sorted;
+    for (const auto offset : offsets) {
+      if (offset != npos) {
+        sorted.push_back(std::min(offset, text.size()));
+      }
+    }
+    std::sort(sorted.begin(), sorted.end());
+    std::vector<std::size_t> sortedLines;
+    sortedLines.reserve(sorted.size());
+    std::size_t line = 1;
+    std::size_t previous = 0;
+    for (const auto offset : sorted) {
+      line += static_cast<std::size_t>(std::count(text.data() + previous, text.data() + offset, '\n'));
+      previous = offset;
+      sortedLines.push_back(line);
+    }
+    std::vector<std::size_t> lines;
+    lines.reserve(offsets.size());
+    for (const auto offset : offsets) {
+      if (offset == npos) {
+        lines.push_back(npos);
+        continue;
+      }
+      const auto it = std::lower_bound(sorted.cbegin(), sorted.cend(), std::min(offset, text.size()));
+      lines.push_back(sortedLines[static_cast<std::size_t>(it - sorted.cbegin())]);
+    }
+    return lines;
+  }
+
+  // Merges the scans in order, checks the names and required objects, and turns offsets into lines
+  PreflightReport finish(std::string_view text, std::vector<ScanResult> parts) {
+    std::unordered_map<std::string, TypeStats> totals;
+    std::vector<RawIssue> errors;
+    std::vector<RawIssue> warnings;
+    for (auto& part : parts) {
+      errors.insert(errors.end(), std::make_move_iterator(part.errors.begin()), std::make_move_iterator(part.errors.end()));
+    }
+    const bool syntaxOk = errors.empty();
+    for (auto& part : parts) {
+      for (auto& [type, stats] : part.types) {
+        auto& total = totals[type];
+        if (total.count == 0) {
+          total.spelling = stats.spelling;
+        }
+        total.knownNamed = stats.knownNamed;
+        total.count += stats.count;
+        total.names.insert(total.names.end(), stats.names.cbegin(), stats.names.cend());
+      }
+    }
+    for (auto& [type, total] : totals) {
+      // Stable: the names of a hash stay in the order of the input
+      auto& names = total.names;
+      std::stable_sort(names.begin(), names.end(), [](const NameRef& a, const NameRef& b) { return a.hash < b.hash; });
+      for (std::size_t first = 0; first < names.size();) {
+        std::size_t last = first + 1;
+        while (last < names.size() && names[last].hash == names[first].hash) {
+          ++last;
+        }
+        for (std::size_t n = first + 1; n < last; ++n) {
+          const auto original = std::find_if(names.cbegin() + static_cast<std::ptrdiff_t>(first), names.cbegin() + static_cast<std::ptrdiff_t>(n),
+                                             [&name = names[n].name](const NameRef& other) { return equalsIgnoringCase(other.name, name); });
+          if (original == names.cbegin() + static_cast<std::ptrdiff_t>(n)) {
+            continue;
+          }
+          if (total.knownNamed) {
+            errors.push_back({names[n].offset, fmt::format("duplicate {} name '{}'", total.spelling, names[n].name), original->offset});
+          } else {
+            warnings.push_back({names[n].offset, fmt::format("'{}' repeats in {}, whose first field may not be a name", names[n].name,
+                                                             total.spelling),
+                                original->offset});
+          }
+        }
+        first = last;
+      }
+    }
+
+    // After a syntax error, objects may have merged: what seems missing may only be misplaced
+    if (syntaxOk) {
+      for (std::size_t r = 0; r < requiredTypes.size(); ++r) {
+        if (totals.find(std::string(requiredTypes[r])) == totals.cend()) {
+          errors.push_back({npos, fmt::format("no {} object, EnergyPlus requires one", requiredSpellings[r])});
+        }
+      }
+    }
+    if (totals.find("output:sqlite") == totals.cend()) {
+      warnings.push_back({npos, "no Output:SQLite object: the SQL and tabular reports will be empty, and so will the net site energy of sweeps"});
+    }
+
+    const auto byOffset = [](const RawIssue& a, const RawIssue& b) { return a.offset < b.offset; };
+    std::stable_sort(errors.begin(), errors.end(), byOffset);
+    std::stable_sort(warnings.begin(), warnings.end(), byOffset);
+    // The errors then the warnings, two offsets each
+    std::vector<std::size_t> offsets;
+    for (const auto* issues : {&errors, &warnings}) {
+      for (const auto& issue : *issues) {
+        offsets.push_back(issue.offset);
+        offsets.push_back(issue.firstOffset);
+      }
+    }
+    const auto lines = lineNumbers(text, offsets);
+
+    PreflightReport report;
+    std::size_t i = 0;
+    for (auto [issues, reported] : {std::pair(&errors, &report.errors), std::pair(&warnings, &report.warnings)}) {
+      for (auto& issue : *issues) {
+        if (issue.firstOffset != npos) {
+          issue.message += fmt::format(", first on line {}", lines[2 * i + 1]);
+        }
+        reported->push_back({lines[2 * i] == npos ? 0 : lines[2 * i], std::move(issue.message)});
+        ++i;
+      }
+    }
+    for (const auto& [type, total] : totals) {
+      report.objectCounts[std::string(total.spelling)] += total.count;
+    }
+    return report;
+  }
+}  // namespace
+
+std::string PreflightIssue::describe() const {
+  return line == 0 ? message : fmt::format("line {}: {}", line, message);
+}
+
+bool PreflightReport::ok() const {
+  return errors.empty();
+}
+
+std::size_t PreflightReport::numObjects() const {
+  std::size_t count = 0;
+  for (const auto& [type, typeCount] : objectCounts) {
+    count += typeCount;
+  }
+  return count;
+}
+
+std::string PreflightReport::errorSummary() const {
+  if (errors.empty()) {
+    return {};
+  }
+  if (errors.size() == 1) {
+    return errors.front().describe();
+  }
+  return fmt::format("{} (and {} more errors)", errors.front().describe(), errors.size() - 1);
+}
+
+PreflightReport preflight(std::string_view text, bool isEpJson) {
+  if (isEpJson) {
+    std::vector<ScanResult> parts;
+    parts.push_back(scanEpJson(text));
+    return finish(text, std::move(parts));
+  }
+  return finish(text, scanIdf(text));
+}
+
+PreflightReport preflightFile(const std::filesystem::path& path) {
+  const auto extension = utilities::ascii_to_lower_copy(path.extension().string());
+  if (extension == ".imf") {
+    return {};
+  }
+  const utilities::MappedFile file(path);
+  return preflight(file.view(), extension == ".epjson" || extension == ".json");
+}
+
+}  // namespace epcli
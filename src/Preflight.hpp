@@ -0,0 +1,57 @@
+#ifndef PREFLIGHT_HPP
+#define PREFLIGHT_HPP
+
+#include <cstddef>      // for size_t
+#include <filesystem>   // for path
+#include <map>          // for map
+#include <string>       // for string
+#include <string_view>  // for string_view
+#include <vector>       // for vector
+
+namespace epcli {
+
+struct PreflightIssue
+{
+  /// 1-based, 0 for an issue with the whole input (a missing object)
+  std::size_t line = 0;
+  std::string message;
+
+  /// "line <n>: <message>"
+  [[nodiscard]] std::string describe() const;
+};
+
+/// What a preflight found in an input
+struct PreflightReport
+{
+  /// The number of objects of each type, named as first written: types are case-insensitive in an IDF
+  std::map<std::string, std::size_t> objectCounts;
+  /// EnergyPlus would stop on these: syntax errors, duplicate names, missing required objects
+  std::vector<PreflightIssue> errors;
+  /// The run works, but not as epcli expects: no Output:SQLite for its reports. Or it may not: a repeated name in a type that may not be
+  /// named
+  std::vector<PreflightIssue> warnings;
+
+  [[nodiscard]] bool ok() const;
+  [[nodiscard]] std::size_t numObjects() const;
+  /// The first error and how many more, on one line, for a failed run or job
+  [[nodiscard]] std::string errorSummary() const;
+};
+
+/// Checks an input in milliseconds, before EnergyPlus spends seconds loading it, and before a run takes a worker. Without the IDD, only
+/// what doesn't depend on it is checked:
+///  - IDF: fields that run over several lines (a missing `,` or `;`), an object missing its type, a last object without its `;`
+///  - epJSON: the whole JSON syntax, stopping at the first error
+///  - both: duplicate object names within a type (a warning for the IDF types not known to be named, whose first field may be something
+///    else), the required Building and GlobalGeometryRules, Output:SQLite (a warning)
+///
+/// IDF inputs above a few MiB are scanned in parallel chunks, cut at object boundaries. Field values aren't copied, only object types and
+/// names are. Thread-safe
+PreflightReport preflight(std::string_view text, bool isEpJson);
+
+/// Maps the file rather than reading it, .epjson and .json being epJSON. .imf inputs aren't checked: their macros are only expanded by
+/// EPMacro, at the start of the run. Throws std::runtime_error if the file cannot be read
+PreflightReport preflightFile(const std::filesystem::path& path);
+
+}  // namespace epcli
+
+#endif  // PREFLIGHT_HPP
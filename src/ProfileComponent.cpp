@@ -0,0 +1,113 @@
+#include "ProfileComponent.hpp"
+
+#include "PhaseProfiler.hpp"  // for PhaseProfiler
+
+#include <ftxui/dom/elements.hpp>  // for text, separator, operator|, color, window, hbox, vbox, size, bgcolor
+#include <ftxui/screen/color.hpp>  // for Color
+
+#include <fmt/format.h>  // for format
+#include <fmt/std.h>     // for formatting std::filesystem::path // IWYU pragma: keep
+
+#include <algorithm>  // for max, min
+#include <chrono>     // for duration
+#include <string>     // for string
+
+namespace {
+constexpr int timelineWidth = 60;
+
+std::string formatSeconds(std::chrono::nanoseconds ns) {
+  return fmt::format("{:.3f} s", std::chrono::duration<double>(ns).count());
+}
+}  // namespace
+
+ProfileComponent::ProfileComponent(const epcli::PhaseProfiler* profiler) : m_profiler(profiler) {}
+
+Element ProfileComponent::Render() {
+  const auto snapshot = m_profiler->snapshot();
+  if (snapshot.phases.empty()) {
+    return text("No run profiled yet") | center;
+  }
+
+  size_t size_name = 20;
+  for (const auto& phase : snapshot.phases) {
+    size_name = std::max(size_name, phase.name.size());
+  }
+
+  auto header = hbox({
+    text("Phase") | ftxui::size(WIDTH, EQUAL, size_name),
+    separator(),
+    hcenter(text("Duration")) | ftxui::size(WIDTH, EQUAL, 12),
+    separator(),
+    hcenter(text("Share")) | ftxui::size(WIDTH, EQUAL, 7),
+    separator(),
+    hcenter(text("Timeline")) | ftxui::size(WIDTH, EQUAL, timelineWidth),
+    separator(),
+    hcenter(text("Zone TS")) | ftxui::size(WIDTH, EQUAL, 9),
+    separator(),
+    hcenter(text("Warmup days")) | ftxui::size(WIDTH, EQUAL, 12),
+  });
+
+  const double total = std::max(1.0, static_cast<double>(snapshot.total.count()));
+
+  Elements rowList;
+  rowList.reserve(snapshot.phases.size());
+  for (const auto& phase : snapshot.phases) {
+    const auto offset = static_cast<int>(static_cast<double>(phase.start.count()) / total * timelineWidth);
+    const int width = std::clamp(static_cast<int>(static_cast<double>(phase.duration.count()) / total * timelineWidth), 1, timelineWidth - offset);
+
+    Color barColor = Color::GrayLight;
+    if (phase.isWarmup) {
+      barColor = Color::Yellow;
+    } else if (phase.environment >= 0) {
+      barColor = Color::Green;
+    }
+
+    const bool slowWarmup = phase.isWarmup && phase.warmupDays >= epcli::PhaseProfiler::slowWarmupDays;
+
+    rowList.emplace_back(hbox({
+      text(phase.name) | ftxui::size(WIDTH, EQUAL, size_name),
+      separator(),
+      align_right(text(formatSeconds(phase.duration))) | ftxui::size(WIDTH, EQUAL, 12),
+      separator(),
+      align_right(text(fmt::format("{:.1f}%", 100.0 * static_cast<double>(phase.duration.count()) / total))) | ftxui::size(WIDTH, EQUAL, 7),
+      separator(),
+      hbox({
+        text("") | ftxui::size(WIDTH, EQUAL, offset),
+        text("") | bgcolor(barColor) | ftxui::size(WIDTH, EQUAL, width),
+      }) | ftxui::size(WIDTH, EQUAL, timelineWidth),
+      separator(),
+      align_right(text(std::to_string(phase.zoneTimeSteps))) | ftxui::size(WIDTH, EQUAL, 9),
+      separator(),
+      align_right(text(phase.isWarmup ? std::to_string(phase.warmupDays) : "")) | ftxui::size(WIDTH, EQUAL, 12) |
+        (slowWarmup ? color(Color::Red) : color(Color::Default)),
+    }));
+  }
+
+  Elements callbackRows;
+  for (size_t i = 0; i < epcli::PhaseProfiler::numCallbacks; ++i) {
+    callbackRows.emplace_back(hbox({
+      text(epcli::PhaseProfiler::callbackName(static_cast<epcli::PhaseProfiler::Callback>(i))),
+      filler(),
+      text(std::to_string(snapshot.callbackCounts[i])),
+    }));
+  }
+
+  const std::string status = snapshot.running ? "Running" : (snapshot.success ? "Done" : "Failed");
+  auto footer = hbox({
+    text(fmt::format("{}, total {}", status, formatSeconds(snapshot.total))),
+    filler(),
+    snapshot.running ? text("") : text(fmt::format("Summary written to {}", m_profiler->summaryPath())) | color(Color::GrayDark),
+  });
+
+  return vbox({
+    window(text("Phases"), vbox({
+                             header,
+                             separator(),
+                             vbox(rowList) | yframe | flex,
+                             separator(),
+                             footer,
+                           })) |
+      flex,
+    window(text("Callbacks"), vbox(callbackRows)) | ftxui::size(WIDTH, LESS_THAN, 60),
+  });
+}
@@ -0,0 +1,24 @@
+#ifndef PROFILE_COMPONENT_HPP
+#define PROFILE_COMPONENT_HPP
+
+#include <ftxui/component/component_base.hpp>  // for ComponentBase
+#include <ftxui/dom/elements.hpp>              // for Element
+
+namespace epcli {
+class PhaseProfiler;
+}
+
+using namespace ftxui;
+
+/// Timeline of the phases of the current (or last) run, as recorded by a PhaseProfiler
+class ProfileComponent : public ComponentBase
+{
+ public:
+  explicit ProfileComponent(const epcli::PhaseProfiler* profiler);
+  Element Render() override;
+
+ private:
+  const epcli::PhaseProfiler* m_profiler;
+};
+
+#endif  // PROFILE_COMPONENT_HPP
@@ -0,0 +1,61 @@
+#include "RuntimeMetrics.hpp"
+
+#include <algorithm>  // for min
+#include <vector>     // for vector
+
+namespace epcli {
+
+namespace {
+  using utilities::metrics::exponentialBuckets;
+
+  // 1us to ~0.26s
+  std::vector<double> callbackBuckets() {
+    return exponentialBuckets(1e-6, 4.0, 10);
+  }
+
+  std::vector<double> countBuckets() {
+    return {0, 1, 5, 10, 25, 50, 100, 250, 500, 1000};
+  }
+}  // namespace
+
+RuntimeMetrics::RuntimeMetrics()
+  : stdoutSent(registry.counter("epcli_messages_sent_total", "Messages sent by the EnergyPlus callbacks to the UI", {{"stream", "stdout"}})),
+    stdoutReceived(registry.counter("epcli_messages_received_total", "Messages received by the UI", {{"stream", "stdout"}})),
+    errorsSent(registry.counter("epcli_messages_sent_total", "Messages sent by the EnergyPlus callbacks to the UI", {{"stream", "error"}})),
+    errorsReceived(registry.counter("epcli_messages_received_total", "Messages received by the UI", {{"stream", "error"}})),
+    activeRuns(registry.gauge("epcli_active_runs", "EnergyPlus runs in progress")),
+    runsStarted(registry.counter("epcli_runs_started_total", "EnergyPlus runs started")),
+    runsCompleted(registry.counter("epcli_runs_completed_total", "EnergyPlus runs that completed successfully")),
+    runsFailed(registry.counter("epcli_runs_failed_total", "EnergyPlus runs that failed")),
+    runsStopped(registry.counter("epcli_runs_stopped_total", "EnergyPlus runs stopped by a termination policy, also counted as failed")),
+    runDuration(registry.histogram("epcli_run_duration_seconds", "Wall time of the EnergyPlus runs",
+                                   {1, 5, 10, 30, 60, 120, 300, 600, 1800, 3600})),
+    runWarnings(registry.histogram("epcli_run_warnings", "Warnings per EnergyPlus run", countBuckets())),
+    runSeveres(registry.histogram("epcli_run_severes", "Severe errors per EnergyPlus run", countBuckets())),
+    suppressedBelowLevel(registry.counter("epcli_messages_suppressed_total", "Messages dropped in the EnergyPlus callbacks, before the UI",
+                                          {{"reason", "level"}})),
+    suppressedRateLimited(registry.counter("epcli_messages_suppressed_total", "Messages dropped in the EnergyPlus callbacks, before the UI",
+                                           {{"reason", "rate_limit"}})),
+    suppressedSampledOut(registry.counter("epcli_messages_suppressed_total", "Messages dropped in the EnergyPlus callbacks, before the UI",
+                                          {{"reason", "sampling"}})),
+    stdoutCallbackDuration(registry.histogram("epcli_callback_duration_seconds", "Time spent in the EnergyPlus callbacks", callbackBuckets(),
+                                              {{"callback", "stdout"}})),
+    errorCallbackDuration(registry.histogram("epcli_callback_duration_seconds", "Time spent in the EnergyPlus callbacks", callbackBuckets(),
+                                             {{"callback", "error"}})),
+    progressCallbackDuration(registry.histogram("epcli_callback_duration_seconds", "Time spent in the EnergyPlus callbacks", callbackBuckets(),
+                                                {{"callback", "progress"}})) {
+
+  // Derived on scrape rather than maintained on each message
+  auto depth = [](const utilities::metrics::Counter& sent, const utilities::metrics::Counter& received) {
+    const auto numSent = sent.value();
+    return static_cast<double>(numSent - std::min(numSent, received.value()));
+  };
+  registry.gaugeCallback(
+    "epcli_queue_depth", "Messages sent but not yet received by the UI", [this, depth]() { return depth(stdoutSent, stdoutReceived); },
+    {{"stream", "stdout"}});
+  registry.gaugeCallback(
+    "epcli_queue_depth", "Messages sent but not yet received by the UI", [this, depth]() { return depth(errorsSent, errorsReceived); },
+    {{"stream", "error"}});
+}
+
+}  // namespace epcli
@@ -0,0 +1,53 @@
+#ifndef RUNTIME_METRICS_HPP
+#define RUNTIME_METRICS_HPP
+
+#include "utilities/Metrics.hpp"  // for Registry, Counter, Gauge, Histogram
+
+#include <atomic>   // for atomic
+#include <cstdint>  // for uint64_t
+
+namespace epcli {
+
+/// Metrics maintained along the hot paths of the message pipeline: the EnergyPlus callbacks (run thread) and MainComponent::OnEvent
+/// (UI thread). Each update is a relaxed atomic, without any lock. Receiver queue depths are sent - received.
+/// All of them live in the registry, which is what --metrics-file and --metrics-port expose
+struct RuntimeMetrics
+{
+  RuntimeMetrics();
+  RuntimeMetrics(const RuntimeMetrics&) = delete;
+  RuntimeMetrics& operator=(const RuntimeMetrics&) = delete;
+
+  utilities::metrics::Registry registry;
+
+  utilities::metrics::Counter& stdoutSent;
+  utilities::metrics::Counter& stdoutReceived;
+  utilities::metrics::Counter& errorsSent;
+  utilities::metrics::Counter& errorsReceived;
+  utilities::metrics::Gauge& activeRuns;
+
+  utilities::metrics::Counter& runsStarted;
+  utilities::metrics::Counter& runsCompleted;
+  utilities::metrics::Counter& runsFailed;
+  utilities::metrics::Counter& runsStopped;
+  utilities::metrics::Histogram& runDuration;
+  // Observed by MainComponent from its counters, once it received all the messages of a run
+  utilities::metrics::Histogram& runWarnings;
+  utilities::metrics::Histogram& runSeveres;
+
+  // Dropped by the CallbackFilter, per reason
+  utilities::metrics::Counter& suppressedBelowLevel;
+  utilities::metrics::Counter& suppressedRateLimited;
+  utilities::metrics::Counter& suppressedSampledOut;
+
+  // Time spent in the EnergyPlus callbacks, which the simulation waits on
+  utilities::metrics::Histogram& stdoutCallbackDuration;
+  utilities::metrics::Histogram& errorCallbackDuration;
+  utilities::metrics::Histogram& progressCallbackDuration;
+
+  /// Incremented (release) by the run thread once it sent everything for a run, so the UI thread knows when a run's messages are all in
+  std::atomic<std::uint64_t> runsFinished = 0;
+};
+
+}  // namespace epcli
+
+#endif  // RUNTIME_METRICS_HPP
@@ -0,0 +1,133 @@
+#include "TerminationPolicy.hpp"
+
+#include <EnergyPlus/api/datatransfer.h>  // for currentEnvironmentNum, currentTime, warmupFlag
+#include <EnergyPlus/api/runtime.h>       // for callbackBeginNewEnvironment, callbackAfterNewEnvironmentWarmupComplete, stopSimulation
+
+#include <fmt/format.h>  // for format
+
+#include <cstddef>  // for size_t
+#include <utility>  // for move
+
+namespace epcli {
+
+bool TerminationPolicy::enabled() const {
+  return maxSeveres > 0 || !errorPatterns.empty() || maxWarmupDays > 0 || maxWarmupTime.count() > 0 || maxRunTime.count() > 0;
+}
+
+TerminationGuard::TerminationGuard(TerminationPolicy policy) : m_policy(std::move(policy)) {
+  m_patterns.reserve(m_policy.errorPatterns.size());
+  for (const auto& pattern : m_policy.errorPatterns) {
+    m_patterns.emplace_back(pattern, std::regex::ECMAScript | std::regex::optimize);
+  }
+}
+
+void TerminationGuard::registerCallbacks(EnergyPlusState state) {
+  m_runStart = std::chrono::steady_clock::now();
+  m_inWarmup = false;
+  m_warmupDays = 0;
+  m_numSeveres = 0;
+  {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    m_reason.clear();
+    m_stoppedAfter = {};
+  }
+  m_triggered.store(false, std::memory_order_relaxed);
+
+  callbackBeginNewEnvironment(state, [this](EnergyPlusState /*s*/) {
+    m_inWarmup = true;
+    m_warmupStart = std::chrono::steady_clock::now();
+    m_warmupDays = 0;
+    // So the first warmup timestep counts as a day
+    m_lastCurrentTime = 24.0;
+  });
+  callbackAfterNewEnvironmentWarmupComplete(state, [this](EnergyPlusState /*s*/) { m_inWarmup = false; });
+  callbackEndOfZoneTimeStepAfterZoneReporting(state, [this](EnergyPlusState s) { onZoneTimeStep(s); });
+}
+
+void TerminationGuard::onError(EnergyPlusState state, EnergyPlus::Error level, const std::string& message) {
+  if (m_triggered.load(std::memory_order_relaxed)) {
+    return;
+  }
+  if (level == EnergyPlus::Error::Severe) {
+    ++m_numSeveres;
+    if (m_policy.maxSeveres > 0 && m_numSeveres >= m_policy.maxSeveres) {
+      stop(state, fmt::format("{} severe errors (--max-severes {})", m_numSeveres, m_policy.maxSeveres));
+      return;
+    }
+  }
+  if (level == EnergyPlus::Error::Warning || level == EnergyPlus::Error::Severe || level == EnergyPlus::Error::Fatal) {
+    for (std::size_t i = 0; i < m_patterns.size(); ++i) {
+      if (std::regex_search(message, m_patterns[i])) {
+        stop(state, fmt::format("error matching '{}' (--stop-on): {}", m_policy.errorPatterns[i], message));
+        return;
+      }
+    }
+  }
+  checkTime(state);
+}
+
+void TerminationGuard::onProgress(EnergyPlusState state) {
+  checkTime(state);
+}
+
+void TerminationGuard::onZoneTimeStep(EnergyPlusState state) {
+  if (m_triggered.load(std::memory_order_relaxed)) {
+    return;
+  }
+  if (m_inWarmup && warmupFlag(state) != 0) {
+    // As in PhaseProfiler: the time of day wrapping around is a new day, design days being repeated as is during warmup
+    const double time = currentTime(state);
+    if (time < m_lastCurrentTime) {
+      ++m_warmupDays;
+      if (m_policy.maxWarmupDays > 0 && m_warmupDays > m_policy.maxWarmupDays) {
+        stop(state, fmt::format("warmup of environment {} not converged after {} days (--max-warmup-days)", currentEnvironmentNum(state),
+                                m_policy.maxWarmupDays));
+        return;
+      }
+    }
+    m_lastCurrentTime = time;
+  }
+  checkTime(state);
+}
+
+void TerminationGuard::checkTime(EnergyPlusState state) {
+  if (m_triggered.load(std::memory_order_relaxed) || (m_policy.maxRunTime.count() == 0 && m_policy.maxWarmupTime.count() == 0)) {
+    return;
+  }
+  const auto now = std::chrono::steady_clock::now();
+  if (m_policy.maxRunTime.count() > 0 && now - m_runStart > m_policy.maxRunTime) {
+    stop(state, fmt::format("run longer than {}s (--max-run-time)", m_policy.maxRunTime.count()));
+  } else if (m_policy.maxWarmupTime.count() > 0 && m_inWarmup && now - m_warmupStart > m_policy.maxWarmupTime) {
+    stop(state, fmt::format("warmup of environment {} longer than {}s (--max-warmup-time)", currentEnvironmentNum(state),
+                            m_policy.maxWarmupTime.count()));
+  }
+}
+
+void TerminationGuard::stop(EnergyPlusState state, std::string reason) {
+  {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    m_reason = std::move(reason);
+    m_stoppedAfter = std::chrono::steady_clock::now() - m_runStart;
+  }
+  m_triggered.store(true, std::memory_order_relaxed);
+  stopSimulation(state);
+}
+
+bool TerminationGuard::triggered() const {
+  return m_triggered.load(std::memory_order_relaxed);
+}
+
+std::string TerminationGuard::reason() const {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  return m_reason;
+}
+
+std::string TerminationGuard::summary() const {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_reason.empty()) {
+    return {};
+  }
+  return fmt::format("Run stopped by epcli after {:.1f}s: {}", std::chrono::duration<double>(m_stoppedAfter).count(), m_reason);
+}
+
+}  // namespace epcli
@@ -0,0 +1,78 @@
+#ifndef TERMINATION_POLICY_HPP
+#define TERMINATION_POLICY_HPP
+
+#include <EnergyPlus/api/TypeDefs.h>  // for Error
+#include <EnergyPlus/api/state.h>     // for EnergyPlusState
+
+#include <atomic>  // for atomic
+#include <chrono>  // for steady_clock, seconds
+#include <mutex>   // for mutex
+#include <regex>   // for regex
+#include <string>  // for string
+#include <vector>  // for vector
+
+namespace epcli {
+
+/// When to give up on a run that is doomed anyway. Zero means no limit
+struct TerminationPolicy
+{
+  unsigned maxSeveres = 0;
+  /// ECMAScript regexes, searched in each Warning, Severe and Fatal message
+  std::vector<std::string> errorPatterns;
+  /// Warmup days of a single environment: EnergyPlus only gives up on convergence at 25 by default
+  int maxWarmupDays = 0;
+  /// Wall time of the warmup of a single environment, and of the whole run
+  std::chrono::seconds maxWarmupTime{0};
+  std::chrono::seconds maxRunTime{0};
+
+  [[nodiscard]] bool enabled() const;
+};
+
+/// Evaluates a TerminationPolicy from the EnergyPlus callbacks, and calls stopSimulation once one of its limits is hit: the run ends at the
+/// next timestep and energyplus() returns 1. The callbacks run on the EnergyPlus thread, triggered() and reason() can be called from any
+class TerminationGuard
+{
+ public:
+  /// Throws std::runtime_error (std::regex_error) if a pattern isn't a valid regex
+  explicit TerminationGuard(TerminationPolicy policy);
+
+  /// To be called on a fresh state, before energyplus(): resets the guard and registers the environment and timestep callbacks, which
+  /// track the warmup and check the time limits
+  void registerCallbacks(EnergyPlusState state);
+
+  /// From the error callback, with every error: before any filtering
+  void onError(EnergyPlusState state, EnergyPlus::Error level, const std::string& message);
+  /// From the progress callback
+  void onProgress(EnergyPlusState state);
+
+  [[nodiscard]] bool triggered() const;
+  /// Why the run was stopped, empty if it wasn't
+  [[nodiscard]] std::string reason() const;
+  /// For the run output once energyplus() returned, empty if the run wasn't stopped
+  [[nodiscard]] std::string summary() const;
+
+ private:
+  void checkTime(EnergyPlusState state);
+  void onZoneTimeStep(EnergyPlusState state);
+  void stop(EnergyPlusState state, std::string reason);
+
+  TerminationPolicy m_policy;
+  std::vector<std::regex> m_patterns;
+
+  std::chrono::steady_clock::time_point m_runStart;
+  std::chrono::steady_clock::time_point m_warmupStart;
+  bool m_inWarmup = false;
+  int m_warmupDays = 0;
+  double m_lastCurrentTime = 24.0;
+  unsigned m_numSeveres = 0;
+
+  // Checked first by every callback, without the lock
+  std::atomic<bool> m_triggered = false;
+  mutable std::mutex m_mutex;
+  std::string m_reason;
+  std::chrono::steady_clock::duration m_stoppedAfter{0};
+};
+
+}  // namespace epcli
+
+#endif  // TERMINATION_POLICY_HPP
@@ -0,0 +1,121 @@
+#include "TimeSeriesComponent.hpp"
+
+#include "VariableSampler.hpp"  // for VariableSampler
+
+#include <ftxui/component/component.hpp>  // for Radiobox
+#include <ftxui/dom/elements.hpp>         // for text, graph, window, hbox, vbox, separator, operator|, color, flex, size
+#include <ftxui/screen/color.hpp>         // for Color
+
+#include <fmt/chrono.h>  // for formatting std::chrono::duration // IWYU pragma: keep
+#include <fmt/format.h>  // for format
+
+#include <algorithm>  // for min, max
+#include <cmath>      // for isnan, lround
+#include <limits>     // for numeric_limits
+#include <utility>    // for move
+
+Element renderTimeSeriesChart(const std::vector<double>& times, const std::vector<double>& values, Element details) {
+  double minValue = std::numeric_limits<double>::max();
+  double maxValue = std::numeric_limits<double>::lowest();
+  for (const double value : values) {
+    if (!std::isnan(value)) {
+      minValue = std::min(minValue, value);
+      maxValue = std::max(maxValue, value);
+    }
+  }
+  if (minValue > maxValue) {
+    return text("No valid samples") | center;
+  }
+  const double range = (maxValue > minValue) ? (maxValue - minValue) : 1.0;
+
+  // Each of the width columns is the mean of its bucket of samples
+  auto plot = [&values, minValue, range](int width, int height) {
+    std::vector<int> output(std::max(width, 0), 0);
+    const size_t n = values.size();
+    for (int x = 0; x < width; ++x) {
+      const size_t begin = n * x / width;
+      const size_t end = std::max(begin + 1, n * (x + 1) / width);
+      double sum = 0.0;
+      int count = 0;
+      for (size_t i = begin; i < std::min(end, n); ++i) {
+        if (!std::isnan(values[i])) {
+          sum += values[i];
+          ++count;
+        }
+      }
+      if (count > 0) {
+        output[x] = static_cast<int>(std::lround((sum / count - minValue) / range * (height - 1)));
+      }
+    }
+    return output;
+  };
+
+  auto footer = hbox({
+    text(fmt::format("Last: {:.2f}", values.back())),
+    separator(),
+    text(fmt::format("Min: {:.2f}", minValue)),
+    separator(),
+    text(fmt::format("Max: {:.2f}", maxValue)),
+    separator(),
+    text(fmt::format("Hours {:.2f} to {:.2f}", times.front(), times.back())),
+    filler(),
+    std::move(details),
+  });
+
+  return vbox({
+    hbox({
+      vbox({
+        text(fmt::format("{:.2f}", maxValue)),
+        filler(),
+        text(fmt::format("{:.2f}", minValue)),
+      }),
+      separator(),
+      graph(std::move(plot)) | color(Color::BlueLight) | flex,
+    }) | flex,
+    separator(),
+    footer,
+  });
+}
+
+TimeSeriesComponent::TimeSeriesComponent(const epcli::VariableSampler* sampler) : m_sampler(sampler) {
+  if (m_sampler != nullptr) {
+    for (const auto& variable : m_sampler->variables()) {
+      m_variableLabels.emplace_back(fmt::format("{}, {}", variable.name, variable.key));
+    }
+  }
+  m_variableSelector = Radiobox(&m_variableLabels, &m_selectedVariable);
+  Add(m_variableSelector);
+}
+
+Element TimeSeriesComponent::RenderChart() {
+  const auto column = static_cast<size_t>(m_selectedVariable);
+  if (m_sampler->handlesResolved() && !m_sampler->isValid(column)) {
+    return text(fmt::format("'{}' was not found by EnergyPlus", m_variableLabels[column])) | color(Color::Red) | center;
+  }
+
+  m_sampler->buffer().copyColumn(column, m_times, m_values, m_sampler->buffer().capacity());
+  if (m_values.empty()) {
+    return text("Waiting for the first sample after warmup...") | center;
+  }
+
+  return renderTimeSeriesChart(m_times, m_values,
+                               text(fmt::format("{} samples ({} buffered), {} per sample", m_sampler->buffer().totalPushed(), m_values.size(),
+                                                m_sampler->averageSampleCost())) |
+                                 color(Color::GrayDark));
+}
+
+Element TimeSeriesComponent::Render() {
+  if (m_sampler == nullptr || m_variableLabels.empty()) {
+    return vbox({
+             text("No variables to sample. Pass them on the command line, before the input file:"),
+             separator(),
+             text("  epcli --variable \"Zone Mean Air Temperature,ZONE ONE\" --variable \"Site Outdoor Air Drybulb Temperature,Environment\" in.idf"),
+           }) |
+           center;
+  }
+
+  return hbox({
+    window(text("Variables"), m_variableSelector->Render() | vscroll_indicator | frame) | ftxui::size(WIDTH, LESS_THAN, 60),
+    window(text(m_variableLabels[m_selectedVariable]), RenderChart()) | flex,
+  });
+}
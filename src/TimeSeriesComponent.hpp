@@ -0,0 +1,41 @@
+#ifndef TIME_SERIES_COMPONENT_HPP
+#define TIME_SERIES_COMPONENT_HPP
+
+#include <ftxui/component/component_base.hpp>  // for ComponentBase, Component
+#include <ftxui/dom/elements.hpp>              // for Element
+
+#include <string>  // for string
+#include <vector>  // for vector
+
+namespace epcli {
+class VariableSampler;
+}
+
+using namespace ftxui;
+
+/// A chart of values against times (in hours), scaled to the range of the values, with their last, min and max below, and details on the
+/// right. NaNs are skipped, values must not be empty, and both vectors must outlive the element
+Element renderTimeSeriesChart(const std::vector<double>& times, const std::vector<double>& values, Element details);
+
+/// Live chart of the variables sampled by a VariableSampler, refreshed on every frame while the simulation runs
+class TimeSeriesComponent : public ComponentBase
+{
+ public:
+  explicit TimeSeriesComponent(const epcli::VariableSampler* sampler);
+  Element Render() override;
+
+ private:
+  Element RenderChart();
+
+  const epcli::VariableSampler* m_sampler;
+
+  std::vector<std::string> m_variableLabels;
+  int m_selectedVariable = 0;
+  Component m_variableSelector;
+
+  // Reused across frames
+  std::vector<double> m_times;
+  std::vector<double> m_values;
+};
+
+#endif  // TIME_SERIES_COMPONENT_HPP
@@ -0,0 +1,115 @@
+#include "VariableSampler.hpp"
+
+#include "utilities/ASCIIStrings.hpp"  // for ascii_trim
+#include "utilities/Trace.hpp"         // for EPCLI_TRACE_SCOPE
+
+#include <EnergyPlus/api/datatransfer.h>  // for requestVariable, getVariableHandle, getVariableValue, apiDataFullyReady, warmupFlag
+#include <EnergyPlus/api/runtime.h>       // for callbackBeginNewEnvironment, callbackAfterNewEnvironmentWarmupComplete, callbackEndOf*
+
+#include <fmt/format.h>  // for format
+
+#include <algorithm>  // for fill
+#include <chrono>     // for steady_clock, duration_cast
+#include <limits>     // for numeric_limits
+#include <stdexcept>  // for runtime_error
+#include <utility>    // for move
+
+namespace epcli {
+
+OutputVariable OutputVariable::parse(std::string_view nameAndKey) {
+  const auto comma = nameAndKey.find(',');
+  if (comma == std::string_view::npos) {
+    throw std::runtime_error(fmt::format("Expected 'Variable Name,Key Value', got '{}'", nameAndKey));
+  }
+  return {std::string(utilities::ascii_trim(nameAndKey.substr(0, comma))), std::string(utilities::ascii_trim(nameAndKey.substr(comma + 1)))};
+}
+
+VariableSampler::VariableSampler(std::vector<OutputVariable> variables, std::size_t capacity)
+  : m_variables(std::move(variables)),
+    m_handles(m_variables.size(), -1),
+    m_row(m_variables.size()),
+    m_buffer(m_variables.size(), capacity) {}
+
+void VariableSampler::registerCallbacks(EnergyPlusState state) {
+  if (m_variables.empty()) {
+    return;
+  }
+
+  for (const auto& variable : m_variables) {
+    requestVariable(state, variable.name.c_str(), variable.key.c_str());
+  }
+
+  // Capturing lambdas: captureless ones would be ambiguous between the function pointer and std::function overloads
+  // Sizing periods and the run period each restart the clock: a chart only makes sense of one environment at a time
+  callbackBeginNewEnvironment(state, [this](EnergyPlusState /*s*/) { m_buffer.clear(); });
+  callbackAfterNewEnvironmentWarmupComplete(state, [this](EnergyPlusState s) {
+    if (!m_handlesResolved.load(std::memory_order_relaxed)) {
+      resolveHandles(s);
+    }
+  });
+  callbackEndOfZoneTimeStepAfterZoneReporting(state, [this](EnergyPlusState s) { sample(s); });
+}
+
+void VariableSampler::resolveHandles(EnergyPlusState state) {
+  if (apiDataFullyReady(state) == 0) {
+    return;
+  }
+  for (std::size_t i = 0; i < m_variables.size(); ++i) {
+    m_handles[i] = getVariableHandle(state, m_variables[i].name.c_str(), m_variables[i].key.c_str());
+  }
+  m_handlesResolved.store(true, std::memory_order_release);
+}
+
+void VariableSampler::sample(EnergyPlusState state) {
+  if (!m_handlesResolved.load(std::memory_order_relaxed) || warmupFlag(state) != 0) {
+    return;
+  }
+  EPCLI_TRACE_SCOPE("VariableSampler::sample");
+
+  const auto start = std::chrono::steady_clock::now();
+
+  for (std::size_t i = 0; i < m_handles.size(); ++i) {
+    m_row[i] = (m_handles[i] >= 0) ? getVariableValue(state, m_handles[i]) : std::numeric_limits<double>::quiet_NaN();
+  }
+  // Hours since the start of the year
+  const double time = (dayOfYear(state) - 1) * 24.0 + currentTime(state);
+  m_buffer.push(time, m_row);
+
+  const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+  m_sampleNanoseconds.fetch_add(elapsed.count(), std::memory_order_relaxed);
+  m_numSamples.fetch_add(1, std::memory_order_relaxed);
+}
+
+void VariableSampler::reset() {
+  m_buffer.clear();
+  std::fill(m_handles.begin(), m_handles.end(), -1);
+  m_handlesResolved = false;
+  m_sampleNanoseconds = 0;
+  m_numSamples = 0;
+}
+
+const std::vector<OutputVariable>& VariableSampler::variables() const {
+  return m_variables;
+}
+
+const utilities::ColumnarRingBuffer& VariableSampler::buffer() const {
+  return m_buffer;
+}
+
+bool VariableSampler::handlesResolved() const {
+  return m_handlesResolved.load(std::memory_order_acquire);
+}
+
+bool VariableSampler::isValid(std::size_t index) const {
+  return handlesResolved() && m_handles[index] >= 0;
+}
+
+std::chrono::nanoseconds VariableSampler::averageSampleCost() const {
+  const auto numSamples = m_numSamples.load(std::memory_order_relaxed);
+  if (numSamples == 0) {
+    return std::chrono::nanoseconds{0};
+  }
+  return std::chrono::nanoseconds{m_sampleNanoseconds.load(std::memory_order_relaxed) / static_cast<std::int64_t>(numSamples)};
+}
+
+}  // namespace epcli
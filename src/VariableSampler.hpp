@@ -0,0 +1,75 @@
+#ifndef VARIABLE_SAMPLER_HPP
+#define VARIABLE_SAMPLER_HPP
+
+#include "utilities/ColumnarRingBuffer.hpp"  // for ColumnarRingBuffer
+
+#include <EnergyPlus/api/state.h>  // for EnergyPlusState
+
+#include <atomic>       // for atomic
+#include <chrono>       // for nanoseconds
+#include <cstddef>      // for size_t
+#include <cstdint>      // for int64_t, uint64_t
+#include <string>       // for string
+#include <string_view>  // for string_view
+#include <vector>       // for vector
+
+namespace epcli {
+
+/// An Output:Variable to sample, eg: {"Zone Mean Air Temperature", "ZONE ONE"}
+struct OutputVariable
+{
+  std::string name;
+  std::string key;
+
+  /// Parses "Name,Key", throws std::runtime_error if there is no comma
+  static OutputVariable parse(std::string_view nameAndKey);
+};
+
+/// Samples output variables at each zone timestep while the simulation runs, through the data exchange API.
+/// Handles are resolved once after the first warmup, and each sample is a single row written into a preallocated ring buffer, so the cost
+/// per timestep is one getVariableValue per variable. Warmup days are skipped, and the buffer is cleared at the start of each environment,
+/// whose times would overlap those of the previous one: it holds the samples of the current design day or run period.
+/// The callbacks run on the EnergyPlus thread, everything else is meant to be called from the UI thread
+class VariableSampler
+{
+ public:
+  // A year of 15-minute timesteps
+  static constexpr std::size_t defaultCapacity = 365 * 24 * 4;
+
+  explicit VariableSampler(std::vector<OutputVariable> variables, std::size_t capacity = defaultCapacity);
+
+  /// To be called on a fresh state, before energyplus(): requests the variables so they get set up even if the input file doesn't have
+  /// matching Output:Variable objects, and registers the sampling callbacks
+  void registerCallbacks(EnergyPlusState state);
+
+  /// Clears the samples and handles, before starting a new run. Not to be called while a run is in progress
+  void reset();
+
+  [[nodiscard]] const std::vector<OutputVariable>& variables() const;
+  [[nodiscard]] const utilities::ColumnarRingBuffer& buffer() const;
+
+  [[nodiscard]] bool handlesResolved() const;
+  /// Whether EnergyPlus found the variable, only meaningful once handlesResolved()
+  [[nodiscard]] bool isValid(std::size_t index) const;
+
+  /// Mean wall time spent in the sampling callback
+  [[nodiscard]] std::chrono::nanoseconds averageSampleCost() const;
+
+ private:
+  void resolveHandles(EnergyPlusState state);
+  void sample(EnergyPlusState state);
+
+  std::vector<OutputVariable> m_variables;
+  std::vector<int> m_handles;
+  // Scratch row, so sampling doesn't allocate
+  std::vector<double> m_row;
+  utilities::ColumnarRingBuffer m_buffer;
+
+  std::atomic<bool> m_handlesResolved = false;
+  std::atomic<std::int64_t> m_sampleNanoseconds = 0;
+  std::atomic<std::uint64_t> m_numSamples = 0;
+};
+
+}  // namespace epcli
+
+#endif  // VARIABLE_SAMPLER_HPP
@@ -0,0 +1,124 @@
+#include "WeatherComponent.hpp"
+
+#include "weather/WeatherData.hpp"  // for WeatherData, MonthlyStats, DesignConditions, DegreeDays
+
+#include <ftxui/dom/elements.hpp>  // for text, separator, operator|, color, window, hbox, vbox, size, align_right, filler, center
+#include <ftxui/screen/color.hpp>  // for Color
+
+#include <fmt/format.h>  // for format
+#include <fmt/std.h>     // for formatting std::filesystem::path // IWYU pragma: keep
+
+#include <array>      // for array
+#include <cmath>      // for isnan
+#include <cstddef>    // for size_t
+#include <exception>  // for exception
+#include <string>     // for string
+#include <utility>    // for move
+
+namespace {
+constexpr double degreeDayBase = 18.0;
+constexpr std::array<const char*, 12> monthNames = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+constexpr int columnWidth = 11;
+
+Element cell(double value, int decimals = 1) {
+  return align_right(text(std::isnan(value) ? std::string("-") : fmt::format("{:.{}f}", value, decimals))) | ftxui::size(WIDTH, EQUAL, columnWidth);
+}
+
+Element labelled(const std::string& label, const std::string& value) {
+  return hbox({text(label) | ftxui::size(WIDTH, EQUAL, 22), text(value)});
+}
+}  // namespace
+
+WeatherComponent::WeatherComponent(std::filesystem::path epwPath) : m_epwPath(std::move(epwPath)) {}
+
+WeatherComponent::~WeatherComponent() = default;
+
+void WeatherComponent::reset() {
+  m_data.reset();
+  m_error.clear();
+  m_design = {};
+  m_degreeDays = {};
+  m_monthly = {};
+}
+
+Element WeatherComponent::Render() {
+  if (m_epwPath.empty()) {
+    return text("No weather file: pass one with -w <file.epw>") | center;
+  }
+  if (!m_data && m_error.empty()) {
+    try {
+      m_data = weather::WeatherData::open(m_epwPath);
+      m_design = m_data->designConditions();
+      m_degreeDays = m_data->degreeDays(degreeDayBase);
+      m_monthly = m_data->monthlyStats();
+    } catch (const std::exception& e) {
+      m_data.reset();
+      m_error = e.what();
+    }
+  }
+  if (!m_data) {
+    return text(m_error) | color(Color::Red) | center;
+  }
+
+  const auto& location = m_data->location();
+  const auto& design = m_design;
+  const auto& degreeDays = m_degreeDays;
+
+  auto summary = vbox({
+    labelled("Location", fmt::format("{}, {}, {} (WMO {})", location.city, location.region, location.country, location.wmo)),
+    labelled("Coordinates", fmt::format("{:.2f}, {:.2f}, {:.0f} m, UTC{:+g}", location.latitude, location.longitude, location.elevation,
+                                        location.timeZone)),
+    labelled("Records", fmt::format("{} ({} per hour)", m_data->numRecords(), m_data->recordsPerHour())),
+    separator(),
+    labelled("Heating 99.6% / 99%", fmt::format("{:.1f} C / {:.1f} C", design.heating99_6, design.heating99_0)),
+    labelled("Cooling 0.4% / 1%", fmt::format("{:.1f} C / {:.1f} C", design.cooling0_4, design.cooling1_0)),
+    labelled("Minimum / maximum", fmt::format("{:.1f} C / {:.1f} C", design.minimum, design.maximum)),
+    labelled(fmt::format("Degree-days base {:g} C", degreeDayBase), fmt::format("{:.0f} heating, {:.0f} cooling", degreeDays.heating,
+                                                                                 degreeDays.cooling)),
+  });
+
+  auto header = hbox({
+    text("Month") | ftxui::size(WIDTH, EQUAL, 6),
+    separator(),
+    align_right(text("Mean C")) | ftxui::size(WIDTH, EQUAL, columnWidth),
+    align_right(text("Min C")) | ftxui::size(WIDTH, EQUAL, columnWidth),
+    align_right(text("Max C")) | ftxui::size(WIDTH, EQUAL, columnWidth),
+    separator(),
+    align_right(text("RH %")) | ftxui::size(WIDTH, EQUAL, columnWidth),
+    align_right(text("GHI kWh/m2")) | ftxui::size(WIDTH, EQUAL, columnWidth),
+    align_right(text("Wind m/s")) | ftxui::size(WIDTH, EQUAL, columnWidth),
+  });
+
+  Elements rowList;
+  const auto& monthly = m_monthly;
+  for (std::size_t m = 0; m < monthly.size(); ++m) {
+    const auto& month = monthly[m];
+    if (month.numRecords == 0) {
+      continue;
+    }
+    rowList.emplace_back(hbox({
+      text(monthNames[m]) | ftxui::size(WIDTH, EQUAL, 6),
+      separator(),
+      cell(month.meanDryBulb),
+      cell(month.minDryBulb) | color(Color::Blue),
+      cell(month.maxDryBulb) | color(Color::Red),
+      separator(),
+      cell(month.meanRelativeHumidity, 0),
+      cell(month.globalHorizontal, 0),
+      cell(month.meanWindSpeed),
+    }));
+  }
+
+  return vbox({
+    window(text(m_epwPath.filename().string()), summary),
+    window(text("Monthly"), vbox({
+                              header,
+                              separator(),
+                              vbox(rowList) | yframe,
+                            })),
+    hbox({
+      filler(),
+      text(m_data->fromCache() ? "From the weather cache" : "Parsed into the weather cache") | color(Color::GrayDark),
+    }),
+  });
+}
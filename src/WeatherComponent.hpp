@@ -0,0 +1,38 @@
+#ifndef WEATHER_COMPONENT_HPP
+#define WEATHER_COMPONENT_HPP
+
+#include "weather/WeatherData.hpp"  // for WeatherData, DesignConditions, DegreeDays, MonthlyStats
+
+#include <ftxui/component/component_base.hpp>  // for ComponentBase
+#include <ftxui/dom/elements.hpp>              // for Element
+
+#include <array>       // for array
+#include <filesystem>  // for path
+#include <memory>      // for unique_ptr
+#include <string>      // for string
+
+using namespace ftxui;
+
+/// Location, design conditions, degree-days and monthly statistics of the weather file of the run (-w), from the shared weather cache
+class WeatherComponent : public ComponentBase
+{
+ public:
+  /// epwPath is empty if the run has no weather file
+  explicit WeatherComponent(std::filesystem::path epwPath);
+  ~WeatherComponent() override;
+  Element Render() override;
+
+  /// Drops the loaded data, so that an edited weather file is read again on the next Render
+  void reset();
+
+ private:
+  std::filesystem::path m_epwPath;
+  std::unique_ptr<weather::WeatherData> m_data;
+  std::string m_error;
+  // Computed once, when m_data is opened, rather than at each frame: the design conditions sort the whole dry-bulb column
+  weather::DesignConditions m_design;
+  weather::DegreeDays m_degreeDays;
+  std::array<weather::MonthlyStats, 12> m_monthly{};
+};
+
+#endif  // WEATHER_COMPONENT_HPP
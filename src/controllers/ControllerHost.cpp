@@ -0,0 +1,221 @@
+#include "ControllerHost.hpp"
+
+#include "../utilities/Trace.hpp"  // for EPCLI_TRACE_SCOPE
+
+#include <EnergyPlus/api/datatransfer.h>  // for requestVariable, get*Handle, get*Value, setActuatorValue, resetActuator, apiDataFullyReady
+#include <EnergyPlus/api/runtime.h>       // for callbackBeginSystemTimestepBeforePredictor, issueSevere
+
+#include <fmt/chrono.h>  // for formatting std::chrono::duration // IWYU pragma: keep
+#include <fmt/format.h>  // for format
+
+#include <algorithm>  // for fill
+#include <cmath>      // for isnan
+#include <limits>     // for numeric_limits
+#include <stdexcept>  // for runtime_error
+#include <utility>    // for move
+
+namespace epcli {
+
+ControllerHost::ControllerHost(const std::filesystem::path& libraryPath) : m_library(libraryPath) {
+  auto* entryPoint = reinterpret_cast<EpcliControllerEntryPoint>(  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    m_library.symbol(EPCLI_CONTROLLER_ENTRY_POINT));
+  if (entryPoint == nullptr) {
+    throw std::runtime_error(fmt::format("'{}' does not export {}", libraryPath.string(), EPCLI_CONTROLLER_ENTRY_POINT));
+  }
+  m_controller = entryPoint();
+  if (m_controller == nullptr || m_controller->apiVersion != EPCLI_CONTROLLER_API_VERSION) {
+    throw std::runtime_error(fmt::format("'{}' was built against an incompatible controller API version (expected {})", libraryPath.string(),
+                                         EPCLI_CONTROLLER_API_VERSION));
+  }
+  if (m_controller->step == nullptr || (m_controller->numSensors > 0 && m_controller->sensors == nullptr) ||
+      (m_controller->numActuators > 0 && m_controller->actuators == nullptr)) {
+    throw std::runtime_error(fmt::format("'{}' returned an incomplete controller description", libraryPath.string()));
+  }
+
+  m_invalidEntries = invalidEntries(*m_controller);
+
+  m_sensors.resize(m_controller->numSensors, SensorSlot{EPCLI_SENSOR_VARIABLE, -1});
+  m_actuatorHandles.resize(m_controller->numActuators, -1);
+  m_actuatorActive.resize(m_controller->numActuators, 0);
+  m_inputs.resize(m_controller->numSensors);
+  m_outputs.resize(m_controller->numActuators);
+}
+
+std::string ControllerHost::invalidEntries(const EpcliController& controller) {
+  // The EnergyPlus API builds std::strings from all of these, a null one would crash the run
+  std::string invalid;
+  for (size_t i = 0; i < controller.numSensors; ++i) {
+    const auto& sensor = controller.sensors[i];
+    const bool needsKey = sensor.kind == EPCLI_SENSOR_VARIABLE || sensor.kind == EPCLI_SENSOR_INTERNAL_VARIABLE;
+    if (sensor.kind != EPCLI_SENSOR_VARIABLE && sensor.kind != EPCLI_SENSOR_METER && sensor.kind != EPCLI_SENSOR_INTERNAL_VARIABLE) {
+      invalid += fmt::format(" sensor #{} has an unknown kind {};", i, static_cast<int>(sensor.kind));
+    } else if (sensor.name == nullptr || (needsKey && sensor.key == nullptr)) {
+      invalid += fmt::format(" sensor #{} has no {};", i, (sensor.name == nullptr) ? "name" : "key");
+    }
+  }
+  for (size_t i = 0; i < controller.numActuators; ++i) {
+    const auto& actuator = controller.actuators[i];
+    if (actuator.componentType == nullptr || actuator.controlType == nullptr || actuator.key == nullptr) {
+      invalid += fmt::format(" actuator #{} has no component type, control type or key;", i);
+    }
+  }
+  return invalid;
+}
+
+ControllerHost::~ControllerHost() {
+  endRun();
+}
+
+std::string ControllerHost::name() const {
+  return (m_controller->name != nullptr) ? m_controller->name : m_library.path().filename().string();
+}
+
+void ControllerHost::registerCallbacks(EnergyPlusState state) {
+  endRun();
+  m_status = Status::Unresolved;
+  m_disabledReason.clear();
+  std::fill(m_actuatorActive.begin(), m_actuatorActive.end(), 0);
+  m_stepNanoseconds = 0;
+  m_numSteps = 0;
+
+  // Still registers the timestep callback, so that the first step disables the controller with a Severe
+  if (m_invalidEntries.empty()) {
+    for (size_t i = 0; i < m_controller->numSensors; ++i) {
+      const auto& sensor = m_controller->sensors[i];
+      if (sensor.kind == EPCLI_SENSOR_VARIABLE) {
+        requestVariable(state, sensor.name, sensor.key);
+      }
+    }
+
+    if (m_controller->create != nullptr) {
+      m_instance = m_controller->create();
+    }
+  }
+
+  callbackBeginSystemTimestepBeforePredictor(state, [this](EnergyPlusState s) { step(s); });
+}
+
+void ControllerHost::endRun() {
+  if (m_instance != nullptr && m_controller->destroy != nullptr) {
+    m_controller->destroy(m_instance);
+  }
+  m_instance = nullptr;
+}
+
+void ControllerHost::resolveHandles(EnergyPlusState state) {
+  if (!m_invalidEntries.empty()) {
+    disable(state, "invalid descriptions:" + m_invalidEntries);
+    return;
+  }
+  if (apiDataFullyReady(state) == 0) {
+    return;
+  }
+
+  std::string missing;
+  for (size_t i = 0; i < m_controller->numSensors; ++i) {
+    const auto& sensor = m_controller->sensors[i];
+    int handle = -1;
+    switch (sensor.kind) {
+      case EPCLI_SENSOR_VARIABLE:
+        handle = getVariableHandle(state, sensor.name, sensor.key);
+        break;
+      case EPCLI_SENSOR_METER:
+        handle = getMeterHandle(state, sensor.name);
+        break;
+      case EPCLI_SENSOR_INTERNAL_VARIABLE:
+        handle = getInternalVariableHandle(state, sensor.name, sensor.key);
+        break;
+    }
+    if (handle < 0) {
+      missing += fmt::format(" sensor '{}, {}';", sensor.name, (sensor.key != nullptr) ? sensor.key : "");
+    }
+    m_sensors[i] = SensorSlot{sensor.kind, handle};
+  }
+
+  for (size_t i = 0; i < m_controller->numActuators; ++i) {
+    const auto& actuator = m_controller->actuators[i];
+    m_actuatorHandles[i] = getActuatorHandle(state, actuator.componentType, actuator.controlType, actuator.key);
+    if (m_actuatorHandles[i] < 0) {
+      missing += fmt::format(" actuator '{}, {}, {}';", actuator.componentType, actuator.controlType, actuator.key);
+    }
+  }
+
+  if (!missing.empty()) {
+    disable(state, "could not resolve" + missing);
+    return;
+  }
+  m_status = Status::Active;
+}
+
+void ControllerHost::disable(EnergyPlusState state, std::string reason) {
+  m_disabledReason = std::move(reason);
+  m_status = Status::Disabled;
+  const std::string message = fmt::format("Controller '{}' is disabled, {}", name(), m_disabledReason);
+  issueSevere(state, message.c_str());
+}
+
+void ControllerHost::step(EnergyPlusState state) {
+  if (m_status == Status::Unresolved) {
+    resolveHandles(state);
+  }
+  if (m_status != Status::Active) {
+    return;
+  }
+  EPCLI_TRACE_SCOPE("ControllerHost::step");
+
+  const auto start = std::chrono::steady_clock::now();
+
+  for (size_t i = 0; i < m_sensors.size(); ++i) {
+    const auto& sensor = m_sensors[i];
+    switch (sensor.kind) {
+      case EPCLI_SENSOR_VARIABLE:
+        m_inputs[i] = getVariableValue(state, sensor.handle);
+        break;
+      case EPCLI_SENSOR_METER:
+        m_inputs[i] = getMeterValue(state, sensor.handle);
+        break;
+      case EPCLI_SENSOR_INTERNAL_VARIABLE:
+        m_inputs[i] = getInternalVariableValue(state, sensor.handle);
+        break;
+    }
+  }
+
+  const EpcliStepInfo info{(dayOfYear(state) - 1) * 24.0 + currentTime(state), systemTimeStep(state), warmupFlag(state), kindOfSim(state)};
+  std::fill(m_outputs.begin(), m_outputs.end(), std::numeric_limits<double>::quiet_NaN());
+  m_controller->step(m_instance, &info, m_inputs.data(), m_outputs.data());
+
+  for (size_t i = 0; i < m_outputs.size(); ++i) {
+    if (!std::isnan(m_outputs[i])) {
+      setActuatorValue(state, m_actuatorHandles[i], m_outputs[i]);
+      m_actuatorActive[i] = 1;
+    } else if (m_actuatorActive[i] != 0) {
+      resetActuator(state, m_actuatorHandles[i]);
+      m_actuatorActive[i] = 0;
+    }
+  }
+
+  const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+  m_stepNanoseconds.fetch_add(elapsed.count(), std::memory_order_relaxed);
+  m_numSteps.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::uint64_t ControllerHost::numSteps() const {
+  return m_numSteps.load(std::memory_order_relaxed);
+}
+
+std::chrono::nanoseconds ControllerHost::averageStepCost() const {
+  const auto numSteps = m_numSteps.load(std::memory_order_relaxed);
+  if (numSteps == 0) {
+    return std::chrono::nanoseconds{0};
+  }
+  return std::chrono::nanoseconds{m_stepNanoseconds.load(std::memory_order_relaxed) / static_cast<std::int64_t>(numSteps)};
+}
+
+std::string ControllerHost::summary() const {
+  if (m_status == Status::Disabled) {
+    return fmt::format("Controller '{}': disabled, {}", name(), m_disabledReason);
+  }
+  return fmt::format("Controller '{}': {} timesteps, {} per timestep", name(), numSteps(), averageStepCost());
+}
+
+}  // namespace epcli
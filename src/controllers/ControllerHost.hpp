@@ -0,0 +1,86 @@
+#ifndef CONTROLLERS_CONTROLLERHOST_HPP
+#define CONTROLLERS_CONTROLLERHOST_HPP
+
+#include "epcli_controller.h"              // for EpcliController, EpcliSensorKind
+#include "../utilities/SharedLibrary.hpp"  // for SharedLibrary
+
+#include <EnergyPlus/api/state.h>  // for EnergyPlusState
+
+#include <atomic>      // for atomic
+#include <chrono>      // for nanoseconds
+#include <cstdint>     // for int64_t, uint64_t
+#include <filesystem>  // for path
+#include <string>      // for string
+#include <vector>      // for vector
+
+namespace epcli {
+
+/// Runs a native controller plugin (see epcli_controller.h) inside the simulation loop.
+/// All the sensor and actuator handles are resolved once, into flat tables, the first time the API data is ready. From then on, each
+/// system timestep is: read the sensors into a contiguous input array, one call to the plugin, write the actuators that aren't NaN.
+/// If any sensor or actuator description is incomplete (null name or key), or any handle can't be resolved, a Severe is issued and the
+/// controller is disabled for the rest of the run
+class ControllerHost
+{
+ public:
+  /// Loads the plugin. Throws std::runtime_error if it cannot be loaded, or doesn't export a compatible entry point
+  explicit ControllerHost(const std::filesystem::path& libraryPath);
+  ControllerHost(const ControllerHost&) = delete;
+  ControllerHost& operator=(const ControllerHost&) = delete;
+  ~ControllerHost();
+
+  /// To be called on a fresh state, before energyplus(): requests the sensor variables, creates the controller's per-run state and
+  /// registers the timestep callback
+  void registerCallbacks(EnergyPlusState state);
+  /// Destroys the controller's per-run state, once energyplus() returned
+  void endRun();
+
+  [[nodiscard]] std::string name() const;
+  [[nodiscard]] std::uint64_t numSteps() const;
+  /// Mean wall time per timestep, including reading the sensors and writing the actuators
+  [[nodiscard]] std::chrono::nanoseconds averageStepCost() const;
+  /// One line to report at the end of a run
+  [[nodiscard]] std::string summary() const;
+
+ private:
+  enum class Status
+  {
+    Unresolved,
+    Active,
+    Disabled,
+  };
+
+  struct SensorSlot
+  {
+    EpcliSensorKind kind;
+    int handle;
+  };
+
+  // The sensors and actuators that can't be passed to the EnergyPlus API, empty if all of them can
+  static std::string invalidEntries(const EpcliController& controller);
+  void resolveHandles(EnergyPlusState state);
+  void disable(EnergyPlusState state, std::string reason);
+  void step(EnergyPlusState state);
+
+  utilities::SharedLibrary m_library;
+  const EpcliController* m_controller = nullptr;
+  void* m_instance = nullptr;
+
+  Status m_status = Status::Unresolved;
+  std::vector<SensorSlot> m_sensors;
+  std::vector<int> m_actuatorHandles;
+  // Whether we overrode the actuator on the previous step, so it only gets reset once when released. Not vector<bool>, on the hot path
+  std::vector<char> m_actuatorActive;
+  std::vector<double> m_inputs;
+  std::vector<double> m_outputs;
+  std::string m_disabledReason;
+  // Checked once when the plugin is loaded
+  std::string m_invalidEntries;
+
+  std::atomic<std::int64_t> m_stepNanoseconds = 0;
+  std::atomic<std::uint64_t> m_numSteps = 0;
+};
+
+}  // namespace epcli
+
+#endif  // CONTROLLERS_CONTROLLERHOST_HPP
@@ -0,0 +1,84 @@
+#ifndef EPCLI_CONTROLLER_H
+#define EPCLI_CONTROLLER_H
+
+/*
+ * C ABI for native controller plugins, loaded by `epcli --controller <library>`.
+ *
+ * A plugin is a shared library exporting `epcli_controller`, which returns a static description of the controller: the sensors it reads
+ * and the actuators it drives, declared up front so that epcli can resolve every handle once, before the first call. At each system
+ * timestep, `step` gets the sensor values in declaration order, and writes the actuator values in declaration order. Outputs start out as
+ * NaN every step: an actuator left to NaN is released back to EnergyPlus.
+ *
+ * `step` runs on the simulation thread, inside the EnergyPlus timestep loop: it must not block.
+ */
+
+#include <stddef.h> /* for size_t */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define EPCLI_CONTROLLER_API_VERSION 1
+
+#if defined(_WIN32)
+#  define EPCLI_CONTROLLER_EXPORT __declspec(dllexport)
+#else
+#  define EPCLI_CONTROLLER_EXPORT __attribute__((visibility("default")))
+#endif
+
+typedef enum
+{
+  EPCLI_SENSOR_VARIABLE = 0,          /* Output:Variable: name, key */
+  EPCLI_SENSOR_METER = 1,             /* Output:Meter: name, key unused */
+  EPCLI_SENSOR_INTERNAL_VARIABLE = 2, /* EMS internal variable: name is the type, key */
+} EpcliSensorKind;
+
+typedef struct
+{
+  EpcliSensorKind kind;
+  const char* name;
+  const char* key;
+} EpcliSensor;
+
+typedef struct
+{
+  const char* componentType;
+  const char* controlType;
+  const char* key;
+} EpcliActuator;
+
+typedef struct
+{
+  double hourOfYear;     /* Hours since Jan 1st 00:00 */
+  double systemTimeStep; /* In hours */
+  int warmup;            /* Non zero during warmup days */
+  int kindOfSim;         /* See KindOfSim in the EnergyPlus data exchange API */
+} EpcliStepInfo;
+
+typedef struct
+{
+  int apiVersion; /* EPCLI_CONTROLLER_API_VERSION */
+  const char* name;
+
+  size_t numSensors;
+  const EpcliSensor* sensors;
+  size_t numActuators;
+  const EpcliActuator* actuators;
+
+  /* Optional: per-run state, passed back to step and destroy */
+  void* (*create)(void);
+  void (*destroy)(void* self);
+
+  /* inputs has numSensors values, outputs has numActuators values */
+  void (*step)(void* self, const EpcliStepInfo* info, const double* inputs, double* outputs);
+} EpcliController;
+
+typedef const EpcliController* (*EpcliControllerEntryPoint)(void);
+
+#define EPCLI_CONTROLLER_ENTRY_POINT "epcli_controller"
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EPCLI_CONTROLLER_H */
@@ -1,22 +1,49 @@
-#include "EnergyPlus.hpp"                          // for validateFileType, runEnergyPlus
+#include "CallbackFilter.hpp"                      // for CallbackFilter, FilterOptions
+#include "ComparisonComponent.hpp"                 // for ComparisonComponent
+#include "EnergyPlus.hpp"                          // for validateFileType, runEnergyPlus, replayRun
 #include "ErrorMessage.hpp"                        // for ErrorMessage
 #include "MainComponent.hpp"                       // for MainComponent
+#include "PhaseProfiler.hpp"                       // for PhaseProfiler
+#include "Preflight.hpp"                           // for preflightFile, PreflightReport
+#include "RuntimeMetrics.hpp"                      // for RuntimeMetrics
+#include "TerminationPolicy.hpp"                   // for TerminationPolicy, TerminationGuard
+#include "VariableSampler.hpp"                     // for VariableSampler, OutputVariable
+#include "controllers/ControllerHost.hpp"          // for ControllerHost
+#include "sqlite/JobTable.hpp"                     // for JobTable
+#include "sqlite/RuntimeHistory.hpp"               // for RuntimeHistory, InputFeatures
+#include "sweep/QueueWorker.hpp"                   // for runQueueWorker, printQueueStatus, orderLongestFirst
+#include "sweep/Sweep.hpp"                         // for Sweep, SweepOptions, ResourceLimits
+#include "sweep/SweepJournal.hpp"                  // for SweepJournal
+#include "weather/WeatherData.hpp"                 // for WeatherData
+#include "outputs/TimeSeriesFile.hpp"              // for TimeSeriesFile, seriesStats
+#include "utilities/FileWatcher.hpp"               // for FileWatcher
+#include "utilities/Process.hpp"                   // for nodeName
+#include "utilities/MetricsExporter.hpp"           // for TextfileExporter, HttpExporter
+#include "utilities/Trace.hpp"                     // for start, stopAndWrite, compiledIn, EPCLI_TRACE_THREAD_NAME
                                                    //
 #include "ftxui/component/component.hpp"           // for Button, Renderer, Vertical, operator|=
 #include <ftxui/component/component_base.hpp>      // for ComponentBase
 #include <ftxui/component/component_options.hpp>   // for ButtonOption
+#include <ftxui/component/event.hpp>               // for Event
 #include <ftxui/component/receiver.hpp>            // for MakeReceiver, Sender
 #include <ftxui/component/screen_interactive.hpp>  // for ScreenInteractive
 #include <ftxui/dom/elements.hpp>                  // for Element, text, operator|, separator, size, vbox, border, Constraint, Direction
                                                    //
 #include "ftxui/modal.hpp"                         // For Modal // TODO: temp, FTXUI 3.0.0 doesn't include this component yet, it's only on master.
                                                    //
+#include <algorithm>                               // for all_of, min
+#include <array>                                   // for array
 #include <atomic>                                  // for atomic
-#include <chrono>                                  // for system_clock, duration, time_point
+#include <chrono>                                  // for system_clock, duration, time_point, seconds
+#include <cstdint>                                 // for uint16_t
 #include <filesystem>                              // for path, absolute, is_regular_file, last_write_time, file_time_type, operator/
 #include <functional>                              // for function
-#include <memory>                                  // for allocator, shared_ptr
-#include <string>                                  // for string, basic_string
+#include <exception>                               // for exception
+#include <memory>                                  // for allocator, shared_ptr, unique_ptr, make_unique
+#include <optional>                                // for optional
+#include <regex>                                   // for regex
+#include <string>                                  // for string, basic_string, stoi, stod
+#include <utility>                                 // for move
 #include <thread>                                  // for thread
 #include <vector>                                  // for vector
                                                    //
@@ -55,6 +82,495 @@ ftxui::Component ReloadModalComponent(std::function<void()> reload_results, std:
   return component;
 }
 
+// Prints why and returns -1 if value isn't an integer in [minValue, maxValue]
+int parseIntOption(const std::string& option, const std::string& value, int minValue, int maxValue) {
+  try {
+    const int result = std::stoi(value);
+    if (result >= minValue && result <= maxValue) {
+      return result;
+    }
+  } catch (const std::exception&) {  // NOLINT(bugprone-empty-catch)
+  }
+  fmt::print("Invalid value for {}: '{}', expected an integer between {} and {}\n", option, value, minValue, maxValue);
+  return -1;
+}
+
+// epcli --compare [--baseline <index>] <run directory or eplusout.sql>...
+int runComparison(const std::vector<std::string>& args) {
+  // Checked once the number of databases is known
+  std::optional<std::string> baselineOption;
+  std::vector<fs::path> databasePaths;
+  for (size_t i = 2; i < args.size(); ++i) {
+    if (args[i] == "--baseline" && i + 1 < args.size()) {
+      baselineOption = args[++i];
+      continue;
+    }
+    fs::path databasePath(args[i]);
+    if (fs::is_directory(databasePath)) {
+      databasePath /= "eplusout.sql";
+    }
+    if (!fs::is_regular_file(databasePath)) {
+      fmt::print("SQL file does not exist at '{}'\n", databasePath);
+      return 1;
+    }
+    databasePaths.emplace_back(std::move(databasePath));
+  }
+  if (databasePaths.empty()) {
+    fmt::print("Usage: epcli --compare [--baseline <index>] <run directory or eplusout.sql>...\n");
+    return 1;
+  }
+  int baselineIndex = 0;
+  if (baselineOption) {
+    baselineIndex = parseIntOption("--baseline", *baselineOption, 0, static_cast<int>(databasePaths.size()) - 1);
+    if (baselineIndex < 0) {
+      return 1;
+    }
+  }
+
+  auto screen = ftxui::ScreenInteractive::Fullscreen();
+  const std::string quit_text = "Quit";
+  auto quit_button = ftxui::Button(&quit_text, screen.ExitLoopClosure(), ftxui::ButtonOption::Ascii());
+  screen.Loop(ftxui::Make<ComparisonComponent>(databasePaths, std::move(quit_button), baselineIndex));
+  return 0;
+}
+
+// The errors then the warnings of a preflight, one per line, at most maxErrors errors
+std::vector<std::string> preflightLines(const epcli::PreflightReport& report, std::size_t maxErrors) {
+  std::vector<std::string> lines;
+  for (std::size_t i = 0; i < std::min(report.errors.size(), maxErrors); ++i) {
+    lines.push_back(fmt::format("Error: {}", report.errors[i].describe()));
+  }
+  if (report.errors.size() > maxErrors) {
+    lines.push_back(fmt::format("... and {} more errors", report.errors.size() - maxErrors));
+  }
+  for (const auto& warning : report.warnings) {
+    lines.push_back(fmt::format("Warning: {}", warning.describe()));
+  }
+  return lines;
+}
+
+// epcli --check [--counts] <input>...
+int runCheck(const std::vector<std::string>& args) {
+  bool counts = false;
+  std::vector<fs::path> inputs;
+  for (size_t i = 2; i < args.size(); ++i) {
+    if (args[i] == "--counts") {
+      counts = true;
+    } else if (epcli::validateFileType(args[i])) {
+      inputs.emplace_back(args[i]);
+    } else {
+      fmt::print("'{}' is not an IDF or epJSON input\n", args[i]);
+      return 1;
+    }
+  }
+  if (inputs.empty()) {
+    fmt::print("Usage: epcli --check [--counts] <input>...\n");
+    return 1;
+  }
+
+  int failed = 0;
+  for (const auto& input : inputs) {
+    try {
+      const auto start = std::chrono::steady_clock::now();
+      const auto report = epcli::preflightFile(input);
+      fmt::print("{}: {} objects of {} types, checked in {:.1f} ms\n", input, report.numObjects(), report.objectCounts.size(),
+                 std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+      for (const auto& line : preflightLines(report, 50)) {
+        fmt::print("  {}\n", line);
+      }
+      if (counts) {
+        for (const auto& [type, count] : report.objectCounts) {
+          fmt::print("  {:>8} {}\n", count, type);
+        }
+      }
+      if (!report.ok()) {
+        ++failed;
+      }
+    } catch (const std::exception& e) {
+      fmt::print("{}\n", e.what());
+      ++failed;
+    }
+  }
+  return failed == 0 ? 0 : 1;
+}
+
+// epcli --weather-stats <file.epw>...
+int runWeatherStats(const std::vector<std::string>& args) {
+  if (args.size() < 3) {
+    fmt::print("Usage: epcli --weather-stats <file.epw>...\n");
+    return 1;
+  }
+  constexpr std::array<const char*, 12> monthNames = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+  int failed = 0;
+  for (size_t i = 2; i < args.size(); ++i) {
+    try {
+      const auto start = std::chrono::steady_clock::now();
+      const auto data = weather::WeatherData::open(fs::path(args[i]));
+      const auto& location = data->location();
+      fmt::print("{}: {}, {}, {} (WMO {}), {} records, {} in {:.1f} ms\n", args[i], location.city, location.region, location.country,
+                 location.wmo, data->numRecords(), data->fromCache() ? "read from the cache" : "parsed",
+                 std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+      const auto design = data->designConditions();
+      const auto degreeDays = data->degreeDays(18.0);
+      fmt::print("  Heating 99.6%: {:.1f} C, cooling 0.4%: {:.1f} C, range {:.1f} to {:.1f} C\n", design.heating99_6, design.cooling0_4,
+                 design.minimum, design.maximum);
+      fmt::print("  Degree-days base 18 C: {:.0f} heating, {:.0f} cooling\n", degreeDays.heating, degreeDays.cooling);
+      fmt::print("  Month  Mean C  Min C  Max C  RH %  GHI kWh/m2  Wind m/s\n");
+      const auto monthly = data->monthlyStats();
+      for (size_t m = 0; m < monthly.size(); ++m) {
+        const auto& month = monthly[m];
+        if (month.numRecords > 0) {
+          fmt::print("  {:<5} {:>7.1f} {:>6.1f} {:>6.1f} {:>5.0f} {:>11.0f} {:>9.1f}\n", monthNames[m], month.meanDryBulb, month.minDryBulb,
+                     month.maxDryBulb, month.meanRelativeHumidity, month.globalHorizontal, month.meanWindSpeed);
+        }
+      }
+    } catch (const std::exception& e) {
+      fmt::print("{}\n", e.what());
+      ++failed;
+    }
+  }
+  return failed == 0 ? 0 : 1;
+}
+
+// epcli --output-stats <eplusout.eso|eplusout.mtr|eplusout.csv>...
+int runOutputStats(const std::vector<std::string>& args) {
+  if (args.size() < 3) {
+    fmt::print("Usage: epcli --output-stats <eplusout.eso|eplusout.mtr|eplusout.csv>...\n");
+    return 1;
+  }
+  int failed = 0;
+  for (size_t i = 2; i < args.size(); ++i) {
+    try {
+      const auto start = std::chrono::steady_clock::now();
+      const auto file = outputs::TimeSeriesFile::open(fs::path(args[i]));
+      file->update();
+      const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      const auto environments = file->environments();
+      fmt::print("{}: {} variables, {} environments, read in {:.0f} ms ({:.0f} MB/s){}\n", args[i], file->variables().size(),
+                 environments.size(), seconds * 1000.0, static_cast<double>(fs::file_size(args[i])) / 1e6 / seconds,
+                 file->complete() ? "" : ", incomplete");
+      std::vector<double> times;
+      std::vector<double> values;
+      for (size_t environment = 0; environment < environments.size(); ++environment) {
+        fmt::print("  {}\n", environments[environment]);
+        for (size_t variable = 0; variable < file->variables().size(); ++variable) {
+          file->copySeries(environment, variable, times, values);
+          if (values.empty()) {
+            continue;
+          }
+          const auto stats = outputs::seriesStats(values);
+          fmt::print("    {}: {} values, mean {:.4g}, min {:.4g}, max {:.4g}, sum {:.6g}\n", file->variables()[variable].label(), stats.count,
+                     stats.mean, stats.min, stats.max, stats.sum);
+        }
+      }
+    } catch (const std::exception& e) {
+      fmt::print("{}\n", e.what());
+      ++failed;
+    }
+  }
+  return failed == 0 ? 0 : 1;
+}
+
+// Prints why and returns -1 if value is neither "max" (0, as fast as possible) nor a factor in (0, 1000]
+double parseSpeedOption(const std::string& option, const std::string& value) {
+  if (value == "max") {
+    return 0.0;
+  }
+  try {
+    const double result = std::stod(value);
+    if (result > 0.0 && result <= 1000.0) {
+      return result;
+    }
+  } catch (const std::exception&) {  // NOLINT(bugprone-empty-catch)
+  }
+  fmt::print("Invalid value for {}: '{}', expected 'max' or a factor between 0 and 1000\n", option, value);
+  return -1.0;
+}
+
+// The options --sweep, --resume and --queue --work share: --memory-budget <MiB>, --memory-pressure <percent> and --pin.
+// Returns how many arguments args[i] and its value are, 0 if args[i] isn't one of them, or -1 after printing why its value is invalid
+int parseResourceOption(const std::vector<std::string>& args, size_t i, sweep::ResourceLimits& limits, bool& pinThreads) {
+  if (args[i] == "--pin") {
+    pinThreads = true;
+    return 1;
+  }
+  if ((args[i] != "--memory-budget" && args[i] != "--memory-pressure") || i + 1 == args.size()) {
+    return 0;
+  }
+  if (args[i] == "--memory-budget") {
+    const int mebibytes = parseIntOption(args[i], args[i + 1], 64, 16 * 1024 * 1024);
+    if (mebibytes < 0) {
+      return -1;
+    }
+    limits.memoryBudget = static_cast<std::size_t>(mebibytes) << 20U;
+  } else {
+    const int percent = parseIntOption(args[i], args[i + 1], 1, 100);
+    if (percent < 0) {
+      return -1;
+    }
+    limits.pressureThreshold = percent;
+  }
+  return 2;
+}
+
+// The termination policies of a run, shared by the interactive run, --sweep, --resume and --queue --work: --max-severes <n>,
+// --stop-on <regex>, --max-warmup-days <n>, --max-warmup-time <seconds> and --max-run-time <seconds>.
+// Returns how many arguments args[i] and its value are, 0 if args[i] isn't one of them, or -1 after printing why its value is invalid
+int parseTerminationOption(const std::vector<std::string>& args, size_t i, epcli::TerminationPolicy& policy) {
+  if (i + 1 == args.size()) {
+    return 0;
+  }
+  const auto& option = args[i];
+  const auto& value = args[i + 1];
+  if (option == "--max-severes") {
+    const int maxSeveres = parseIntOption(option, value, 1, 1'000'000);
+    if (maxSeveres < 0) {
+      return -1;
+    }
+    policy.maxSeveres = static_cast<unsigned>(maxSeveres);
+  } else if (option == "--stop-on") {
+    try {
+      // Checked here rather than by each run
+      [[maybe_unused]] const std::regex pattern(value);
+    } catch (const std::exception& e) {
+      fmt::print("Invalid --stop-on pattern: {}\n", e.what());
+      return -1;
+    }
+    policy.errorPatterns.emplace_back(value);
+  } else if (option == "--max-warmup-days") {
+    policy.maxWarmupDays = parseIntOption(option, value, 1, 1000);
+    if (policy.maxWarmupDays < 0) {
+      return -1;
+    }
+  } else if (option == "--max-warmup-time" || option == "--max-run-time") {
+    const int seconds = parseIntOption(option, value, 1, 7 * 86400);
+    if (seconds < 0) {
+      return -1;
+    }
+    (option == "--max-run-time" ? policy.maxRunTime : policy.maxWarmupTime) = std::chrono::seconds(seconds);
+  } else {
+    return 0;
+  }
+  return 2;
+}
+
+// Runs the sweep, then prints and writes its summary
+int runSweepWith(sweep::SweepOptions options) {
+  if (!fs::is_regular_file(options.baseInput)) {
+    fmt::print("File does not exist at '{}'\n", options.baseInput);
+    return 1;
+  }
+
+  const auto summaryPath = options.outputDirectory / "sweep_summary.csv";
+  try {
+    sweep::Sweep sweep(std::move(options));
+    const auto& results = sweep.run();
+    sweep.printSummary();
+    sweep.writeCsv(summaryPath);
+    fmt::print("Summary written to {}\n", summaryPath);
+    return std::all_of(results.cbegin(), results.cend(), [](const auto& result) { return result.succeeded; }) ? 0 : 1;
+  } catch (const std::exception& e) {
+    fmt::print("{}\n", e.what());
+    return 1;
+  }
+}
+
+// epcli --sweep <spec> [--jobs <n>] [--memory-budget <MiB>] [--memory-pressure <percent>] [--pin] [-d <output directory>]
+//                      [termination options, eg: --max-severes 1] [EnergyPlus options, eg: -w weather.epw] <base.idf>
+int runSweep(const std::vector<std::string>& args) {
+  if (args.size() < 4) {
+    fmt::print("Usage: epcli --sweep <spec> [--jobs <n>] [--memory-budget <MiB>] [--memory-pressure <percent>] [--pin] [-d <output directory>]\n"
+               "                    [termination options] [EnergyPlus options] <base.idf>\n");
+    return 1;
+  }
+  sweep::SweepOptions options;
+  options.specPath = fs::path(args[2]);
+  for (size_t i = 3; i < args.size(); ++i) {
+    const int resourceArgs = parseResourceOption(args, i, options.resources, options.pinThreads);
+    if (resourceArgs < 0) {
+      return 1;
+    }
+    const int terminationArgs = resourceArgs == 0 ? parseTerminationOption(args, i, options.termination) : 0;
+    if (terminationArgs < 0) {
+      return 1;
+    }
+    if (resourceArgs > 0 || terminationArgs > 0) {
+      i += static_cast<size_t>(resourceArgs + terminationArgs) - 1;
+    } else if (args[i] == "--jobs" && i + 1 < args.size()) {
+      const int jobs = parseIntOption(args[i], args[i + 1], 1, 1024);
+      if (jobs < 0) {
+        return 1;
+      }
+      options.jobs = static_cast<unsigned>(jobs);
+      ++i;
+    } else if ((args[i] == "-d" || args[i] == "--output-directory") && i + 1 < args.size()) {
+      options.outputDirectory = fs::path(args[++i]);
+    } else if (i + 1 == args.size()) {
+      options.baseInput = fs::path(args[i]);
+    } else {
+      options.energyPlusArgs.emplace_back(args[i]);
+    }
+  }
+  return runSweepWith(std::move(options));
+}
+
+// epcli --resume <sweep.journal> [--jobs <n>] [--memory-budget <MiB>] [--memory-pressure <percent>] [--pin] [termination options]
+int runResume(const std::vector<std::string>& args) {
+  if (args.size() < 3) {
+    fmt::print("Usage: epcli --resume <sweep.journal> [--jobs <n>] [--memory-budget <MiB>] [--memory-pressure <percent>] [--pin]\n"
+               "                     [termination options]\n");
+    return 1;
+  }
+  sweep::SweepOptions options;
+  try {
+    // What defines the sweep comes from the journal, how to run it from the command line
+    const auto header = sweep::SweepJournal::readHeader(fs::path(args[2]));
+    options.baseInput = header.baseInput;
+    options.specPath = header.specPath;
+    options.outputDirectory = header.outputDirectory;
+    options.energyPlusArgs = header.energyPlusArgs;
+    options.resume = true;
+  } catch (const std::exception& e) {
+    fmt::print("{}\n", e.what());
+    return 1;
+  }
+  for (size_t i = 3; i < args.size(); ++i) {
+    const int resourceArgs = parseResourceOption(args, i, options.resources, options.pinThreads);
+    if (resourceArgs < 0) {
+      return 1;
+    }
+    const int terminationArgs = resourceArgs == 0 ? parseTerminationOption(args, i, options.termination) : 0;
+    if (terminationArgs < 0) {
+      return 1;
+    }
+    if (resourceArgs > 0 || terminationArgs > 0) {
+      i += static_cast<size_t>(resourceArgs + terminationArgs) - 1;
+    } else if (args[i] == "--jobs" && i + 1 < args.size()) {
+      const int jobs = parseIntOption(args[i], args[i + 1], 1, 1024);
+      if (jobs < 0) {
+        return 1;
+      }
+      options.jobs = static_cast<unsigned>(jobs);
+      ++i;
+    } else {
+      fmt::print("Unknown option for --resume: '{}'\n", args[i]);
+      return 1;
+    }
+  }
+  return runSweepWith(std::move(options));
+}
+
+// epcli --queue <jobs.db> --enqueue [-d <output root>] [EnergyPlus options] <input>...
+// epcli --queue <jobs.db> --work [--workers <n>] [--lease <seconds>] [--max-attempts <n>] [--memory-budget <MiB>] [--memory-pressure <percent>]
+//                                [--pin] [termination options]
+// epcli --queue <jobs.db> --status
+int runQueue(const std::vector<std::string>& args) {
+  if (args.size() < 4 || (args[3] != "--enqueue" && args[3] != "--work" && args[3] != "--status")) {
+    fmt::print("Usage: epcli --queue <jobs.db> --enqueue [-d <output root>] [EnergyPlus options] <input>...\n"
+               "       epcli --queue <jobs.db> --work [--workers <n>] [--lease <seconds>] [--max-attempts <n>] [--memory-budget <MiB>]\n"
+               "                                      [--memory-pressure <percent>] [--pin] [termination options]\n"
+               "       epcli --queue <jobs.db> --status\n");
+    return 1;
+  }
+  const fs::path databasePath(args[2]);
+  const std::string& action = args[3];
+  if (action != "--enqueue" && !fs::is_regular_file(databasePath)) {
+    fmt::print("Job table does not exist at '{}'\n", databasePath);
+    return 1;
+  }
+
+  try {
+    if (action == "--status") {
+      sweep::printQueueStatus(databasePath);
+      return 0;
+    }
+
+    if (action == "--work") {
+      sweep::QueueWorkerOptions options;
+      options.databasePath = databasePath;
+      for (size_t i = 4; i < args.size(); i += 2) {
+        const int resourceArgs = parseResourceOption(args, i, options.resources, options.pinThreads);
+        if (resourceArgs < 0) {
+          return 1;
+        }
+        if (resourceArgs == 1) {
+          // A flag: the loop skips a value it doesn't have
+          --i;
+          continue;
+        }
+        if (resourceArgs == 2) {
+          continue;
+        }
+        const int terminationArgs = parseTerminationOption(args, i, options.termination);
+        if (terminationArgs < 0) {
+          return 1;
+        }
+        if (terminationArgs == 2) {
+          continue;
+        }
+        if (i + 1 == args.size()) {
+          fmt::print("Missing value for {}\n", args[i]);
+          return 1;
+        }
+        int value = 0;
+        if (args[i] == "--workers") {
+          value = parseIntOption(args[i], args[i + 1], 1, 1024);
+          options.workers = static_cast<unsigned>(value);
+        } else if (args[i] == "--lease") {
+          value = parseIntOption(args[i], args[i + 1], 5, 86400);
+          options.leaseDuration = std::chrono::seconds(value);
+        } else if (args[i] == "--max-attempts") {
+          value = parseIntOption(args[i], args[i + 1], 1, 100);
+          options.maxAttempts = value;
+        } else {
+          fmt::print("Unknown option for --work: '{}'\n", args[i]);
+          return 1;
+        }
+        if (value < 0) {
+          return 1;
+        }
+      }
+      return sweep::runQueueWorker(options) == 0 ? 0 : 1;
+    }
+
+    // Inputs are recognized by their extension, anything else is passed to EnergyPlus
+    fs::path outputRoot = databasePath.parent_path() / "runs";
+    std::vector<fs::path> inputs;
+    std::vector<std::string> energyPlusArgs;
+    for (size_t i = 4; i < args.size(); ++i) {
+      if ((args[i] == "-d" || args[i] == "--output-directory") && i + 1 < args.size()) {
+        outputRoot = fs::path(args[++i]);
+      } else if (epcli::validateFileType(args[i])) {
+        if (!fs::is_regular_file(args[i])) {
+          fmt::print("File does not exist at '{}'\n", args[i]);
+          return 1;
+        }
+        inputs.emplace_back(args[i]);
+      } else {
+        energyPlusArgs.emplace_back(args[i]);
+      }
+    }
+    if (inputs.empty()) {
+      fmt::print("--enqueue: no input file to run\n");
+      return 1;
+    }
+    try {
+      if (const auto numPredicted = sweep::orderLongestFirst(inputs, energyPlusArgs); numPredicted > 0) {
+        fmt::print("Longest first: {} of {} inputs have a predicted run time\n", numPredicted, inputs.size());
+      }
+    } catch (const std::exception& e) {
+      fmt::print("{}, the jobs will run in order\n", e.what());
+    }
+    sql::JobTable table(databasePath, utilities::nodeName());
+    const auto ids = table.enqueue(inputs, outputRoot, energyPlusArgs);
+    fmt::print("Enqueued jobs {} to {} in {}, their outputs will be in {}/job-NNNNN\n", ids.front(), ids.back(), databasePath, outputRoot);
+    return 0;
+  } catch (const std::exception& e) {
+    fmt::print("{}\n", e.what());
+    return 1;
+  }
+}
+
 int main(int argc, const char* argv[]) {
 
   // State of the application:
@@ -65,7 +581,177 @@ int main(int argc, const char* argv[]) {
   // Avoid pointer arithmetics by using a vector (we convert to string anyways in the loop below, so it's better than using an extra span)
   std::vector<std::string> args(argv, argv + argc);
 
-  if (argc > 1) {
+  if (argc > 1 && args[1] == "--compare") {
+    return runComparison(args);
+  }
+  if (argc > 1 && args[1] == "--check") {
+    return runCheck(args);
+  }
+  if (argc > 1 && args[1] == "--weather-stats") {
+    return runWeatherStats(args);
+  }
+  if (argc > 1 && args[1] == "--output-stats") {
+    return runOutputStats(args);
+  }
+  if (argc > 1 && args[1] == "--sweep") {
+    return runSweep(args);
+  }
+  if (argc > 1 && args[1] == "--resume") {
+    return runResume(args);
+  }
+  if (argc > 1 && args[1] == "--queue") {
+    return runQueue(args);
+  }
+
+  // epcli-only options are consumed here, EnergyPlus gets the rest
+  std::vector<epcli::OutputVariable> sampledVariables;
+  std::vector<std::unique_ptr<epcli::ControllerHost>> controllers;
+  fs::path tracePath;
+  fs::path metricsPath;
+  int metricsPort = -1;
+  int metricsInterval = 15;
+  fs::path recordPath;
+  fs::path replayPath;
+  double replaySpeed = 1.0;
+  bool watch = false;
+  epcli::FilterOptions filterOptions;
+  epcli::TerminationPolicy terminationPolicy;
+  std::vector<std::string> eplusArgs;
+  eplusArgs.reserve(args.size());
+  for (size_t i = 0; i < args.size(); ++i) {
+    if (args[i] == "--variable" && i + 1 < args.size()) {
+      try {
+        sampledVariables.emplace_back(epcli::OutputVariable::parse(args[++i]));
+      } catch (const std::exception& e) {
+        fmt::print("{}\n", e.what());
+        return 1;
+      }
+      continue;
+    }
+    if (args[i] == "--trace" && i + 1 < args.size()) {
+      tracePath = fs::path(args[++i]);
+      continue;
+    }
+    if (args[i] == "--metrics-file" && i + 1 < args.size()) {
+      metricsPath = fs::path(args[++i]);
+      continue;
+    }
+    if (args[i] == "--metrics-port" && i + 1 < args.size()) {
+      metricsPort = parseIntOption(args[i], args[i + 1], 0, 65535);
+      if (metricsPort < 0) {
+        return 1;
+      }
+      ++i;
+      continue;
+    }
+    if (args[i] == "--metrics-interval" && i + 1 < args.size()) {
+      metricsInterval = parseIntOption(args[i], args[i + 1], 1, 86400);
+      if (metricsInterval < 0) {
+        return 1;
+      }
+      ++i;
+      continue;
+    }
+    if (args[i] == "--record" && i + 1 < args.size()) {
+      recordPath = fs::path(args[++i]);
+      continue;
+    }
+    if (args[i] == "--replay" && i + 1 < args.size()) {
+      replayPath = fs::path(args[++i]);
+      continue;
+    }
+    if (args[i] == "--watch") {
+      watch = true;
+      continue;
+    }
+    if (args[i] == "--replay-speed" && i + 1 < args.size()) {
+      replaySpeed = parseSpeedOption(args[i], args[i + 1]);
+      if (replaySpeed < 0.0) {
+        return 1;
+      }
+      ++i;
+      continue;
+    }
+    if (args[i] == "--min-level" && i + 1 < args.size()) {
+      try {
+        filterOptions.minimumLevel = epcli::FilterOptions::parseLevel(args[++i]);
+      } catch (const std::exception& e) {
+        fmt::print("{}\n", e.what());
+        return 1;
+      }
+      continue;
+    }
+    if (args[i] == "--template-rate" && i + 1 < args.size()) {
+      const int rate = parseIntOption(args[i], args[i + 1], 0, 1'000'000);
+      if (rate < 0) {
+        return 1;
+      }
+      filterOptions.templateRate = rate;
+      ++i;
+      continue;
+    }
+    if (args[i] == "--sample-progress" && i + 1 < args.size()) {
+      const int sampling = parseIntOption(args[i], args[i + 1], 1, 1'000'000);
+      if (sampling < 0) {
+        return 1;
+      }
+      filterOptions.progressSampling = static_cast<unsigned>(sampling);
+      ++i;
+      continue;
+    }
+    if (const int terminationArgs = parseTerminationOption(args, i, terminationPolicy); terminationArgs != 0) {
+      if (terminationArgs < 0) {
+        return 1;
+      }
+      i += static_cast<size_t>(terminationArgs) - 1;
+      continue;
+    }
+    if (args[i] == "--controller" && i + 1 < args.size()) {
+      try {
+        controllers.emplace_back(std::make_unique<epcli::ControllerHost>(args[++i]));
+      } catch (const std::exception& e) {
+        fmt::print("{}\n", e.what());
+        return 1;
+      }
+      continue;
+    }
+    eplusArgs.emplace_back(args[i]);
+  }
+  args = std::move(eplusArgs);
+
+  if (!recordPath.empty() && !replayPath.empty()) {
+    fmt::print("--record and --replay cannot be used together\n");
+    return 1;
+  }
+  if (watch && !replayPath.empty()) {
+    fmt::print("--watch and --replay cannot be used together\n");
+    return 1;
+  }
+
+  if (!tracePath.empty()) {
+    if (!utilities::trace::compiledIn()) {
+      fmt::print("--trace: epcli was built without EPCLI_ENABLE_TRACING\n");
+      return 1;
+    }
+    utilities::trace::start();
+    EPCLI_TRACE_THREAD_NAME("UI");
+  }
+
+  argc = static_cast<int>(args.size());
+  std::vector<const char*> eplusArgv;
+  eplusArgv.reserve(args.size());
+  for (const auto& arg : args) {
+    eplusArgv.push_back(arg.c_str());
+  }
+
+  if (!replayPath.empty()) {
+    // Nothing is simulated, the event log stands in for the input file
+    filePath = replayPath;
+    if (!fs::is_regular_file(filePath)) {
+      fmt::print("Event log does not exist at '{}'\n", filePath);
+      return 1;
+    }
+  } else if (argc > 1) {
     filePath = fs::path(args[argc - 1]);
     if (!epcli::validateFileType(filePath)) {
       filePath = fs::path("in.idf");
@@ -83,10 +769,82 @@ int main(int argc, const char* argv[]) {
       break;
     }
   }
+  fs::path weatherFile;
+  for (int i = 1; i < argc - 2; ++i) {
+    if (args[i] == "-w" || args[i] == "--weather") {
+      weatherFile = fs::path(args[i + 1]);
+      break;
+    }
+  }
+  // --watch: the input, and the weather file if any
+  std::vector<fs::path> watchedFiles;
+  if (watch) {
+    watchedFiles.push_back(filePath);
+    if (!weatherFile.empty()) {
+      watchedFiles.push_back(weatherFile);
+    }
+  }
   if (fs::is_regular_file(outputDirectory / "eplusout.err")) {
     modal_reload_shown = true;
   }
 
+  epcli::VariableSampler sampler(std::move(sampledVariables));
+  epcli::PhaseProfiler profiler(outputDirectory);
+  epcli::RuntimeMetrics metrics;
+  epcli::CallbackFilter filter(filterOptions);
+  std::unique_ptr<epcli::TerminationGuard> guard;
+  if (terminationPolicy.enabled()) {
+    try {
+      guard = std::make_unique<epcli::TerminationGuard>(std::move(terminationPolicy));
+    } catch (const std::exception& e) {
+      fmt::print("Invalid --stop-on pattern: {}\n", e.what());
+      return 1;
+    }
+  }
+
+  epcli::RunOptions runOptions;
+  runOptions.sampler = &sampler;
+  runOptions.profiler = &profiler;
+  runOptions.metrics = &metrics;
+  runOptions.recordPath = recordPath;
+  // Not even the check for nothing to drop in the callbacks otherwise
+  if (filterOptions.enabled()) {
+    runOptions.filter = &filter;
+  }
+  runOptions.guard = guard.get();
+  for (const auto& controller : controllers) {
+    runOptions.controllers.push_back(controller.get());
+  }
+  // Set by --watch when the input changes during a run
+  std::atomic<bool> cancelRun = false;
+  if (watch) {
+    runOptions.cancel = &cancelRun;
+  }
+
+  // Predicts the run time shown while running, and records it. Runs go on without it
+  std::unique_ptr<sql::RuntimeHistory> history;
+  if (replayPath.empty()) {
+    try {
+      history = std::make_unique<sql::RuntimeHistory>();
+    } catch (const std::exception& e) {
+      fmt::print("{}\n", e.what());
+    }
+  }
+
+  std::unique_ptr<utilities::metrics::TextfileExporter> metricsFile;
+  std::unique_ptr<utilities::metrics::HttpExporter> metricsServer;
+  try {
+    if (!metricsPath.empty()) {
+      metricsFile = std::make_unique<utilities::metrics::TextfileExporter>(metrics.registry, metricsPath, std::chrono::seconds(metricsInterval));
+    }
+    if (metricsPort >= 0) {
+      metricsServer = std::make_unique<utilities::metrics::HttpExporter>(metrics.registry, static_cast<std::uint16_t>(metricsPort));
+    }
+  } catch (const std::exception& e) {
+    fmt::print("{}\n", e.what());
+    return 1;
+  }
+
   /* std::chrono::time_point<std::chrono::file_clock> */ auto lastWriteTime = fs::last_write_time(filePath);
 
   auto screen = ftxui::ScreenInteractive::Fullscreen();
@@ -102,32 +860,123 @@ int main(int argc, const char* argv[]) {
 
   std::string run_text = "Run " + filePath.string();  // NOLINT(misc-const-correctness)
   std::thread runThread;
-  auto run_button = ftxui::Button(
-    &run_text,
-    [&]() {
-      if (runThread.joinable()) {
-        runThread.join();
-      }
-      if (main_component != nullptr && main_component->hasAlreadyRun()) {
-        const fs::file_time_type newWriteTime = fs::last_write_time(filePath);
-        if (newWriteTime <= lastWriteTime) {
-          senderRunOutput->Send("--------------------------------------------------------------------------");
-          senderRunOutput->Send(fmt::format("Refusing to rerun file at {}, it was not modified since last run, Last modified time: {}", filePath,
-                                            to_system_clock(lastWriteTime)));
+  // --watch, on the UI thread only: whether a run is going, and whether the input changed during it, so that it starts again once cancelled
+  bool runInProgress = false;
+  bool rerunPending = false;
+  // inputChanged: --watch confirmed it from the contents, no need to check the modification time
+  std::function<void(bool)> startRun;
+  startRun = [&](bool inputChanged) {
+    if (runThread.joinable()) {
+      runThread.join();
+    }
+    if (main_component != nullptr && (inputChanged || main_component->hasAlreadyRun())) {
+      // Replaying the same log again is the point
+      if (!inputChanged && replayPath.empty() && fs::last_write_time(filePath) <= lastWriteTime) {
+        senderRunOutput->Send("--------------------------------------------------------------------------");
+        senderRunOutput->Send(fmt::format("Refusing to rerun file at {}, it was not modified since last run, Last modified time: {}", filePath,
+                                          to_system_clock(lastWriteTime)));
+        return;
+      }
+      main_component->clear_state();
+    }
+    // Milliseconds, where EnergyPlus takes seconds to load the input before stopping on the same errors
+    if (replayPath.empty()) {
+      try {
+        const auto report = epcli::preflightFile(filePath);
+        for (const auto& line : preflightLines(report, 20)) {
+          senderRunOutput->Send(fmt::format("Preflight: {}", line));
+        }
+        if (!report.ok()) {
+          senderRunOutput->Send(fmt::format("Not running {}: EnergyPlus would stop on these errors", filePath));
+          progress = -1;
           return;
         }
-        main_component->clear_state();
+      } catch (const std::exception& e) {
+        senderRunOutput->Send(e.what());
+        progress = -1;
+        return;
+      }
+    }
+    cancelRun = false;
+    sampler.reset();
+    if (!replayPath.empty()) {
+      runThread = std::thread(epcli::replayRun, replayPath, replaySpeed, &senderRunOutput, &senderErrorOutput, &progress, &screen, runOptions);
+    } else {
+      std::optional<sql::InputFeatures> features;
+      std::optional<double> predicted;
+      if (history != nullptr && argc > 1) {
+        try {
+          // Without the program name and the input
+          features = sql::InputFeatures::fromFile(filePath, std::vector<std::string>(args.cbegin() + 1, args.cend() - 1));
+          predicted = history->predict(*features);
+        } catch (const std::exception& e) {
+          senderRunOutput->Send(e.what());
+        }
+      }
+      if (main_component != nullptr) {
+        main_component->startRunClock(predicted);
       }
-      // NOLINTNEXTLINE(modernize-avoid-c-arrays)
-      runThread = std::thread(epcli::runEnergyPlus, argc, argv, &senderRunOutput, &senderErrorOutput, &progress, &screen);
-    },
-    ftxui::ButtonOption::Simple());
+      runInProgress = true;
+      runThread = std::thread([&, features]() {
+        const auto start = std::chrono::steady_clock::now();
+        epcli::runEnergyPlus(argc, eplusArgv.data(), &senderRunOutput, &senderErrorOutput, &progress, &screen, runOptions);
+        // A cancelled run says nothing about how long the input takes
+        if (features && !cancelRun) {
+          try {
+            history->record(*features, filePath, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(),
+                            progress == 100, epcli::PhaseProfiler::toJson(profiler.snapshot()));
+          } catch (const std::exception& e) {
+            senderRunOutput->Send(e.what());
+          }
+        }
+        if (watch) {
+          screen.Post([&]() {
+            runInProgress = false;
+            if (rerunPending) {
+              rerunPending = false;
+              startRun(true);
+            }
+          });
+        }
+      });
+    }
+  };
+  auto run_button = ftxui::Button(
+    &run_text, [&]() { startRun(false); }, ftxui::ButtonOption::Simple());
+
+  // Once a save is over, and only if the contents changed: a run going on is cancelled, then the input runs again
+  std::unique_ptr<utilities::FileWatcher> watcher;
+  if (watch) {
+    try {
+      watcher = std::make_unique<utilities::FileWatcher>(watchedFiles, std::chrono::milliseconds(300), [&](const std::vector<fs::path>& changed) {
+        // On the UI thread, like the Run button
+        screen.Post([&, changed]() {
+          for (const auto& file : changed) {
+            senderRunOutput->Send(fmt::format("{} changed", file));
+          }
+          if (runInProgress) {
+            cancelRun = true;
+            rerunPending = true;
+            return;
+          }
+          startRun(true);
+        });
+      });
+    } catch (const std::exception& e) {
+      fmt::print("{}\n", e.what());
+      return 1;
+    }
+    for (const auto& file : watchedFiles) {
+      senderRunOutput->Send(fmt::format("Watching {}, the input runs again when it changes", file));
+    }
+  }
 
   const std::string quit_text = "Quit";
   auto quit_button = ftxui::Button(&quit_text, screen.ExitLoopClosure(), ftxui::ButtonOption::Ascii());
 
   main_component = std::make_shared<MainComponent>(std::move(receiverRunOutput), std::move(receiverErrorOutput), std::move(run_button),
-                                                   std::move(quit_button), &progress, outputDirectory);
+                                                   std::move(quit_button), &progress, outputDirectory, weatherFile,
+                                                   [&screen]() { screen.PostEvent(ftxui::Event::Custom); }, runOptions);
 
   auto hide_modal = [&modal_reload_shown] { modal_reload_shown = false; };
   auto reload_results = [&main_component, &modal_reload_shown]() {
@@ -143,10 +992,25 @@ int main(int argc, const char* argv[]) {
 
   screen.Loop(composite);
 
+  // Its callback posts to the screen
+  watcher.reset();
   if (runThread.joinable()) {
     runThread.join();
   }
 
+  // Final write, with the last run accounted for
+  metricsFile.reset();
+  metricsServer.reset();
+
+  if (!tracePath.empty()) {
+    try {
+      utilities::trace::stopAndWrite(tracePath);
+      fmt::print("Trace written to {}\n", tracePath);
+    } catch (const std::exception& e) {
+      fmt::print("{}\n", e.what());
+    }
+  }
+
   // screen.Loop(ftxui::Container::Vertical({
   //   renderer,
   //   renderer_runOutput,
@@ -0,0 +1,428 @@
+#include "CsvFile.hpp"
+
+#include "../utilities/FastFloat.hpp"   // for parseDouble
+#include "../utilities/MappedFile.hpp"  // for MappedFile
+#include "../utilities/ThreadPool.hpp"  // for ThreadPool
+#include "../utilities/Trace.hpp"       // for EPCLI_TRACE_SCOPE
+
+#include <fmt/format.h>  // for format
+#include <fmt/std.h>     // for formatting std::filesystem::path // IWYU pragma: keep
+
+#include <algorithm>  // for min, clamp
+#include <array>      // for array
+#include <bit>        // for countr_zero, endian
+#include <cmath>      // for isnan
+#include <cstdint>    // for uint64_t
+#include <cstring>    // for memchr, memcpy
+#include <future>     // for future
+#include <limits>     // for numeric_limits
+#include <stdexcept>  // for runtime_error
+#include <utility>    // for move
+
+namespace outputs {
+
+namespace {
+  // Below that, a file isn't worth a thread pool
+  constexpr std::size_t minChunkBytes = 1024 * 1024;
+  constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+  constexpr double hoursPerYear = 8760.0;
+  constexpr std::array<int, 13> cumulativeDays = {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334, 365};
+  constexpr std::array<std::string_view, 12> monthNames = {"January", "February", "March",     "April",   "May",      "June",
+                                                           "July",    "August",   "September", "October", "November", "December"};
+
+  std::string_view trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) {
+      s.remove_prefix(1);
+    }
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r')) {
+      s.remove_suffix(1);
+    }
+    return s;
+  }
+
+  bool isDigit(char c) {
+    return static_cast<unsigned>(c - '0') < 10U;
+  }
+
+  // SWAR: the high bit of each zero byte of word is set, and the lowest one is exact (a borrow only spills into the bytes above it)
+  std::uint64_t zeroBytes(std::uint64_t word) {
+    return (word - 0x0101010101010101ULL) & ~word & 0x8080808080808080ULL;
+  }
+
+  // The first ',' or '\n' of [p, last), or last. Eight bytes at a time, compared to both at once: the structural characters are found as
+  // simdjson does with vector registers, in plain 64-bit words, which every target epcli builds for has
+  const char* findDelimiter(const char* p, const char* last) {
+    if constexpr (std::endian::native == std::endian::little) {
+      constexpr std::uint64_t commas = 0x0101010101010101ULL * ',';
+      constexpr std::uint64_t newlines = 0x0101010101010101ULL * '\n';
+      while (last - p >= 8) {
+        std::uint64_t word = 0;
+        std::memcpy(&word, p, sizeof(word));
+        const std::uint64_t found = zeroBytes(word ^ commas) | zeroBytes(word ^ newlines);
+        if (found != 0) {
+          return p + (std::countr_zero(found) / 8);
+        }
+        p += 8;
+      }
+    }
+    while (p != last && *p != ',' && *p != '\n') {
+      ++p;
+    }
+    return p;
+  }
+
+  // Parses the cell at p into value (NaN if it is empty or not a number), returns its end: the next ',' or '\n', or last
+  const char* parseCell(const char* p, const char* last, double& value) {
+    value = nan;
+    while (p != last && *p == ' ') {
+      ++p;
+    }
+    if (const char* end = utilities::parseDouble(p, last, value)) {
+      p = end;
+      while (p != last && (*p == ' ' || *p == '\r')) {
+        ++p;
+      }
+      if (p == last || *p == ',' || *p == '\n') {
+        return p;
+      }
+      value = nan;
+    }
+    return findDelimiter(p, last);
+  }
+
+  // In hours since January 1st at the end of the interval: " 01/01  00:15:00", " 01/01" for a daily row, or the month name of a monthly
+  // row. NaN otherwise
+  double parseDateTime(std::string_view field) {
+    field = trim(field);
+    if (!field.empty() && isDigit(field.front())) {
+      // Month, day, hour, minute, second
+      std::array<int, 5> numbers{};
+      std::size_t count = 0;
+      for (std::size_t i = 0; i < field.size() && count < numbers.size();) {
+        if (!isDigit(field[i])) {
+          ++i;
+          continue;
+        }
+        int number = 0;
+        for (; i < field.size() && isDigit(field[i]) && number < 10000; ++i) {
+          number = number * 10 + (field[i] - '0');
+        }
+        numbers[count++] = number;
+      }
+      const int month = numbers[0];
+      if ((count != 2 && count < 4) || month < 1 || month > 12 || numbers[1] < 1) {
+        return nan;
+      }
+      if (count == 2) {
+        // The end of that day
+        return (cumulativeDays[month - 1] + numbers[1]) * 24.0;
+      }
+      return ((cumulativeDays[month - 1] + numbers[1] - 1) * 24.0) + numbers[2] + (numbers[3] / 60.0) + (numbers[4] / 3600.0);
+    }
+    for (std::size_t m = 0; m < monthNames.size(); ++m) {
+      if (field.starts_with(monthNames[m])) {
+        return cumulativeDays[m + 1] * 24.0;
+      }
+    }
+    return nan;
+  }
+}  // namespace
+
+CsvFile::CsvFile(std::filesystem::path path) : m_path(std::move(path)) {}
+
+CsvFile::~CsvFile() = default;
+
+void CsvFile::parseHeader(std::string_view header) {
+  constexpr std::string_view byteOrderMark = "\xEF\xBB\xBF";
+  if (header.starts_with(byteOrderMark)) {
+    header.remove_prefix(byteOrderMark.size());
+  }
+  std::vector<std::string_view> fields;
+  while (true) {
+    const auto comma = header.find(',');
+    fields.push_back(trim(header.substr(0, comma)));
+    if (comma == std::string_view::npos) {
+      break;
+    }
+    header.remove_prefix(comma + 1);
+  }
+  // A trailing comma doesn't make a column
+  if (fields.size() > 1 && fields.back().empty()) {
+    fields.pop_back();
+  }
+  if (fields.size() == 1 && fields.front().empty()) {
+    throw std::runtime_error(fmt::format("{} has an empty header line", m_path));
+  }
+
+  m_hasDateTime = (fields.front() == "Date/Time");
+  for (std::size_t i = m_hasDateTime ? 1 : 0; i < fields.size(); ++i) {
+    std::string_view field = fields[i];
+    if (field.size() >= 2 && field.front() == '"' && field.back() == '"') {
+      field = trim(field.substr(1, field.size() - 2));
+    }
+
+    // "Environment:Site Outdoor Air Drybulb Temperature [C](TimeStep)". Meters have a colon too, so the key stays in the name
+    OutputVariable variable;
+    variable.id = static_cast<int>(i);
+    variable.column = m_variables.size();
+    variable.frequency = Frequency::TimeStep;
+    if (const auto open = field.rfind('('); field.ends_with(')') && open != std::string_view::npos) {
+      if (const auto frequency = parseFrequency(field.substr(open + 1))) {
+        variable.frequency = *frequency;
+        field = trim(field.substr(0, open));
+      }
+    }
+    const auto unitsStart = field.rfind('[');
+    const auto unitsEnd = field.rfind(']');
+    if (unitsStart != std::string_view::npos && unitsEnd != std::string_view::npos && unitsEnd > unitsStart) {
+      variable.units = field.substr(unitsStart + 1, unitsEnd - unitsStart - 1);
+      field = field.substr(0, unitsStart);
+    }
+    variable.name = trim(field);
+    m_variables.push_back(std::move(variable));
+  }
+}
+
+void CsvFile::parseChunk(std::string_view chunk, std::size_t firstRow, std::size_t numRows) const {
+  EPCLI_TRACE_SCOPE("CsvFile::parseChunk");
+  const char* p = chunk.data();
+  const char* const last = chunk.data() + chunk.size();
+  const std::size_t numColumns = m_variables.size();
+  double* const times = m_times.get();
+  double* const values = m_values.get();
+
+  for (std::size_t row = firstRow; row < firstRow + numRows; ++row) {
+    bool lineEnded = false;
+    if (m_hasDateTime) {
+      const char* end = findDelimiter(p, last);
+      times[row] = parseDateTime(std::string_view(p, static_cast<std::size_t>(end - p)));
+      p = end;
+      lineEnded = (p == last || *p == '\n');
+    } else {
+      times[row] = static_cast<double>(row);
+    }
+    for (std::size_t column = 0; column < numColumns; ++column) {
+      double value = nan;
+      // Missing cells at the end of the line are NaN too
+      if (!lineEnded) {
+        if (column > 0 || m_hasDateTime) {
+          ++p;  // The comma after the previous cell
+        }
+        p = parseCell(p, last, value);
+        lineEnded = (p == last || *p == '\n');
+      }
+      values[(column * m_numRows) + row] = value;
+    }
+    // Cells past the last column of the header are ignored
+    if (!lineEnded) {
+      const auto* eol = static_cast<const char*>(std::memchr(p, '\n', static_cast<std::size_t>(last - p)));
+      p = (eol != nullptr) ? eol : last;
+    }
+    if (p != last) {
+      ++p;
+    }
+  }
+}
+
+void CsvFile::splitEnvironments() {
+  m_environments.clear();
+  if (m_numRows == 0) {
+    return;
+  }
+  m_environments.push_back({"Environment 1", 0, m_numRows});
+  if (!m_hasDateTime) {
+    return;
+  }
+
+  double* const times = m_times.get();
+  // Added to the calendar times of the current environment, a year more at each new year
+  double offset = 0.0;
+  double previous = nan;
+  for (std::size_t row = 0; row < m_numRows; ++row) {
+    const double calendarTime = times[row];
+    // The RunPeriod rows, and anything else without a date: at the time of the row above
+    if (std::isnan(calendarTime)) {
+      times[row] = std::isnan(previous) ? 0.0 : previous;
+      continue;
+    }
+    double time = calendarTime + offset;
+    if (!std::isnan(previous) && time < previous) {
+      if (previous - offset >= hoursPerYear - 24.0 && calendarTime <= 24.0) {
+        offset += hoursPerYear;
+        time = calendarTime + offset;
+      } else {
+        m_environments.back().endRow = row;
+        m_environments.push_back({fmt::format("Environment {}", m_environments.size() + 1), row, m_numRows});
+        offset = 0.0;
+        time = calendarTime;
+      }
+    }
+    times[row] = time;
+    previous = time;
+  }
+}
+
+bool CsvFile::update(const std::atomic<bool>* cancel) {
+  EPCLI_TRACE_SCOPE("CsvFile::update");
+  if (m_complete) {
+    return false;
+  }
+  const utilities::MappedFile file(m_path);
+  const std::string_view text = file.view();
+
+  const auto headerEnd = text.find('\n');
+  if (headerEnd == std::string_view::npos) {
+    throw std::runtime_error(fmt::format("{} has no header line", m_path));
+  }
+  if (!m_headerRead) {
+    parseHeader(text.substr(0, headerEnd));
+    m_headerRead = true;
+  }
+  const std::size_t bodyStart = headerEnd + 1;
+
+  // Cut right after a newline, so each chunk holds whole lines
+  std::unique_ptr<utilities::ThreadPool> pool;
+  std::size_t numChunks = 1;
+  if (text.size() - bodyStart >= 2 * minChunkBytes) {
+    pool = std::make_unique<utilities::ThreadPool>();
+    numChunks = std::clamp<std::size_t>((text.size() - bodyStart) / minChunkBytes, 1, 4 * static_cast<std::size_t>(pool->size()));
+  }
+  std::vector<std::size_t> boundaries = {bodyStart};
+  for (std::size_t chunk = 1; chunk < numChunks; ++chunk) {
+    const std::size_t target = std::max(boundaries.back(), bodyStart + ((text.size() - bodyStart) * chunk / numChunks));
+    const auto eol = text.find('\n', target);
+    boundaries.push_back(eol == std::string_view::npos ? text.size() : eol + 1);
+  }
+  boundaries.push_back(text.size());
+
+  const auto cancelled = [cancel]() { return cancel != nullptr && *cancel; };
+  // Runs task on each chunk, on the pool if there is one. Waits for all of them, and rethrows the first exception
+  const auto forEachChunk = [&](const auto& task) {
+    if (!pool) {
+      task(0);
+      return;
+    }
+    std::vector<std::future<void>> futures;
+    futures.reserve(numChunks);
+    for (std::size_t chunk = 0; chunk < numChunks; ++chunk) {
+      futures.push_back(pool->submit([&task, chunk]() { task(chunk); }));
+    }
+    for (auto& future : futures) {
+      future.wait();
+    }
+    for (auto& future : futures) {
+      future.get();
+    }
+  };
+
+  // Counting the lines is a memchr, many times faster than parsing them: the rows of every chunk are known before any is parsed
+  std::vector<std::size_t> firstRows(numChunks + 1, 0);
+  forEachChunk([&text, &boundaries, &firstRows](std::size_t chunk) {
+    const char* p = text.data() + boundaries[chunk];
+    const char* const last = text.data() + boundaries[chunk + 1];
+    std::size_t numLines = 0;
+    while (const auto* eol = static_cast<const char*>(std::memchr(p, '\n', static_cast<std::size_t>(last - p)))) {
+      ++numLines;
+      p = eol + 1;
+    }
+    // The last line of the file may not end with a newline
+    firstRows[chunk + 1] = numLines + ((p != last) ? 1 : 0);
+  });
+  for (std::size_t chunk = 0; chunk < numChunks; ++chunk) {
+    firstRows[chunk + 1] += firstRows[chunk];
+  }
+  m_progress = 0.1;
+  if (cancelled()) {
+    return false;
+  }
+
+  m_numRows = firstRows.back();
+  // Not value-initialized: every cell is written once by parseChunk, and the pages are first touched by the thread parsing them
+  m_times = std::make_unique_for_overwrite<double[]>(m_numRows);                      // NOLINT(modernize-avoid-c-arrays)
+  m_values = std::make_unique_for_overwrite<double[]>(m_numRows * m_variables.size());  // NOLINT(modernize-avoid-c-arrays)
+
+  std::atomic<std::size_t> bytesParsed = 0;
+  forEachChunk([this, &text, &boundaries, &firstRows, &bytesParsed, &cancelled, size = text.size()](std::size_t chunk) {
+    if (cancelled()) {
+      return;
+    }
+    parseChunk(text.substr(boundaries[chunk], boundaries[chunk + 1] - boundaries[chunk]), firstRows[chunk],
+               firstRows[chunk + 1] - firstRows[chunk]);
+    bytesParsed += boundaries[chunk + 1] - boundaries[chunk];
+    m_progress = 0.1 + (0.9 * static_cast<double>(bytesParsed) / static_cast<double>(size));
+  });
+  if (cancelled()) {
+    m_numRows = 0;
+    m_times.reset();
+    m_values.reset();
+    m_progress = 0.0;
+    return false;
+  }
+
+  splitEnvironments();
+  m_progress = 1.0;
+  m_complete = true;
+  return true;
+}
+
+const std::filesystem::path& CsvFile::path() const {
+  return m_path;
+}
+
+bool CsvFile::complete() const {
+  return m_complete;
+}
+
+double CsvFile::progress() const {
+  return m_progress;
+}
+
+const std::vector<OutputVariable>& CsvFile::variables() const {
+  static const std::vector<OutputVariable> none;
+  // Published by the store to m_headerRead, which follows the writes to m_variables
+  return m_headerRead ? m_variables : none;
+}
+
+std::vector<std::string> CsvFile::environments() const {
+  std::vector<std::string> names;
+  if (m_complete) {
+    for (const auto& environment : m_environments) {
+      names.push_back(environment.name);
+    }
+  }
+  return names;
+}
+
+void CsvFile::copySeries(std::size_t environment, std::size_t variable, std::vector<double>& times, std::vector<double>& values) const {
+  times.clear();
+  values.clear();
+  if (!m_complete || environment >= m_environments.size()) {
+    return;
+  }
+  const auto& rows = m_environments[environment];
+  const auto columnValues = column(variable);
+  for (std::size_t row = rows.firstRow; row < rows.endRow; ++row) {
+    // The rows of the other frequencies, for a variable reported less often than the rows come
+    if (!std::isnan(columnValues[row])) {
+      times.push_back(m_times[row]);
+      values.push_back(columnValues[row]);
+    }
+  }
+}
+
+std::size_t CsvFile::numRows() const {
+  return m_complete ? m_numRows : 0;
+}
+
+std::span<const double> CsvFile::times() const {
+  return {m_times.get(), numRows()};
+}
+
+std::span<const double> CsvFile::column(std::size_t variable) const {
+  if (!m_complete || variable >= m_variables.size()) {
+    return {};
+  }
+  return {m_values.get() + (variable * m_numRows), m_numRows};
+}
+
+}  // namespace outputs
@@ -0,0 +1,83 @@
+#ifndef OUTPUTS_CSVFILE_HPP
+#define OUTPUTS_CSVFILE_HPP
+
+#include "TimeSeriesFile.hpp"  // for TimeSeriesFile, OutputVariable
+
+#include <atomic>       // for atomic
+#include <cstddef>      // for size_t
+#include <filesystem>   // for path
+#include <memory>       // for unique_ptr
+#include <span>         // for span
+#include <string>       // for string
+#include <string_view>  // for string_view
+#include <vector>       // for vector
+
+namespace outputs {
+
+/// A reader of the CSV outputs of EnergyPlus (eplusout.csv and eplusmtr.csv, as ReadVarsESO writes them) and of any CSV of numbers.
+///
+/// The file is mapped and read in two passes over chunks cut at line ends, on every core: the first counts the lines of each chunk, which
+/// places every row before anything is parsed, the second parses each chunk straight into its rows of the columns, one contiguous array of
+/// doubles per column. Nothing is allocated per line or per cell. Empty and non-numeric cells are NaN.
+///
+/// A first column named "Date/Time" gives the times, in hours since January 1st at the end of the interval: " 01/01  00:15:00" or a month
+/// name for monthly rows. An environment starts wherever the time goes back, other than from December 31st to January 1st. Without it
+/// the time is the row number, all in one environment. The headers "Key:Name [units](Frequency)" give the variables
+class CsvFile final : public TimeSeriesFile
+{
+ public:
+  /// Doesn't read anything yet
+  explicit CsvFile(std::filesystem::path path);
+  ~CsvFile() override;
+
+  /// Reads the whole file on the first call, and does nothing on later ones: unlike an ESO, a CSV is only written once the run is over.
+  /// Nothing is kept if cancel is set before the end
+  bool update(const std::atomic<bool>* cancel = nullptr) override;
+
+  [[nodiscard]] const std::filesystem::path& path() const override;
+  [[nodiscard]] bool complete() const override;
+  [[nodiscard]] double progress() const override;
+
+  [[nodiscard]] const std::vector<OutputVariable>& variables() const override;
+  /// Empty until complete
+  [[nodiscard]] std::vector<std::string> environments() const override;
+  void copySeries(std::size_t environment, std::size_t variable, std::vector<double>& times, std::vector<double>& values) const override;
+
+  /// Zero until complete
+  [[nodiscard]] std::size_t numRows() const;
+  [[nodiscard]] std::span<const double> times() const;
+  /// The values of variables()[variable], numRows() of them
+  [[nodiscard]] std::span<const double> column(std::size_t variable) const;
+
+ private:
+  struct Environment
+  {
+    std::string name;
+    std::size_t firstRow = 0;
+    std::size_t endRow = 0;
+  };
+
+  void parseHeader(std::string_view header);
+  // Parses the lines of chunk into the rows starting at firstRow
+  void parseChunk(std::string_view chunk, std::size_t firstRow, std::size_t numRows) const;
+  // Turns the calendar times into a continuous time and splits the rows into environments
+  void splitEnvironments();
+
+  std::filesystem::path m_path;
+  std::vector<OutputVariable> m_variables;
+  bool m_hasDateTime = false;
+
+  std::size_t m_numRows = 0;
+  std::unique_ptr<double[]> m_times;  // NOLINT(modernize-avoid-c-arrays)
+  // Column-major: column c occupies [c * m_numRows, (c + 1) * m_numRows)
+  std::unique_ptr<double[]> m_values;  // NOLINT(modernize-avoid-c-arrays)
+  std::vector<Environment> m_environments;
+
+  std::atomic<bool> m_headerRead = false;
+  std::atomic<bool> m_complete = false;
+  std::atomic<double> m_progress = 0.0;
+};
+
+}  // namespace outputs
+
+#endif  // OUTPUTS_CSVFILE_HPP
@@ -0,0 +1,441 @@
+#include "EsoFile.hpp"
+
+#include "../utilities/FastFloat.hpp"   // for parseDouble
+#include "../utilities/MappedFile.hpp"  // for MappedFile
+#include "../utilities/ThreadPool.hpp"  // for ThreadPool
+#include "../utilities/Trace.hpp"       // for EPCLI_TRACE_SCOPE
+
+#include <fmt/format.h>  // for format
+#include <fmt/std.h>     // for formatting std::filesystem::path // IWYU pragma: keep
+
+#include <algorithm>  // for max, min, any_of
+#include <cmath>      // for isnan
+#include <cstring>    // for memchr
+#include <future>     // for future
+#include <limits>     // for numeric_limits
+#include <optional>   // for optional
+#include <span>       // for span
+#include <stdexcept>  // for runtime_error
+#include <utility>    // for move
+
+namespace outputs {
+
+namespace {
+  constexpr std::int32_t unknownId = std::numeric_limits<std::int32_t>::min();
+  // The stamp lines: each value line belongs to the last one above it
+  constexpr std::int32_t environmentStamp = 1;
+  constexpr std::int32_t intervalStamp = 2;  // TimeStep, Hourly and Each Call values
+  constexpr std::int32_t dailyStamp = 3;
+  constexpr std::int32_t monthlyStamp = 4;
+  constexpr std::int32_t runPeriodStamp = 5;
+  constexpr std::int32_t annualStamp = 6;
+
+  // Report codes index a flat table: far above what the largest models use, far below what a garbled id could ask to allocate
+  constexpr std::int64_t maxId = 1 << 22;
+
+  constexpr std::size_t chunkBytes = 8 * 1024 * 1024;
+  constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+
+  std::string_view trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) {
+      s.remove_prefix(1);
+    }
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r')) {
+      s.remove_suffix(1);
+    }
+    return s;
+  }
+
+  // The id at the start of a line, -1 if there is none
+  std::int64_t leadingId(std::string_view line, std::size_t& comma) {
+    std::int64_t id = 0;
+    std::size_t i = 0;
+    for (; i < line.size() && line[i] >= '0' && line[i] <= '9' && i < 10; ++i) {
+      id = id * 10 + (line[i] - '0');
+    }
+    if (i == 0 || i >= line.size() || line[i] != ',') {
+      return -1;
+    }
+    comma = i;
+    return id;
+  }
+
+  // The numeric fields of a stamp line after its id, NaN where there is none
+  std::array<double, 8> stampFields(std::string_view line) {
+    std::array<double, 8> fields{};
+    fields.fill(nan);
+    for (auto& field : fields) {
+      const auto comma = line.find(',');
+      if (comma == std::string_view::npos) {
+        break;
+      }
+      line.remove_prefix(comma + 1);
+      const auto value = trim(line.substr(0, line.find(',')));
+      utilities::parseDouble(value.data(), value.data() + value.size(), field);
+    }
+    return fields;
+  }
+
+  // At the end of the interval, in hours since the start of the environment
+  double stampTime(std::int32_t stamp, std::string_view line) {
+    const auto fields = stampFields(line);
+    switch (stamp) {
+      case intervalStamp:
+        // Day of simulation, month, day of month, DST, hour, start minute, end minute
+        return (fields[0] - 1.0) * 24.0 + (fields[4] - 1.0) + fields[6] / 60.0;
+      case dailyStamp:
+      case monthlyStamp:
+      case runPeriodStamp:
+        // Cumulative days of simulation
+        return fields[0] * 24.0;
+      default:
+        // The calendar year
+        return fields[0];
+    }
+  }
+}  // namespace
+
+// The rows of the chunk, for each environment it covers. The first one continues the environment the previous chunk ended in
+struct EsoFile::DecodedChunk
+{
+  struct Rows
+  {
+    std::vector<double> times;
+    // Row-major, a row is m_numColumns[frequency] values
+    std::vector<double> values;
+  };
+  struct Part
+  {
+    std::string name;
+    bool continues = false;
+    std::array<Rows, numFrequencies> rows;
+  };
+  std::vector<Part> parts;
+  // Where the chunk ends in the file
+  std::size_t end = 0;
+};
+
+EsoFile::EsoFile(std::filesystem::path path) : m_path(std::move(path)) {}
+
+EsoFile::~EsoFile() = default;
+
+void EsoFile::parseDictionary(std::string_view header) {
+  if (!header.starts_with("Program Version")) {
+    throw std::runtime_error(fmt::format("{} is not an ESO or MTR file", m_path));
+  }
+  while (!header.empty()) {
+    const auto eol = header.find('\n');
+    const std::string_view line = trim(header.substr(0, eol));
+    header.remove_prefix(eol == std::string_view::npos ? header.size() : eol + 1);
+
+    std::size_t comma = 0;
+    const auto id = leadingId(line, comma);
+    if (id < 0) {
+      continue;
+    }
+    if (id > maxId) {
+      throw std::runtime_error(fmt::format("{} has a report code out of range in its dictionary: {}", m_path, line.substr(0, comma)));
+    }
+    const auto bang = line.find('!');
+    const auto comment = trim(bang == std::string_view::npos ? std::string_view() : line.substr(bang + 1));
+    const std::optional<Frequency> frequency = parseFrequency(comment);
+    if (m_ids.size() <= static_cast<std::size_t>(id)) {
+      m_ids.resize(static_cast<std::size_t>(id) + 1, unknownId);
+    }
+    if (!frequency) {
+      // The stamp definitions, eg: "2,8,Day of Simulation[],Month[],..."
+      if (id <= annualStamp) {
+        m_ids[id] = -static_cast<std::int32_t>(id);
+      }
+      continue;
+    }
+
+    // "id,numFields,key,Name [units]", or "id,numFields,Name [units]" for meters
+    std::string_view fields = trim(line.substr(0, bang));
+    fields.remove_prefix(std::min(fields.size(), comma + 1));
+    fields.remove_prefix(std::min(fields.size(), fields.find(',') + 1));
+    OutputVariable variable;
+    variable.id = static_cast<int>(id);
+    variable.frequency = *frequency;
+    if (const auto keyEnd = fields.find(','); keyEnd != std::string_view::npos) {
+      variable.key = trim(fields.substr(0, keyEnd));
+      fields.remove_prefix(keyEnd + 1);
+    }
+    const auto unitsStart = fields.rfind('[');
+    const auto unitsEnd = fields.rfind(']');
+    if (unitsStart != std::string_view::npos && unitsEnd != std::string_view::npos && unitsEnd > unitsStart) {
+      variable.units = fields.substr(unitsStart + 1, unitsEnd - unitsStart - 1);
+      fields = fields.substr(0, unitsStart);
+    }
+    variable.name = trim(fields);
+    variable.column = m_numColumns[static_cast<std::size_t>(*frequency)]++;
+    m_ids[id] = static_cast<std::int32_t>(m_variables.size());
+    m_variables.push_back(std::move(variable));
+  }
+}
+
+bool EsoFile::isStampLine(std::string_view text, std::size_t lineStart) const {
+  std::size_t comma = 0;
+  const auto id = leadingId(text.substr(lineStart, 12), comma);
+  return id >= 0 && static_cast<std::size_t>(id) < m_ids.size() && m_ids[id] < 0 && m_ids[id] != unknownId;
+}
+
+EsoFile::DecodedChunk EsoFile::decodeChunk(std::string_view chunk) const {
+  EPCLI_TRACE_SCOPE("EsoFile::decodeChunk");
+  DecodedChunk result;
+  result.parts.emplace_back().continues = true;
+  auto* part = &result.parts.back();
+
+  double time = nan;
+  // Each stamp line starts a new row in the frequencies reported after it
+  std::size_t stamp = 0;
+  std::array<std::size_t, numFrequencies> rowStamps{};
+  rowStamps.fill(std::numeric_limits<std::size_t>::max());
+
+  // One pass over each value line: its id, its value, then the newline after it
+  const char* p = chunk.data();
+  const char* const last = p + chunk.size();
+  const auto nextLine = [last](const char* from) {
+    // Most often right after the value
+    if (from < last && *from == '\n') {
+      return from + 1;
+    }
+    const void* eol = std::memchr(from, '\n', static_cast<std::size_t>(last - from));
+    return (eol == nullptr) ? last : static_cast<const char*>(eol) + 1;
+  };
+  while (p < last) {
+    std::size_t comma = 0;
+    const auto id = leadingId(std::string_view(p, std::min<std::size_t>(static_cast<std::size_t>(last - p), 12)), comma);
+    if (id < 0 || static_cast<std::size_t>(id) >= m_ids.size() || m_ids[id] == unknownId) {
+      p = nextLine(p);
+      continue;
+    }
+    const std::int32_t code = m_ids[id];
+    if (code >= 0) {
+      const auto& variable = m_variables[code];
+      const auto frequency = static_cast<std::size_t>(variable.frequency);
+      const std::size_t numColumns = m_numColumns[frequency];
+      auto& rows = part->rows[frequency];
+      if (rowStamps[frequency] != stamp) {
+        rowStamps[frequency] = stamp;
+        rows.times.push_back(time);
+        rows.values.resize(rows.values.size() + numColumns, nan);
+      }
+      // Daily and longer values go on with their min and max, and when they happened: parsing stops at the comma
+      double value = nan;
+      const char* valueEnd = utilities::parseDouble(p + comma + 1, last, value);
+      rows.values[rows.values.size() - numColumns + variable.column] = value;
+      p = nextLine(valueEnd == nullptr ? p + comma + 1 : valueEnd);
+      continue;
+    }
+
+    const char* lineEnd = nextLine(p);
+    const auto line = trim(std::string_view(p, static_cast<std::size_t>(lineEnd - p)).substr(0, static_cast<std::size_t>(lineEnd - p) - 1));
+    p = lineEnd;
+    ++stamp;
+    if (-code == environmentStamp) {
+      auto name = line.substr(comma + 1);
+      result.parts.emplace_back().name = trim(name.substr(0, name.find(',')));
+      part = &result.parts.back();
+      time = nan;
+    } else {
+      time = stampTime(-code, line);
+    }
+  }
+  return result;
+}
+
+void EsoFile::merge(DecodedChunk&& chunk) {
+  for (auto& part : chunk.parts) {
+    const bool hasRows = std::any_of(part.rows.cbegin(), part.rows.cend(), [](const auto& rows) { return !rows.times.empty(); });
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!part.continues || (m_environments.empty() && hasRows)) {
+      m_environments.push_back(std::make_unique<Environment>());
+      m_environments.back()->name = std::move(part.name);
+    }
+    if (!hasRows) {
+      continue;
+    }
+    auto& environment = *m_environments.back();
+    lock.unlock();
+
+    for (std::size_t f = 0; f < numFrequencies; ++f) {
+      const auto& rows = part.rows[f];
+      const std::size_t numRows = rows.times.size();
+      if (numRows == 0) {
+        continue;
+      }
+      const std::size_t numColumns = m_numColumns[f];
+      lock.lock();
+      auto& buffer = environment.buffers[f];
+      if (!buffer) {
+        buffer = std::make_unique<utilities::ColumnarRingBuffer>(numColumns, numRows);
+      } else if (buffer->size() + numRows > buffer->capacity()) {
+        // Geometric, so that reading a growing file in many small updates doesn't copy it over and over
+        buffer->reserve(std::max(buffer->size() + numRows, 2 * buffer->capacity()));
+      }
+      lock.unlock();
+      for (std::size_t r = 0; r < numRows; ++r) {
+        buffer->push(rows.times[r], std::span<const double>(rows.values.data() + r * numColumns, numColumns));
+      }
+    }
+  }
+}
+
+bool EsoFile::update(const std::atomic<bool>* cancel) {
+  EPCLI_TRACE_SCOPE("EsoFile::update");
+  if (m_complete) {
+    return false;
+  }
+  const utilities::MappedFile file(m_path);
+  const std::string_view text = file.view();
+
+  if (!m_dictionaryRead) {
+    constexpr std::string_view endOfDictionary = "End of Data Dictionary";
+    const auto dictionaryEnd = text.find(endOfDictionary);
+    if (dictionaryEnd == std::string_view::npos) {
+      // Still being written, unless it isn't an ESO file at all
+      if (!text.empty() && !text.starts_with(std::string_view("Program Version").substr(0, text.size()))) {
+        throw std::runtime_error(fmt::format("{} is not an ESO or MTR file", m_path));
+      }
+      return false;
+    }
+    parseDictionary(text.substr(0, dictionaryEnd));
+    const auto eol = text.find('\n', dictionaryEnd);
+    m_offset = (eol == std::string_view::npos) ? text.size() : eol + 1;
+    m_dictionaryRead = true;
+  } else if (text.size() < m_offset) {
+    throw std::runtime_error(fmt::format("{} was truncated while being read", m_path));
+  }
+
+  // Once the run is over the data ends at "End of Data". Until then, at the last stamp line: the values after it may not all be written yet
+  std::size_t end = text.size();
+  bool complete = false;
+  const std::size_t tailStart = std::max(m_offset, text.size() - std::min<std::size_t>(text.size(), 4096));
+  if (const auto marker = text.find("End of Data", tailStart); marker != std::string_view::npos && (marker == 0 || text[marker - 1] == '\n')) {
+    end = marker;
+    complete = true;
+  } else {
+    const auto lastNewline = text.rfind('\n');
+    end = (lastNewline == std::string_view::npos || lastNewline < m_offset) ? m_offset : lastNewline + 1;
+    while (end > m_offset) {
+      const auto previous = text.rfind('\n', end - 2);
+      const std::size_t lineStart = (previous == std::string_view::npos || previous < m_offset) ? m_offset : previous + 1;
+      end = lineStart;
+      if (isStampLine(text, lineStart)) {
+        break;
+      }
+    }
+  }
+  if (end <= m_offset) {
+    m_complete = complete;
+    return false;
+  }
+
+  // Chunks start at a stamp line, so they decode independently
+  std::vector<std::size_t> boundaries = {m_offset};
+  while (boundaries.back() < end) {
+    std::size_t next = std::min(boundaries.back() + chunkBytes, end);
+    while (next < end) {
+      const auto eol = text.find('\n', next);
+      next = (eol == std::string_view::npos || eol + 1 >= end) ? end : eol + 1;
+      if (next < end && isStampLine(text, next)) {
+        break;
+      }
+    }
+    boundaries.push_back(next);
+  }
+
+  const auto decode = [this, &text, &boundaries](std::size_t chunk) {
+    auto decoded = decodeChunk(text.substr(boundaries[chunk], boundaries[chunk + 1] - boundaries[chunk]));
+    decoded.end = boundaries[chunk + 1];
+    return decoded;
+  };
+  const std::size_t numChunks = boundaries.size() - 1;
+  if (numChunks == 1) {
+    merge(decode(0));
+    m_offset = end;
+  } else {
+    // In batches, so that the decoded values of a multi-GB file aren't all held at once, and the buffers fill as the file is read
+    utilities::ThreadPool pool;
+    const std::size_t batchSize = 2 * static_cast<std::size_t>(pool.size());
+    for (std::size_t first = 0; first < numChunks; first += batchSize) {
+      std::vector<std::future<DecodedChunk>> futures;
+      for (std::size_t chunk = first; chunk < std::min(first + batchSize, numChunks); ++chunk) {
+        futures.push_back(pool.submit([&decode, chunk]() { return decode(chunk); }));
+      }
+      for (auto& future : futures) {
+        auto decoded = future.get();
+        m_offset = decoded.end;
+        merge(std::move(decoded));
+        m_progress = static_cast<double>(m_offset) / static_cast<double>(text.size());
+      }
+      if (cancel != nullptr && *cancel) {
+        return true;
+      }
+    }
+  }
+  m_complete = complete;
+  m_progress = complete ? 1.0 : static_cast<double>(m_offset) / static_cast<double>(text.size());
+  return true;
+}
+
+const std::filesystem::path& EsoFile::path() const {
+  return m_path;
+}
+
+bool EsoFile::complete() const {
+  return m_complete;
+}
+
+double EsoFile::progress() const {
+  return m_progress;
+}
+
+const std::vector<OutputVariable>& EsoFile::variables() const {
+  static const std::vector<OutputVariable> none;
+  // Published by the store to m_dictionaryRead, which follows the writes to m_variables
+  return m_dictionaryRead ? m_variables : none;
+}
+
+std::vector<std::string> EsoFile::environments() const {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  std::vector<std::string> names;
+  names.reserve(m_environments.size());
+  for (const auto& environment : m_environments) {
+    names.push_back(environment->name);
+  }
+  return names;
+}
+
+const utilities::ColumnarRingBuffer* EsoFile::buffer(std::size_t environment, Frequency frequency) const {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  if (environment >= m_environments.size()) {
+    return nullptr;
+  }
+  return m_environments[environment]->buffers[static_cast<std::size_t>(frequency)].get();
+}
+
+void EsoFile::copySeries(std::size_t environment, std::size_t variable, std::vector<double>& times, std::vector<double>& values) const {
+  times.clear();
+  values.clear();
+  const auto& outputVariable = variables().at(variable);
+  const auto* rows = buffer(environment, outputVariable.frequency);
+  if (rows == nullptr) {
+    return;
+  }
+  rows->copyColumn(outputVariable.column, times, values, rows->size());
+  // NaN in the rows of the stamps it wasn't reported at
+  std::size_t kept = 0;
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    if (!std::isnan(values[i])) {
+      times[kept] = times[i];
+      values[kept] = values[i];
+      ++kept;
+    }
+  }
+  times.resize(kept);
+  values.resize(kept);
+}
+
+}  // namespace outputs
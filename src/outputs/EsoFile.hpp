@@ -0,0 +1,83 @@
+#ifndef OUTPUTS_ESOFILE_HPP
+#define OUTPUTS_ESOFILE_HPP
+
+#include "TimeSeriesFile.hpp"                   // for TimeSeriesFile, OutputVariable, Frequency
+#include "../utilities/ColumnarRingBuffer.hpp"  // for ColumnarRingBuffer
+
+#include <array>        // for array
+#include <atomic>       // for atomic
+#include <cstddef>      // for size_t
+#include <cstdint>      // for int32_t
+#include <filesystem>   // for path
+#include <memory>       // for unique_ptr
+#include <mutex>        // for mutex
+#include <string>       // for string
+#include <string_view>  // for string_view
+#include <vector>       // for vector
+
+namespace outputs {
+
+/// A streaming reader of the text outputs of EnergyPlus, eplusout.eso and eplusout.mtr, for runs without Output:SQLite.
+///
+/// The file is mapped, its data dictionary parsed, and the data lines decoded in parallel chunks of a few MiB, cut right before a time stamp
+/// line: every value line belongs to the last stamp line above it, so the chunks are independent but for the environment they start in.
+/// Each environment (design day, run period) gets one utilities::ColumnarRingBuffer per reporting frequency, with a column per variable of
+/// that frequency and a row per stamp. Times are in hours since the start of the environment, at the end of the interval (the calendar year
+/// for annual values). Daily and longer values are the mean or sum of the period, their min and max aren't kept.
+///
+/// update() reads what was appended since the previous call: the output of a run in progress can be read as it grows. The buffers can be
+/// read from other threads while it runs
+class EsoFile final : public TimeSeriesFile
+{
+ public:
+  /// Doesn't read anything yet
+  explicit EsoFile(std::filesystem::path path);
+  ~EsoFile() override;
+
+  /// Reads the complete blocks appended since the last call, stopping between two batches of chunks if cancel is set
+  bool update(const std::atomic<bool>* cancel = nullptr) override;
+
+  [[nodiscard]] const std::filesystem::path& path() const override;
+  /// Whether the "End of Data" line was read
+  [[nodiscard]] bool complete() const override;
+  [[nodiscard]] double progress() const override;
+
+  [[nodiscard]] const std::vector<OutputVariable>& variables() const override;
+  [[nodiscard]] std::vector<std::string> environments() const override;
+  void copySeries(std::size_t environment, std::size_t variable, std::vector<double>& times, std::vector<double>& values) const override;
+  /// The values of the variables of a frequency in an environment, nullptr if none were read yet. Valid as long as the EsoFile
+  [[nodiscard]] const utilities::ColumnarRingBuffer* buffer(std::size_t environment, Frequency frequency) const;
+
+ private:
+  struct Environment
+  {
+    std::string name;
+    std::array<std::unique_ptr<utilities::ColumnarRingBuffer>, numFrequencies> buffers;
+  };
+  struct DecodedChunk;
+
+  void parseDictionary(std::string_view header);
+  [[nodiscard]] bool isStampLine(std::string_view text, std::size_t lineStart) const;
+  DecodedChunk decodeChunk(std::string_view chunk) const;
+  void merge(DecodedChunk&& chunk);
+
+  std::filesystem::path m_path;
+  std::vector<OutputVariable> m_variables;
+  // Indexed by id: the index of the variable in m_variables, or a negative stamp kind (-1 environment, -2 timestep or hourly stamp...)
+  std::vector<std::int32_t> m_ids;
+  std::array<std::size_t, numFrequencies> m_numColumns{};
+  // Where the next update starts decoding
+  std::size_t m_offset = 0;
+
+  std::atomic<bool> m_dictionaryRead = false;
+  std::atomic<bool> m_complete = false;
+  std::atomic<double> m_progress = 0.0;
+
+  // Guards the list of environments, not their buffers (which have their own lock)
+  mutable std::mutex m_mutex;
+  std::vector<std::unique_ptr<Environment>> m_environments;
+};
+
+}  // namespace outputs
+
+#endif  // OUTPUTS_ESOFILE_HPP
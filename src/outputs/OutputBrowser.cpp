@@ -0,0 +1,185 @@
+#include "OutputBrowser.hpp"
+
+#include "TimeSeriesFile.hpp"             // for TimeSeriesFile, OutputVariable, frequencyName, seriesStats
+#include "../TimeSeriesComponent.hpp"     // for renderTimeSeriesChart
+#include "../utilities/ASCIIStrings.hpp"  // for ascii_to_lower_copy
+
+#include <ftxui/component/component.hpp>  // for Input, Menu, Radiobox, Container
+#include <ftxui/dom/elements.hpp>         // for text, window, vbox, hbox, separator, operator|, size, flex, gauge, center
+#include <ftxui/screen/color.hpp>         // for Color
+
+#include <fmt/format.h>  // for format
+#include <fmt/std.h>     // for formatting std::filesystem::path // IWYU pragma: keep
+
+#include <algorithm>  // for max, min
+#include <chrono>     // for milliseconds
+#include <exception>  // for exception
+#include <utility>    // for move
+
+using namespace ftxui;
+
+namespace {
+// How often the file of a run that stopped before writing "End of Data" is checked for more
+constexpr std::chrono::milliseconds pollInterval{500};
+}  // namespace
+
+OutputBrowserComponent::OutputBrowserComponent(std::function<void()> requestRedraw) : m_requestRedraw(std::move(requestRedraw)) {
+  m_filterInput = Input(&m_filter, "filter variables");
+  m_environmentSelector = Radiobox(&m_environmentNames, &m_selectedEnvironment);
+  m_variableMenu = Menu(&m_variableLabels, &m_selectedVariable);
+
+  Add(Container::Vertical({
+    m_filterInput,
+    m_environmentSelector,
+    m_variableMenu,
+  }));
+}
+
+OutputBrowserComponent::~OutputBrowserComponent() {
+  reset();
+}
+
+void OutputBrowserComponent::setFile(const std::filesystem::path& path) {
+  if (m_file && path == m_path) {
+    return;
+  }
+
+  reset();
+  m_path = path;
+  m_file = outputs::TimeSeriesFile::open(path);
+  m_loader = std::thread([this]() { load(); });
+}
+
+void OutputBrowserComponent::reset() {
+  {
+    const std::lock_guard lock(m_mutex);
+    m_stop = true;
+  }
+  m_stopped.notify_one();
+  if (m_loader.joinable()) {
+    m_loader.join();
+  }
+  m_stop = false;
+
+  m_file.reset();
+  m_path.clear();
+  m_errorMessage.clear();
+  m_appliedFilter.clear();
+  m_filterApplied = false;
+  m_variableLabels.clear();
+  m_variableIndices.clear();
+  m_selectedVariable = 0;
+  m_environmentNames.clear();
+  m_selectedEnvironment = 0;
+}
+
+void OutputBrowserComponent::load() {
+  try {
+    while (!m_stop) {
+      if (m_file->update(&m_stop)) {
+        m_requestRedraw();
+      }
+      if (m_file->complete()) {
+        return;
+      }
+      std::unique_lock lock(m_mutex);
+      m_stopped.wait_for(lock, pollInterval, [this]() { return m_stop.load(); });
+    }
+  } catch (const std::exception& e) {
+    {
+      const std::lock_guard lock(m_mutex);
+      m_errorMessage = e.what();
+    }
+    m_requestRedraw();
+  }
+}
+
+void OutputBrowserComponent::applyFilter() {
+  m_appliedFilter = m_filter;
+  m_filterApplied = true;
+  m_variableLabels.clear();
+  m_variableIndices.clear();
+
+  const std::string filter = utilities::ascii_to_lower_copy(m_filter);
+  const auto& variables = m_file->variables();
+  for (std::size_t i = 0; i < variables.size(); ++i) {
+    std::string label = variables[i].label();
+    if (!filter.empty() && utilities::ascii_to_lower_copy(label).find(filter) == std::string::npos) {
+      continue;
+    }
+    m_variableLabels.emplace_back(std::move(label));
+    m_variableIndices.push_back(i);
+  }
+  m_selectedVariable = std::max(0, std::min(m_selectedVariable, static_cast<int>(m_variableIndices.size()) - 1));
+}
+
+Element OutputBrowserComponent::RenderChart() {
+  if (m_variableIndices.empty()) {
+    return text(fmt::format("No variable matches '{}'", m_filter)) | center;
+  }
+  if (m_environmentNames.empty()) {
+    return text("Waiting for the first environment...") | center;
+  }
+
+  const std::size_t variableIndex = m_variableIndices[static_cast<std::size_t>(m_selectedVariable)];
+  const auto& variable = m_file->variables()[variableIndex];
+  m_file->copySeries(static_cast<std::size_t>(m_selectedEnvironment), variableIndex, m_times, m_values);
+  if (m_values.empty()) {
+    return text(fmt::format("No {} values in {}", outputs::frequencyName(variable.frequency),
+                            m_environmentNames[static_cast<std::size_t>(m_selectedEnvironment)])) |
+           center;
+  }
+
+  const auto stats = outputs::seriesStats(m_values);
+  return renderTimeSeriesChart(m_times, m_values,
+                               text(fmt::format("{} {} values, mean {:.2f}, sum {:.6g}", stats.count, outputs::frequencyName(variable.frequency),
+                                                stats.mean, stats.sum)) |
+                                 color(Color::GrayDark));
+}
+
+Element OutputBrowserComponent::Render() {
+  if (!m_file) {
+    return text("NOTHING TO SHOW") | center;
+  }
+  {
+    const std::lock_guard lock(m_mutex);
+    if (!m_errorMessage.empty()) {
+      return text(m_errorMessage) | color(Color::Red) | center;
+    }
+  }
+  // Empty until the header is read, fixed afterwards
+  if (m_file->variables().empty()) {
+    return text(fmt::format("Reading the header of {}...", m_path)) | center;
+  }
+
+  if (!m_filterApplied || m_filter != m_appliedFilter) {
+    applyFilter();
+  }
+  m_environmentNames = m_file->environments();
+  m_selectedEnvironment = std::max(0, std::min(m_selectedEnvironment, static_cast<int>(m_environmentNames.size()) - 1));
+
+  const std::string title = m_variableIndices.empty() ? m_path.filename().string() : m_variableLabels[m_selectedVariable];
+  Element status = text(fmt::format("{}, complete", m_path.filename())) | color(Color::GrayDark);
+  if (!m_file->complete()) {
+    const double progress = m_file->progress();
+    status = hbox({
+      text(fmt::format("Reading {} ", m_path.filename())),
+      gauge(static_cast<float>(progress)) | flex,
+      text(fmt::format(" {:.0f} %", progress * 100.0)),
+    });
+  }
+
+  return vbox({
+    hbox({
+      vbox({
+        window(text("Filter"), m_filterInput->Render()),
+        window(text("Environments"), m_environmentSelector->Render()),
+        window(text(fmt::format("Variables ({}/{})", m_variableLabels.size(), m_file->variables().size())),
+               m_variableMenu->Render() | vscroll_indicator | frame) |
+          flex,
+      }) | ftxui::size(WIDTH, LESS_THAN, 70),
+      window(text(title), RenderChart()) | flex,
+    }) | flex,
+    status,
+  });
+}
@@ -0,0 +1,75 @@
+#ifndef OUTPUTS_OUTPUTBROWSER_HPP
+#define OUTPUTS_OUTPUTBROWSER_HPP
+
+#include <ftxui/component/component_base.hpp>  // for ComponentBase, Component
+#include <ftxui/dom/elements.hpp>              // for Element
+
+#include <atomic>              // for atomic
+#include <condition_variable>  // for condition_variable
+#include <cstddef>             // for size_t
+#include <filesystem>          // for path
+#include <functional>          // for function
+#include <memory>              // for unique_ptr
+#include <mutex>               // for mutex
+#include <string>              // for string
+#include <thread>              // for thread
+#include <vector>              // for vector
+
+namespace outputs {
+class TimeSeriesFile;
+}
+
+/// Browser of the time series of eplusout.eso, eplusout.mtr or a CSV output, for the runs without Output:SQLite. The file is read by an
+/// outputs::TimeSeriesFile on a background thread, and can be browsed while it loads: the variables as soon as the header is read, their
+/// values as they come
+class OutputBrowserComponent : public ftxui::ComponentBase
+{
+ public:
+  /// requestRedraw is called from the loading thread whenever more of the file was read
+  explicit OutputBrowserComponent(std::function<void()> requestRedraw);
+  ~OutputBrowserComponent() override;
+
+  /// Starts loading the file if it isn't the one being browsed
+  void setFile(const std::filesystem::path& path);
+  /// Stops loading and drops the values
+  void reset();
+
+  ftxui::Element Render() override;
+
+ private:
+  // The body of m_loader
+  void load();
+  ftxui::Element RenderChart();
+  void applyFilter();
+
+  std::function<void()> m_requestRedraw;
+  std::filesystem::path m_path;
+  std::unique_ptr<outputs::TimeSeriesFile> m_file;
+
+  std::thread m_loader;
+  std::atomic<bool> m_stop = false;
+  std::mutex m_mutex;
+  std::condition_variable m_stopped;
+  // Guarded by m_mutex, set by the loader
+  std::string m_errorMessage;
+
+  std::string m_filter;
+  std::string m_appliedFilter;
+  bool m_filterApplied = false;
+  // The labels displayed in the menu, and the index in TimeSeriesFile::variables() for each of them
+  std::vector<std::string> m_variableLabels;
+  std::vector<std::size_t> m_variableIndices;
+  int m_selectedVariable = 0;
+  std::vector<std::string> m_environmentNames;
+  int m_selectedEnvironment = 0;
+
+  // Reused across frames
+  std::vector<double> m_times;
+  std::vector<double> m_values;
+
+  ftxui::Component m_filterInput;
+  ftxui::Component m_environmentSelector;
+  ftxui::Component m_variableMenu;
+};
+
+#endif  // OUTPUTS_OUTPUTBROWSER_HPP
@@ -0,0 +1,61 @@
+#include "TimeSeriesFile.hpp"
+
+#include "CsvFile.hpp"  // for CsvFile
+#include "EsoFile.hpp"  // for EsoFile
+
+#include <fmt/format.h>  // for format
+
+#include <algorithm>  // for min, max
+#include <array>      // for array
+#include <limits>     // for numeric_limits
+
+namespace outputs {
+
+namespace {
+  constexpr std::array<std::string_view, numFrequencies> frequencyNames = {"Each Call", "TimeStep", "Hourly", "Daily", "Monthly", "RunPeriod",
+                                                                           "Annual"};
+}  // namespace
+
+std::string_view frequencyName(Frequency frequency) {
+  return frequencyNames[static_cast<std::size_t>(frequency)];
+}
+
+std::optional<Frequency> parseFrequency(std::string_view text) {
+  for (std::size_t f = 0; f < numFrequencies; ++f) {
+    if (text.starts_with(frequencyNames[f])) {
+      return static_cast<Frequency>(f);
+    }
+  }
+  return std::nullopt;
+}
+
+std::string OutputVariable::label() const {
+  return fmt::format("{}{}{} [{}] {}", key, key.empty() ? "" : ":", name, units, frequencyName(frequency));
+}
+
+SeriesStats seriesStats(std::span<const double> values) {
+  SeriesStats stats;
+  if (values.empty()) {
+    stats.mean = stats.min = stats.max = stats.sum = std::numeric_limits<double>::quiet_NaN();
+    return stats;
+  }
+  stats.count = values.size();
+  stats.min = values.front();
+  stats.max = values.front();
+  for (const double value : values) {
+    stats.sum += value;
+    stats.min = std::min(stats.min, value);
+    stats.max = std::max(stats.max, value);
+  }
+  stats.mean = stats.sum / static_cast<double>(stats.count);
+  return stats;
+}
+
+std::unique_ptr<TimeSeriesFile> TimeSeriesFile::open(const std::filesystem::path& path) {
+  if (path.extension() == ".csv") {
+    return std::make_unique<CsvFile>(path);
+  }
+  return std::make_unique<EsoFile>(path);
+}
+
+}  // namespace outputs
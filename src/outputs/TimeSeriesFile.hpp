@@ -0,0 +1,97 @@
+#ifndef OUTPUTS_TIMESERIESFILE_HPP
+#define OUTPUTS_TIMESERIESFILE_HPP
+
+#include <atomic>       // for atomic
+#include <cstddef>      // for size_t
+#include <cstdint>      // for uint8_t
+#include <filesystem>   // for path
+#include <memory>       // for unique_ptr
+#include <optional>     // for optional
+#include <span>         // for span
+#include <string>       // for string
+#include <string_view>  // for string_view
+#include <vector>       // for vector
+
+namespace outputs {
+
+enum class Frequency : std::uint8_t
+{
+  EachCall,
+  TimeStep,
+  Hourly,
+  Daily,
+  Monthly,
+  RunPeriod,
+  Annual,
+};
+inline constexpr std::size_t numFrequencies = 7;
+
+/// As EnergyPlus writes it: "Each Call", "TimeStep", "Hourly"...
+std::string_view frequencyName(Frequency frequency);
+/// The frequency whose name text starts with
+std::optional<Frequency> parseFrequency(std::string_view text);
+
+/// An output variable or meter of a time series file
+struct OutputVariable
+{
+  /// The id in the data dictionary of an ESO, the column of a CSV
+  int id = 0;
+  /// Empty for meters, and in CSV files where the key can't be told from the name
+  std::string key;
+  std::string name;
+  std::string units;
+  Frequency frequency = Frequency::Hourly;
+  /// Where the file reader keeps its values
+  std::size_t column = 0;
+
+  /// "key:name [units] frequency", as in the dictionary
+  [[nodiscard]] std::string label() const;
+};
+
+/// Of the values of a series, NaN (and a count of 0) if there is none
+struct SeriesStats
+{
+  std::size_t count = 0;
+  double mean = 0.0;
+  double min = 0.0;
+  double max = 0.0;
+  /// What a meter in J adds up to over the environment
+  double sum = 0.0;
+};
+
+SeriesStats seriesStats(std::span<const double> values);
+
+/// The time series outputs of EnergyPlus besides the SQL database: outputs::EsoFile for eplusout.eso and eplusout.mtr, outputs::CsvFile for
+/// eplusout.csv and eplusmtr.csv. update() runs on one thread, the accessors can be called from any other while it does
+class TimeSeriesFile
+{
+ public:
+  /// A CsvFile for a .csv, an EsoFile otherwise. Doesn't read anything yet
+  static std::unique_ptr<TimeSeriesFile> open(const std::filesystem::path& path);
+
+  TimeSeriesFile() = default;
+  TimeSeriesFile(const TimeSeriesFile&) = delete;
+  TimeSeriesFile& operator=(const TimeSeriesFile&) = delete;
+  virtual ~TimeSeriesFile() = default;
+
+  /// Reads what wasn't read yet, stopping early if cancel is set. Returns whether anything new was read. Throws std::runtime_error if the
+  /// file cannot be read or isn't of the expected format. Not to be called concurrently
+  virtual bool update(const std::atomic<bool>* cancel = nullptr) = 0;
+
+  [[nodiscard]] virtual const std::filesystem::path& path() const = 0;
+  /// Whether the whole file was read
+  [[nodiscard]] virtual bool complete() const = 0;
+  /// The fraction of the file read, as of the last update
+  [[nodiscard]] virtual double progress() const = 0;
+
+  /// Empty until the header was read. Doesn't change afterwards
+  [[nodiscard]] virtual const std::vector<OutputVariable>& variables() const = 0;
+  [[nodiscard]] virtual std::vector<std::string> environments() const = 0;
+  /// Copies the values of variables()[variable] read so far in an environment, oldest first, with their times in hours, into the output
+  /// vectors, reusing their storage. Rows where the variable has no value are left out
+  virtual void copySeries(std::size_t environment, std::size_t variable, std::vector<double>& times, std::vector<double>& values) const = 0;
+};
+
+}  // namespace outputs
+
+#endif  // OUTPUTS_TIMESERIESFILE_HPP
@@ -0,0 +1,241 @@
+#include "JobTable.hpp"
+
+#include "PreparedStatement.hpp"  // for PreparedStatement
+
+#include <sqlite3.h>  // for sqlite3_open_v2, sqlite3_exec, sqlite3_changes, sqlite3_busy_timeout, sqlite3_get_autocommit
+
+#include <fmt/format.h>  // for format
+
+#include <algorithm>  // for min
+#include <cstdint>    // for uint64_t
+#include <random>     // for random_device
+#include <stdexcept>  // for runtime_error
+#include <utility>    // for move
+
+namespace sql {
+
+namespace {
+  constexpr auto schema = R"sql(
+    CREATE TABLE IF NOT EXISTS Jobs (
+      JobId INTEGER PRIMARY KEY,
+      Input TEXT NOT NULL,
+      OutputRoot TEXT NOT NULL,
+      Arguments TEXT NOT NULL,
+      State TEXT NOT NULL DEFAULT 'pending',
+      Attempts INTEGER NOT NULL DEFAULT 0,
+      Node TEXT,
+      LeaseToken TEXT,
+      LeaseExpires REAL,
+      Heartbeat REAL,
+      StartedAt REAL,
+      FinishedAt REAL,
+      RunSeconds REAL,
+      NetSiteEnergy REAL,
+      Warnings INTEGER,
+      Severes INTEGER,
+      Error TEXT
+    );
+    CREATE INDEX IF NOT EXISTS JobsByState ON Jobs (State, JobId);
+    CREATE INDEX IF NOT EXISTS JobsByLease ON Jobs (LeaseToken);)sql";
+
+  // Arguments are stored one per line
+  constexpr char argumentSeparator = '\n';
+
+  // Seconds since the epoch: leases are compared across machines, so a steady clock won't do
+  double wallClock() {
+    return std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+  }
+
+  void execScript(sqlite3* db, const char* script) {
+    char* err = nullptr;
+    if (sqlite3_exec(db, script, nullptr, nullptr, &err) != SQLITE_OK) {
+      const std::string errMsg = (err != nullptr) ? err : "unknown error";
+      sqlite3_free(err);
+      throw std::runtime_error("Job table: " + errMsg);
+    }
+  }
+
+  void execute(PreparedStatement& statement, sqlite3* db, const char* what) {
+    if (statement.execute() != SQLITE_DONE) {
+      throw std::runtime_error(fmt::format("Job table: {} failed: {}", what, sqlite3_errmsg(db)));
+    }
+  }
+
+  // PreparedStatement commits its transaction when destroyed, and ignores a failed COMMIT (eg: still busy after the timeout)
+  void ensureCommitted(sqlite3* db) {
+    if (sqlite3_get_autocommit(db) == 0) {
+      const std::string errMsg = sqlite3_errmsg(db);
+      sqlite3_exec(db, "ROLLBACK", nullptr, nullptr, nullptr);
+      throw std::runtime_error("Job table: could not commit: " + errMsg);
+    }
+  }
+
+  // A failed statement must not be committed along with the rest when the transaction's PreparedStatement goes out of scope: after a
+  // ROLLBACK, its COMMIT is a no-op
+  void rollback(sqlite3* db) {
+    sqlite3_exec(db, "ROLLBACK", nullptr, nullptr, nullptr);
+  }
+
+  std::string newLeaseToken(const std::string& nodeName) {
+    std::random_device device;
+    const auto random = (static_cast<std::uint64_t>(device()) << 32U) | device();
+    return fmt::format("{}/{:016x}", nodeName, random);
+  }
+}  // namespace
+
+JobTable::JobTable(const std::filesystem::path& databasePath, std::string nodeName, std::chrono::seconds leaseDuration, int maxAttempts)
+  : m_nodeName(std::move(nodeName)), m_leaseDuration(leaseDuration), m_maxAttempts(maxAttempts) {
+  const std::string fileName = databasePath.string();
+  if (sqlite3_open_v2(fileName.c_str(), &m_db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, nullptr) != SQLITE_OK) {
+    const std::string errMsg = m_db != nullptr ? sqlite3_errmsg(m_db) : "out of memory";
+    sqlite3_close(m_db);
+    throw std::runtime_error(fmt::format("Could not open the job table at '{}': {}", fileName, errMsg));
+  }
+  // Nodes wait on each other's claims, which only take milliseconds
+  sqlite3_busy_timeout(m_db, 30'000);
+  try {
+    // WAL needs shared memory between the processes, which network filesystems don't provide: keep the rollback journal
+    execScript(m_db, "PRAGMA journal_mode=DELETE; PRAGMA synchronous=FULL;");
+    execScript(m_db, schema);
+  } catch (const std::exception&) {
+    sqlite3_close(m_db);
+    throw;
+  }
+}
+
+JobTable::~JobTable() {
+  sqlite3_close(m_db);
+}
+
+std::vector<int> JobTable::enqueue(const std::vector<std::filesystem::path>& inputs, const std::filesystem::path& outputRoot,
+                                   const std::vector<std::string>& arguments) {
+  std::string joinedArguments;
+  for (const auto& argument : arguments) {
+    if (!joinedArguments.empty()) {
+      joinedArguments += argumentSeparator;
+    }
+    joinedArguments += argument;
+  }
+  // Absolute: the nodes run from other directories, the shared volume being mounted at the same place on all of them
+  const std::string root = std::filesystem::absolute(outputRoot).string();
+
+  std::vector<int> ids;
+  ids.reserve(inputs.size());
+  {
+    PreparedStatement insert("INSERT INTO Jobs (Input, OutputRoot, Arguments) VALUES (?, ?, ?);", m_db, true);
+    try {
+      for (const auto& input : inputs) {
+        if (!insert.bindAll(std::filesystem::absolute(input).string(), root, joinedArguments)) {
+          throw std::runtime_error("Job table: could not bind the job");
+        }
+        execute(insert, m_db, "enqueue");
+        ids.push_back(static_cast<int>(sqlite3_last_insert_rowid(m_db)));
+      }
+    } catch (const std::exception&) {
+      rollback(m_db);
+      throw;
+    }
+  }
+  ensureCommitted(m_db);
+  return ids;
+}
+
+std::optional<Job> JobTable::claim() {
+  const double now = wallClock();
+  const auto token = newLeaseToken(m_nodeName);
+  std::optional<Job> job;
+  {
+    // The node of a job whose lease expired that many times probably died because of it
+    PreparedStatement giveUp(R"sql(
+      UPDATE Jobs SET State = 'failed', FinishedAt = ?, LeaseExpires = NULL, Error = ?
+        WHERE State = 'running' AND LeaseExpires < ? AND Attempts >= ?;)sql",
+                             m_db, true, now, fmt::format("lease expired {} times", m_maxAttempts), now, m_maxAttempts);
+    try {
+      execute(giveUp, m_db, "failing abandoned jobs");
+
+      // A single statement: the oldest claimable job changes hands atomically, whichever node gets the write lock first
+      PreparedStatement claim(R"sql(
+        UPDATE Jobs SET State = 'running', Node = ?, LeaseToken = ?, LeaseExpires = ?, Heartbeat = ?, StartedAt = ?, Attempts = Attempts + 1
+          WHERE JobId = (SELECT JobId FROM Jobs
+                           WHERE State = 'pending' OR (State = 'running' AND LeaseExpires < ?)
+                           ORDER BY JobId LIMIT 1);)sql",
+                              m_db, false, m_nodeName, token, now + static_cast<double>(m_leaseDuration.count()), now, now, now);
+      execute(claim, m_db, "claim");
+
+      if (sqlite3_changes(m_db) == 1) {
+        PreparedStatement read("SELECT JobId, Input, OutputRoot, Arguments, Attempts FROM Jobs WHERE LeaseToken = ?;", m_db, false, token);
+        if (read.step()) {
+          job.emplace();
+          job->id = read.getColumnAsInt(0);
+          job->input = read.getColumnAsString(1);
+          job->outputDirectory = std::filesystem::path(read.getColumnAsString(2)) / fmt::format("job-{:05}", job->id);
+          const auto arguments = read.getColumnAsString(3);
+          for (std::size_t begin = 0; begin < arguments.size();) {
+            const auto end = std::min(arguments.find(argumentSeparator, begin), arguments.size());
+            job->arguments.emplace_back(arguments.substr(begin, end - begin));
+            begin = end + 1;
+          }
+          job->attempt = read.getColumnAsInt(4);
+          job->leaseToken = token;
+          read.step();
+        }
+      }
+    } catch (const std::exception&) {
+      rollback(m_db);
+      throw;
+    }
+  }
+  ensureCommitted(m_db);
+  return job;
+}
+
+bool JobTable::heartbeat(const Job& job) {
+  const double now = wallClock();
+  PreparedStatement beat("UPDATE Jobs SET LeaseExpires = ?, Heartbeat = ? WHERE JobId = ? AND LeaseToken = ? AND State = 'running';", m_db,
+                         false, now + static_cast<double>(m_leaseDuration.count()), now, job.id, job.leaseToken);
+  execute(beat, m_db, "heartbeat");
+  return sqlite3_changes(m_db) == 1;
+}
+
+bool JobTable::complete(const Job& job, const JobResult& result) {
+  PreparedStatement update(R"sql(
+    UPDATE Jobs SET State = ?, FinishedAt = ?, LeaseExpires = NULL, RunSeconds = ?, NetSiteEnergy = ?, Warnings = ?, Severes = ?, Error = ?
+      WHERE JobId = ? AND LeaseToken = ? AND State = 'running';)sql",
+                           m_db, false, result.succeeded ? "done" : "failed", wallClock(), result.seconds, result.netSiteEnergy,
+                           result.warnings, result.severes, result.error, job.id, job.leaseToken);
+  execute(update, m_db, "complete");
+  return sqlite3_changes(m_db) == 1;
+}
+
+int JobTable::remaining() const {
+  const PreparedStatement count("SELECT COUNT(*) FROM Jobs WHERE State IN ('pending', 'running');", m_db, false);
+  return count.execAndReturnFirstInt().value_or(0);
+}
+
+std::vector<JobStatus> JobTable::status() const {
+  PreparedStatement select(R"sql(
+    SELECT JobId, Input, State, COALESCE(Node, ''), Attempts,
+           CASE State WHEN 'running' THEN ? - Heartbeat ELSE COALESCE(RunSeconds, 0) END,
+           NetSiteEnergy IS NOT NULL, NetSiteEnergy, COALESCE(Warnings, 0), COALESCE(Severes, 0), COALESCE(Error, '')
+      FROM Jobs ORDER BY JobId;)sql",
+                           m_db, false, wallClock());
+  std::vector<JobStatus> result;
+  while (select.step()) {
+    JobStatus& job = result.emplace_back();
+    job.id = select.getColumnAsInt(0);
+    job.input = select.getColumnAsString(1);
+    job.state = select.getColumnAsString(2);
+    job.node = select.getColumnAsString(3);
+    job.attempts = select.getColumnAsInt(4);
+    job.seconds = select.getColumnAsDouble(5);
+    if (select.getColumnAsInt(6) != 0) {
+      job.netSiteEnergy = select.getColumnAsDouble(7);
+    }
+    job.warnings = select.getColumnAsInt(8);
+    job.severes = select.getColumnAsInt(9);
+    job.error = select.getColumnAsString(10);
+  }
+  return result;
+}
+
+}  // namespace sql
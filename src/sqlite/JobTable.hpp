@@ -0,0 +1,97 @@
+#ifndef SQL_JOBTABLE_HPP
+#define SQL_JOBTABLE_HPP
+
+#include <chrono>      // for seconds
+#include <filesystem>  // for path
+#include <optional>    // for optional
+#include <string>      // for string
+#include <vector>      // for vector
+
+struct sqlite3;
+
+namespace sql {
+
+/// A job as claimed by a node: valid until its lease expires, which heartbeat() pushes back
+struct Job
+{
+  int id = 0;
+  std::filesystem::path input;
+  std::filesystem::path outputDirectory;
+  /// Passed to EnergyPlus before -d and the input (eg: -w weather.epw)
+  std::vector<std::string> arguments;
+  /// 1 for the first claim, more if a node died while running it
+  int attempt = 0;
+  std::string leaseToken;
+};
+
+struct JobResult
+{
+  bool succeeded = false;
+  std::optional<double> netSiteEnergy;
+  int warnings = 0;
+  int severes = 0;
+  double seconds = 0.0;
+  std::string error;
+};
+
+/// A row of the table, for status reports
+struct JobStatus
+{
+  int id = 0;
+  std::string input;
+  std::string state;
+  std::string node;
+  int attempts = 0;
+  /// Seconds since the last heartbeat of a running job, or the run time of a finished one
+  double seconds = 0.0;
+  std::optional<double> netSiteEnergy;
+  int warnings = 0;
+  int severes = 0;
+  std::string error;
+};
+
+/// A queue of EnergyPlus runs in a SQLite database on a filesystem shared by several machines (eg: NFS), with no other coordination:
+/// each node claims pending jobs under a lease it renews with heartbeats while the run goes, and writes the results back. A job whose lease
+/// expired (its node died, or lost the volume) is claimed again by another node, up to maxAttempts times.
+///
+/// Every claim and update is a single statement guarded by the claimer's lease token, in a transaction: two nodes never run the same job
+/// under a live lease, and a node that lost its lease can't overwrite the results of the node that took over. Leases are wall clock times,
+/// so the clocks of the nodes must be synchronized (NTP) well within the lease duration. Not thread-safe: one JobTable per thread
+class JobTable
+{
+ public:
+  /// Opens the job table, creating it if needed. nodeName identifies this process in the table (eg: utilities::nodeName())
+  JobTable(const std::filesystem::path& databasePath, std::string nodeName, std::chrono::seconds leaseDuration = std::chrono::seconds(60),
+           int maxAttempts = 3);
+  JobTable(const JobTable&) = delete;
+  JobTable& operator=(const JobTable&) = delete;
+  ~JobTable();
+
+  /// Adds the runs of each input, all in one transaction. Each gets <outputRoot>/job-<id> as output directory. Returns their ids
+  std::vector<int> enqueue(const std::vector<std::filesystem::path>& inputs, const std::filesystem::path& outputRoot,
+                           const std::vector<std::string>& arguments);
+
+  /// Claims the oldest job that is pending, or whose lease expired. Empty when there is none
+  std::optional<Job> claim();
+
+  /// Extends the lease of a claimed job. False if it was lost: expired, and claimed by another node
+  bool heartbeat(const Job& job);
+
+  /// Writes the results of a claimed job, and releases it. False if the lease was lost, in which case nothing is written
+  bool complete(const Job& job, const JobResult& result);
+
+  /// Jobs left to run: pending ones, and running ones that may yet expire and be claimed again
+  [[nodiscard]] int remaining() const;
+
+  [[nodiscard]] std::vector<JobStatus> status() const;
+
+ private:
+  sqlite3* m_db = nullptr;
+  std::string m_nodeName;
+  std::chrono::seconds m_leaseDuration;
+  int m_maxAttempts;
+};
+
+}  // namespace sql
+
+#endif  // SQL_JOBTABLE_HPP
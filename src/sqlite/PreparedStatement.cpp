@@ -57,6 +57,10 @@ bool PreparedStatement::bind(int position, double val) {
   return sqlite3_bind_double(m_statement, position, val) == SQLITE_OK;
 }
 
+bool PreparedStatement::bindNull(int position) {
+  return sqlite3_bind_null(m_statement, position) == SQLITE_OK;
+}
+
 int PreparedStatement::execute() {
   const int code = sqlite3_step(m_statement);
   sqlite3_reset(m_statement);
@@ -183,6 +187,36 @@ std::optional<std::vector<std::string>> PreparedStatement::execAndReturnVectorOf
   return valueVector;
 }
 
+void PreparedStatement::resetAndClearBindings() {
+  sqlite3_reset(m_statement);
+  sqlite3_clear_bindings(m_statement);
+}
+
+bool PreparedStatement::step() {
+  const int code = sqlite3_step(m_statement);
+  if (code == SQLITE_ROW) {
+    return true;
+  }
+  sqlite3_reset(m_statement);
+  return false;
+}
+
+int PreparedStatement::getColumnAsInt(int column) const {
+  return sqlite3_column_int(m_statement, column);
+}
+
+double PreparedStatement::getColumnAsDouble(int column) const {
+  return sqlite3_column_double(m_statement, column);
+}
+
+std::string PreparedStatement::getColumnAsString(int column) const {
+  const unsigned char* text = sqlite3_column_text(m_statement, column);
+  if (text == nullptr) {
+    return {};
+  }
+  return columnText(text);
+}
+
 PreparedStatement::PreparedStatement(PreparedStatement::InternalConstructor /*unused*/, const std::string& t_stmt, sqlite3* t_db, bool t_transaction)
   : m_db(t_db), m_statement(nullptr), m_transaction(t_transaction) {
   if (m_transaction) {
@@ -53,6 +53,14 @@ class PreparedStatement
 
   bool bind(int position, double val);
 
+  bool bindNull(int position);
+
+  /** NULL when empty. */
+  template <typename T>
+  bool bind(int position, const std::optional<T>& val) {
+    return val ? bind(position, *val) : bindNull(position);
+  }
+
   // Makes no sense
   bool bind(int position, char val) = delete;
 
@@ -119,6 +127,18 @@ class PreparedStatement
 
   /// execute a statement and return the results (if any) in a vector of string
   [[nodiscard]] std::optional<std::vector<std::string>> execAndReturnVectorOfString() const;
+
+  /// Resets the statement so it can be executed again, and sets all its parameters back to NULL
+  void resetAndClearBindings();
+
+  /// Steps to the next result row, for statements returning several columns. Returns false (and resets the statement) once there are no more rows
+  bool step();
+
+  /// Accessors for the current row after a successful step(), column is 0-indexed
+  [[nodiscard]] int getColumnAsInt(int column) const;
+  [[nodiscard]] double getColumnAsDouble(int column) const;
+  // Returns an empty string for NULL
+  [[nodiscard]] std::string getColumnAsString(int column) const;
 };
 }  // namespace sql
 #endif  // UTILITIES_SQL_PREPAREDSTATEMENT_HPP
@@ -0,0 +1,87 @@
+#include "RunComparison.hpp"
+
+#include "../utilities/ThreadPool.hpp"  // for ThreadPool
+
+#include <algorithm>  // for find
+#include <exception>  // for exception
+#include <future>     // for future
+#include <iterator>   // for distance
+
+namespace sql {
+
+namespace {
+  RunSummary extractRunSummary(const std::filesystem::path& databasePath) {
+    RunSummary summary;
+    summary.databasePath = databasePath;
+    try {
+      // The runs are done, no need to copy the file: each worker gets its own connection straight to the database
+      const SQLiteReports report(databasePath, false);
+      summary.energyPlusVersion = report.energyPlusVersion();
+      summary.netSiteEnergy = report.netSiteEnergy();
+      summary.endUses = report.endUseByFuelTable();
+    } catch (const std::exception& e) {
+      summary.errorMessage = e.what();
+    }
+    return summary;
+  }
+
+  size_t indexOrAppend(std::vector<std::string>& names, const std::string& name) {
+    auto it = std::find(names.cbegin(), names.cend(), name);
+    if (it != names.cend()) {
+      return static_cast<size_t>(std::distance(names.cbegin(), it));
+    }
+    names.push_back(name);
+    return names.size() - 1;
+  }
+}  // namespace
+
+std::vector<RunSummary> collectRunSummaries(const std::vector<std::filesystem::path>& databasePaths, unsigned numThreads) {
+  std::vector<std::future<RunSummary>> futures;
+  futures.reserve(databasePaths.size());
+
+  std::vector<RunSummary> result;
+  result.reserve(databasePaths.size());
+  {
+    utilities::ThreadPool pool(numThreads);
+    for (const auto& databasePath : databasePaths) {
+      futures.emplace_back(pool.submit([&databasePath]() { return extractRunSummary(databasePath); }));
+    }
+    for (auto& future : futures) {
+      result.emplace_back(future.get());
+    }
+  }
+  return result;
+}
+
+std::vector<EndUseTable> alignEndUseTables(const std::vector<RunSummary>& summaries) {
+  std::vector<std::string> endUseNames;
+  std::vector<std::string> fuelNames;
+  for (const auto& summary : summaries) {
+    for (const auto& endUseName : summary.endUses.endUseNames) {
+      indexOrAppend(endUseNames, endUseName);
+    }
+    for (const auto& fuelName : summary.endUses.fuelNames) {
+      indexOrAppend(fuelNames, fuelName);
+    }
+  }
+
+  std::vector<EndUseTable> result;
+  result.reserve(summaries.size());
+  for (const auto& summary : summaries) {
+    auto& aligned = result.emplace_back();
+    aligned.endUseNames = endUseNames;
+    aligned.fuelNames = fuelNames;
+    aligned.values.assign(endUseNames.size(), std::vector<double>(fuelNames.size(), 0.0));
+
+    const auto& table = summary.endUses;
+    for (size_t i = 0; i < table.values.size(); ++i) {
+      const size_t row = indexOrAppend(endUseNames, table.endUseNames[i]);
+      for (size_t j = 0; j < table.values[i].size(); ++j) {
+        aligned.values[row][indexOrAppend(fuelNames, table.fuelNames[j])] = table.values[i][j];
+      }
+    }
+  }
+  return result;
+}
+
+}  // namespace sql
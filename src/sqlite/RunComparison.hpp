@@ -0,0 +1,34 @@
+#ifndef SQL_RUNCOMPARISON_HPP
+#define SQL_RUNCOMPARISON_HPP
+
+#include "SQLiteReports.hpp"  // for EndUseTable
+
+#include <filesystem>  // for path
+#include <optional>    // for optional
+#include <string>      // for string
+#include <vector>      // for vector
+
+namespace sql {
+
+/// The summary tables extracted from one eplusout.sql
+struct RunSummary
+{
+  std::filesystem::path databasePath;
+  std::string energyPlusVersion;
+  std::optional<double> netSiteEnergy;
+  EndUseTable endUses;
+  // Non empty if the database could not be read
+  std::string errorMessage;
+};
+
+/// Opens each database on its own read-only connection and extracts the summaries concurrently.
+/// The result is in the same order as databasePaths. numThreads = 0 means one per hardware thread
+std::vector<RunSummary> collectRunSummaries(const std::vector<std::filesystem::path>& databasePaths, unsigned numThreads = 0);
+
+/// Reindexes all the end use tables on the union of their end uses and fuels (in order of first appearance), filling missing cells with zero,
+/// so that they can be compared cell by cell
+std::vector<EndUseTable> alignEndUseTables(const std::vector<RunSummary>& summaries);
+
+}  // namespace sql
+
+#endif  // SQL_RUNCOMPARISON_HPP
@@ -0,0 +1,335 @@
+#include "RuntimeHistory.hpp"
+
+#include "PreparedStatement.hpp"           // for PreparedStatement
+#include "../utilities/ASCIIStrings.hpp"   // for ascii_to_lower_copy, ascii_trim
+#include "../utilities/Hash.hpp"           // for fnv1a64, toHex
+#include "../utilities/Paths.hpp"          // for cacheDirectory
+
+#include <sqlite3.h>  // for sqlite3_open_v2, sqlite3_exec, sqlite3_busy_timeout, sqlite3_errmsg
+
+#include <fmt/format.h>  // for format
+#include <fmt/std.h>     // for formatting std::filesystem::path // IWYU pragma: keep
+
+#include <algorithm>  // for max, min, find, partial_sort, reverse
+#include <array>      // for array
+#include <chrono>     // for system_clock, duration
+#include <cmath>      // for log, log1p, exp, sqrt
+#include <fstream>    // for ifstream
+#include <iterator>   // for istreambuf_iterator
+#include <stdexcept>  // for runtime_error
+#include <utility>    // for pair
+
+namespace sql {
+
+namespace {
+  constexpr auto schema = R"sql(
+    CREATE TABLE IF NOT EXISTS Runs (
+      RunId INTEGER PRIMARY KEY,
+      InputKey TEXT NOT NULL,
+      Input TEXT NOT NULL,
+      InputBytes REAL NOT NULL,
+      Objects INTEGER NOT NULL,
+      Zones INTEGER NOT NULL,
+      Surfaces INTEGER NOT NULL,
+      TimestepsPerHour INTEGER NOT NULL,
+      Periods INTEGER NOT NULL,
+      WallSeconds REAL NOT NULL,
+      Succeeded INTEGER NOT NULL,
+      FinishedAt REAL NOT NULL,
+      Phases TEXT
+    );
+    CREATE INDEX IF NOT EXISTS RunsByKey ON Runs (InputKey, Succeeded, RunId);
+    CREATE TABLE IF NOT EXISTS Learned (
+      Name TEXT PRIMARY KEY,
+      Value REAL NOT NULL
+    );)sql";
+
+  // Older runs are deleted past this many, and only the most recent successful ones are used as neighbors
+  constexpr int maxRuns = 20000;
+  constexpr int maxSamples = 5000;
+  // Runs of the same key averaged, and neighbors of an unknown input
+  constexpr int sameKeyRuns = 3;
+  constexpr std::size_t numNeighbors = 5;
+
+  // The output location doesn't change the run
+  constexpr std::array<std::string_view, 6> outputOptions{"-d", "--output-directory", "-p", "--output-prefix", "-s", "--output-suffix"};
+
+  void execScript(sqlite3* db, const char* script) {
+    char* err = nullptr;
+    if (sqlite3_exec(db, script, nullptr, nullptr, &err) != SQLITE_OK) {
+      const std::string errMsg = (err != nullptr) ? err : "unknown error";
+      sqlite3_free(err);
+      throw std::runtime_error("Runtime history: " + errMsg);
+    }
+  }
+
+  bool startsWith(std::string_view s, std::string_view prefix) {
+    return s.substr(0, prefix.size()) == prefix;
+  }
+
+  // type is lowercase
+  void countObject(std::string_view type, InputFeatures& features) {
+    ++features.objects;
+    if (type == "zone") {
+      ++features.zones;
+    } else if (type == "runperiod" || startsWith(type, "sizingperiod:")) {
+      ++features.periods;
+    } else if (startsWith(type, "buildingsurface:") || startsWith(type, "fenestrationsurface:") || startsWith(type, "wall:")
+               || startsWith(type, "roofceiling:") || startsWith(type, "floor:") || startsWith(type, "ceiling:") || type == "roof"
+               || type == "window" || type == "door" || type == "glazeddoor" || type == "window:interzone" || type == "door:interzone"
+               || type == "glazeddoor:interzone") {
+      ++features.surfaces;
+    }
+  }
+
+  int toInt(std::string_view value) {
+    int result = 0;
+    for (const char c : value) {
+      if (c < '0' || c > '9') {
+        break;
+      }
+      result = result * 10 + (c - '0');
+    }
+    return result;
+  }
+
+  void scanIdf(std::string_view text, InputFeatures& features) {
+    std::string type;
+    std::string field;
+    int fieldIndex = 0;
+    for (std::size_t i = 0; i < text.size(); ++i) {
+      const char c = text[i];
+      if (c == '!') {
+        i = text.find('\n', i);
+        if (i == std::string_view::npos) {
+          break;
+        }
+      } else if (c == ',' || c == ';') {
+        if (fieldIndex == 0) {
+          type = utilities::ascii_to_lower_copy(utilities::ascii_trim(std::string_view(field)));
+        } else if (fieldIndex == 1 && type == "timestep") {
+          features.timestepsPerHour = toInt(utilities::ascii_trim(std::string_view(field)));
+        }
+        field.clear();
+        ++fieldIndex;
+        if (c == ';') {
+          countObject(type, features);
+          fieldIndex = 0;
+        }
+      } else if (fieldIndex <= 1) {
+        field += c;
+      }
+    }
+  }
+
+  // Only the structure: object types are the keys of the root, objects the keys of their type, fields the keys of an object
+  void scanEpJson(std::string_view text, InputFeatures& features) {
+    int depth = 0;
+    std::string type;
+    for (std::size_t i = 0; i < text.size(); ++i) {
+      const char c = text[i];
+      if (c == '{' || c == '[') {
+        ++depth;
+      } else if (c == '}' || c == ']') {
+        --depth;
+      } else if (c == '"') {
+        const std::size_t start = i + 1;
+        for (++i; i < text.size() && text[i] != '"'; ++i) {
+          if (text[i] == '\\') {
+            ++i;
+          }
+        }
+        const auto next = text.find_first_not_of(" \t\r\n", i + 1);
+        if (next == std::string_view::npos || text[next] != ':') {
+          continue;
+        }
+        const auto key = text.substr(start, std::min(i, text.size()) - start);
+        if (depth == 1) {
+          type = utilities::ascii_to_lower_copy(key);
+        } else if (depth == 2) {
+          countObject(type, features);
+        } else if (depth == 3 && type == "timestep" && key == "number_of_timesteps_per_hour") {
+          features.timestepsPerHour = toInt(utilities::ascii_trim(text.substr(next + 1, 16)));
+        }
+      }
+    }
+  }
+
+  std::vector<double> featureVector(const InputFeatures& features) {
+    // Logs: a model twice as large is as different from one as from four times as large. The size of the text says less than the counts
+    return {0.5 * std::log1p(static_cast<double>(features.bytes)), std::log1p(features.objects), std::log1p(features.zones),
+            std::log1p(features.surfaces), std::log1p(features.timestepsPerHour), std::log1p(features.periods)};
+  }
+
+  double logSeconds(double seconds) {
+    return std::log(std::max(seconds, 0.01));
+  }
+
+  double wallClock() {
+    return std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+  }
+}  // namespace
+
+InputFeatures InputFeatures::fromFile(const std::filesystem::path& input, const std::vector<std::string>& energyPlusArgs) {
+  std::ifstream file(input, std::ios::binary);
+  if (!file) {
+    throw std::runtime_error(fmt::format("Cannot read '{}'", input));
+  }
+  const std::string text{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+  return fromText(text, utilities::ascii_to_lower_copy(input.extension().string()) == ".epjson", energyPlusArgs);
+}
+
+InputFeatures InputFeatures::fromText(std::string_view text, bool isEpJson, const std::vector<std::string>& energyPlusArgs) {
+  InputFeatures features;
+  features.bytes = text.size();
+  features.key = utilities::fnv1a64(text);
+  for (std::size_t i = 0; i < energyPlusArgs.size(); ++i) {
+    if (std::find(outputOptions.cbegin(), outputOptions.cend(), energyPlusArgs[i]) != outputOptions.cend()) {
+      ++i;
+      continue;
+    }
+    // The separator keeps "-w a" "b" apart from "-w" "a b"
+    features.key = utilities::fnv1a64(energyPlusArgs[i], utilities::fnv1a64("\n", features.key));
+  }
+  if (isEpJson) {
+    scanEpJson(text, features);
+  } else {
+    scanIdf(text, features);
+  }
+  return features;
+}
+
+std::filesystem::path RuntimeHistory::defaultPath() {
+  return utilities::cacheDirectory() / "runtime_history.sqlite";
+}
+
+RuntimeHistory::RuntimeHistory(const std::filesystem::path& databasePath) {
+  const std::string fileName = databasePath.string();
+  if (sqlite3_open_v2(fileName.c_str(), &m_db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, nullptr) != SQLITE_OK) {
+    const std::string errMsg = m_db != nullptr ? sqlite3_errmsg(m_db) : "out of memory";
+    sqlite3_close(m_db);
+    throw std::runtime_error(fmt::format("Could not open the runtime history at '{}': {}", fileName, errMsg));
+  }
+  // Other epcli processes only ever hold it for an insert
+  sqlite3_busy_timeout(m_db, 5'000);
+  try {
+    execScript(m_db, schema);
+    PreparedStatement select(fmt::format("SELECT InputBytes, Objects, Zones, Surfaces, TimestepsPerHour, Periods, WallSeconds FROM Runs "
+                                         "WHERE Succeeded = 1 ORDER BY RunId DESC LIMIT {};",
+                                         maxSamples),
+                             m_db);
+    while (select.step()) {
+      InputFeatures features;
+      features.bytes = static_cast<std::uintmax_t>(select.getColumnAsDouble(0));
+      features.objects = select.getColumnAsInt(1);
+      features.zones = select.getColumnAsInt(2);
+      features.surfaces = select.getColumnAsInt(3);
+      features.timestepsPerHour = select.getColumnAsInt(4);
+      features.periods = select.getColumnAsInt(5);
+      m_samples.push_back({featureVector(features), logSeconds(select.getColumnAsDouble(6))});
+    }
+    // Oldest first, as record() appends
+    std::reverse(m_samples.begin(), m_samples.end());
+  } catch (const std::exception&) {
+    sqlite3_close(m_db);
+    throw;
+  }
+}
+
+RuntimeHistory::~RuntimeHistory() {
+  sqlite3_close(m_db);
+}
+
+void RuntimeHistory::record(const InputFeatures& features, const std::filesystem::path& input, double wallSeconds, bool succeeded,
+                            const std::string& phasesJson) {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  {
+    PreparedStatement insert("INSERT INTO Runs (InputKey, Input, InputBytes, Objects, Zones, Surfaces, TimestepsPerHour, Periods, WallSeconds, "
+                             "Succeeded, FinishedAt, Phases) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?);",
+                             m_db);
+    std::optional<std::string> phases;
+    if (!phasesJson.empty()) {
+      phases = phasesJson;
+    }
+    // The size as REAL: PreparedStatement has no 64-bit integer binding, and a double holds any file size exactly
+    if (!insert.bindAll(utilities::toHex(features.key), std::filesystem::absolute(input).string(), static_cast<double>(features.bytes),
+                        features.objects, features.zones, features.surfaces, features.timestepsPerHour, features.periods, wallSeconds,
+                        succeeded, wallClock(), phases)) {
+      throw std::runtime_error("Runtime history: could not bind the run");
+    }
+    if (insert.execute() != SQLITE_DONE) {
+      throw std::runtime_error(fmt::format("Runtime history: could not record the run: {}", sqlite3_errmsg(m_db)));
+    }
+  }
+  {
+    PreparedStatement prune(fmt::format("DELETE FROM Runs WHERE RunId <= (SELECT MAX(RunId) FROM Runs) - {};", maxRuns), m_db);
+    prune.execute();
+  }
+
+  if (succeeded) {
+    if (m_samples.size() == static_cast<std::size_t>(maxSamples)) {
+      m_samples.erase(m_samples.begin());
+    }
+    m_samples.push_back({featureVector(features), logSeconds(wallSeconds)});
+  }
+}
+
+std::optional<double> RuntimeHistory::predict(const InputFeatures& features) const {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  {
+    PreparedStatement sameKey(
+      fmt::format("SELECT AVG(WallSeconds) FROM (SELECT WallSeconds FROM Runs WHERE InputKey = ? AND Succeeded = 1 ORDER BY RunId DESC LIMIT {});",
+                  sameKeyRuns),
+      m_db, false, utilities::toHex(features.key));
+    // AVG of no row is NULL, read as 0
+    if (const auto seconds = sameKey.execAndReturnFirstDouble(); seconds && *seconds > 0.0) {
+      return seconds;
+    }
+  }
+  if (m_samples.empty()) {
+    return std::nullopt;
+  }
+
+  const auto target = featureVector(features);
+  std::vector<std::pair<double, double>> neighbors;  // distance, log seconds
+  neighbors.reserve(m_samples.size());
+  for (const auto& sample : m_samples) {
+    double squared = 0.0;
+    for (std::size_t i = 0; i < target.size(); ++i) {
+      squared += (sample.features[i] - target[i]) * (sample.features[i] - target[i]);
+    }
+    neighbors.emplace_back(std::sqrt(squared), sample.logSeconds);
+  }
+  const auto k = std::min(numNeighbors, neighbors.size());
+  std::partial_sort(neighbors.begin(), neighbors.begin() + static_cast<std::ptrdiff_t>(k), neighbors.end());
+  double weightedSum = 0.0;
+  double totalWeight = 0.0;
+  for (std::size_t i = 0; i < k; ++i) {
+    // The offset keeps identical features from taking all the weight
+    const double weight = 1.0 / (neighbors[i].first + 0.05);
+    weightedSum += weight * neighbors[i].second;
+    totalWeight += weight;
+  }
+  return std::exp(weightedSum / totalWeight);
+}
+
+std::size_t RuntimeHistory::numRuns() const {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  return m_samples.size();
+}
+
+std::optional<double> RuntimeHistory::learned(const std::string& name) const {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  const PreparedStatement select("SELECT Value FROM Learned WHERE Name = ?;", m_db, false, name);
+  return select.execAndReturnFirstDouble();
+}
+
+void RuntimeHistory::setLearned(const std::string& name, double value) {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  PreparedStatement upsert("INSERT OR REPLACE INTO Learned (Name, Value) VALUES (?, ?);", m_db, false, name, value);
+  if (upsert.execute() != SQLITE_DONE) {
+    throw std::runtime_error(fmt::format("Runtime history: could not store {}: {}", name, sqlite3_errmsg(m_db)));
+  }
+}
+
+}  // namespace sql
@@ -0,0 +1,82 @@
+#ifndef SQL_RUNTIMEHISTORY_HPP
+#define SQL_RUNTIMEHISTORY_HPP
+
+#include <cstddef>      // for size_t
+#include <cstdint>      // for uint64_t, uintmax_t
+#include <filesystem>   // for path
+#include <mutex>        // for mutex
+#include <optional>     // for optional
+#include <string>       // for string
+#include <string_view>  // for string_view
+#include <vector>       // for vector
+
+struct sqlite3;
+
+namespace sql {
+
+/// What the run time of a simulation is predicted from
+struct InputFeatures
+{
+  /// The input text and the EnergyPlus arguments that change the run (not the output directory, prefix or suffix): same key, same run
+  std::uint64_t key = 0;
+  std::uintmax_t bytes = 0;
+  int objects = 0;
+  int zones = 0;
+  /// Heat transfer surfaces and subsurfaces, detailed or not
+  int surfaces = 0;
+  int timestepsPerHour = 0;
+  /// RunPeriod and SizingPeriod:* objects
+  int periods = 0;
+
+  /// Scans an IDF or epJSON input once: object types are counted, fields aren't validated. Throws std::runtime_error if it can't be read
+  static InputFeatures fromFile(const std::filesystem::path& input, const std::vector<std::string>& energyPlusArgs);
+  static InputFeatures fromText(std::string_view text, bool isEpJson, const std::vector<std::string>& energyPlusArgs);
+};
+
+/// The wall time of past runs, in a database of the epcli cache directory, to predict how long the next ones will take: the average of the
+/// last runs of the same input with the same arguments if there are some, otherwise a distance weighted geometric mean of the runs of the
+/// most similar inputs (object counts, size, timesteps). Only successful runs are used, the failed ones are kept for reference.
+///
+/// Thread-safe. Several processes can share the database, each run being a single insert
+class RuntimeHistory
+{
+ public:
+  /// <cache directory>/runtime_history.sqlite
+  static std::filesystem::path defaultPath();
+
+  /// Opens the history, creating it if needed. Throws std::runtime_error on failure
+  explicit RuntimeHistory(const std::filesystem::path& databasePath = defaultPath());
+  RuntimeHistory(const RuntimeHistory&) = delete;
+  RuntimeHistory& operator=(const RuntimeHistory&) = delete;
+  ~RuntimeHistory();
+
+  /// phasesJson is the PhaseProfiler::toJson of the run, or empty. Throws std::runtime_error on failure
+  void record(const InputFeatures& features, const std::filesystem::path& input, double wallSeconds, bool succeeded,
+              const std::string& phasesJson);
+
+  /// Predicted wall time in seconds, empty if no successful run is known
+  [[nodiscard]] std::optional<double> predict(const InputFeatures& features) const;
+
+  /// Successful runs the predictions are made from
+  [[nodiscard]] std::size_t numRuns() const;
+
+  /// Named values learned by other parts of a batch, kept with the run times (eg: ResourceGovernor's resident bytes per input byte)
+  [[nodiscard]] std::optional<double> learned(const std::string& name) const;
+  void setLearned(const std::string& name, double value);
+
+ private:
+  struct Sample
+  {
+    std::vector<double> features;
+    double logSeconds = 0.0;
+  };
+
+  sqlite3* m_db = nullptr;
+  mutable std::mutex m_mutex;
+  /// The last successful runs, for the nearest neighbors
+  std::vector<Sample> m_samples;
+};
+
+}  // namespace sql
+
+#endif  // SQL_RUNTIMEHISTORY_HPP
@@ -1,8 +1,12 @@
 #include "SQLiteReports.hpp"
 
 #include "PreparedStatement.hpp"   // for PreparedStatement
+#include "SidecarIndex.hpp"        // for SourceIdentity, ensureSidecarIndex, attachSidecarIndex
+#include "StatementCache.hpp"      // for StatementCache
+#include "../utilities/Trace.hpp"  // for EPCLI_TRACE_SCOPE
                                    //
 #include <ftxui/dom/elements.hpp>  // for operator|, Element, separator, text, size, hcenter, vbox, Constraint, Direction, Elements, flex
+#include <ftxui/screen/color.hpp>  // for Color
                                    //
 #include <sqlite3.h>               // for sqlite3_close, sqlite3_open_v2, SQLITE_OPEN_READONLY
 #include <ctre.hpp>                // For CTRE
@@ -10,20 +14,36 @@
                                    //
 #include <algorithm>               // for max
 #include <array>                   // for array
+#include <exception>               // for exception
 #include <filesystem>              // for path, copy_file, operator/, temp_directory_path, copy_options
+#include <memory>                  // for make_unique
 #include <optional>                // for optional
 #include <stdexcept>               // for runtime_error
 #include <string>                  // for string
+#include <utility>                 // for move
 
 using namespace ftxui;
 
 namespace sql {
 
-SQLiteReports::SQLiteReports(std::filesystem::path databasePath)  // NOLINT(performance-unnecessary-value-param)
-  : m_db(nullptr), m_databasePath(std::filesystem::temp_directory_path() / "eplusout.sql") {
+SQLiteReports::SQLiteReports(std::filesystem::path databasePath, bool copyToTemporary)
+  : m_db(nullptr), m_databasePath(std::move(databasePath)) {
+  EPCLI_TRACE_SCOPE("SQLiteReports::open");
 
-  // TODO: currently I have to copy it to a temporary directory because it's still in use and locked:
-  std::filesystem::copy_file(databasePath, m_databasePath, std::filesystem::copy_options::overwrite_existing);
+  // Identify the original file, not the temporary copy which gets a new modified time every time
+  std::optional<SourceIdentity> sourceIdentity;
+  try {
+    sourceIdentity = SourceIdentity::fromFile(m_databasePath);
+  } catch (const std::exception&) {
+    sourceIdentity.reset();
+  }
+
+  if (copyToTemporary) {
+    // TODO: currently I have to copy it to a temporary directory because it's still in use and locked:
+    const std::filesystem::path tempPath = std::filesystem::temp_directory_path() / "eplusout.sql";
+    std::filesystem::copy_file(m_databasePath, tempPath, std::filesystem::copy_options::overwrite_existing);
+    m_databasePath = tempPath;
+  }
 
   std::string fileName = m_databasePath.make_preferred().string();
 
@@ -33,14 +53,33 @@ SQLiteReports::SQLiteReports(std::filesystem::path databasePath)  // NOLINT(perf
   if (!m_connectionOpen) {
     throw std::runtime_error(fmt::format("epcli could not open the sqlfile at '{}'\n", fileName));
   }
+  m_statementCache = std::make_unique<StatementCache>(m_db);
   // create index on dictionaryIndex for large table reportvariabledata
   if (!isValidConnection()) {
-    sqlite3_close(m_db);
-    m_connectionOpen = false;
+    close();
     throw std::runtime_error("epcli is not compatible with this file.");
   }
   // set a 1 second timeout
   // sqlite3_busy_timeout(m_db, 1000);
+
+  // Build (first open) or reuse the sidecar index. It is purely an optimization: on any failure (eg: read-only cache directory), keep
+  // querying the original tables
+  if (sourceIdentity) {
+    try {
+      attachSidecarIndex(m_db, ensureSidecarIndex(*sourceIdentity, m_databasePath));
+      m_hasSidecarIndex = true;
+    } catch (const std::exception&) {
+      m_hasSidecarIndex = false;
+    }
+  }
+}
+
+bool SQLiteReports::hasSidecarIndex() const {
+  return m_hasSidecarIndex;
+}
+
+const StatementCache& SQLiteReports::statementCache() const {
+  return *m_statementCache;
 }
 
 bool SQLiteReports::isValidConnection() const {
@@ -52,6 +91,8 @@ SQLiteReports::~SQLiteReports() {
 }
 
 bool SQLiteReports::close() {
+  // Statements must be finalized before the connection can be closed
+  m_statementCache.reset();
   if (m_connectionOpen) {
     sqlite3_close(m_db);
     m_connectionOpen = false;
@@ -60,9 +101,10 @@ bool SQLiteReports::close() {
 }
 
 std::string SQLiteReports::energyPlusVersion() const {
+  EPCLI_TRACE_SCOPE("SQLiteReports::energyPlusVersion");
   std::string result;
-  if (m_db) {
-    if (auto s_ = PreparedStatement{R"sql(SELECT EnergyPlusVersion FROM Simulations)sql", m_db, false}.execAndReturnFirstString()) {
+  if (m_statementCache) {
+    if (auto s_ = m_statementCache->acquire(R"sql(SELECT EnergyPlusVersion FROM Simulations)sql")->execAndReturnFirstString()) {
       // in 8.1 this is 'EnergyPlus-Windows-32 8.1.0.008, YMD=2014.11.08 22:49'
       // in 8.2 this is 'EnergyPlus, Version 8.2.0-8397c2e30b, YMD=2015.01.09 08:37'
       // radiance script is writing 'EnergyPlus, VERSION 8.2, (OpenStudio) YMD=2015.1.9 08:35:36'
@@ -75,50 +117,49 @@ std::string SQLiteReports::energyPlusVersion() const {
 }
 
 std::optional<double> SQLiteReports::netSiteEnergy() const {
-  return PreparedStatement{
+  EPCLI_TRACE_SCOPE("SQLiteReports::netSiteEnergy");
+  return m_statementCache->acquire(
     R"sql(SELECT Value FROM TabularDataWithStrings
             WHERE ReportName='AnnualBuildingUtilityPerformanceSummary'
             AND ReportForString='Entire Facility'
             AND TableName='Site and Source Energy'
             AND RowName='Net Site Energy'
             AND ColumnName='Total Energy'
-            AND Units='GJ';)sql",
-    m_db, false}
-    .execAndReturnFirstDouble();
+            AND Units='GJ';)sql")
+    ->execAndReturnFirstDouble();
 }
 
 std::vector<UnmetHoursTableRow> SQLiteReports::unmetHoursTable() const {
+  EPCLI_TRACE_SCOPE("SQLiteReports::unmetHoursTable");
 
   std::vector<UnmetHoursTableRow> result;
 
   auto zoneNames_ =  //
-    PreparedStatement{R"sql(SELECT DISTINCT(RowName) FROM TabularDataWithStrings
+    m_statementCache->acquire(R"sql(SELECT DISTINCT(RowName) FROM TabularDataWithStrings
     WHERE ReportName='SystemSummary'
     AND ReportForString='Entire Facility'
-    AND TableName='Time Setpoint Not Met';)sql",
-                      m_db, false}
-      .execAndReturnVectorOfString();
+    AND TableName='Time Setpoint Not Met';)sql")
+      ->execAndReturnVectorOfString();
 
   if (!zoneNames_.has_value()) {
     return result;
   }
 
-  PreparedStatement stmt(R"sql(
+  auto stmt = m_statementCache->acquire(R"sql(
 SELECT Value FROM TabularDataWithStrings
     WHERE ReportName='SystemSummary'
     AND ReportForString='Entire Facility'
     AND TableName='Time Setpoint Not Met'
     AND RowName=?
     AND ColumnName=?;
-  )sql",
-                         m_db, false);
+  )sql");
 
   for (const auto& zoneName : zoneNames_.value()) {
     std::array<double, 4> vals{};
     for (int i = 0; auto colName : UnmetHoursTableRow::headers) {
-      stmt.bind(1, zoneName);
-      stmt.bind(2, std::string{colName});
-      if (auto val_ = stmt.execAndReturnFirstDouble()) {
+      stmt->bind(1, zoneName);
+      stmt->bind(2, std::string{colName});
+      if (auto val_ = stmt->execAndReturnFirstDouble()) {
         vals[i++] = val_.value();
       }
     }
@@ -129,26 +170,25 @@ SELECT Value FROM TabularDataWithStrings
 }
 
 EndUseTable SQLiteReports::endUseByFuelTable() const {
+  EPCLI_TRACE_SCOPE("SQLiteReports::endUseByFuelTable");
 
   EndUseTable result;
 
   const double threshold = 0.1;
 
   auto endUsesNames_ =  //
-    PreparedStatement{R"sql(SELECT DISTINCT(RowName) FROM TabularDataWithStrings
+    m_statementCache->acquire(R"sql(SELECT DISTINCT(RowName) FROM TabularDataWithStrings
             WHERE ReportName='AnnualBuildingUtilityPerformanceSummary'
             AND ReportForString='Entire Facility'
-            AND TableName='End Uses';)sql",
-                      m_db, false}
-      .execAndReturnVectorOfString();
+            AND TableName='End Uses';)sql")
+      ->execAndReturnVectorOfString();
 
   auto fuelNames_ =  //
-    PreparedStatement{R"sql(SELECT DISTINCT(ColumnName) FROM TabularDataWithStrings
+    m_statementCache->acquire(R"sql(SELECT DISTINCT(ColumnName) FROM TabularDataWithStrings
             WHERE ReportName='AnnualBuildingUtilityPerformanceSummary'
             AND ReportForString='Entire Facility'
-            AND TableName='End Uses';)sql",
-                      m_db, false}
-      .execAndReturnVectorOfString();
+            AND TableName='End Uses';)sql")
+      ->execAndReturnVectorOfString();
 
   if (!endUsesNames_.has_value() || !fuelNames_.has_value()) {
     return result;
@@ -159,18 +199,17 @@ EndUseTable SQLiteReports::endUseByFuelTable() const {
 
   {
     // Capture only the fuels for which we have non zero data
-    PreparedStatement stmt_total_for_fuel(R"sql(
+    auto stmt_total_for_fuel = m_statementCache->acquire(R"sql(
     SELECT Value FROM TabularDataWithStrings
       WHERE ReportName='AnnualBuildingUtilityPerformanceSummary'
       AND ReportForString='Entire Facility'
       AND TableName='End Uses'
       AND RowName='Total End Uses'
-      AND ColumnName=?;)sql",
-                                          m_db, false);
+      AND ColumnName=?;)sql");
 
     for (const auto& fuelName : fuelNames_.value()) {
-      stmt_total_for_fuel.bind(1, fuelName);
-      if (auto val_ = stmt_total_for_fuel.execAndReturnFirstDouble(); val_ && val_.value() > threshold) {
+      stmt_total_for_fuel->bind(1, fuelName);
+      if (auto val_ = stmt_total_for_fuel->execAndReturnFirstDouble(); val_ && val_.value() > threshold) {
         fuelNames.emplace_back(fuelName);
       }
     }
@@ -181,17 +220,16 @@ EndUseTable SQLiteReports::endUseByFuelTable() const {
 
   {
     // Capture only the end uses for which we have non zero data
-    PreparedStatement stmt_total_for_end_use(R"sql(
+    auto stmt_total_for_end_use = m_statementCache->acquire(R"sql(
     SELECT SUM(Value) FROM TabularDataWithStrings
       WHERE ReportName='AnnualBuildingUtilityPerformanceSummary'
       AND ReportForString='Entire Facility'
       AND TableName='End Uses'
-      AND RowName=?;)sql",
-                                             m_db, false);
+      AND RowName=?;)sql");
 
     for (const auto& endUsesName : endUsesNames_.value()) {
-      stmt_total_for_end_use.bind(1, endUsesName);
-      if (auto val_ = stmt_total_for_end_use.execAndReturnFirstDouble(); val_ && val_.value() > threshold) {
+      stmt_total_for_end_use->bind(1, endUsesName);
+      if (auto val_ = stmt_total_for_end_use->execAndReturnFirstDouble(); val_ && val_.value() > threshold) {
         endUsesNames.emplace_back(endUsesName);
       }
     }
@@ -200,43 +238,118 @@ EndUseTable SQLiteReports::endUseByFuelTable() const {
   auto& values = result.values;
   values.reserve(endUsesNames.size());
 
-  PreparedStatement stmt_each(R"sql(
+  auto stmt_each = m_statementCache->acquire(R"sql(
     SELECT Value FROM TabularDataWithStrings
       WHERE ReportName='AnnualBuildingUtilityPerformanceSummary'
       AND ReportForString='Entire Facility'
       AND TableName='End Uses'
       AND RowName=?
-      AND ColumnName=?;)sql",
-                              m_db, false);
+      AND ColumnName=?;)sql");
 
   for (const auto& endUsesName : endUsesNames) {
-    stmt_each.bind(1, endUsesName);
+    stmt_each->bind(1, endUsesName);
     auto& rowValues = values.emplace_back();
     rowValues.reserve(fuelNames.size());
     for (const auto& fuelName : fuelNames) {
-      stmt_each.bind(2, fuelName);
-      rowValues.emplace_back(stmt_each.execAndReturnFirstDouble().value_or(0.0));
+      stmt_each->bind(2, fuelName);
+      rowValues.emplace_back(stmt_each->execAndReturnFirstDouble().value_or(0.0));
     }
   }
 
   {
-    PreparedStatement stmt_units(R"sql(
+    auto stmt_units = m_statementCache->acquire(R"sql(
       SELECT DISTINCT(Units)
         FROM TabularDataWithStrings
         WHERE ReportName='AnnualBuildingUtilityPerformanceSummary'
         AND ReportForString='Entire Facility'
         AND TableName='End Uses'
-        AND ColumnName=?;)sql",
-                                 m_db, false);
+        AND ColumnName=?;)sql");
     for (auto& fuelName : fuelNames) {
-      stmt_units.bind(1, fuelName);
-      fuelName += " [" + stmt_units.execAndReturnFirstString().value_or("") + "]";
+      stmt_units->bind(1, fuelName);
+      fuelName += " [" + stmt_units->execAndReturnFirstString().value_or("") + "]";
     }
   }
 
   return result;
 }
 
+const std::vector<TabularTableEntry>& SQLiteReports::tabularIndex() const {
+  if (m_tabularIndex) {
+    return *m_tabularIndex;
+  }
+
+  EPCLI_TRACE_SCOPE("SQLiteReports::tabularIndex");
+  auto& result = m_tabularIndex.emplace();
+
+  // Materialized in the sidecar index
+  constexpr auto sidecarQuery = R"sql(
+    SELECT ReportNameIndex, ReportForStringIndex, TableNameIndex, ReportName, ReportForString, TableName, FirstKey, LastKey, NumCells
+      FROM idx.TabularIndex
+      ORDER BY FirstKey;)sql";
+
+  // Otherwise group on the integer indexes first, and only resolve the strings for each table
+  constexpr auto query = R"sql(
+    SELECT t.ReportNameIndex, t.ReportForStringIndex, t.TableNameIndex, rn.Value, fs.Value, tn.Value, t.FirstKey, t.LastKey, t.NumCells
+      FROM (SELECT ReportNameIndex, ReportForStringIndex, TableNameIndex, MIN(TabularDataIndex) AS FirstKey, MAX(TabularDataIndex) AS LastKey,
+                   COUNT(*) AS NumCells
+              FROM TabularData
+              GROUP BY ReportNameIndex, ReportForStringIndex, TableNameIndex) AS t
+      INNER JOIN Strings AS rn ON rn.StringIndex = t.ReportNameIndex
+      INNER JOIN Strings AS fs ON fs.StringIndex = t.ReportForStringIndex
+      INNER JOIN Strings AS tn ON tn.StringIndex = t.TableNameIndex
+      ORDER BY t.FirstKey;)sql";
+
+  auto stmt = m_statementCache->acquire(m_hasSidecarIndex ? sidecarQuery : query);
+
+  while (stmt->step()) {
+    auto& entry = result.emplace_back();
+    entry.reportNameIndex = stmt->getColumnAsInt(0);
+    entry.reportForStringIndex = stmt->getColumnAsInt(1);
+    entry.tableNameIndex = stmt->getColumnAsInt(2);
+    entry.reportName = stmt->getColumnAsString(3);
+    entry.reportForString = stmt->getColumnAsString(4);
+    entry.tableName = stmt->getColumnAsString(5);
+    entry.firstKey = stmt->getColumnAsInt(6);
+    entry.lastKey = stmt->getColumnAsInt(7);
+    entry.numCells = stmt->getColumnAsInt(8);
+  }
+
+  return result;
+}
+
+std::vector<TabularCell> SQLiteReports::tabularPage(const TabularTableEntry& table, int afterKey, int pageSize) const {
+  EPCLI_TRACE_SCOPE("SQLiteReports::tabularPage");
+  std::vector<TabularCell> result;
+  result.reserve(pageSize);
+
+  auto stmt = m_statementCache->acquire(R"sql(
+    SELECT td.TabularDataIndex, rn.Value, cn.Value, u.Value, td.Value
+      FROM TabularData AS td
+      INNER JOIN Strings AS rn ON rn.StringIndex = td.RowNameIndex
+      INNER JOIN Strings AS cn ON cn.StringIndex = td.ColumnNameIndex
+      INNER JOIN Strings AS u ON u.StringIndex = td.UnitsIndex
+      WHERE td.TabularDataIndex > ?
+      AND td.TabularDataIndex <= ?
+      AND td.ReportNameIndex = ?
+      AND td.ReportForStringIndex = ?
+      AND td.TableNameIndex = ?
+      ORDER BY td.TabularDataIndex
+      LIMIT ?;)sql");
+  // Bounded on both ends: the last page of a table stops at its last cell instead of scanning TabularData to its end
+  stmt->bindAll(afterKey, table.lastKey, table.reportNameIndex, table.reportForStringIndex, table.tableNameIndex, pageSize);
+
+  while (stmt->step()) {
+    auto& cell = result.emplace_back();
+    cell.key = stmt->getColumnAsInt(0);
+    cell.rowName = stmt->getColumnAsString(1);
+    cell.columnName = stmt->getColumnAsString(2);
+    cell.units = stmt->getColumnAsString(3);
+    cell.value = stmt->getColumnAsString(4);
+  }
+
+  return result;
+}
+
 }  // namespace sql
 
 ftxui::Element RenderHighLevelInfo(const sql::SQLiteReports& report) {
@@ -354,8 +467,21 @@ ftxui::Element RenderUnmetHours(const sql::SQLiteReports& report) {
 }
 
 ftxui::Element RenderEndUseByFuel(const sql::SQLiteReports& report) {
+  return RenderEndUseByFuel(report.endUseByFuelTable());
+}
+
+ftxui::Element RenderEndUseByFuel(const sql::EndUseTable& tableData, const sql::EndUseTable* baseline, const std::string& title) {
+
+  auto format_double = [](double d) { return fmt::format("{:.2f}", d); };
 
-  auto tableData = report.endUseByFuelTable();
+  auto delta = [&tableData, &baseline](size_t i, size_t j) { return tableData.values[i][j] - baseline->values[i][j]; };
+
+  auto format_cell = [&](size_t i, size_t j) {
+    if (baseline == nullptr) {
+      return format_double(tableData.values[i][j]);
+    }
+    return fmt::format("{:.2f} ({:+.2f})", tableData.values[i][j], delta(i, j));
+  };
 
   std::vector<size_t> col_sizes;
   col_sizes.resize(tableData.fuelNames.size() + 1);
@@ -370,6 +496,9 @@ ftxui::Element RenderEndUseByFuel(const sql::SQLiteReports& report) {
   headerList.emplace_back(separator());
   for (size_t i = 1; const auto& colName : tableData.fuelNames) {
     col_sizes[i] = colName.size();
+    for (size_t row = 0; row < tableData.values.size(); ++row) {
+      col_sizes[i] = std::max(col_sizes[i], format_cell(row, i - 1).size());
+    }
     headerList.emplace_back(text(std::string{colName})                 //
                             | ftxui::size(WIDTH, EQUAL, col_sizes[i])  //
     );
@@ -381,35 +510,50 @@ ftxui::Element RenderEndUseByFuel(const sql::SQLiteReports& report) {
 
   auto header = hbox(headerList);
 
-  auto format_double = [](double d) { return fmt::format("{:.2f}", d); };
-
   Elements rowList;
   for (size_t i = 0; const auto& tableRow : tableData.values) {
     Elements row;
     auto& endUsesName = tableData.endUseNames[i];
     row.emplace_back(text(endUsesName) | ftxui::size(WIDTH, EQUAL, col_sizes[0]));
     row.emplace_back(separator());
-    for (size_t j = 1; const auto& val : tableRow) {
-      row.emplace_back(hcenter(text(format_double(val))) | ftxui::size(WIDTH, EQUAL, col_sizes[j]));
+    for (size_t j = 1; j <= tableRow.size(); ++j) {
+      Decorator cell_decorator = nothing;
+      if (baseline != nullptr && delta(i, j - 1) > 0.0) {
+        cell_decorator = color(Color::Red);
+      } else if (baseline != nullptr && delta(i, j - 1) < 0.0) {
+        cell_decorator = color(Color::Green);
+      }
+      row.emplace_back(hcenter(text(format_cell(i, j - 1))) | ftxui::size(WIDTH, EQUAL, col_sizes[j]) | cell_decorator);
       if (j < tableRow.size()) {
         row.emplace_back(separator());
       }
-      ++j;
     }
     rowList.push_back(hbox(row));
     rowList.push_back(separator());
     ++i;
   }
 
-  return window(text("End Use by Fuel"), vbox({
-                                           header,  //
-                                           separator(),
-                                           vbox(rowList) | vscroll_indicator | yframe,  //  | reflect(box_),
-                                         }));
+  return window(text(title), vbox({
+                               header,  //
+                               separator(),
+                               vbox(rowList) | vscroll_indicator | yframe,  //  | reflect(box_),
+                             }));
 }
 
-ftxui::Element SQLiteComponent::RenderDatabase(std::filesystem::path databasePath) {
-  const sql::SQLiteReports report(std::move(databasePath));
+void SQLiteComponent::reset() {
+  m_report.reset();
+  m_databasePath.clear();
+}
+
+ftxui::Element SQLiteComponent::RenderDatabase(const std::filesystem::path& databasePath) {
+  const auto lastWriteTime = std::filesystem::last_write_time(databasePath);
+  if (!m_report || databasePath != m_databasePath || lastWriteTime != m_lastWriteTime) {
+    m_report.reset();
+    m_report = std::make_unique<sql::SQLiteReports>(databasePath);
+    m_databasePath = databasePath;
+    m_lastWriteTime = lastWriteTime;
+  }
+  const sql::SQLiteReports& report = *m_report;
 
   // TODO maybe at some point figure out how to make this work
   // auto layout = Container::Vertical({
@@ -418,5 +562,14 @@ ftxui::Element SQLiteComponent::RenderDatabase(std::filesystem::path databasePat
   //   Collapsible("End Use by Fuel", RenderEndUseByFuel(report)),
   // });
 
-  return vbox({RenderHighLevelInfo(report), RenderUnmetHours(report), RenderEndUseByFuel(report)});
+  const auto& cache = report.statementCache();
+  auto footer = hbox({
+    filler(),
+    text(fmt::format("Statement cache: {} hits, {} misses, {}/{} cached", cache.hits(), cache.misses(), cache.size(), cache.capacity()))
+      | color(Color::GrayDark),
+    separator(),
+    text(report.hasSidecarIndex() ? "Indexed" : "Not indexed") | color(Color::GrayDark),
+  });
+
+  return vbox({RenderHighLevelInfo(report), RenderUnmetHours(report), RenderEndUseByFuel(report), footer});
 }
@@ -1,11 +1,14 @@
 #ifndef SQL_SQLITEREPORTS_HPP
 #define SQL_SQLITEREPORTS_HPP
 
+#include "StatementCache.hpp"  // for StatementCache
+
 #include <ftxui/component/component_base.hpp>  // for ComponentBase
 #include <ftxui/dom/elements.hpp>              // for Element
 
 #include <array>        // for array
 #include <filesystem>   // for path
+#include <memory>       // for unique_ptr
 #include <optional>     // for optional
 #include <string>       // for string
 #include <string_view>  // for basic_string_view, str...
@@ -43,15 +46,51 @@ struct EndUseTable
   std::vector<std::vector<double>> values;
 };
 
+/// One table of the TabularDataWithStrings view, as written in the HTML report
+struct TabularTableEntry
+{
+  std::string reportName;
+  std::string reportForString;
+  std::string tableName;
+  // Indexes into the Strings table, to query TabularData directly
+  int reportNameIndex = 0;
+  int reportForStringIndex = 0;
+  int tableNameIndex = 0;
+  // The smallest and largest TabularDataIndex of the table: the cells of a table are contiguous, so a page is a bounded rowid range seek
+  int firstKey = 0;
+  int lastKey = 0;
+  int numCells = 0;
+};
+
+struct TabularCell
+{
+  // The TabularDataIndex, used as the key for keyset pagination
+  int key = 0;
+  std::string rowName;
+  std::string columnName;
+  std::string units;
+  std::string value;
+};
+
 class SQLiteReports
 {
  public:
-  explicit SQLiteReports(std::filesystem::path databasePath);
+  // When copyToTemporary is true, the database is first copied to the temp directory since EnergyPlus may still hold a lock on it.
+  // Pass false for finished runs (eg: when comparing several databases concurrently) to open the file in place, read-only
+  explicit SQLiteReports(std::filesystem::path databasePath, bool copyToTemporary = true);
+  SQLiteReports(const SQLiteReports&) = delete;
+  SQLiteReports& operator=(const SQLiteReports&) = delete;
 
   ~SQLiteReports();
 
   bool isValidConnection() const;
 
+  // Whether lookups go through the sidecar index database (see SidecarIndex.hpp)
+  bool hasSidecarIndex() const;
+
+  // The prepared statements of this connection, for their hit/miss counters
+  const StatementCache& statementCache() const;
+
   std::string energyPlusVersion() const;
   std::optional<double> netSiteEnergy() const;
   std::vector<UnmetHoursTableRow> unmetHoursTable() const;
@@ -59,24 +98,51 @@ class SQLiteReports
   // template <size_t ROW_SIZE, size_t COL_SIZE>
   EndUseTable endUseByFuelTable() const;
 
+  /// All the tables in TabularData, in the order EnergyPlus wrote them. Built on first call with a single scan, then cached for the
+  /// lifetime of the connection
+  const std::vector<TabularTableEntry>& tabularIndex() const;
+
+  /// Returns at most pageSize cells of the table whose key is strictly greater than afterKey (keyset pagination: no OFFSET scan).
+  /// Use afterKey = table.firstKey - 1 for the first page, then the key of the last cell returned
+  std::vector<TabularCell> tabularPage(const TabularTableEntry& table, int afterKey, int pageSize) const;
+
  private:
   bool close();
 
+  mutable std::optional<std::vector<TabularTableEntry>> m_tabularIndex;
+
   sqlite3* m_db;
   std::filesystem::path m_databasePath;
   bool m_connectionOpen = false;
+  bool m_hasSidecarIndex = false;
+  // Every query goes through it: each distinct statement is only prepared once per connection
+  mutable std::unique_ptr<StatementCache> m_statementCache;
 };
 
 }  // namespace sql
 
+ftxui::Element RenderHighLevelInfo(const sql::SQLiteReports& report);
+ftxui::Element RenderUnmetHours(const sql::SQLiteReports& report);
+ftxui::Element RenderEndUseByFuel(const sql::SQLiteReports& report);
+// When a baseline (aligned on the same endUseNames and fuelNames) is passed, each cell also shows the delta versus the baseline
+ftxui::Element RenderEndUseByFuel(const sql::EndUseTable& tableData, const sql::EndUseTable* baseline = nullptr,
+                                  const std::string& title = "End Use by Fuel");
+
 class SQLiteComponent : public ftxui::ComponentBase
 {
  public:
   SQLiteComponent() = default;
-  static ftxui::Element RenderDatabase(std::filesystem::path databasePath);
+  // The connection is kept open across frames so its prepared statements get reused, it is only reopened if the file changed
+  ftxui::Element RenderDatabase(const std::filesystem::path& databasePath);
+  void reset();
   virtual bool Focusable() const override {
     return true;
   };
+
+ private:
+  std::unique_ptr<sql::SQLiteReports> m_report;
+  std::filesystem::path m_databasePath;
+  std::filesystem::file_time_type m_lastWriteTime;
 };
 
 #endif  // SQL_PREPAREDSTATEMENT_HPP
@@ -0,0 +1,193 @@
+#include "SidecarIndex.hpp"
+
+#include "PreparedStatement.hpp"          // for PreparedStatement
+#include "../utilities/Hash.hpp"          // for fnv1a64, toHex
+#include "../utilities/Paths.hpp"         // for cacheDirectory
+#include "../utilities/Trace.hpp"         // for EPCLI_TRACE_SCOPE
+                                          //
+#include <sqlite3.h>                      // for sqlite3_open_v2, sqlite3_exec, sqlite3_close
+#include <fmt/format.h>                   // for format
+                                          //
+#include <chrono>                         // for duration_cast, nanoseconds
+#include <exception>                      // for exception
+#include <random>                         // for random_device
+#include <stdexcept>                      // for runtime_error
+#include <string>                         // for string, stoll, stoull, to_string
+#include <system_error>                   // for error_code
+
+namespace sql {
+
+namespace {
+  // Bump whenever the sidecar layout changes, so older ones get rebuilt
+  constexpr int sidecarSchemaVersion = 2;
+
+  void execScript(sqlite3* db, const std::string& script) {
+    char* err = nullptr;
+    if (sqlite3_exec(db, script.c_str(), nullptr, nullptr, &err) != SQLITE_OK) {
+      const std::string errMsg = (err != nullptr) ? err : "unknown error";
+      sqlite3_free(err);
+      throw std::runtime_error("Error building the sidecar index: " + errMsg);
+    }
+  }
+
+  // The source is attached through a URI filename to pass mode=ro
+  std::string toUri(const std::filesystem::path& path) {
+    std::string uri = "file:";
+#if _WIN32
+    uri += '/';
+#endif
+    for (const char c : path.generic_string()) {
+      if (c == '%' || c == '?' || c == '#') {
+        uri += fmt::format("%{:02X}", static_cast<unsigned char>(c));
+      } else {
+        uri += c;
+      }
+    }
+    return uri;
+  }
+
+  bool isUpToDate(const SourceIdentity& identity, const std::filesystem::path& sidecarPath) {
+    if (!std::filesystem::is_regular_file(sidecarPath)) {
+      return false;
+    }
+    sqlite3* db = nullptr;
+    const std::string fileName = sidecarPath.string();
+    if (sqlite3_open_v2(fileName.c_str(), &db, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK) {
+      sqlite3_close(db);
+      return false;
+    }
+    bool result = false;
+    try {
+      PreparedStatement stmt("SELECT Path, Size, ModifiedTime, SchemaVersion FROM SourceIdentity;", db, false);
+      if (stmt.step()) {
+        SourceIdentity stored;
+        stored.path = stmt.getColumnAsString(0);
+        stored.size = std::stoull(stmt.getColumnAsString(1));
+        stored.modifiedTime = std::stoll(stmt.getColumnAsString(2));
+        result = (stored == identity) && (stmt.getColumnAsInt(3) == sidecarSchemaVersion);
+      }
+    } catch (const std::exception&) {
+      result = false;
+    }
+    sqlite3_close(db);
+    return result;
+  }
+
+  void buildSidecarIndex(const SourceIdentity& identity, const std::filesystem::path& databasePath, const std::filesystem::path& tempPath) {
+    EPCLI_TRACE_SCOPE("buildSidecarIndex");
+    sqlite3* db = nullptr;
+    const std::string fileName = tempPath.string();
+    if (sqlite3_open_v2(fileName.c_str(), &db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_URI, nullptr) != SQLITE_OK) {
+      sqlite3_close(db);
+      throw std::runtime_error(fmt::format("Could not create the sidecar index at '{}'", fileName));
+    }
+
+    try {
+      // The file is renamed into place only once complete, so durability of the intermediate states doesn't matter
+      execScript(db, "PRAGMA journal_mode=OFF; PRAGMA synchronous=OFF;");
+
+      {
+        // mode=ro: the simulation outputs are never modified
+        PreparedStatement attach("ATTACH DATABASE ? AS src;", db, false, toUri(databasePath) + "?mode=ro");
+        attach.execAndThrowOnError();
+      }
+
+      execScript(db, R"sql(
+        BEGIN;
+
+        CREATE TABLE SourceIdentity (Path TEXT, Size TEXT, ModifiedTime TEXT, SchemaVersion INTEGER);
+
+        CREATE TABLE TabularDataWithStrings (
+          TabularDataIndex INTEGER PRIMARY KEY,
+          Value TEXT,
+          ReportName TEXT,
+          ReportForString TEXT,
+          TableName TEXT,
+          RowName TEXT,
+          ColumnName TEXT,
+          Units TEXT
+        );
+        INSERT INTO TabularDataWithStrings
+          SELECT TabularDataIndex, Value, ReportName, ReportForString, TableName, RowName, ColumnName, Units FROM src.TabularDataWithStrings;
+
+        -- Covering: every SQLiteReports lookup filters on a prefix of this and only reads RowName, ColumnName, Units or Value
+        CREATE INDEX TabularDataLookup ON TabularDataWithStrings (ReportName, ReportForString, TableName, RowName, ColumnName, Units, Value);
+
+        CREATE TABLE TabularIndex AS
+          SELECT t.ReportNameIndex, t.ReportForStringIndex, t.TableNameIndex,
+                 rn.Value AS ReportName, fs.Value AS ReportForString, tn.Value AS TableName, t.FirstKey, t.LastKey, t.NumCells
+            FROM (SELECT ReportNameIndex, ReportForStringIndex, TableNameIndex, MIN(TabularDataIndex) AS FirstKey,
+                         MAX(TabularDataIndex) AS LastKey, COUNT(*) AS NumCells
+                    FROM src.TabularData
+                    GROUP BY ReportNameIndex, ReportForStringIndex, TableNameIndex) AS t
+            INNER JOIN src.Strings AS rn ON rn.StringIndex = t.ReportNameIndex
+            INNER JOIN src.Strings AS fs ON fs.StringIndex = t.ReportForStringIndex
+            INNER JOIN src.Strings AS tn ON tn.StringIndex = t.TableNameIndex
+            ORDER BY t.FirstKey;
+
+        COMMIT;)sql");
+
+      {
+        // Stored as TEXT: uintmax_t / int64 don't fit PreparedStatement::bind(int)
+        PreparedStatement insert("INSERT INTO SourceIdentity VALUES (?, ?, ?, ?);", db, false, identity.path, std::to_string(identity.size),
+                                 std::to_string(identity.modifiedTime), sidecarSchemaVersion);
+        insert.execAndThrowOnError();
+      }
+
+      execScript(db, "DETACH DATABASE src; ANALYZE;");
+    } catch (...) {
+      sqlite3_close(db);
+      throw;
+    }
+    sqlite3_close(db);
+  }
+}  // namespace
+
+SourceIdentity SourceIdentity::fromFile(const std::filesystem::path& databasePath) {
+  SourceIdentity identity;
+  identity.path = std::filesystem::weakly_canonical(databasePath).string();
+  identity.size = std::filesystem::file_size(databasePath);
+  identity.modifiedTime =
+    std::chrono::duration_cast<std::chrono::nanoseconds>(std::filesystem::last_write_time(databasePath).time_since_epoch()).count();
+  return identity;
+}
+
+std::filesystem::path sidecarIndexPath(const SourceIdentity& identity) {
+  const std::filesystem::path dir = utilities::cacheDirectory() / "index";
+  std::error_code ec;
+  std::filesystem::create_directories(dir, ec);
+  // Keyed on the path only, so that a rerun in the same directory replaces its stale sidecar instead of piling up new ones
+  return dir / (utilities::toHex(utilities::fnv1a64(identity.path)) + ".sqlite");
+}
+
+std::filesystem::path ensureSidecarIndex(const SourceIdentity& identity, const std::filesystem::path& databasePath) {
+  std::filesystem::path sidecarPath = sidecarIndexPath(identity);
+  if (isUpToDate(identity, sidecarPath)) {
+    return sidecarPath;
+  }
+
+  // Build under a unique name and rename into place, so concurrent readers (other threads or epcli processes) never see a partial index
+  std::random_device rd;
+  std::filesystem::path tempPath = sidecarPath;
+  tempPath += fmt::format(".{:08x}{:08x}.tmp", rd(), rd());
+  try {
+    buildSidecarIndex(identity, databasePath, tempPath);
+    std::filesystem::rename(tempPath, sidecarPath);
+  } catch (...) {
+    std::error_code ec;
+    std::filesystem::remove(tempPath, ec);
+    throw;
+  }
+  return sidecarPath;
+}
+
+void attachSidecarIndex(sqlite3* db, const std::filesystem::path& sidecarPath) {
+  {
+    PreparedStatement attach("ATTACH DATABASE ? AS idx;", db, false, sidecarPath.string());
+    attach.execAndThrowOnError();
+  }
+  PreparedStatement view("CREATE TEMP VIEW TabularDataWithStrings AS SELECT * FROM idx.TabularDataWithStrings;", db, false);
+  view.execAndThrowOnError();
+}
+
+}  // namespace sql
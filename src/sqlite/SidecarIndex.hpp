@@ -0,0 +1,40 @@
+#ifndef SQL_SIDECARINDEX_HPP
+#define SQL_SIDECARINDEX_HPP
+
+#include <cstdint>     // for uintmax_t, int64_t
+#include <filesystem>  // for path
+#include <string>      // for string
+
+struct sqlite3;
+
+namespace sql {
+
+/// What identifies an eplusout.sql: if any of it changes, the sidecar index is stale and gets rebuilt
+struct SourceIdentity
+{
+  std::string path;  // canonical
+  std::uintmax_t size = 0;
+  std::int64_t modifiedTime = 0;
+
+  static SourceIdentity fromFile(const std::filesystem::path& databasePath);
+  bool operator==(const SourceIdentity& other) const = default;
+};
+
+/// The EnergyPlus SQL output has no index on TabularDataWithStrings and is opened read-only, so every lookup is a full scan.
+/// The sidecar index is a separate database in the epcli cache directory, holding a narrow copy of TabularDataWithStrings with a covering
+/// index on (ReportName, ReportForString, TableName, RowName, ColumnName), plus the materialized SQLiteReports::tabularIndex.
+/// The simulation outputs are never modified.
+std::filesystem::path sidecarIndexPath(const SourceIdentity& identity);
+
+/// Returns the path to an up to date sidecar index for identity, building it from databasePath (the file actually opened, which may be a
+/// temporary copy of identity.path) if it is missing or stale. Throws std::runtime_error on failure
+std::filesystem::path ensureSidecarIndex(const SourceIdentity& identity, const std::filesystem::path& databasePath);
+
+/// ATTACHes the sidecar as the 'idx' schema, and shadows TabularDataWithStrings with its indexed copy through a TEMP VIEW (temp is searched
+/// before main, and works on a read-only connection), so existing queries transparently get indexed lookups.
+/// Throws std::runtime_error on failure
+void attachSidecarIndex(sqlite3* db, const std::filesystem::path& sidecarPath);
+
+}  // namespace sql
+
+#endif  // SQL_SIDECARINDEX_HPP
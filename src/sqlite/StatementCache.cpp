@@ -0,0 +1,77 @@
+#include "StatementCache.hpp"
+
+#include <utility>  // for move
+
+namespace sql {
+
+StatementCache::Lease::Lease(StatementCache* cache, std::string sql, std::unique_ptr<PreparedStatement> statement)
+  : m_cache(cache), m_sql(std::move(sql)), m_statement(std::move(statement)) {}
+
+StatementCache::Lease::~Lease() {
+  // Moved-from
+  if (m_statement == nullptr) {
+    return;
+  }
+  m_cache->release(std::move(m_sql), std::move(m_statement));
+}
+
+StatementCache::StatementCache(sqlite3* db, std::size_t capacity) : m_db(db), m_capacity(capacity) {}
+
+StatementCache::Lease StatementCache::acquire(const std::string& sql) {
+  if (auto it = m_index.find(sql); it != m_index.end()) {
+    ++m_hits;
+    auto statement = std::move(it->second->second);
+    m_lru.erase(it->second);
+    m_index.erase(it);
+    return {this, sql, std::move(statement)};
+  }
+
+  ++m_misses;
+  return {this, sql, std::make_unique<PreparedStatement>(sql, m_db, false)};
+}
+
+void StatementCache::release(std::string sql, std::unique_ptr<PreparedStatement> statement) {
+  // So the next user starts from a clean state and the statement doesn't hold a read transaction open
+  statement->resetAndClearBindings();
+
+  if (m_capacity == 0 || m_index.contains(sql)) {
+    // Duplicate of a statement that was already returned
+    return;
+  }
+
+  m_lru.emplace_front(sql, std::move(statement));
+  m_index.emplace(std::move(sql), m_lru.begin());
+
+  if (m_lru.size() > m_capacity) {
+    m_index.erase(m_lru.back().first);
+    m_lru.pop_back();
+    ++m_evictions;
+  }
+}
+
+void StatementCache::clear() {
+  m_index.clear();
+  m_lru.clear();
+}
+
+std::size_t StatementCache::size() const {
+  return m_lru.size();
+}
+
+std::size_t StatementCache::capacity() const {
+  return m_capacity;
+}
+
+std::size_t StatementCache::hits() const {
+  return m_hits;
+}
+
+std::size_t StatementCache::misses() const {
+  return m_misses;
+}
+
+std::size_t StatementCache::evictions() const {
+  return m_evictions;
+}
+
+}  // namespace sql
@@ -0,0 +1,82 @@
+#ifndef SQL_STATEMENTCACHE_HPP
+#define SQL_STATEMENTCACHE_HPP
+
+#include "PreparedStatement.hpp"  // for PreparedStatement
+
+#include <cstddef>        // for size_t
+#include <list>           // for list
+#include <memory>         // for unique_ptr
+#include <string>         // for string
+#include <unordered_map>  // for unordered_map
+#include <utility>        // for pair
+
+struct sqlite3;
+
+namespace sql {
+
+/// LRU cache of prepared statements for a single connection, keyed by SQL text, so hot queries go through sqlite3_prepare_v2 once per
+/// connection lifetime instead of once per call. Not thread safe: like the connection itself, it belongs to one thread at a time.
+/// The cache must outlive the leases it hands out, and be destroyed before the connection is closed
+class StatementCache
+{
+ public:
+  /// RAII handle on a cached statement. On destruction, the statement is reset, its bindings are cleared, and it goes back to the cache
+  class Lease
+  {
+   public:
+    Lease(StatementCache* cache, std::string sql, std::unique_ptr<PreparedStatement> statement);
+    Lease(const Lease&) = delete;
+    Lease& operator=(const Lease&) = delete;
+    Lease(Lease&& other) noexcept = default;
+    Lease& operator=(Lease&& other) noexcept = delete;
+    ~Lease();
+
+    PreparedStatement& operator*() const {
+      return *m_statement;
+    }
+    PreparedStatement* operator->() const {
+      return m_statement.get();
+    }
+
+   private:
+    StatementCache* m_cache;
+    std::string m_sql;
+    std::unique_ptr<PreparedStatement> m_statement;
+  };
+
+  explicit StatementCache(sqlite3* db, std::size_t capacity = 64);
+  StatementCache(const StatementCache&) = delete;
+  StatementCache& operator=(const StatementCache&) = delete;
+
+  /// Returns the cached statement for this SQL text, preparing it on a miss. If the statement is already leased (eg: two of the same query
+  /// in flight), a second one is prepared and the duplicate is dropped when returned
+  Lease acquire(const std::string& sql);
+
+  /// Finalizes all the idle statements
+  void clear();
+
+  [[nodiscard]] std::size_t size() const;
+  [[nodiscard]] std::size_t capacity() const;
+  [[nodiscard]] std::size_t hits() const;
+  [[nodiscard]] std::size_t misses() const;
+  [[nodiscard]] std::size_t evictions() const;
+
+ private:
+  void release(std::string sql, std::unique_ptr<PreparedStatement> statement);
+
+  using Entry = std::pair<std::string, std::unique_ptr<PreparedStatement>>;
+
+  sqlite3* m_db;
+  std::size_t m_capacity;
+  // Idle statements, most recently used first
+  std::list<Entry> m_lru;
+  std::unordered_map<std::string, std::list<Entry>::iterator> m_index;
+
+  std::size_t m_hits = 0;
+  std::size_t m_misses = 0;
+  std::size_t m_evictions = 0;
+};
+
+}  // namespace sql
+
+#endif  // SQL_STATEMENTCACHE_HPP
@@ -0,0 +1,256 @@
+#include "TabularBrowser.hpp"
+
+#include "../utilities/ASCIIStrings.hpp"  // for ascii_to_lower_copy
+
+#include <ftxui/component/component.hpp>          // for Input, Menu, Button, Container
+#include <ftxui/component/component_options.hpp>  // for ButtonOption
+#include <ftxui/dom/elements.hpp>                 // for text, window, vbox, hbox, separator, operator|, size, flex, reflect
+#include <ftxui/screen/color.hpp>                 // for Color
+
+#include <fmt/format.h>  // for format
+
+#include <algorithm>     // for max, min
+#include <exception>     // for exception
+#include <memory>        // for make_unique
+#include <system_error>  // for error_code
+#include <utility>       // for move
+
+using namespace ftxui;
+
+TabularBrowserComponent::TabularBrowserComponent() {
+  m_filterInput = Input(&m_filter, "filter tables");
+  m_tableMenu = Menu(&m_tableLabels, &m_selectedTable);
+  m_previousButton = Button(
+    &m_previousButtonText, [this]() { previousPage(); }, ButtonOption::Simple());
+  m_nextButton = Button(
+    &m_nextButtonText, [this]() { nextPage(); }, ButtonOption::Simple());
+
+  Add(Container::Horizontal({
+    Container::Vertical({
+      m_filterInput,
+      m_tableMenu,
+    }),
+    Container::Horizontal({
+      m_previousButton,
+      m_nextButton,
+    }),
+  }));
+}
+
+void TabularBrowserComponent::setDatabase(const std::filesystem::path& databasePath) {
+  std::error_code ec;
+  const auto lastWriteTime = std::filesystem::last_write_time(databasePath, ec);
+  if (m_report && databasePath == m_databasePath && lastWriteTime == m_lastWriteTime) {
+    return;
+  }
+
+  reset();
+  m_databasePath = databasePath;
+  m_lastWriteTime = lastWriteTime;
+  try {
+    // Only called once the run is done, no need for a temporary copy which would defeat the purpose on large files
+    m_report = std::make_unique<sql::SQLiteReports>(databasePath, false);
+  } catch (const std::exception& e) {
+    m_errorMessage = e.what();
+    return;
+  }
+  applyFilter();
+}
+
+void TabularBrowserComponent::reset() {
+  m_report.reset();
+  m_databasePath.clear();
+  m_errorMessage.clear();
+  m_tableLabels.clear();
+  m_tableIndices.clear();
+  m_appliedFilter.clear();
+  m_selectedTable = 0;
+  m_loadedTable = -1;
+  m_page.clear();
+  m_pageAfterKeys.clear();
+}
+
+void TabularBrowserComponent::applyFilter() {
+  m_appliedFilter = m_filter;
+  m_tableLabels.clear();
+  m_tableIndices.clear();
+  if (!m_report) {
+    return;
+  }
+
+  const std::string filter = utilities::ascii_to_lower_copy(m_filter);
+  const auto& tabularIndex = m_report->tabularIndex();
+  for (size_t i = 0; i < tabularIndex.size(); ++i) {
+    const auto& entry = tabularIndex[i];
+    std::string label = fmt::format("{} > {} > {}", entry.reportName, entry.reportForString, entry.tableName);
+    if (!filter.empty() && utilities::ascii_to_lower_copy(label).find(filter) == std::string::npos) {
+      continue;
+    }
+    m_tableLabels.emplace_back(std::move(label));
+    m_tableIndices.push_back(i);
+  }
+  m_selectedTable = std::max(0, std::min(m_selectedTable, static_cast<int>(m_tableIndices.size()) - 1));
+  loadFirstPage();
+}
+
+void TabularBrowserComponent::loadFirstPage() {
+  m_page.clear();
+  m_pageAfterKeys.clear();
+  if (!m_report || m_tableIndices.empty()) {
+    m_loadedTable = -1;
+    return;
+  }
+  m_loadedTable = static_cast<int>(m_tableIndices[m_selectedTable]);
+  fetchPage(m_report->tabularIndex()[m_loadedTable].firstKey - 1);
+}
+
+void TabularBrowserComponent::fetchPage(int afterKey) {
+  const auto& table = m_report->tabularIndex()[m_loadedTable];
+  m_page = m_report->tabularPage(table, afterKey, m_pageSize);
+  m_pageAfterKeys.push_back(afterKey);
+}
+
+void TabularBrowserComponent::nextPage() {
+  if (m_loadedTable < 0 || m_page.empty()) {
+    return;
+  }
+  const auto& table = m_report->tabularIndex()[m_loadedTable];
+  if (m_page.back().key >= table.lastKey) {
+    return;
+  }
+  auto page = m_report->tabularPage(table, m_page.back().key, m_pageSize);
+  if (page.empty()) {
+    return;
+  }
+  m_pageAfterKeys.push_back(m_page.back().key);
+  m_page = std::move(page);
+}
+
+void TabularBrowserComponent::previousPage() {
+  if (m_loadedTable < 0 || m_pageAfterKeys.size() < 2) {
+    return;
+  }
+  m_pageAfterKeys.pop_back();
+  const int afterKey = m_pageAfterKeys.back();
+  m_pageAfterKeys.pop_back();
+  fetchPage(afterKey);
+}
+
+void TabularBrowserComponent::resizePage() {
+  // Not laid out yet
+  if (m_pageBox.y_max <= m_pageBox.y_min) {
+    return;
+  }
+  const int visibleRows = std::max(10, m_pageBox.y_max - m_pageBox.y_min + 1);
+  if (visibleRows == m_pageSize) {
+    return;
+  }
+  m_pageSize = visibleRows;
+  if (m_loadedTable >= 0 && !m_pageAfterKeys.empty()) {
+    // Same first cell, as many as now fit
+    const int afterKey = m_pageAfterKeys.back();
+    m_pageAfterKeys.pop_back();
+    fetchPage(afterKey);
+  }
+}
+
+bool TabularBrowserComponent::OnEvent(Event event) {
+  bool handled = ComponentBase::OnEvent(event);
+
+  if (!handled && event == Event::PageDown) {
+    nextPage();
+    handled = true;
+  } else if (!handled && event == Event::PageUp) {
+    previousPage();
+    handled = true;
+  }
+
+  if (m_filter != m_appliedFilter) {
+    applyFilter();
+  } else if (!m_tableIndices.empty() && static_cast<int>(m_tableIndices[m_selectedTable]) != m_loadedTable) {
+    loadFirstPage();
+  }
+
+  return handled;
+}
+
+Element TabularBrowserComponent::RenderPage() {
+  if (m_loadedTable < 0) {
+    return window(text("Table"), text("(empty)"));
+  }
+
+  resizePage();
+  const auto& table = m_report->tabularIndex()[m_loadedTable];
+
+  size_t size_row = 20;
+  size_t size_column = 20;
+  size_t size_value = 15;
+  size_t size_units = 10;
+  for (const auto& cell : m_page) {
+    size_row = std::max(size_row, cell.rowName.size());
+    size_column = std::max(size_column, cell.columnName.size());
+    size_value = std::max(size_value, cell.value.size());
+    size_units = std::max(size_units, cell.units.size());
+  }
+
+  auto header = hbox({
+    text("Row") | ftxui::size(WIDTH, EQUAL, size_row),
+    separator(),
+    text("Column") | ftxui::size(WIDTH, EQUAL, size_column),
+    separator(),
+    hcenter(text("Value")) | ftxui::size(WIDTH, EQUAL, size_value),
+    separator(),
+    hcenter(text("Units")) | ftxui::size(WIDTH, EQUAL, size_units),
+  });
+
+  Elements rowList;
+  rowList.reserve(m_page.size());
+  for (const auto& cell : m_page) {
+    rowList.emplace_back(hbox({
+      text(cell.rowName) | ftxui::size(WIDTH, EQUAL, size_row),
+      separator(),
+      text(cell.columnName) | ftxui::size(WIDTH, EQUAL, size_column),
+      separator(),
+      align_right(text(cell.value)) | ftxui::size(WIDTH, EQUAL, size_value),
+      separator(),
+      hcenter(text(cell.units)) | ftxui::size(WIDTH, EQUAL, size_units),
+    }));
+  }
+  if (rowList.empty()) {
+    rowList.push_back(text("(empty)"));
+  }
+
+  const int numPages = std::max(1, (table.numCells + m_pageSize - 1) / m_pageSize);
+  auto footer = hbox({
+    m_previousButton->Render(),
+    filler(),
+    text(fmt::format("Page {} / ~{}  ({} cells)", m_pageAfterKeys.size(), numPages, table.numCells)),
+    filler(),
+    m_nextButton->Render(),
+  });
+
+  return window(text(fmt::format("{} > {} > {}", table.reportName, table.reportForString, table.tableName)),
+                vbox({
+                  header,
+                  separator(),
+                  vbox(rowList) | yframe | flex | reflect(m_pageBox),
+                  separator(),
+                  footer,
+                }));
+}
+
+Element TabularBrowserComponent::Render() {
+  if (!m_errorMessage.empty()) {
+    return text(m_errorMessage) | color(Color::Red);
+  }
+
+  const size_t numTables = m_report ? m_report->tabularIndex().size() : 0;
+
+  return hbox({
+    vbox({
+      window(text("Filter"), m_filterInput->Render()),
+      window(text(fmt::format("Tables ({}/{})", m_tableLabels.size(), numTables)), m_tableMenu->Render() | vscroll_indicator | frame) | flex,
+    }) | ftxui::size(WIDTH, LESS_THAN, 70),
+    RenderPage() | flex,
+  });
+}
@@ -0,0 +1,70 @@
+#ifndef SQL_TABULARBROWSER_HPP
+#define SQL_TABULARBROWSER_HPP
+
+#include "SQLiteReports.hpp"  // for SQLiteReports, TabularCell
+
+#include <ftxui/component/component_base.hpp>  // for ComponentBase, Component
+#include <ftxui/component/event.hpp>           // for Event
+#include <ftxui/dom/elements.hpp>              // for Element
+#include <ftxui/screen/box.hpp>                // for Box
+
+#include <filesystem>  // for path, file_time_type
+#include <memory>      // for unique_ptr
+#include <string>      // for string
+#include <vector>      // for vector
+
+/// Generic browser for all the tables EnergyPlus wrote to TabularDataWithStrings.
+/// The list of tables comes from the cached SQLiteReports::tabularIndex, and only the visible page of cells is ever fetched
+class TabularBrowserComponent : public ftxui::ComponentBase
+{
+ public:
+  TabularBrowserComponent();
+
+  // (Re)opens the database if it isn't the one being browsed, or if it was modified since
+  void setDatabase(const std::filesystem::path& databasePath);
+  void reset();
+
+  ftxui::Element Render() override;
+  bool OnEvent(ftxui::Event event) override;
+
+ private:
+  ftxui::Element RenderPage();
+
+  void applyFilter();
+  void loadFirstPage();
+  void nextPage();
+  void previousPage();
+  // Refetches the current page if the pane no longer shows m_pageSize rows
+  void resizePage();
+  void fetchPage(int afterKey);
+
+  std::unique_ptr<sql::SQLiteReports> m_report;
+  std::filesystem::path m_databasePath;
+  std::filesystem::file_time_type m_lastWriteTime;
+  std::string m_errorMessage;
+
+  std::string m_filter;
+  std::string m_appliedFilter;
+  // The labels displayed in the menu, and the index in tabularIndex() for each of them
+  std::vector<std::string> m_tableLabels;
+  std::vector<size_t> m_tableIndices;
+  int m_selectedTable = 0;
+  // Index in tabularIndex() of the table whose page is displayed, -1 if none
+  int m_loadedTable = -1;
+
+  std::vector<sql::TabularCell> m_page;
+  // The afterKey used to fetch each page up to the current one, to go back
+  std::vector<int> m_pageAfterKeys;
+  // Until the first layout, then the number of visible rows
+  int m_pageSize = 50;
+  ftxui::Box m_pageBox;
+
+  std::string m_previousButtonText = "< Previous";
+  std::string m_nextButtonText = "Next >";
+  ftxui::Component m_filterInput;
+  ftxui::Component m_tableMenu;
+  ftxui::Component m_previousButton;
+  ftxui::Component m_nextButton;
+};
+
+#endif  // SQL_TABULARBROWSER_HPP
@@ -0,0 +1,71 @@
+#include "HeadlessRun.hpp"
+
+#include "../EnergyPlus.hpp"            // for runEnergyPlus, RunOptions
+#include "../ErrorMessage.hpp"          // for ErrorMessage
+#include "../PhaseProfiler.hpp"         // for PhaseProfiler
+#include "../TerminationPolicy.hpp"     // for TerminationGuard
+#include "../sqlite/SQLiteReports.hpp"  // for SQLiteReports
+
+#include <ftxui/component/receiver.hpp>  // for MakeReceiver
+
+#include <memory>  // for unique_ptr, make_unique
+
+namespace sweep {
+
+HeadlessResult runHeadless(const std::filesystem::path& input, const std::filesystem::path& outputDirectory,
+                           const std::vector<std::string>& energyPlusArgs, std::atomic<int>& progress,
+                           const epcli::TerminationPolicy& termination, const std::atomic<bool>* cancel) {
+  std::vector<std::string> args{"energyplus"};
+  args.insert(args.end(), energyPlusArgs.cbegin(), energyPlusArgs.cend());
+  args.emplace_back("-d");
+  args.emplace_back(outputDirectory.string());
+  args.emplace_back(input.string());
+  std::vector<const char*> argv;
+  argv.reserve(args.size());
+  for (const auto& arg : args) {
+    argv.push_back(arg.c_str());
+  }
+
+  auto receiverRunOutput = ftxui::MakeReceiver<std::string>();
+  auto receiverErrorOutput = ftxui::MakeReceiver<ErrorMessage>();
+  auto senderRunOutput = receiverRunOutput->MakeSender();
+  auto senderErrorOutput = receiverErrorOutput->MakeSender();
+  epcli::PhaseProfiler profiler(outputDirectory);
+  // One per run: it counts the severes and warmup days of this run only
+  std::unique_ptr<epcli::TerminationGuard> guard;
+  if (termination.enabled()) {
+    guard = std::make_unique<epcli::TerminationGuard>(termination);
+  }
+  epcli::RunOptions options;
+  options.profiler = &profiler;
+  options.guard = guard.get();
+  options.cancel = cancel;
+  epcli::runEnergyPlus(static_cast<int>(argv.size()), argv.data(), &senderRunOutput, &senderErrorOutput, &progress, nullptr, options);
+
+  HeadlessResult result;
+  result.succeeded = progress == 100;
+  result.phases = epcli::PhaseProfiler::toJson(profiler.snapshot());
+  if (guard != nullptr) {
+    result.stoppedBy = guard->reason();
+  }
+  // Nobody reads the stdout lines of a headless run, they are all in its output directory
+  while (receiverErrorOutput->HasPending()) {
+    ErrorMessage message;
+    receiverErrorOutput->Receive(&message);
+    if (message.error == EnergyPlus::Error::Warning) {
+      ++result.warnings;
+    } else if (message.error == EnergyPlus::Error::Severe || message.error == EnergyPlus::Error::Fatal) {
+      ++result.severes;
+    }
+  }
+
+  const auto databasePath = outputDirectory / "eplusout.sql";
+  if (result.succeeded && std::filesystem::is_regular_file(databasePath)) {
+    // In place, read-only: the run is over
+    const sql::SQLiteReports report(databasePath, false);
+    result.netSiteEnergy = report.netSiteEnergy();
+  }
+  return result;
+}
+
+}  // namespace sweep
@@ -0,0 +1,38 @@
+#ifndef SWEEP_HEADLESSRUN_HPP
+#define SWEEP_HEADLESSRUN_HPP
+
+#include "../TerminationPolicy.hpp"  // for TerminationPolicy
+
+#include <atomic>      // for atomic
+#include <cstddef>     // for size_t
+#include <filesystem>  // for path
+#include <optional>    // for optional
+#include <string>      // for string
+#include <vector>      // for vector
+
+namespace sweep {
+
+struct HeadlessResult
+{
+  bool succeeded = false;
+  /// From <outputDirectory>/eplusout.sql: missing if the input has no Output:SQLite with tabular reports
+  std::optional<double> netSiteEnergy;
+  std::size_t warnings = 0;
+  std::size_t severes = 0;
+  /// Where the run time went, as epcli::PhaseProfiler::toJson (also written to <outputDirectory>/epcli_profile.json)
+  std::string phases;
+  /// Why the termination policy stopped the run, empty if it didn't
+  std::string stoppedBy;
+};
+
+/// runEnergyPlus without a screen: `energyplus <energyPlusArgs...> -d <outputDirectory> <input>`, counting the warnings and severes as
+/// they are received, then reading the Net Site Energy of the run. progress is updated as the run goes. The run has its own
+/// epcli::TerminationGuard if termination is enabled. Setting cancel, from any thread, stops the run at its next timestep. Throws
+/// std::runtime_error if the results can't be read, or a pattern of termination isn't a valid regex
+HeadlessResult runHeadless(const std::filesystem::path& input, const std::filesystem::path& outputDirectory,
+                           const std::vector<std::string>& energyPlusArgs, std::atomic<int>& progress,
+                           const epcli::TerminationPolicy& termination = {}, const std::atomic<bool>* cancel = nullptr);
+
+}  // namespace sweep
+
+#endif  // SWEEP_HEADLESSRUN_HPP
@@ -0,0 +1,150 @@
+#include "IdfTemplate.hpp"
+
+#include "../utilities/ASCIIStrings.hpp"  // for ascii_to_lower_copy
+
+#include <fmt/format.h>  // for format
+
+#include <algorithm>    // for sort, adjacent_find
+#include <fstream>      // for ifstream
+#include <iterator>     // for istreambuf_iterator
+#include <stdexcept>    // for runtime_error
+#include <string_view>  // for string_view
+#include <utility>      // for move
+
+namespace sweep {
+
+namespace {
+  struct Field
+  {
+    std::size_t begin = 0;
+    std::size_t end = 0;
+  };
+
+  bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+  }
+
+  // Calls onObject(fields) for each object of an IDF: fields[0] is the object type. A field is what lies between the separators, without
+  // the surrounding whitespace and `!` comments, so an empty field is an empty range right before its separator
+  template <typename OnObject>
+  void scanObjects(std::string_view text, OnObject&& onObject) {
+    std::vector<Field> fields;
+    std::size_t i = 0;
+    const std::size_t n = text.size();
+    while (i < n) {
+      while (i < n && (isSpace(text[i]) || text[i] == '!')) {
+        if (text[i] == '!') {
+          i = std::min(n, text.find('\n', i));
+        } else {
+          ++i;
+        }
+      }
+      if (i >= n) {
+        break;
+      }
+      Field field{i, i};
+      while (i < n && text[i] != ',' && text[i] != ';') {
+        if (text[i] == '!') {
+          i = std::min(n, text.find('\n', i));
+          continue;
+        }
+        if (!isSpace(text[i])) {
+          field.end = i + 1;
+        }
+        ++i;
+      }
+      fields.push_back(field);
+      if (i < n && text[i++] == ';') {
+        onObject(fields);
+        fields.clear();
+      }
+    }
+  }
+}  // namespace
+
+IdfTemplate::IdfTemplate(std::string text, const std::vector<FieldRef>& targets) : m_text(std::move(text)), m_numTargets(targets.size()) {
+  struct Target
+  {
+    std::string type;
+    std::string name;
+    bool any = false;
+    std::size_t matches = 0;
+  };
+  std::vector<Target> lowered;
+  lowered.reserve(targets.size());
+  for (const auto& target : targets) {
+    lowered.push_back(Target{utilities::ascii_to_lower_copy(target.objectType), utilities::ascii_to_lower_copy(target.name), target.name == "*"});
+  }
+
+  const std::string_view view(m_text);
+  scanObjects(view, [&](const std::vector<Field>& fields) {
+    const auto type = utilities::ascii_to_lower_copy(view.substr(fields[0].begin, fields[0].end - fields[0].begin));
+    for (std::size_t t = 0; t < targets.size(); ++t) {
+      auto& target = lowered[t];
+      if (type != target.type) {
+        continue;
+      }
+      if (!target.any
+          && (fields.size() < 2 || utilities::ascii_to_lower_copy(view.substr(fields[1].begin, fields[1].end - fields[1].begin)) != target.name)) {
+        continue;
+      }
+      const auto field = static_cast<std::size_t>(targets[t].field);
+      if (field >= fields.size()) {
+        const auto name = fields.size() < 2 ? std::string_view() : view.substr(fields[1].begin, fields[1].end - fields[1].begin);
+        throw std::runtime_error(fmt::format("{} '{}' has {} fields after its type, field {} cannot be substituted", targets[t].objectType, name,
+                                             fields.size() - 1, field));
+      }
+      ++target.matches;
+      m_spans.push_back(Span{fields[field].begin, fields[field].end, t});
+    }
+  });
+
+  for (std::size_t t = 0; t < targets.size(); ++t) {
+    if (lowered[t].matches == 0) {
+      throw std::runtime_error(fmt::format("No {} named '{}' in the input", targets[t].objectType, targets[t].name));
+    }
+  }
+  std::sort(m_spans.begin(), m_spans.end(), [](const Span& a, const Span& b) { return a.begin < b.begin; });
+  const auto twice = std::adjacent_find(m_spans.cbegin(), m_spans.cend(), [](const Span& a, const Span& b) { return a.begin == b.begin; });
+  if (twice != m_spans.cend()) {
+    throw std::runtime_error(fmt::format("Parameters {} and {} substitute the same field", twice->target + 1, (twice + 1)->target + 1));
+  }
+}
+
+IdfTemplate IdfTemplate::fromFile(const std::filesystem::path& path, const std::vector<FieldRef>& targets) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    throw std::runtime_error(fmt::format("Cannot open '{}'", path.string()));
+  }
+  return {std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()), targets};
+}
+
+std::string IdfTemplate::instantiate(const std::vector<std::string>& values) const {
+  if (values.size() != m_numTargets) {
+    throw std::runtime_error(fmt::format("Expected {} values, got {}", m_numTargets, values.size()));
+  }
+  std::size_t size = m_text.size();
+  for (const auto& span : m_spans) {
+    size += values[span.target].size() - (span.end - span.begin);
+  }
+  std::string result;
+  result.reserve(size);
+  std::size_t previous = 0;
+  for (const auto& span : m_spans) {
+    result.append(m_text, previous, span.begin - previous);
+    result.append(values[span.target]);
+    previous = span.end;
+  }
+  result.append(m_text, previous);
+  return result;
+}
+
+const std::string& IdfTemplate::text() const {
+  return m_text;
+}
+
+std::size_t IdfTemplate::numSubstitutions() const {
+  return m_spans.size();
+}
+
+}  // namespace sweep
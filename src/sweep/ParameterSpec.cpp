@@ -0,0 +1,269 @@
+#include "ParameterSpec.hpp"
+
+#include "../utilities/ASCIIStrings.hpp"  // for ascii_trim, ascii_to_lower_copy
+
+#include <fmt/format.h>  // for format
+
+#include <algorithm>    // for min
+#include <fstream>      // for ifstream
+#include <limits>       // for numeric_limits
+#include <numeric>      // for iota
+#include <random>       // for mt19937_64
+#include <sstream>      // for istringstream
+#include <stdexcept>    // for runtime_error
+#include <string_view>  // for string_view
+#include <utility>      // for move, swap
+
+namespace sweep {
+
+namespace {
+  // More than anyone will simulate, small enough for the lhs and random draws to fit in memory
+  constexpr std::size_t maxVariants = 10'000'000;
+
+  std::vector<std::string> splitWords(std::string_view text) {
+    std::vector<std::string> words;
+    std::istringstream stream{std::string(text)};
+    std::string word;
+    while (stream >> word) {
+      words.emplace_back(std::move(word));
+    }
+    return words;
+  }
+
+  double parseDouble(const std::string& text) {
+    std::size_t consumed = 0;
+    double value = 0.0;
+    try {
+      value = std::stod(text, &consumed);
+    } catch (const std::exception&) {
+      consumed = 0;
+    }
+    if (consumed == 0 || consumed != text.size()) {
+      throw std::runtime_error(fmt::format("'{}' is not a number", text));
+    }
+    return value;
+  }
+
+  std::size_t parseCount(const std::string& text, std::size_t minValue, std::size_t maxValue) {
+    const double value = parseDouble(text);
+    if (value != static_cast<double>(static_cast<std::size_t>(value)) || value < static_cast<double>(minValue)
+        || value > static_cast<double>(maxValue)) {
+      throw std::runtime_error(fmt::format("'{}' is not an integer between {} and {}", text, minValue, maxValue));
+    }
+    return static_cast<std::size_t>(value);
+  }
+
+  FieldRef parseTarget(std::string_view text) {
+    std::vector<std::string_view> parts;
+    while (true) {
+      const auto comma = text.find(',');
+      parts.push_back(utilities::ascii_trim(text.substr(0, comma)));
+      if (comma == std::string_view::npos) {
+        break;
+      }
+      text.remove_prefix(comma + 1);
+    }
+    if (parts.size() != 3 || parts[0].empty() || parts[1].empty()) {
+      throw std::runtime_error("expected <ObjectType>, <Name or *>, <field>");
+    }
+    return FieldRef{std::string(parts[0]), std::string(parts[1]), static_cast<int>(parseCount(std::string(parts[2]), 1, 10'000))};
+  }
+
+  Parameter parseParameter(std::string name, std::string_view definition) {
+    const auto bar = definition.find('|');
+    if (bar == std::string_view::npos) {
+      throw std::runtime_error("expected <ObjectType>, <Name or *>, <field> | values ... or range <min> <max> [<steps>]");
+    }
+    Parameter parameter;
+    parameter.name = std::move(name);
+    parameter.target = parseTarget(definition.substr(0, bar));
+
+    auto words = splitWords(definition.substr(bar + 1));
+    if (words.size() >= 2 && words[0] == "values") {
+      parameter.values.assign(std::make_move_iterator(words.begin() + 1), std::make_move_iterator(words.end()));
+    } else if ((words.size() == 3 || words.size() == 4) && words[0] == "range") {
+      parameter.min = parseDouble(words[1]);
+      parameter.max = parseDouble(words[2]);
+      if (parameter.max < parameter.min) {
+        throw std::runtime_error(fmt::format("empty range [{}, {}]", words[1], words[2]));
+      }
+      if (words.size() == 4) {
+        parameter.steps = static_cast<int>(parseCount(words[3], 1, 100'000));
+      }
+    } else {
+      throw std::runtime_error("expected 'values <v1> <v2>...' or 'range <min> <max> [<steps>]' after '|'");
+    }
+    return parameter;
+  }
+
+  // A uniform double in [0, 1) from the top 53 bits: unlike std::uniform_real_distribution, the same on every standard library
+  double unitDraw(std::mt19937_64& engine) {
+    return static_cast<double>(engine() >> 11U) * 0x1.0p-53;
+  }
+}  // namespace
+
+ParameterSpec ParameterSpec::parse(std::istream& input) {
+  ParameterSpec spec;
+  bool samplesGiven = false;
+  std::string line;
+  int lineNumber = 0;
+  while (std::getline(input, line)) {
+    ++lineNumber;
+    std::string_view content(line);
+    content = utilities::ascii_trim(content.substr(0, content.find('#')));
+    if (content.empty()) {
+      continue;
+    }
+    try {
+      const auto colon = content.find(':');
+      if (colon == std::string_view::npos) {
+        throw std::runtime_error("expected 'key: value'");
+      }
+      const auto key = utilities::ascii_to_lower_copy(utilities::ascii_trim(content.substr(0, colon)));
+      const auto value = utilities::ascii_trim(content.substr(colon + 1));
+      if (key == "sampling") {
+        const auto words = splitWords(value);
+        if (words.size() == 1 && words[0] == "grid") {
+          spec.m_sampling = Sampling::Grid;
+        } else if (words.size() == 2 && (words[0] == "lhs" || words[0] == "random")) {
+          spec.m_sampling = words[0] == "lhs" ? Sampling::LatinHypercube : Sampling::Random;
+          spec.m_samples = parseCount(words[1], 1, maxVariants);
+          samplesGiven = true;
+        } else {
+          throw std::runtime_error("expected 'grid', 'lhs <n>' or 'random <n>'");
+        }
+      } else if (key == "seed") {
+        spec.m_seed = parseCount(std::string(value), 0, std::numeric_limits<std::uint32_t>::max());
+      } else if (key.empty()) {
+        throw std::runtime_error("missing parameter name");
+      } else {
+        for (const auto& parameter : spec.m_parameters) {
+          if (utilities::ascii_to_lower_copy(parameter.name) == key) {
+            throw std::runtime_error(fmt::format("parameter '{}' is defined twice", parameter.name));
+          }
+        }
+        spec.m_parameters.emplace_back(parseParameter(std::string(utilities::ascii_trim(content.substr(0, colon))), value));
+      }
+    } catch (const std::runtime_error& e) {
+      throw std::runtime_error(fmt::format("Parameter spec, line {}: {}", lineNumber, e.what()));
+    }
+  }
+
+  if (spec.m_parameters.empty()) {
+    throw std::runtime_error("Parameter spec: no parameter to vary");
+  }
+  if (spec.m_sampling == Sampling::Grid) {
+    std::size_t count = 1;
+    for (const auto& parameter : spec.m_parameters) {
+      const std::size_t levels = parameter.values.empty() ? static_cast<std::size_t>(parameter.steps) : parameter.values.size();
+      if (levels == 0) {
+        throw std::runtime_error(fmt::format("Parameter spec: '{}' needs a number of steps for a grid sampling", parameter.name));
+      }
+      if (count > maxVariants / levels) {
+        throw std::runtime_error(fmt::format("Parameter spec: the grid has more than {} combinations", maxVariants));
+      }
+      count *= levels;
+    }
+    spec.m_samples = count;
+  } else if (!samplesGiven) {
+    throw std::runtime_error("Parameter spec: lhs and random need a number of samples");
+  }
+  spec.draw();
+  return spec;
+}
+
+ParameterSpec ParameterSpec::fromFile(const std::filesystem::path& path) {
+  std::ifstream file(path);
+  if (!file) {
+    throw std::runtime_error(fmt::format("Cannot open the parameter spec '{}'", path.string()));
+  }
+  return parse(file);
+}
+
+const std::vector<Parameter>& ParameterSpec::parameters() const {
+  return m_parameters;
+}
+
+std::vector<FieldRef> ParameterSpec::targets() const {
+  std::vector<FieldRef> targets;
+  targets.reserve(m_parameters.size());
+  for (const auto& parameter : m_parameters) {
+    targets.push_back(parameter.target);
+  }
+  return targets;
+}
+
+Sampling ParameterSpec::sampling() const {
+  return m_sampling;
+}
+
+std::size_t ParameterSpec::numVariants() const {
+  return m_samples;
+}
+
+void ParameterSpec::draw() {
+  if (m_sampling == Sampling::Grid) {
+    return;
+  }
+  const std::size_t numParameters = m_parameters.size();
+  m_units.resize(m_samples * numParameters);
+  std::mt19937_64 engine(m_seed);
+  if (m_sampling == Sampling::Random) {
+    for (auto& unit : m_units) {
+      unit = unitDraw(engine);
+    }
+    return;
+  }
+  // Latin hypercube: for each parameter, every one of the n strata of [0, 1) is used by exactly one sample, in a shuffled order
+  std::vector<std::size_t> strata(m_samples);
+  for (std::size_t p = 0; p < numParameters; ++p) {
+    std::iota(strata.begin(), strata.end(), std::size_t{0});
+    for (std::size_t i = m_samples - 1; i > 0; --i) {
+      std::swap(strata[i], strata[engine() % (i + 1)]);
+    }
+    for (std::size_t i = 0; i < m_samples; ++i) {
+      m_units[i * numParameters + p] = (static_cast<double>(strata[i]) + unitDraw(engine)) / static_cast<double>(m_samples);
+    }
+  }
+}
+
+std::string ParameterSpec::valueAt(std::size_t parameter, double unit) const {
+  const auto& param = m_parameters[parameter];
+  if (!param.values.empty()) {
+    const auto index = std::min(param.values.size() - 1, static_cast<std::size_t>(unit * static_cast<double>(param.values.size())));
+    return param.values[index];
+  }
+  return fmt::format("{:.6g}", param.min + unit * (param.max - param.min));
+}
+
+std::vector<std::string> ParameterSpec::variant(std::size_t index) const {
+  if (index >= m_samples) {
+    throw std::runtime_error(fmt::format("Variant {} out of range, the sweep has {}", index, m_samples));
+  }
+  const std::size_t numParameters = m_parameters.size();
+  std::vector<std::string> values(numParameters);
+  if (m_sampling != Sampling::Grid) {
+    for (std::size_t p = 0; p < numParameters; ++p) {
+      values[p] = valueAt(p, m_units[index * numParameters + p]);
+    }
+    return values;
+  }
+  // Mixed radix, the last parameter varying fastest
+  for (std::size_t p = numParameters; p-- > 0;) {
+    const auto& param = m_parameters[p];
+    if (!param.values.empty()) {
+      values[p] = param.values[index % param.values.size()];
+      index /= param.values.size();
+    } else {
+      const auto steps = static_cast<std::size_t>(param.steps);
+      const auto step = index % steps;
+      index /= steps;
+      const double value = steps == 1 ? param.min
+                                      : param.min + (param.max - param.min) * static_cast<double>(step) / static_cast<double>(steps - 1);
+      values[p] = fmt::format("{:.6g}", value);
+    }
+  }
+  return values;
+}
+
+}  // namespace sweep
@@ -0,0 +1,81 @@
+#ifndef SWEEP_PARAMETERSPEC_HPP
+#define SWEEP_PARAMETERSPEC_HPP
+
+#include <cstddef>     // for size_t
+#include <cstdint>     // for uint64_t
+#include <filesystem>  // for path
+#include <istream>     // for istream
+#include <string>      // for string
+#include <vector>      // for vector
+
+namespace sweep {
+
+/// A field of an IDF object: the object is found by its type and name (case insensitive, as EnergyPlus does), `*` matching every object of
+/// that type. field counts from the name: 1 is the name itself, 2 the field after it...
+struct FieldRef
+{
+  std::string objectType;
+  std::string name;
+  int field = 0;
+};
+
+struct Parameter
+{
+  std::string name;
+  FieldRef target;
+  /// Discrete values, substituted as written. Empty for a continuous range
+  std::vector<std::string> values;
+  double min = 0.0;
+  double max = 0.0;
+  /// For a range in a grid sampling: how many evenly spaced values, min and max included
+  int steps = 0;
+};
+
+enum class Sampling
+{
+  Grid,
+  LatinHypercube,
+  Random,
+};
+
+/// What to vary, and how to sample it. Parsed from a text file, one `key: value` per line, `#` starting a comment:
+///
+///     sampling: lhs 500          # grid (the default: every combination), lhs <n> or random <n>
+///     seed: 42
+///     insulation: Material:NoMass, R13LAYER, 3 | range 1.0 5.0 5
+///     orientation: Building, *, 2 | values 0 90 180 270
+///
+/// Any other key is a parameter name, followed by the field it replaces and, after `|`, either `values ...` or `range <min> <max> [<steps>]`.
+/// Steps are required by a grid. lhs and random draw each continuous value in [min, max], and pick discrete values with equal odds
+class ParameterSpec
+{
+ public:
+  /// Throws std::runtime_error, with the line number, on anything it doesn't understand
+  static ParameterSpec parse(std::istream& input);
+  static ParameterSpec fromFile(const std::filesystem::path& path);
+
+  [[nodiscard]] const std::vector<Parameter>& parameters() const;
+  [[nodiscard]] std::vector<FieldRef> targets() const;
+  [[nodiscard]] Sampling sampling() const;
+
+  [[nodiscard]] std::size_t numVariants() const;
+
+  /// The value of each parameter for the variant at index, as substituted in the input. Deterministic for a given seed, and cheap: grids
+  /// are decoded from the index, the lhs and random draws are made once, at parse time
+  [[nodiscard]] std::vector<std::string> variant(std::size_t index) const;
+
+ private:
+  void draw();
+  [[nodiscard]] std::string valueAt(std::size_t parameter, double unit) const;
+
+  std::vector<Parameter> m_parameters;
+  Sampling m_sampling = Sampling::Grid;
+  std::size_t m_samples = 0;
+  std::uint64_t m_seed = 1;
+  /// lhs and random: numVariants() rows of a value in [0, 1) per parameter
+  std::vector<double> m_units;
+};
+
+}  // namespace sweep
+
+#endif  // SWEEP_PARAMETERSPEC_HPP
@@ -0,0 +1,269 @@
+#include "QueueWorker.hpp"
+
+#include "HeadlessRun.hpp"              // for runHeadless
+#include "../Preflight.hpp"             // for preflightFile
+#include "../sqlite/JobTable.hpp"       // for JobTable, Job, JobResult, JobStatus
+#include "../sqlite/RuntimeHistory.hpp"  // for RuntimeHistory, InputFeatures
+#include "ResourceGovernor.hpp"          // for ResourceGovernor
+#include "../utilities/CpuTopology.hpp"  // for cpuPlacementOrder, pinCurrentThread
+#include "../utilities/Eta.hpp"          // for formatDuration
+#include "../utilities/Process.hpp"      // for nodeName
+
+#include <fmt/format.h>  // for format, print
+#include <fmt/std.h>     // for formatting std::filesystem::path // IWYU pragma: keep
+
+#include <algorithm>           // for max, stable_sort
+#include <atomic>              // for atomic
+#include <condition_variable>  // for condition_variable
+#include <exception>           // for exception
+#include <map>                 // for map
+#include <memory>              // for unique_ptr, make_unique
+#include <mutex>               // for mutex, lock_guard, unique_lock
+#include <optional>            // for optional
+#include <stdexcept>           // for runtime_error
+#include <string>              // for string
+#include <system_error>        // for error_code
+#include <thread>              // for thread, sleep_for
+#include <utility>             // for pair, move
+#include <vector>              // for vector
+
+namespace sweep {
+
+namespace {
+  // Renews the lease of a job while it runs, from its own thread and connection. Once the lease is lost, the job belongs to the node that
+  // reclaimed it, and writes to the same output directory: lost() is set for the run to stop
+  class Heartbeat
+  {
+   public:
+    Heartbeat(sql::JobTable& table, const sql::Job& job, std::chrono::seconds interval)
+      : m_thread([this, &table, &job, interval]() { beat(table, job, interval); }) {}
+    Heartbeat(const Heartbeat&) = delete;
+    Heartbeat& operator=(const Heartbeat&) = delete;
+
+    ~Heartbeat() {
+      {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        m_done = true;
+      }
+      m_condition.notify_one();
+      m_thread.join();
+    }
+
+    [[nodiscard]] const std::atomic<bool>* lost() const {
+      return &m_lost;
+    }
+
+   private:
+    void beat(sql::JobTable& table, const sql::Job& job, std::chrono::seconds interval) {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      while (!m_condition.wait_for(lock, interval, [this]() { return m_done; })) {
+        // Unlocked: the renewal can wait for the whole busy timeout of the database, the destructor mustn't wait for it to be notified
+        lock.unlock();
+        bool renewed = true;
+        try {
+          renewed = table.heartbeat(job);
+        } catch (const std::exception& e) {
+          // The lease may still be renewed at the next beat
+          fmt::print("Job {}: {}\n", job.id, e.what());
+        }
+        if (!renewed) {
+          m_lost = true;
+          fmt::print("Job {}: lease lost, stopping the run, another node will run it again\n", job.id);
+          return;
+        }
+        lock.lock();
+      }
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_done = false;
+    std::atomic<bool> m_lost = false;
+    // Last, so that it starts once the rest is constructed
+    std::thread m_thread;
+  };
+
+  // history may be null
+  int workerLoop(const QueueWorkerOptions& options, const std::string& nodeName, ResourceGovernor& governor, sql::RuntimeHistory* history) {
+    sql::JobTable table(options.databasePath, nodeName, options.leaseDuration, options.maxAttempts);
+    sql::JobTable heartbeatTable(options.databasePath, nodeName, options.leaseDuration, options.maxAttempts);
+    const auto idlePoll = std::max(std::chrono::seconds(1), options.leaseDuration / 4);
+    const auto heartbeatInterval = std::max(std::chrono::seconds(1), options.leaseDuration / 3);
+
+    int failed = 0;
+    while (true) {
+      std::optional<sql::Job> job;
+      try {
+        job = table.claim();
+        if (!job) {
+          if (table.remaining() == 0) {
+            return failed;
+          }
+          // Other nodes are running the last jobs: wait for them to finish, or for their leases to expire
+          std::this_thread::sleep_for(idlePoll);
+          continue;
+        }
+      } catch (const std::exception& e) {
+        // The shared volume may be briefly unavailable
+        fmt::print("{}: {}\n", nodeName, e.what());
+        std::this_thread::sleep_for(idlePoll);
+        continue;
+      }
+      std::optional<sql::InputFeatures> features;
+      std::optional<double> predicted;
+      if (history != nullptr) {
+        try {
+          features = sql::InputFeatures::fromFile(job->input, job->arguments);
+          predicted = history->predict(*features);
+        } catch (const std::exception& e) {
+          // The run will tell more
+          fmt::print("{}: job {}: {}\n", nodeName, job->id, e.what());
+        }
+      }
+      fmt::print("{}: job {} (attempt {}{}): {}\n", nodeName, job->id, job->attempt,
+                 predicted ? fmt::format(", predicted {}", utilities::formatDuration(*predicted)) : "", job->input);
+
+      sql::JobResult result;
+      std::string phases;
+      bool leaseLost = false;
+      const auto start = std::chrono::steady_clock::now();
+      {
+        const Heartbeat heartbeat(heartbeatTable, *job, heartbeatInterval);
+        try {
+          std::filesystem::create_directories(job->outputDirectory);
+          // Rejected in milliseconds, before the job waits for memory and takes a slot
+          if (const auto report = epcli::preflightFile(job->input); !report.ok()) {
+            throw std::runtime_error(fmt::format("preflight: {}", report.errorSummary()));
+          }
+          std::error_code ec;
+          const auto inputBytes = std::filesystem::file_size(job->input, ec);
+          const auto admission = governor.admit(ec ? 0 : inputBytes);
+          std::atomic<int> progress = 0;
+          const auto run = runHeadless(job->input, job->outputDirectory, job->arguments, progress, options.termination, heartbeat.lost());
+          result.succeeded = run.succeeded;
+          result.netSiteEnergy = run.netSiteEnergy;
+          result.warnings = static_cast<int>(run.warnings);
+          result.severes = static_cast<int>(run.severes);
+          // A stopped run says nothing of how long the job takes
+          if (run.stoppedBy.empty()) {
+            phases = run.phases;
+          } else {
+            result.error = fmt::format("stopped: {}", run.stoppedBy);
+          }
+        } catch (const std::exception& e) {
+          result.error = e.what();
+        }
+        leaseLost = *heartbeat.lost();
+      }
+      if (leaseLost) {
+        // Stopped partway: neither a result nor a run time for the history
+        fmt::print("{}: job {} stopped, its lease was taken over\n", nodeName, job->id);
+        continue;
+      }
+      // Including the wait for memory: the time the job held its lease
+      result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      // Not when EnergyPlus couldn't even start
+      if (features && !phases.empty()) {
+        try {
+          history->record(*features, job->input, result.seconds, result.succeeded, phases);
+        } catch (const std::exception& e) {
+          fmt::print("{}: job {}: {}\n", nodeName, job->id, e.what());
+        }
+      }
+
+      try {
+        if (!table.complete(*job, result)) {
+          fmt::print("{}: job {} finished after its lease was taken over, its results were discarded\n", nodeName, job->id);
+          continue;
+        }
+      } catch (const std::exception& e) {
+        // Not written: the lease will expire, and the job run again
+        fmt::print("{}: job {}: {}\n", nodeName, job->id, e.what());
+        continue;
+      }
+      if (!result.succeeded) {
+        ++failed;
+      }
+      fmt::print("{}: job {} {} in {:.1f}s\n", nodeName, job->id, result.succeeded ? "done" : "failed", result.seconds);
+    }
+  }
+}  // namespace
+
+int runQueueWorker(const QueueWorkerOptions& options) {
+  const auto node = utilities::nodeName();
+  const auto placement = options.pinThreads ? utilities::cpuPlacementOrder() : std::vector<int>{};
+  std::unique_ptr<sql::RuntimeHistory> history;
+  try {
+    history = std::make_unique<sql::RuntimeHistory>();
+  } catch (const std::exception& e) {
+    fmt::print("{}: {}, the runs won't be recorded\n", node, e.what());
+  }
+  ResourceGovernor governor(options.resources);
+  std::atomic<int> failed = 0;
+  std::vector<std::thread> threads;
+  threads.reserve(options.workers);
+  for (unsigned i = 0; i < options.workers; ++i) {
+    const int cpu = placement.empty() ? -1 : placement[i % placement.size()];
+    threads.emplace_back([&options, &failed, &governor, &history, cpu, nodeName = options.workers > 1 ? fmt::format("{}#{}", node, i) : node]() {
+      if (cpu >= 0) {
+        utilities::pinCurrentThread(cpu);
+      }
+      try {
+        failed += workerLoop(options, nodeName, governor, history.get());
+      } catch (const std::exception& e) {
+        fmt::print("{}: {}\n", nodeName, e.what());
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  fmt::print("{}: {}\n", node, governor.summary());
+  return failed;
+}
+
+std::size_t orderLongestFirst(std::vector<std::filesystem::path>& inputs, const std::vector<std::string>& energyPlusArgs) {
+  const sql::RuntimeHistory history;
+  std::vector<std::pair<std::optional<double>, std::filesystem::path>> predicted;
+  predicted.reserve(inputs.size());
+  std::size_t numPredicted = 0;
+  // Copies: inputs is left as it was if an input can't be read
+  for (const auto& input : inputs) {
+    const auto seconds = history.predict(sql::InputFeatures::fromFile(input, energyPlusArgs));
+    if (seconds) {
+      ++numPredicted;
+    }
+    predicted.emplace_back(seconds, input);
+  }
+  std::stable_sort(predicted.begin(), predicted.end(), [](const auto& a, const auto& b) {
+    if (!a.first || !b.first) {
+      return !a.first && b.first;
+    }
+    return *a.first > *b.first;
+  });
+  for (std::size_t i = 0; i < inputs.size(); ++i) {
+    inputs[i] = std::move(predicted[i].second);
+  }
+  return numPredicted;
+}
+
+void printQueueStatus(const std::filesystem::path& databasePath) {
+  const sql::JobTable table(databasePath, utilities::nodeName());
+  const auto jobs = table.status();
+
+  std::map<std::string, int> counts;
+  fmt::print("{:>6}  {:<7}  {:>8}  {:<24}  {:>9}  {:>14}  {:>8}  {:>7}  {}\n", "Job", "State", "Attempts", "Node", "Time [s]", "Net Site [GJ]",
+             "Warnings", "Severes", "Input");
+  for (const auto& job : jobs) {
+    ++counts[job.state];
+    fmt::print("{:>6}  {:<7}  {:>8}  {:<24}  {:>9.1f}  {:>14}  {:>8}  {:>7}  {}\n", job.id, job.state, job.attempts, job.node, job.seconds,
+               job.netSiteEnergy ? fmt::format("{:.2f}", *job.netSiteEnergy) : "", job.warnings, job.severes, job.input);
+    if (!job.error.empty()) {
+      fmt::print("{:>6}  {}\n", "", job.error);
+    }
+  }
+  fmt::print("\n{} jobs: {} pending, {} running (time since the last heartbeat), {} done, {} failed\n", jobs.size(), counts["pending"],
+             counts["running"], counts["done"], counts["failed"]);
+}
+
+}  // namespace sweep
@@ -0,0 +1,45 @@
+#ifndef SWEEP_QUEUEWORKER_HPP
+#define SWEEP_QUEUEWORKER_HPP
+
+#include "ResourceGovernor.hpp"       // for ResourceLimits
+#include "../TerminationPolicy.hpp"  // for TerminationPolicy
+
+#include <chrono>      // for seconds
+#include <cstddef>     // for size_t
+#include <filesystem>  // for path
+#include <string>      // for string
+#include <vector>      // for vector
+
+namespace sweep {
+
+struct QueueWorkerOptions
+{
+  std::filesystem::path databasePath;
+  /// Simulations at most at once on this node
+  unsigned workers = 1;
+  std::chrono::seconds leaseDuration{60};
+  int maxAttempts = 3;
+  /// Shared by the workers of this node: a claimed job waits for its memory to fit, under the heartbeat of its lease
+  ResourceLimits resources;
+  /// Pins each worker to its own core (see utilities::cpuPlacementOrder)
+  bool pinThreads = false;
+  /// Applied to each job on its own, a job it stops is a failed one
+  epcli::TerminationPolicy termination;
+};
+
+/// epcli --queue <jobs.db> --work: claims and runs the jobs of a sql::JobTable, each worker thread with its own connection and a heartbeat
+/// thread renewing the lease of its current job. Each run is recorded in the runtime history of this node. Returns once no job is left,
+/// including those running on other nodes, as they could still expire and need to be run here. Returns the number of jobs that failed on
+/// this node
+int runQueueWorker(const QueueWorkerOptions& options);
+
+/// epcli --queue <jobs.db> --enqueue: sorts the inputs longest first as predicted by this node's runtime history, as the nodes claim the
+/// jobs in order. Inputs without a prediction go first, in their order. Returns how many have a prediction
+std::size_t orderLongestFirst(std::vector<std::filesystem::path>& inputs, const std::vector<std::string>& energyPlusArgs);
+
+/// epcli --queue <jobs.db> --status: a table of the jobs and their results on stdout
+void printQueueStatus(const std::filesystem::path& databasePath);
+
+}  // namespace sweep
+
+#endif  // SWEEP_QUEUEWORKER_HPP
@@ -0,0 +1,165 @@
+#include "ResourceGovernor.hpp"
+
+#include "../utilities/Process.hpp"  // for residentSetSize, availableMemory, memoryPressure
+
+#include <fmt/format.h>  // for format
+
+#include <algorithm>  // for max
+#include <chrono>     // for milliseconds
+#include <limits>     // for numeric_limits
+
+namespace sweep {
+
+namespace {
+  // Before any simulation finished: high on purpose, a model rarely needs more resident memory than this many times its IDF
+  constexpr double defaultRatio = 400.0;
+  // On top of the highest observed ratio, for the variation between variants
+  constexpr double ratioMargin = 1.25;
+  // Even a tiny input loads the whole of EnergyPlus' data structures
+  constexpr std::size_t minimumEstimate = std::size_t{64} << 20U;
+  constexpr auto sampleInterval = std::chrono::milliseconds(250);
+
+  double toGiB(std::size_t bytes) {
+    return static_cast<double>(bytes) / static_cast<double>(std::size_t{1} << 30U);
+  }
+
+  std::size_t estimateWith(double ratio, std::uintmax_t inputBytes) {
+    return std::max(minimumEstimate, static_cast<std::size_t>(ratio * static_cast<double>(inputBytes)));
+  }
+}  // namespace
+
+ResourceGovernor::Admission::Admission(ResourceGovernor* governor, std::uintmax_t inputBytes, std::size_t estimate)
+  : m_governor(governor), m_inputBytes(inputBytes), m_estimate(estimate) {}
+
+ResourceGovernor::Admission::Admission(Admission&& other) noexcept
+  : m_governor(other.m_governor), m_inputBytes(other.m_inputBytes), m_estimate(other.m_estimate) {
+  other.m_governor = nullptr;
+}
+
+ResourceGovernor::Admission::~Admission() {
+  if (m_governor != nullptr) {
+    m_governor->release(m_inputBytes, m_estimate);
+  }
+}
+
+std::size_t ResourceGovernor::Admission::estimate() const {
+  return m_estimate;
+}
+
+ResourceGovernor::ResourceGovernor(ResourceLimits limits)
+  : m_limits(limits), m_baselineRss(utilities::residentSetSize()), m_lastRss(m_baselineRss), m_peakRss(m_baselineRss),
+    m_ratio(limits.initialRatio > 0.0 ? limits.initialRatio : defaultRatio) {
+  if (m_limits.memoryBudget == 0) {
+    const std::size_t available = utilities::availableMemory();
+    m_limits.memoryBudget = available > 0 ? available / 10 * 9 : std::numeric_limits<std::size_t>::max();
+  }
+  m_monitor = std::thread([this]() { monitor(); });
+}
+
+ResourceGovernor::~ResourceGovernor() {
+  {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopping = true;
+  }
+  m_changed.notify_all();
+  m_monitor.join();
+}
+
+ResourceGovernor::Admission ResourceGovernor::admit(std::uintmax_t inputBytes) {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  bool waited = false;
+  std::size_t estimate = estimateWith(m_ratio, inputBytes);
+  while (!fits(estimate)) {
+    if (!waited) {
+      waited = true;
+      ++m_delayed;
+      if (m_underPressure) {
+        ++m_pressureBackoffs;
+      }
+    }
+    m_changed.wait(lock);
+    // The ratio may have been learned meanwhile
+    estimate = estimateWith(m_ratio, inputBytes);
+  }
+  ++m_running;
+  m_committed += estimate;
+  m_runningInputBytes += inputBytes;
+  return {this, inputBytes, estimate};
+}
+
+std::size_t ResourceGovernor::estimate(std::uintmax_t inputBytes) const {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  return estimateWith(m_ratio, inputBytes);
+}
+
+std::optional<double> ResourceGovernor::learnedRatio() const {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  return m_learned ? std::optional<double>(m_ratio) : std::nullopt;
+}
+
+std::size_t ResourceGovernor::budget() const {
+  return m_limits.memoryBudget;
+}
+
+bool ResourceGovernor::fits(std::size_t estimate) const {
+  if (m_running == 0) {
+    return true;
+  }
+  if (m_underPressure) {
+    return false;
+  }
+  // Whichever is larger: what the running simulations were expected to use, or what they actually use
+  const std::size_t used = std::max(m_committed, m_lastRss > m_baselineRss ? m_lastRss - m_baselineRss : 0);
+  return used <= m_limits.memoryBudget && estimate <= m_limits.memoryBudget - used;
+}
+
+void ResourceGovernor::release(std::uintmax_t inputBytes, std::size_t estimate) {
+  {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    --m_running;
+    m_committed -= estimate;
+    m_runningInputBytes -= inputBytes;
+    // A finished simulation went through all its phases: what was observed until now is representative
+    if (m_observedRatio > 0.0) {
+      m_ratio = m_learned ? std::max(m_ratio, m_observedRatio * ratioMargin) : m_observedRatio * ratioMargin;
+      m_learned = true;
+    }
+  }
+  m_changed.notify_all();
+}
+
+void ResourceGovernor::monitor() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (!m_stopping) {
+    lock.unlock();
+    const std::size_t rss = utilities::residentSetSize();
+    const double pressure = utilities::memoryPressure();
+    const std::size_t available = pressure < 0.0 ? utilities::availableMemory() : 0;
+    lock.lock();
+
+    m_lastRss = rss;
+    m_peakRss = std::max(m_peakRss, rss);
+    if (m_runningInputBytes > 0 && rss > m_baselineRss) {
+      m_observedRatio = std::max(m_observedRatio, static_cast<double>(rss - m_baselineRss) / static_cast<double>(m_runningInputBytes));
+      if (m_learned) {
+        m_ratio = std::max(m_ratio, m_observedRatio * ratioMargin);
+      }
+    }
+    // Without pressure stall information, running low on available memory is the next best signal
+    m_underPressure = pressure >= 0.0 ? pressure >= m_limits.pressureThreshold : (available > 0 && available < m_limits.memoryBudget / 20);
+    m_changed.notify_all();
+
+    m_changed.wait_for(lock, sampleInterval, [this]() { return m_stopping; });
+  }
+}
+
+std::string ResourceGovernor::summary() const {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  const bool unlimited = m_limits.memoryBudget == std::numeric_limits<std::size_t>::max();
+  return fmt::format("Memory budget {}, peak resident set size {:.2f} GiB, {:.0f} resident bytes per input byte ({}), {} simulations waited "
+                     "for memory ({} for memory pressure)",
+                     unlimited ? "unlimited" : fmt::format("{:.2f} GiB", toGiB(m_limits.memoryBudget)), toGiB(m_peakRss), m_ratio,
+                     m_learned ? "observed" : "initial estimate", m_delayed, m_pressureBackoffs);
+}
+
+}  // namespace sweep
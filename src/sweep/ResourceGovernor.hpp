@@ -0,0 +1,100 @@
+#ifndef SWEEP_RESOURCEGOVERNOR_HPP
+#define SWEEP_RESOURCEGOVERNOR_HPP
+
+#include <condition_variable>  // for condition_variable
+#include <cstddef>             // for size_t
+#include <cstdint>             // for uintmax_t
+#include <mutex>               // for mutex
+#include <optional>            // for optional
+#include <string>              // for string
+#include <thread>              // for thread
+
+namespace sweep {
+
+struct ResourceLimits
+{
+  /// Bytes the simulations may use together, 0 for 90% of the memory available when the governor starts
+  std::size_t memoryBudget = 0;
+  /// Pressure stall percentage (see utilities::memoryPressure) above which no new simulation starts
+  double pressureThreshold = 10.0;
+  /// Resident bytes per input byte assumed until a simulation finished (eg: learned by a previous batch), 0 for a deliberately high default
+  double initialRatio = 0.0;
+};
+
+/// Memory admission control for the simulations of a batch, which all run in this process: a simulation starts only once its projected
+/// memory fits the budget next to those already running, and not while the system reports memory pressure. That keeps N workers on N
+/// cores from pushing large models into swap or the OOM killer.
+///
+/// A simulation's memory is estimated from the size of its input, at first with a deliberately high ratio. A monitor thread samples the
+/// resident set size while simulations run, and once one has finished, the ratio is replaced with the highest observed one (plus a margin).
+/// One simulation is always admitted when none runs, however large its estimate
+class ResourceGovernor
+{
+ public:
+  /// Releases its share of the budget when destroyed
+  class Admission
+  {
+   public:
+    Admission(ResourceGovernor* governor, std::uintmax_t inputBytes, std::size_t estimate);
+    Admission(Admission&& other) noexcept;
+    Admission& operator=(Admission&&) = delete;
+    Admission(const Admission&) = delete;
+    Admission& operator=(const Admission&) = delete;
+    ~Admission();
+
+    [[nodiscard]] std::size_t estimate() const;
+
+   private:
+    ResourceGovernor* m_governor;
+    std::uintmax_t m_inputBytes;
+    std::size_t m_estimate;
+  };
+
+  explicit ResourceGovernor(ResourceLimits limits);
+  ResourceGovernor(const ResourceGovernor&) = delete;
+  ResourceGovernor& operator=(const ResourceGovernor&) = delete;
+  ~ResourceGovernor();
+
+  /// Blocks until a simulation of an input of that size fits
+  Admission admit(std::uintmax_t inputBytes);
+
+  [[nodiscard]] std::size_t estimate(std::uintmax_t inputBytes) const;
+  [[nodiscard]] std::size_t budget() const;
+
+  /// Resident bytes per input byte observed (plus a margin), once a simulation finished: worth keeping for the next batch
+  [[nodiscard]] std::optional<double> learnedRatio() const;
+
+  /// The budget, the peak resident set size, the learned ratio and how often admissions waited
+  [[nodiscard]] std::string summary() const;
+
+ private:
+  void release(std::uintmax_t inputBytes, std::size_t estimate);
+  void monitor();
+  [[nodiscard]] bool fits(std::size_t estimate) const;
+
+  ResourceLimits m_limits;
+  /// The process before any simulation: the budget is on top of it
+  std::size_t m_baselineRss = 0;
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_changed;
+  std::size_t m_running = 0;
+  std::size_t m_committed = 0;
+  std::uintmax_t m_runningInputBytes = 0;
+  std::size_t m_lastRss = 0;
+  std::size_t m_peakRss = 0;
+  bool m_underPressure = false;
+  /// Resident bytes per input byte: the estimate until a simulation finished, then the highest observed times a margin
+  double m_ratio;
+  double m_observedRatio = 0.0;
+  bool m_learned = false;
+  std::size_t m_delayed = 0;
+  std::size_t m_pressureBackoffs = 0;
+  bool m_stopping = false;
+
+  std::thread m_monitor;
+};
+
+}  // namespace sweep
+
+#endif  // SWEEP_RESOURCEGOVERNOR_HPP
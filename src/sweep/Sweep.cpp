@@ -0,0 +1,418 @@
+#include "Sweep.hpp"
+
+#include "HeadlessRun.hpp"                     // for runHeadless
+#include "SweepJournal.hpp"                    // for SweepJournal, JournalHeader, JournalEntry
+#include "../Preflight.hpp"                    // for preflight
+#include "../utilities/ASCIIStrings.hpp"      // for ascii_to_lower_copy
+#include "../utilities/CpuTopology.hpp"       // for physicalCoreCount
+#include "../utilities/Eta.hpp"               // for remainingSeconds, makespan, formatDuration
+#include "../utilities/Hash.hpp"              // for fnv1a64
+#include "../utilities/WorkStealingPool.hpp"  // for WorkStealingPool
+
+#include <fmt/format.h>  // for format, print
+#include <fmt/std.h>     // for formatting std::filesystem::path // IWYU pragma: keep
+
+#include <algorithm>  // for max, stable_sort
+#include <exception>  // for exception
+#include <chrono>     // for steady_clock, duration, seconds
+#include <fstream>    // for ofstream
+#include <stdexcept>  // for runtime_error
+#include <utility>    // for move
+
+namespace sweep {
+
+namespace {
+  const std::filesystem::path& idfInput(const std::filesystem::path& path) {
+    const auto extension = utilities::ascii_to_lower_copy(path.extension().string());
+    if (extension != ".idf" && extension != ".imf") {
+      throw std::runtime_error(fmt::format("'{}': sweeps substitute IDF fields, the base input must be an .idf", path));
+    }
+    return path;
+  }
+
+  // Their ##include and ##def lines are only expanded by EPMacro at the start of the run, so they aren't preflighted, as in preflightFile
+  bool isMacroInput(const std::filesystem::path& path) {
+    return utilities::ascii_to_lower_copy(path.extension().string()) == ".imf";
+  }
+
+  std::string csvField(const std::string& value) {
+    if (value.find_first_of(",\"\n") == std::string::npos) {
+      return value;
+    }
+    std::string quoted = "\"";
+    for (const char c : value) {
+      if (c == '"') {
+        quoted += '"';
+      }
+      quoted += c;
+    }
+    quoted += '"';
+    return quoted;
+  }
+
+  std::string status(const VariantResult& result) {
+    if (!result.finished) {
+      return "not run";
+    }
+    if (!result.error.empty()) {
+      return result.error;
+    }
+    return result.succeeded ? "ok" : "failed";
+  }
+
+  // Where the ResourceGovernor's ratio is kept from a sweep to the next
+  constexpr auto memoryRatioName = "residentBytesPerInputByte";
+
+  // m_startedAt of the variants not started yet, and of those done
+  constexpr double notStarted = -1.0;
+  constexpr double done = -2.0;
+
+  std::string energy(const VariantResult& result) {
+    return result.netSiteEnergy ? fmt::format("{:.2f}", *result.netSiteEnergy) : "n/a";
+  }
+}  // namespace
+
+Sweep::Sweep(SweepOptions options)
+  : m_options(std::move(options)),
+    m_spec(ParameterSpec::fromFile(m_options.specPath)),
+    m_template(IdfTemplate::fromFile(idfInput(m_options.baseInput), m_spec.targets())) {}
+
+Sweep::~Sweep() = default;
+
+const ParameterSpec& Sweep::spec() const {
+  return m_spec;
+}
+
+const std::vector<VariantResult>& Sweep::run() {
+  const std::size_t numVariants = m_spec.numVariants();
+  m_results.assign(numVariants, VariantResult{});
+  m_progress = std::make_unique<std::atomic<int>[]>(numVariants);    // NOLINT(modernize-avoid-c-arrays)
+  m_startedAt = std::make_unique<std::atomic<double>[]>(numVariants);  // NOLINT(modernize-avoid-c-arrays)
+  for (std::size_t i = 0; i < numVariants; ++i) {
+    m_startedAt[i] = notStarted;
+  }
+  m_waiting = 0;
+  m_running = 0;
+  m_finished = 0;
+  m_failed = 0;
+  std::filesystem::create_directories(m_options.outputDirectory);
+
+  // Before anything runs: every variant would fail on the errors of the base
+  if (!isMacroInput(m_options.baseInput)) {
+    const auto report = epcli::preflight(m_template.text(), false);
+    for (const auto& warning : report.warnings) {
+      fmt::print("{}: {}\n", m_options.baseInput, warning.describe());
+    }
+    if (!report.ok()) {
+      throw std::runtime_error(fmt::format("{}: {}", m_options.baseInput, report.errorSummary()));
+    }
+  }
+
+  const auto header = JournalHeader::describe(m_options, m_template.text(), numVariants);
+  if (m_options.resume) {
+    restoreFinished(header);
+  }
+  m_journal = std::make_unique<SweepJournal>(SweepJournal::pathFor(m_options.outputDirectory), header, m_options.resume);
+
+  try {
+    m_history = std::make_unique<sql::RuntimeHistory>();
+  } catch (const std::exception& e) {
+    fmt::print("{}, the variants will run in order\n", e.what());
+  }
+  predictRunTimes();
+
+  auto resources = m_options.resources;
+  if (m_history != nullptr && resources.initialRatio <= 0.0) {
+    resources.initialRatio = m_history->learned(memoryRatioName).value_or(0.0);
+  }
+  m_governor = std::make_unique<ResourceGovernor>(resources);
+  m_start = std::chrono::steady_clock::now();
+  {
+    utilities::WorkStealingPool pool(m_options.jobs == 0 ? utilities::physicalCoreCount() : m_options.jobs, m_options.pinThreads);
+    m_numWorkers = pool.size();
+    fmt::print("Sweeping {} variants of {} ({} fields substituted), up to {} at a time{}, in {}\n", numVariants, m_options.baseInput,
+               m_template.numSubstitutions(), pool.size(), m_options.pinThreads ? " on pinned cores" : "", m_options.outputDirectory);
+    if (const auto eta = remainingSeconds()) {
+      fmt::print("Longest first, as predicted by {} past runs: done in about {}\n", m_history->numRuns(), utilities::formatDuration(*eta));
+    }
+    // In reverse: each worker takes the most recent task of its queue first, so the variants start roughly in order
+    for (auto it = m_order.crbegin(); it != m_order.crend(); ++it) {
+      pool.submit([this, i = *it]() { runVariant(i); });
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_variantFinished.wait_for(lock, std::chrono::seconds(30), [this, numVariants]() { return m_finished == numVariants; })) {
+      printStatus();
+    }
+    lock.unlock();
+    pool.wait();
+  }
+
+  fmt::print("Sweep done in {:.1f}s, {} of {} variants failed\n", std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count(),
+             m_failed.load(), numVariants);
+  fmt::print("{}\n", m_governor->summary());
+  if (const auto ratio = m_governor->learnedRatio(); ratio && m_history != nullptr) {
+    try {
+      m_history->setLearned(memoryRatioName, *ratio);
+    } catch (const std::exception& e) {
+      fmt::print("{}\n", e.what());
+    }
+  }
+  m_governor.reset();
+  m_history.reset();
+  m_journal.reset();
+  return m_results;
+}
+
+void Sweep::restoreFinished(const JournalHeader& header) {
+  const auto journalPath = SweepJournal::pathFor(m_options.outputDirectory);
+  SweepJournal::readHeader(journalPath).checkSameSweep(header);
+  for (auto& entry : SweepJournal::readFinished(journalPath)) {
+    const std::size_t index = entry.result.index;
+    if (index >= m_results.size()) {
+      continue;
+    }
+    if (!entry.outputsIntact()) {
+      fmt::print("run-{:05}: its outputs are missing or changed since it finished, it will run again\n", index);
+      continue;
+    }
+    entry.result.values = m_spec.variant(index);
+    m_results[index] = std::move(entry.result);
+    m_progress[index] = m_results[index].succeeded ? 100 : -1;
+    m_startedAt[index] = done;
+    ++m_finished;
+    if (!m_results[index].succeeded) {
+      ++m_failed;
+    }
+  }
+  fmt::print("Resuming {}: {} of {} variants already finished\n", journalPath, m_finished.load(), m_results.size());
+}
+
+void Sweep::predictRunTimes() {
+  m_order.clear();
+  for (std::size_t i = 0; i < m_results.size(); ++i) {
+    if (!m_results[i].finished) {
+      m_order.push_back(i);
+    }
+  }
+  if (m_history == nullptr) {
+    return;
+  }
+  m_baseFeatures = sql::InputFeatures::fromText(m_template.text(), false, m_options.energyPlusArgs);
+  for (const std::size_t i : m_order) {
+    m_results[i].predictedSeconds = m_history->predict(variantFeatures(m_spec.variant(i)));
+  }
+  // Longest first. Unknown ones could be the longest: they go first too
+  std::stable_sort(m_order.begin(), m_order.end(), [this](std::size_t a, std::size_t b) {
+    const auto& predictedA = m_results[a].predictedSeconds;
+    const auto& predictedB = m_results[b].predictedSeconds;
+    if (!predictedA || !predictedB) {
+      return !predictedA && predictedB;
+    }
+    return *predictedA > *predictedB;
+  });
+}
+
+sql::InputFeatures Sweep::variantFeatures(const std::vector<std::string>& values) const {
+  // Substituting fields doesn't change what is counted, and hashing the values is as good as hashing the whole instantiated text
+  auto features = m_baseFeatures;
+  for (const auto& value : values) {
+    features.key = utilities::fnv1a64(value, utilities::fnv1a64("\n", features.key));
+  }
+  return features;
+}
+
+void Sweep::runVariant(std::size_t index) {
+  auto& result = m_results[index];
+  result.index = index;
+  result.directory = m_options.outputDirectory / fmt::format("run-{:05}", index);
+  auto& progress = m_progress[index];
+  std::chrono::steady_clock::time_point start;
+  bool admitted = false;
+  std::string phases;
+
+  try {
+    result.values = m_spec.variant(index);
+    std::filesystem::create_directories(result.directory);
+    // The EnergyPlus API only reads its input from a file
+    const auto inputPath = result.directory / "in.idf";
+    const auto input = m_template.instantiate(result.values);
+    {
+      std::ofstream file(inputPath, std::ios::binary | std::ios::trunc);
+      file << input;
+      if (!file) {
+        throw std::runtime_error(fmt::format("cannot write {}", inputPath));
+      }
+    }
+    // A value can break the syntax (a `,` in it) or repeat a name: rejected before it waits for memory and takes a worker
+    if (!isMacroInput(m_options.baseInput)) {
+      if (const auto report = epcli::preflight(input, false); !report.ok()) {
+        throw std::runtime_error(fmt::format("preflight: {}", report.errorSummary()));
+      }
+    }
+
+    ++m_waiting;
+    const auto admission = m_governor->admit(input.size());
+    --m_waiting;
+    ++m_running;
+    admitted = true;
+    start = std::chrono::steady_clock::now();
+    m_startedAt[index] = std::chrono::duration<double>(start - m_start).count();
+    try {
+      m_journal->started(index);
+    } catch (const std::exception& e) {
+      // Only the journal is lost: a resume would run the variant again
+      fmt::print("{}\n", e.what());
+    }
+    const auto run = runHeadless(inputPath, result.directory, m_options.energyPlusArgs, progress, m_options.termination);
+    // A stopped run says nothing of how long the variant takes
+    if (run.stoppedBy.empty()) {
+      phases = run.phases;
+    }
+    result.succeeded = run.succeeded;
+    result.netSiteEnergy = run.netSiteEnergy;
+    result.warnings = run.warnings;
+    result.severes = run.severes;
+    if (!run.stoppedBy.empty()) {
+      result.error = fmt::format("stopped: {}", run.stoppedBy);
+    }
+  } catch (const std::exception& e) {
+    result.error = e.what();
+    result.succeeded = false;
+  }
+  if (admitted) {
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    --m_running;
+  }
+  result.finished = true;
+  m_startedAt[index] = done;
+  try {
+    m_journal->finished(result);
+  } catch (const std::exception& e) {
+    fmt::print("{}\n", e.what());
+  }
+
+  if (m_history != nullptr && admitted && !phases.empty()) {
+    try {
+      m_history->record(variantFeatures(result.values), result.directory / "in.idf", result.seconds, result.succeeded, phases);
+    } catch (const std::exception& e) {
+      fmt::print("{}\n", e.what());
+    }
+  }
+
+  {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    if (!result.succeeded) {
+      ++m_failed;
+    }
+    ++m_finished;
+    fmt::print("[{}/{}] {} {} in {:.1f}s{}: {} GJ, {} warnings, {} severes\n", m_finished.load(), m_results.size(), result.directory.filename(),
+               status(result), result.seconds, result.predictedSeconds ? fmt::format(" (predicted {:.1f}s)", *result.predictedSeconds) : "",
+               energy(result), result.warnings, result.severes);
+  }
+  m_variantFinished.notify_one();
+}
+
+std::optional<double> Sweep::remainingSeconds() const {
+  // Variants without a prediction are assumed to take as long as the average of the others
+  double knownSum = 0.0;
+  std::size_t numKnown = 0;
+  for (const auto& result : m_results) {
+    if (result.predictedSeconds) {
+      knownSum += *result.predictedSeconds;
+      ++numKnown;
+    }
+  }
+  if (numKnown == 0) {
+    return std::nullopt;
+  }
+  const double fallback = knownSum / static_cast<double>(numKnown);
+
+  const double now = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+  std::vector<double> running;
+  std::vector<double> pending;
+  for (const std::size_t i : m_order) {
+    const double startedAt = m_startedAt[i].load();
+    const double predicted = m_results[i].predictedSeconds.value_or(fallback);
+    if (startedAt == notStarted) {
+      pending.push_back(predicted);
+    } else if (startedAt >= 0.0) {
+      running.push_back(utilities::remainingSeconds(predicted, now - startedAt, std::max(m_progress[i].load(), 0) / 100.0).value_or(0.0));
+    }
+  }
+  return utilities::makespan(running, pending, m_numWorkers);
+}
+
+void Sweep::printStatus() const {
+  // A failed run (-1) is as done as a successful one
+  long long progressSum = 0;
+  for (std::size_t i = 0; i < m_results.size(); ++i) {
+    const int progress = m_progress[i].load();
+    progressSum += progress < 0 ? 100 : progress;
+  }
+  const auto eta = remainingSeconds();
+  fmt::print("[{}/{}] {} running, {} waiting for memory, {:.1f}% of the sweep simulated{}\n", m_finished.load(), m_results.size(),
+             m_running.load(), m_waiting.load(), static_cast<double>(progressSum) / static_cast<double>(m_results.size()),
+             eta ? fmt::format(", about {} left", utilities::formatDuration(*eta)) : "");
+}
+
+void Sweep::printSummary() const {
+  const auto& parameters = m_spec.parameters();
+  std::vector<std::size_t> widths;
+  widths.reserve(parameters.size());
+  for (std::size_t p = 0; p < parameters.size(); ++p) {
+    std::size_t width = parameters[p].name.size();
+    for (const auto& result : m_results) {
+      if (p < result.values.size()) {
+        width = std::max(width, result.values[p].size());
+      }
+    }
+    widths.push_back(width);
+  }
+
+  std::string header = fmt::format("{:<9}", "Run");
+  for (std::size_t p = 0; p < parameters.size(); ++p) {
+    header += fmt::format("  {:>{}}", parameters[p].name, widths[p]);
+  }
+  header += fmt::format("  {:>14}  {:>8}  {:>7}  {:>8}  {}", "Net Site [GJ]", "Warnings", "Severes", "Time [s]", "Status");
+  fmt::print("\n{}\n{}\n", header, std::string(header.size(), '-'));
+
+  const VariantResult* lowest = nullptr;
+  for (const auto& result : m_results) {
+    std::string row = fmt::format("run-{:05}", result.index);
+    for (std::size_t p = 0; p < parameters.size(); ++p) {
+      row += fmt::format("  {:>{}}", p < result.values.size() ? result.values[p] : "", widths[p]);
+    }
+    row += fmt::format("  {:>14}  {:>8}  {:>7}  {:>8.1f}  {}", energy(result), result.warnings, result.severes, result.seconds, status(result));
+    fmt::print("{}\n", row);
+    if (result.netSiteEnergy && (lowest == nullptr || *result.netSiteEnergy < *lowest->netSiteEnergy)) {
+      lowest = &result;
+    }
+  }
+  if (lowest != nullptr) {
+    fmt::print("\nLowest Net Site Energy: run-{:05}, {:.2f} GJ\n", lowest->index, *lowest->netSiteEnergy);
+  }
+}
+
+void Sweep::writeCsv(const std::filesystem::path& path) const {
+  std::ofstream file(path, std::ios::trunc);
+  if (!file) {
+    throw std::runtime_error(fmt::format("Cannot write '{}'", path));
+  }
+  file << "run";
+  for (const auto& parameter : m_spec.parameters()) {
+    file << ',' << csvField(parameter.name);
+  }
+  file << ",net_site_energy_gj,warnings,severes,seconds,predicted_seconds,status\n";
+  for (const auto& result : m_results) {
+    file << fmt::format("run-{:05}", result.index);
+    for (const auto& value : result.values) {
+      file << ',' << csvField(value);
+    }
+    file << ',' << (result.netSiteEnergy ? fmt::format("{}", *result.netSiteEnergy) : "") << ',' << result.warnings << ',' << result.severes
+         << ',' << fmt::format("{:.3f}", result.seconds) << ',' << (result.predictedSeconds ? fmt::format("{:.3f}", *result.predictedSeconds) : "")
+         << ',' << csvField(status(result)) << '\n';
+  }
+}
+
+}  // namespace sweep
@@ -0,0 +1,124 @@
+#ifndef SWEEP_SWEEP_HPP
+#define SWEEP_SWEEP_HPP
+
+#include "IdfTemplate.hpp"                // for IdfTemplate
+#include "ParameterSpec.hpp"              // for ParameterSpec
+#include "ResourceGovernor.hpp"           // for ResourceGovernor, ResourceLimits
+#include "../TerminationPolicy.hpp"      // for TerminationPolicy
+#include "../sqlite/RuntimeHistory.hpp"  // for RuntimeHistory, InputFeatures
+
+#include <atomic>              // for atomic
+#include <chrono>              // for steady_clock
+#include <condition_variable>  // for condition_variable
+#include <cstddef>             // for size_t
+#include <filesystem>          // for path
+#include <memory>              // for unique_ptr
+#include <mutex>               // for mutex
+#include <optional>            // for optional
+#include <string>              // for string
+#include <vector>              // for vector
+
+namespace sweep {
+
+class SweepJournal;
+struct JournalHeader;
+
+struct SweepOptions
+{
+  std::filesystem::path baseInput;
+  std::filesystem::path specPath;
+  /// Each variant runs in <outputDirectory>/run-NNNNN, with its in.idf
+  std::filesystem::path outputDirectory{"sweep"};
+  /// Passed to every run, before -d and the input (eg: -w weather.epw)
+  std::vector<std::string> energyPlusArgs;
+  /// Simulations at most at once, 0 for one per physical core
+  unsigned jobs = 0;
+  /// Fewer may run at once when their memory wouldn't fit
+  ResourceLimits resources;
+  /// Pins each worker to its own core (see utilities::cpuPlacementOrder)
+  bool pinThreads = false;
+  /// Applied to each variant on its own, a variant it stops is a failed one
+  epcli::TerminationPolicy termination;
+  /// Runs only the variants <outputDirectory>/sweep.journal doesn't have as finished with their outputs intact, instead of starting over
+  bool resume = false;
+};
+
+struct VariantResult
+{
+  std::size_t index = 0;
+  std::vector<std::string> values;
+  std::filesystem::path directory;
+  bool finished = false;
+  bool succeeded = false;
+  /// From the run's eplusout.sql: missing if the input has no Output:SQLite with tabular reports
+  std::optional<double> netSiteEnergy;
+  std::size_t warnings = 0;
+  std::size_t severes = 0;
+  double seconds = 0.0;
+  /// From the runtime history, before the sweep started
+  std::optional<double> predictedSeconds;
+  /// Why the variant couldn't run, if it couldn't
+  std::string error;
+};
+
+/// epcli --sweep: runs every variant of a base IDF described by a ParameterSpec, as concurrent runEnergyPlus calls on a WorkStealingPool,
+/// and collects the Net Site Energy of each. A variant's input is generated by the worker that runs it, right before the simulation, which
+/// then waits for the ResourceGovernor to admit it. The variants start longest first, as predicted by the runtime history, which records
+/// each of them in turn. Every variant's start and results are logged in a SweepJournal, from which an interrupted sweep resumes
+class Sweep
+{
+ public:
+  /// Throws std::runtime_error if the spec can't be parsed, or doesn't match the base input
+  explicit Sweep(SweepOptions options);
+  Sweep(const Sweep&) = delete;
+  Sweep& operator=(const Sweep&) = delete;
+  ~Sweep();
+
+  [[nodiscard]] const ParameterSpec& spec() const;
+
+  /// Blocks until every variant has run, printing the progress on stdout
+  const std::vector<VariantResult>& run();
+
+  /// The results as a table on stdout
+  void printSummary() const;
+  /// The results as CSV, one row per variant
+  void writeCsv(const std::filesystem::path& path) const;
+
+ private:
+  /// The variants the journal has as finished, when resuming. Throws std::runtime_error if the sweep changed since the journal was written
+  void restoreFinished(const JournalHeader& header);
+  void predictRunTimes();
+  [[nodiscard]] sql::InputFeatures variantFeatures(const std::vector<std::string>& values) const;
+  void runVariant(std::size_t index);
+  /// Seconds until the sweep is done, if there is anything to predict it from
+  [[nodiscard]] std::optional<double> remainingSeconds() const;
+  void printStatus() const;
+
+  SweepOptions m_options;
+  ParameterSpec m_spec;
+  IdfTemplate m_template;
+  std::vector<VariantResult> m_results;
+  /// The progress of each variant's run, as runEnergyPlus reports it
+  std::unique_ptr<std::atomic<int>[]> m_progress;  // NOLINT(modernize-avoid-c-arrays)
+  std::unique_ptr<ResourceGovernor> m_governor;
+  std::unique_ptr<SweepJournal> m_journal;
+  /// Null if the history can't be opened, the sweep runs all the same
+  std::unique_ptr<sql::RuntimeHistory> m_history;
+  sql::InputFeatures m_baseFeatures;
+  /// The variants in the order they are submitted
+  std::vector<std::size_t> m_order;
+  unsigned m_numWorkers = 0;
+  std::chrono::steady_clock::time_point m_start;
+  /// Seconds after m_start each variant started, or notStarted / done
+  std::unique_ptr<std::atomic<double>[]> m_startedAt;  // NOLINT(modernize-avoid-c-arrays)
+  std::atomic<std::size_t> m_waiting = 0;
+  std::atomic<std::size_t> m_running = 0;
+  std::atomic<std::size_t> m_finished = 0;
+  std::atomic<std::size_t> m_failed = 0;
+  std::mutex m_mutex;
+  std::condition_variable m_variantFinished;
+};
+
+}  // namespace sweep
+
+#endif  // SWEEP_SWEEP_HPP
@@ -0,0 +1,270 @@
+#include "SweepJournal.hpp"
+
+#include "../utilities/Hash.hpp"  // for fnv1a64, toHex
+
+#include <fmt/format.h>  // for format
+#include <fmt/std.h>     // for formatting std::filesystem::path // IWYU pragma: keep
+
+#include <chrono>        // for system_clock, duration
+#include <exception>     // for exception
+#include <fstream>       // for ifstream
+#include <iterator>      // for istreambuf_iterator
+#include <map>           // for map
+#include <stdexcept>     // for runtime_error
+#include <system_error>  // for error_code
+#include <utility>       // for move
+
+namespace sweep {
+
+namespace {
+  constexpr auto journalVersion = "1";
+
+  std::string escape(std::string_view field) {
+    std::string escaped;
+    escaped.reserve(field.size());
+    for (const char c : field) {
+      switch (c) {
+        case '\\':
+          escaped += "\\\\";
+          break;
+        case '\t':
+          escaped += "\\t";
+          break;
+        case '\n':
+          escaped += "\\n";
+          break;
+        case '\r':
+          escaped += "\\r";
+          break;
+        default:
+          escaped += c;
+      }
+    }
+    return escaped;
+  }
+
+  std::string unescape(std::string_view field) {
+    std::string unescaped;
+    unescaped.reserve(field.size());
+    for (std::size_t i = 0; i < field.size(); ++i) {
+      if (field[i] != '\\' || i + 1 == field.size()) {
+        unescaped += field[i];
+        continue;
+      }
+      const char c = field[++i];
+      unescaped += c == 't' ? '\t' : c == 'n' ? '\n' : c == 'r' ? '\r' : c;
+    }
+    return unescaped;
+  }
+
+  std::string fileHash(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+      throw std::runtime_error(fmt::format("Cannot read '{}'", path));
+    }
+    const std::string text{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    return utilities::toHex(utilities::fnv1a64(text));
+  }
+
+  // Each valid record, in order: lines whose checksum doesn't match (a torn write) are skipped
+  std::vector<std::vector<std::string>> readRecords(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+      throw std::runtime_error(fmt::format("Cannot read the journal '{}'", path));
+    }
+    std::vector<std::vector<std::string>> records;
+    std::string line;
+    while (std::getline(file, line)) {
+      const auto checksumStart = line.rfind('\t');
+      if (checksumStart == std::string::npos) {
+        continue;
+      }
+      const std::string_view payload(line.data(), checksumStart);
+      if (line.compare(checksumStart + 1, std::string::npos, utilities::toHex(utilities::fnv1a64(payload))) != 0) {
+        continue;
+      }
+      std::vector<std::string> fields;
+      std::size_t pos = 0;
+      while (true) {
+        const auto tab = payload.find('\t', pos);
+        fields.push_back(unescape(payload.substr(pos, tab == std::string_view::npos ? std::string_view::npos : tab - pos)));
+        if (tab == std::string_view::npos) {
+          break;
+        }
+        pos = tab + 1;
+      }
+      records.push_back(std::move(fields));
+    }
+    return records;
+  }
+
+  std::optional<std::uintmax_t> sizeIfExists(const std::filesystem::path& path) {
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(path, ec);
+    return ec ? std::nullopt : std::optional<std::uintmax_t>(size);
+  }
+
+  std::string optionalField(const std::optional<std::uintmax_t>& value) {
+    return value ? std::to_string(*value) : "";
+  }
+
+  std::optional<std::uintmax_t> parseSize(const std::string& field) {
+    return field.empty() ? std::nullopt : std::optional<std::uintmax_t>(std::stoull(field));
+  }
+}  // namespace
+
+JournalHeader JournalHeader::describe(const SweepOptions& options, std::string_view baseText, std::size_t numVariants) {
+  JournalHeader header;
+  header.baseInput = std::filesystem::absolute(options.baseInput);
+  header.specPath = std::filesystem::absolute(options.specPath);
+  header.outputDirectory = std::filesystem::absolute(options.outputDirectory);
+  header.energyPlusArgs = options.energyPlusArgs;
+  header.baseHash = utilities::toHex(utilities::fnv1a64(baseText));
+  header.specHash = fileHash(options.specPath);
+  header.numVariants = numVariants;
+  return header;
+}
+
+void JournalHeader::checkSameSweep(const JournalHeader& other) const {
+  if (baseHash != other.baseHash) {
+    throw std::runtime_error(fmt::format("{} changed since the sweep started, its finished variants don't apply anymore", baseInput));
+  }
+  if (specHash != other.specHash || numVariants != other.numVariants) {
+    throw std::runtime_error(fmt::format("{} changed since the sweep started, its finished variants don't apply anymore", specPath));
+  }
+  if (energyPlusArgs != other.energyPlusArgs) {
+    throw std::runtime_error("The EnergyPlus options differ from those the sweep started with");
+  }
+}
+
+bool JournalEntry::outputsIntact() const {
+  if (!std::filesystem::is_directory(result.directory)) {
+    return false;
+  }
+  // A variant that failed before EnergyPlus ran has no outputs to check
+  return sizeIfExists(result.directory / "eplusout.err") == errSize && sizeIfExists(result.directory / "eplusout.sql") == sqlSize;
+}
+
+std::filesystem::path SweepJournal::pathFor(const std::filesystem::path& outputDirectory) {
+  return outputDirectory / "sweep.journal";
+}
+
+JournalHeader SweepJournal::readHeader(const std::filesystem::path& path) {
+  JournalHeader header;
+  bool isJournal = false;
+  bool hasVariants = false;
+  for (const auto& record : readRecords(path)) {
+    const auto& kind = record.front();
+    if (kind == "journal" && record.size() == 2) {
+      if (record[1] != journalVersion) {
+        throw std::runtime_error(fmt::format("'{}' was written by another version of epcli", path));
+      }
+      isJournal = true;
+    } else if (kind == "base" && record.size() == 3) {
+      header.baseInput = record[1];
+      header.baseHash = record[2];
+    } else if (kind == "spec" && record.size() == 3) {
+      header.specPath = record[1];
+      header.specHash = record[2];
+    } else if (kind == "output" && record.size() == 2) {
+      header.outputDirectory = record[1];
+    } else if (kind == "arg" && record.size() == 2) {
+      header.energyPlusArgs.push_back(record[1]);
+    } else if (kind == "variants" && record.size() == 2) {
+      header.numVariants = std::stoull(record[1]);
+      hasVariants = true;
+    }
+  }
+  if (!isJournal || !hasVariants || header.baseInput.empty() || header.specPath.empty() || header.outputDirectory.empty()) {
+    throw std::runtime_error(fmt::format("'{}' is not a sweep journal, or its header is incomplete", path));
+  }
+  return header;
+}
+
+std::vector<JournalEntry> SweepJournal::readFinished(const std::filesystem::path& path) {
+  // A variant run again after a resume has several done records: the last one counts
+  std::map<std::size_t, JournalEntry> entries;
+  for (const auto& record : readRecords(path)) {
+    if (record.front() != "done" || record.size() != 11) {
+      continue;
+    }
+    try {
+      JournalEntry entry;
+      auto& result = entry.result;
+      result.index = std::stoull(record[1]);
+      result.finished = true;
+      result.succeeded = record[2] == "ok";
+      result.seconds = std::stod(record[3]);
+      if (!record[4].empty()) {
+        result.netSiteEnergy = std::stod(record[4]);
+      }
+      result.warnings = std::stoull(record[5]);
+      result.severes = std::stoull(record[6]);
+      entry.errSize = parseSize(record[7]);
+      entry.sqlSize = parseSize(record[8]);
+      result.directory = record[9];
+      result.error = record[10];
+      entries[result.index] = std::move(entry);
+    } catch (const std::exception&) {  // NOLINT(bugprone-empty-catch)
+      // The checksum matched, so only a journal from a broken epcli gets here: the variant runs again
+    }
+  }
+  std::vector<JournalEntry> finished;
+  finished.reserve(entries.size());
+  for (auto& [index, entry] : entries) {
+    finished.push_back(std::move(entry));
+  }
+  return finished;
+}
+
+SweepJournal::SweepJournal(const std::filesystem::path& path, const JournalHeader& header, bool resume) : m_file(path, !resume) {
+  if (resume) {
+    // After a torn record, or the next one would be lost with it
+    std::ifstream existing(path, std::ios::binary | std::ios::ate);
+    if (existing && existing.tellg() > 0) {
+      existing.seekg(-1, std::ios::end);
+      if (existing.get() != '\n') {
+        m_file.append("\n");
+      }
+    }
+    const double now = std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+    append({"resumed", fmt::format("{:.0f}", now)});
+    return;
+  }
+  append({"journal", journalVersion});
+  append({"base", header.baseInput.string(), header.baseHash});
+  append({"spec", header.specPath.string(), header.specHash});
+  append({"output", header.outputDirectory.string()});
+  for (const auto& arg : header.energyPlusArgs) {
+    append({"arg", arg});
+  }
+  append({"variants", std::to_string(header.numVariants)});
+}
+
+void SweepJournal::started(std::size_t index) {
+  append({"start", std::to_string(index)});
+}
+
+void SweepJournal::finished(const VariantResult& result) {
+  // Absolute: the journal may be resumed from another directory
+  const auto directory = std::filesystem::absolute(result.directory);
+  append({"done", std::to_string(result.index), result.succeeded ? "ok" : "failed", fmt::format("{}", result.seconds),
+          result.netSiteEnergy ? fmt::format("{}", *result.netSiteEnergy) : "", std::to_string(result.warnings), std::to_string(result.severes),
+          optionalField(sizeIfExists(directory / "eplusout.err")), optionalField(sizeIfExists(directory / "eplusout.sql")), directory.string(),
+          result.error});
+}
+
+void SweepJournal::append(const std::vector<std::string>& fields) {
+  std::string payload;
+  for (std::size_t i = 0; i < fields.size(); ++i) {
+    if (i > 0) {
+      payload += '\t';
+    }
+    payload += escape(fields[i]);
+  }
+  const std::string line = fmt::format("{}\t{}\n", payload, utilities::toHex(utilities::fnv1a64(payload)));
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  m_file.append(line);
+}
+
+}  // namespace sweep
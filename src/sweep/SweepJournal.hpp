@@ -0,0 +1,79 @@
+#ifndef SWEEP_SWEEPJOURNAL_HPP
+#define SWEEP_SWEEPJOURNAL_HPP
+
+#include "Sweep.hpp"                      // for SweepOptions, VariantResult
+#include "../utilities/DurableFile.hpp"  // for DurableFile
+
+#include <cstddef>      // for size_t
+#include <cstdint>      // for uintmax_t
+#include <filesystem>   // for path
+#include <mutex>        // for mutex
+#include <optional>     // for optional
+#include <string>       // for string
+#include <string_view>  // for string_view
+#include <vector>       // for vector
+
+namespace sweep {
+
+/// What defines a sweep: enough to run it again, and to tell whether its inputs changed since
+struct JournalHeader
+{
+  std::filesystem::path baseInput;
+  std::filesystem::path specPath;
+  std::filesystem::path outputDirectory;
+  std::vector<std::string> energyPlusArgs;
+  /// fnv1a64 of the base input and spec files
+  std::string baseHash;
+  std::string specHash;
+  std::size_t numVariants = 0;
+
+  /// Paths made absolute, so that --resume works from any directory
+  static JournalHeader describe(const SweepOptions& options, std::string_view baseText, std::size_t numVariants);
+
+  /// Throws std::runtime_error, saying what differs, if other isn't the same sweep
+  void checkSameSweep(const JournalHeader& other) const;
+};
+
+/// A finished variant as the journal recorded it, with the size of its outputs at the time
+struct JournalEntry
+{
+  VariantResult result;
+  std::optional<std::uintmax_t> errSize;
+  std::optional<std::uintmax_t> sqlSize;
+
+  /// The outputs are still where the journal says, as they were: the variant needn't run again
+  [[nodiscard]] bool outputsIntact() const;
+};
+
+/// <outputDirectory>/sweep.journal: a write-ahead log of a sweep, each record fsync'd before the sweep goes on, so that an interrupted sweep
+/// (Ctrl-C, reboot, OOM killer) can be resumed with only its unfinished variants. The header describes the sweep, then each variant gets a
+/// start record when its simulation starts, and a done record with its results and output locations when it finished.
+///
+/// Records are text lines ending with their checksum: a torn last line, from a crash in the middle of an append, is ignored when reading.
+/// Thread-safe
+class SweepJournal
+{
+ public:
+  static std::filesystem::path pathFor(const std::filesystem::path& outputDirectory);
+
+  /// Throws std::runtime_error if path isn't a journal, or its header is incomplete
+  static JournalHeader readHeader(const std::filesystem::path& path);
+  /// The last done record of each variant that has one
+  static std::vector<JournalEntry> readFinished(const std::filesystem::path& path);
+
+  /// Starts a new journal with header, or appends to the existing one when resuming. Throws std::runtime_error on failure
+  SweepJournal(const std::filesystem::path& path, const JournalHeader& header, bool resume);
+
+  void started(std::size_t index);
+  void finished(const VariantResult& result);
+
+ private:
+  void append(const std::vector<std::string>& fields);
+
+  std::mutex m_mutex;
+  utilities::DurableFile m_file;
+};
+
+}  // namespace sweep
+
+#endif  // SWEEP_SWEEPJOURNAL_HPP
@@ -0,0 +1,95 @@
+#include "ColumnarRingBuffer.hpp"
+
+#include <algorithm>  // for copy, min
+#include <cassert>    // for assert
+#include <utility>    // for move
+
+namespace utilities {
+
+ColumnarRingBuffer::ColumnarRingBuffer(std::size_t numColumns, std::size_t capacity)
+  : m_numColumns(numColumns), m_capacity(std::max<std::size_t>(capacity, 1)), m_times(m_capacity), m_values(m_numColumns * m_capacity) {}
+
+void ColumnarRingBuffer::push(double time, std::span<const double> values) {
+  assert(values.size() == m_numColumns);
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  m_times[m_head] = time;
+  for (std::size_t c = 0; c < m_numColumns; ++c) {
+    m_values[c * m_capacity + m_head] = values[c];
+  }
+  m_head = (m_head + 1 == m_capacity) ? 0 : m_head + 1;
+  m_size = std::min(m_size + 1, m_capacity);
+  ++m_totalPushed;
+}
+
+void ColumnarRingBuffer::clear() {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  m_head = 0;
+  m_size = 0;
+  m_totalPushed = 0;
+}
+
+void ColumnarRingBuffer::reserve(std::size_t capacity) {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  if (capacity <= m_capacity) {
+    return;
+  }
+  // Unwrapped, oldest first
+  const std::size_t start = (m_head + m_capacity - m_size) % m_capacity;
+  const std::size_t firstPart = std::min(m_size, m_capacity - start);
+  const auto unwrap = [this, start, firstPart](const double* from, double* to) {
+    std::copy(from + start, from + start + firstPart, to);
+    std::copy(from, from + (m_size - firstPart), to + firstPart);
+  };
+
+  std::vector<double> times(capacity);
+  std::vector<double> values(m_numColumns * capacity);
+  unwrap(m_times.data(), times.data());
+  for (std::size_t c = 0; c < m_numColumns; ++c) {
+    unwrap(m_values.data() + c * m_capacity, values.data() + c * capacity);
+  }
+  m_times = std::move(times);
+  m_values = std::move(values);
+  m_capacity = capacity;
+  m_head = m_size;
+}
+
+void ColumnarRingBuffer::copyColumn(std::size_t column, std::vector<double>& times, std::vector<double>& values, std::size_t maxRows) const {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  const std::size_t n = std::min(maxRows, m_size);
+  times.resize(n);
+  values.resize(n);
+  if (n == 0) {
+    return;
+  }
+
+  // The n rows end right before m_head, and may wrap around
+  const std::size_t start = (m_head + m_capacity - n) % m_capacity;
+  const std::size_t firstPart = std::min(n, m_capacity - start);
+  const auto* columnBegin = m_values.data() + column * m_capacity;
+
+  std::copy(m_times.data() + start, m_times.data() + start + firstPart, times.data());
+  std::copy(m_times.data(), m_times.data() + (n - firstPart), times.data() + firstPart);
+  std::copy(columnBegin + start, columnBegin + start + firstPart, values.data());
+  std::copy(columnBegin, columnBegin + (n - firstPart), values.data() + firstPart);
+}
+
+std::size_t ColumnarRingBuffer::size() const {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  return m_size;
+}
+
+std::size_t ColumnarRingBuffer::capacity() const {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  return m_capacity;
+}
+
+std::size_t ColumnarRingBuffer::numColumns() const {
+  return m_numColumns;
+}
+
+std::uint64_t ColumnarRingBuffer::totalPushed() const {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  return m_totalPushed;
+}
+
+}  // namespace utilities
@@ -0,0 +1,54 @@
+#ifndef UTILITIES_COLUMNARRINGBUFFER_HPP
+#define UTILITIES_COLUMNARRINGBUFFER_HPP
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint64_t
+#include <mutex>    // for mutex
+#include <span>     // for span
+#include <vector>   // for vector
+
+namespace utilities {
+
+/// Fixed capacity time series storage: one time column plus numColumns value columns, each laid out contiguously, all allocated up front so
+/// that push never allocates. Once full, the oldest rows are overwritten.
+/// One writer and any number of readers: the lock is only held for the duration of a row write or a column copy
+class ColumnarRingBuffer
+{
+ public:
+  ColumnarRingBuffer(std::size_t numColumns, std::size_t capacity);
+  ColumnarRingBuffer(const ColumnarRingBuffer&) = delete;
+  ColumnarRingBuffer& operator=(const ColumnarRingBuffer&) = delete;
+
+  /// values.size() must be numColumns()
+  void push(double time, std::span<const double> values);
+  void clear();
+  /// Grows the capacity to at least capacity, keeping the rows. Allocates, unlike push: meant for writers that learn how many rows are
+  /// coming as they go, such as the output file readers
+  void reserve(std::size_t capacity);
+
+  /// Copies the (at most maxRows) most recent rows, oldest first, into the output vectors, reusing their storage
+  void copyColumn(std::size_t column, std::vector<double>& times, std::vector<double>& values, std::size_t maxRows) const;
+
+  [[nodiscard]] std::size_t size() const;
+  [[nodiscard]] std::size_t capacity() const;
+  [[nodiscard]] std::size_t numColumns() const;
+  /// Rows pushed since the last clear, including the overwritten ones
+  [[nodiscard]] std::uint64_t totalPushed() const;
+
+ private:
+  std::size_t m_numColumns;
+  std::size_t m_capacity;
+  std::vector<double> m_times;
+  // Column c occupies [c * m_capacity, (c + 1) * m_capacity)
+  std::vector<double> m_values;
+  // Where the next row goes
+  std::size_t m_head = 0;
+  // Rows held, at most m_capacity
+  std::size_t m_size = 0;
+  std::uint64_t m_totalPushed = 0;
+  mutable std::mutex m_mutex;
+};
+
+}  // namespace utilities
+
+#endif  // UTILITIES_COLUMNARRINGBUFFER_HPP
@@ -0,0 +1,174 @@
+#include "CpuTopology.hpp"
+
+#include <algorithm>  // for max, min, sort, find, count_if
+#include <numeric>    // for iota
+#include <thread>     // for thread
+
+#if _WIN32
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <windows.h>  // for SetThreadAffinityMask, GetCurrentThread
+#elif !defined(__APPLE__)
+#  include <pthread.h>  // for pthread_setaffinity_np, pthread_self
+#  include <sched.h>    // for sched_getaffinity, cpu_set_t, CPU_SET, CPU_ISSET
+
+#  include <cctype>        // for isdigit
+#  include <exception>     // for exception
+#  include <filesystem>    // for path, directory_iterator
+#  include <fstream>       // for ifstream
+#  include <map>           // for map
+#  include <string>        // for string, stoi, to_string
+#  include <system_error>  // for error_code
+#  include <tuple>         // for tie
+#  include <utility>       // for pair
+#endif
+
+namespace utilities {
+
+namespace {
+  std::vector<int> sequentialOrder() {
+    std::vector<int> cpus(std::max(1U, std::thread::hardware_concurrency()));
+    std::iota(cpus.begin(), cpus.end(), 0);
+    return cpus;
+  }
+
+#if !_WIN32 && !defined(__APPLE__)
+  // The /sys cpulist format: 0-3,8,10-11
+  std::vector<int> parseCpuList(const std::string& list) {
+    std::vector<int> cpus;
+    std::size_t pos = 0;
+    while (pos < list.size()) {
+      const auto comma = std::min(list.find(',', pos), list.size());
+      const auto range = list.substr(pos, comma - pos);
+      const auto dash = range.find('-');
+      try {
+        const int first = std::stoi(range.substr(0, dash));
+        const int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+        for (int cpu = first; cpu <= last; ++cpu) {
+          cpus.push_back(cpu);
+        }
+      } catch (const std::exception&) {  // NOLINT(bugprone-empty-catch)
+      }
+      pos = comma + 1;
+    }
+    return cpus;
+  }
+
+  struct CpuInfo
+  {
+    int cpu = 0;
+    int node = 0;
+    // 0 for the first hardware thread of its core, 1 for its first SMT sibling...
+    int smtRank = 0;
+    // Position among the CPUs of the same node and smtRank
+    int slot = 0;
+  };
+
+  std::vector<CpuInfo> readTopology() {
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+      return {};
+    }
+    std::vector<int> allowedCpus;
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &allowed)) {
+        allowedCpus.push_back(cpu);
+      }
+    }
+
+    const std::filesystem::path sysCpu("/sys/devices/system/cpu");
+    std::vector<CpuInfo> infos;
+    for (const int cpu : allowedCpus) {
+      CpuInfo info;
+      info.cpu = cpu;
+      const auto cpuDirectory = sysCpu / ("cpu" + std::to_string(cpu));
+      std::error_code ec;
+      for (const auto& entry : std::filesystem::directory_iterator(cpuDirectory, ec)) {
+        const auto name = entry.path().filename().string();
+        if (name.size() > 4 && name.compare(0, 4, "node") == 0 && std::isdigit(static_cast<unsigned char>(name[4])) != 0) {
+          info.node = std::stoi(name.substr(4));
+          break;
+        }
+      }
+      std::ifstream siblingsFile(cpuDirectory / "topology" / "thread_siblings_list");
+      std::string siblingsList;
+      if (siblingsFile >> siblingsList) {
+        // Only the siblings this process may run on count
+        int rank = 0;
+        for (const int sibling : parseCpuList(siblingsList)) {
+          if (sibling == cpu) {
+            break;
+          }
+          if (std::find(allowedCpus.cbegin(), allowedCpus.cend(), sibling) != allowedCpus.cend()) {
+            ++rank;
+          }
+        }
+        info.smtRank = rank;
+      }
+      infos.push_back(info);
+    }
+
+    std::map<std::pair<int, int>, int> slots;
+    for (auto& info : infos) {
+      info.slot = slots[{info.node, info.smtRank}]++;
+    }
+    return infos;
+  }
+#endif
+}  // namespace
+
+std::vector<int> cpuPlacementOrder() {
+#if _WIN32 || defined(__APPLE__)
+  return sequentialOrder();
+#else
+  auto infos = readTopology();
+  if (infos.empty()) {
+    return sequentialOrder();
+  }
+  // Physical cores before SMT siblings, then round robin over the nodes
+  std::sort(infos.begin(), infos.end(), [](const CpuInfo& a, const CpuInfo& b) {
+    return std::tie(a.smtRank, a.slot, a.node, a.cpu) < std::tie(b.smtRank, b.slot, b.node, b.cpu);
+  });
+  std::vector<int> cpus;
+  cpus.reserve(infos.size());
+  for (const auto& info : infos) {
+    cpus.push_back(info.cpu);
+  }
+  return cpus;
+#endif
+}
+
+unsigned physicalCoreCount() {
+#if _WIN32 || defined(__APPLE__)
+  return std::max(1U, std::thread::hardware_concurrency());
+#else
+  const auto infos = readTopology();
+  const auto cores = std::count_if(infos.cbegin(), infos.cend(), [](const CpuInfo& info) { return info.smtRank == 0; });
+  return cores > 0 ? static_cast<unsigned>(cores) : std::max(1U, std::thread::hardware_concurrency());
+#endif
+}
+
+bool pinCurrentThread(int cpu) {
+#if _WIN32
+  if (cpu < 0 || cpu >= 64) {
+    return false;
+  }
+  return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR{1} << static_cast<unsigned>(cpu)) != 0;
+#elif defined(__APPLE__)
+  // macOS only takes affinity hints between threads, not CPUs
+  (void)cpu;
+  return false;
+#else
+  if (cpu < 0 || cpu >= CPU_SETSIZE) {
+    return false;
+  }
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#endif
+}
+
+}  // namespace utilities
@@ -0,0 +1,22 @@
+#ifndef UTILITIES_CPUTOPOLOGY_HPP
+#define UTILITIES_CPUTOPOLOGY_HPP
+
+#include <vector>  // for vector
+
+namespace utilities {
+
+/// The CPUs this process may run on, in the order workers should be pinned to them: one hardware thread of every physical core first,
+/// alternating between NUMA nodes so that memory bandwidth is shared evenly, then their SMT siblings. Outside of Linux, or when /sys
+/// can't be read, the CPU indices in order
+std::vector<int> cpuPlacementOrder();
+
+/// Physical cores this process may run on, hardware threads when unknown. EnergyPlus gains little from SMT, so this is the sensible number
+/// of simulations at once
+unsigned physicalCoreCount();
+
+/// Pins the calling thread to a single CPU. False where unsupported (macOS) or on failure
+bool pinCurrentThread(int cpu);
+
+}  // namespace utilities
+
+#endif  // UTILITIES_CPUTOPOLOGY_HPP
@@ -0,0 +1,106 @@
+#include "DurableFile.hpp"
+
+#include <fmt/format.h>  // for format
+#include <fmt/std.h>     // for formatting std::filesystem::path // IWYU pragma: keep
+
+#include <stdexcept>  // for runtime_error
+#include <string>     // for string
+
+#if _WIN32
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <windows.h>  // for CreateFileW, WriteFile, FlushFileBuffers, CloseHandle
+#else
+#  include <fcntl.h>   // for open, O_WRONLY, O_APPEND, O_CREAT, O_TRUNC, O_RDONLY
+#  include <unistd.h>  // for write, fsync, close
+
+#  include <cerrno>        // for errno, EINTR
+#  include <system_error>  // for error_code, generic_category
+#endif
+
+namespace utilities {
+
+namespace {
+#if !_WIN32
+  std::string lastError() {
+    return std::error_code(errno, std::generic_category()).message();
+  }
+
+  // Best effort: some filesystems don't support syncing a directory
+  void syncDirectory(const std::filesystem::path& directory) {
+    const int fd = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY);
+    if (fd >= 0) {
+      ::fsync(fd);
+      ::close(fd);
+    }
+  }
+#endif
+}  // namespace
+
+DurableFile::DurableFile(const std::filesystem::path& path, bool truncate) : m_path(path) {
+  const bool existed = std::filesystem::exists(path);
+#if _WIN32
+  m_handle = CreateFileW(path.c_str(), FILE_APPEND_DATA, FILE_SHARE_READ, nullptr, truncate ? CREATE_ALWAYS : OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL,
+                         nullptr);
+  if (m_handle == INVALID_HANDLE_VALUE) {
+    m_handle = nullptr;
+    throw std::runtime_error(fmt::format("Cannot open {} for writing, error {}", path, GetLastError()));
+  }
+  // NTFS journals its metadata: a created file survives once FlushFileBuffers returned, no need to sync the directory
+  (void)existed;
+#else
+  m_fd = ::open(path.c_str(), O_WRONLY | O_APPEND | O_CREAT | (truncate ? O_TRUNC : 0), 0644);  // NOLINT(hicpp-signed-bitwise)
+  if (m_fd < 0) {
+    throw std::runtime_error(fmt::format("Cannot open {} for writing: {}", path, lastError()));
+  }
+  if (!existed) {
+    ::fsync(m_fd);
+    syncDirectory(path.parent_path());
+  }
+#endif
+}
+
+DurableFile::~DurableFile() {
+#if _WIN32
+  if (m_handle != nullptr) {
+    CloseHandle(m_handle);
+  }
+#else
+  if (m_fd >= 0) {
+    ::close(m_fd);
+  }
+#endif
+}
+
+void DurableFile::append(std::string_view data) {
+#if _WIN32
+  while (!data.empty()) {
+    DWORD written = 0;
+    if (WriteFile(m_handle, data.data(), static_cast<DWORD>(data.size()), &written, nullptr) == 0) {
+      throw std::runtime_error(fmt::format("Cannot write to {}, error {}", m_path, GetLastError()));
+    }
+    data.remove_prefix(written);
+  }
+  if (FlushFileBuffers(m_handle) == 0) {
+    throw std::runtime_error(fmt::format("Cannot flush {}, error {}", m_path, GetLastError()));
+  }
+#else
+  while (!data.empty()) {
+    const auto written = ::write(m_fd, data.data(), data.size());
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::runtime_error(fmt::format("Cannot write to {}: {}", m_path, lastError()));
+    }
+    data.remove_prefix(static_cast<std::size_t>(written));
+  }
+  // Not fdatasync, which macOS lacks: appends change the size of the file, so it would sync as much anyway
+  if (::fsync(m_fd) != 0) {
+    throw std::runtime_error(fmt::format("Cannot sync {}: {}", m_path, lastError()));
+  }
+#endif
+}
+
+}  // namespace utilities
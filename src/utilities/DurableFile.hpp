@@ -0,0 +1,35 @@
+#ifndef UTILITIES_DURABLEFILE_HPP
+#define UTILITIES_DURABLEFILE_HPP
+
+#include <filesystem>   // for path
+#include <string_view>  // for string_view
+
+namespace utilities {
+
+/// An append-only file whose appends are on disk once append() returns: written in full, then fsync'd (FlushFileBuffers on Windows).
+/// A crash can leave at most the last append torn, so readers must be able to detect an incomplete last record. Not thread-safe
+class DurableFile
+{
+ public:
+  /// Creates the file if needed, truncating it if asked to. When it is created, its directory is synced too, so that the file itself
+  /// survives a crash. Throws std::runtime_error on failure
+  DurableFile(const std::filesystem::path& path, bool truncate);
+  DurableFile(const DurableFile&) = delete;
+  DurableFile& operator=(const DurableFile&) = delete;
+  ~DurableFile();
+
+  /// Throws std::runtime_error on failure, in which case part of data may have been written
+  void append(std::string_view data);
+
+ private:
+  std::filesystem::path m_path;
+#if _WIN32
+  void* m_handle = nullptr;
+#else
+  int m_fd = -1;
+#endif
+};
+
+}  // namespace utilities
+
+#endif  // UTILITIES_DURABLEFILE_HPP
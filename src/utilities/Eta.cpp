@@ -0,0 +1,65 @@
+#include "Eta.hpp"
+
+#include <fmt/format.h>  // for format
+
+#include <algorithm>   // for max, clamp
+#include <cmath>       // for lround
+#include <functional>  // for greater
+#include <queue>       // for priority_queue
+
+namespace utilities {
+
+std::optional<double> remainingSeconds(std::optional<double> predictedSeconds, double elapsedSeconds, double fraction) {
+  fraction = std::clamp(fraction, 0.0, 1.0);
+  if (fraction >= 1.0) {
+    return 0.0;
+  }
+  std::optional<double> observed;
+  if (fraction > 0.0) {
+    observed = elapsedSeconds * (1.0 - fraction) / fraction;
+  }
+  if (!predictedSeconds) {
+    return observed;
+  }
+  // A run taking longer than predicted has at least a little left
+  const double predicted = std::max(*predictedSeconds - elapsedSeconds, 0.0);
+  if (!observed) {
+    return predicted;
+  }
+  return fraction * *observed + (1.0 - fraction) * predicted;
+}
+
+double makespan(const std::vector<double>& runningRemaining, const std::vector<double>& pending, unsigned numWorkers) {
+  // When each worker is free again, soonest first
+  std::priority_queue<double, std::vector<double>, std::greater<>> freeAt;
+  for (const double remaining : runningRemaining) {
+    freeAt.push(std::max(remaining, 0.0));
+  }
+  while (freeAt.size() < std::max(1U, numWorkers)) {
+    freeAt.push(0.0);
+  }
+  double end = 0.0;
+  for (const double seconds : pending) {
+    const double start = freeAt.top();
+    freeAt.pop();
+    freeAt.push(start + std::max(seconds, 0.0));
+  }
+  while (!freeAt.empty()) {
+    end = std::max(end, freeAt.top());
+    freeAt.pop();
+  }
+  return end;
+}
+
+std::string formatDuration(double seconds) {
+  const long total = std::lround(std::max(seconds, 0.0));
+  if (total < 60) {
+    return fmt::format("{}s", total);
+  }
+  if (total < 3600) {
+    return fmt::format("{}m {:02}s", total / 60, total % 60);
+  }
+  return fmt::format("{}h {:02}m", total / 3600, (total % 3600) / 60);
+}
+
+}  // namespace utilities
@@ -0,0 +1,24 @@
+#ifndef UTILITIES_ETA_HPP
+#define UTILITIES_ETA_HPP
+
+#include <optional>  // for optional
+#include <string>    // for string
+#include <vector>    // for vector
+
+namespace utilities {
+
+/// Seconds left in a run, elapsed seconds into it at fraction (0 to 1) of its progress. The rate observed so far is blended with the
+/// prediction (eg: from sql::RuntimeHistory), trusting the observation more as the run goes: EnergyPlus reports no progress during input
+/// processing and sizing, so early rates are poor. Empty when there is neither a prediction nor any progress yet
+std::optional<double> remainingSeconds(std::optional<double> predictedSeconds, double elapsedSeconds, double fraction);
+
+/// Seconds until a batch is done on numWorkers workers: the running jobs (their remaining seconds) keep their workers, then each pending
+/// job (their predicted seconds, in the order they will start) goes to the first worker free, as a pool does
+double makespan(const std::vector<double>& runningRemaining, const std::vector<double>& pending, unsigned numWorkers);
+
+/// 45s, 12m 05s, 3h 20m
+std::string formatDuration(double seconds);
+
+}  // namespace utilities
+
+#endif  // UTILITIES_ETA_HPP
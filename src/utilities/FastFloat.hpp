@@ -0,0 +1,157 @@
+#ifndef UTILITIES_FASTFLOAT_HPP
+#define UTILITIES_FASTFLOAT_HPP
+
+#include <algorithm>  // for min
+#include <array>      // for array
+#include <bit>        // for endian
+#include <cstddef>    // for size_t
+#include <cstdint>    // for uint64_t
+#include <cstdlib>    // for strtod
+#include <cstring>    // for memcpy
+#include <string>     // for string
+
+namespace utilities {
+
+namespace detail {
+  // Every power of ten up to 1e22 is exact as a double
+  inline constexpr std::array<double, 23> exactPowersOfTen = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                                              1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+  inline bool isDigit(char c) {
+    return static_cast<unsigned>(c - '0') < 10U;
+  }
+
+  // SWAR: eight characters as one little-endian word, checked and converted without a loop (the trick of simdjson and fast_float)
+  inline std::uint64_t loadEight(const char* p) {
+    std::uint64_t word = 0;
+    std::memcpy(&word, p, sizeof(word));
+    return word;
+  }
+
+  inline bool isEightDigits(std::uint64_t word) {
+    return ((word & 0xF0F0F0F0F0F0F0F0ULL) | (((word + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4U)) == 0x3333333333333333ULL;
+  }
+
+  inline std::uint64_t parseEightDigits(std::uint64_t word) {
+    constexpr std::uint64_t mask = 0x000000FF000000FFULL;
+    constexpr std::uint64_t mul1 = 0x000F424000000064ULL;  // 100 + (1000000 << 32)
+    constexpr std::uint64_t mul2 = 0x0000271000000001ULL;  // 1 + (10000 << 32)
+    word -= 0x3030303030303030ULL;
+    word = (word * 10) + (word >> 8U);  // pairs of digits
+    return (((word & mask) * mul1) + (((word >> 16U) & mask) * mul2)) >> 32U;
+  }
+
+  // Accumulates runs of eight digits into mantissa while they all fit, returns the number of digits consumed
+  inline int accumulateEightDigits(const char*& p, const char* last, std::uint64_t& mantissa, int& significantDigits) {
+    int consumed = 0;
+    if constexpr (std::endian::native == std::endian::little) {
+      // Leading zeros aren't significant, the scalar loop skips them
+      while (mantissa != 0 && significantDigits <= 11 && last - p >= 8 && isEightDigits(loadEight(p))) {
+        mantissa = mantissa * 100000000 + parseEightDigits(loadEight(p));
+        significantDigits += 8;
+        consumed += 8;
+        p += 8;
+      }
+    }
+    return consumed;
+  }
+}  // namespace detail
+
+/// Parses a decimal number at the start of [first, last): [+-]digits[.digits][(e|E)[+-]digits], as EnergyPlus and CSV writers print them.
+/// Returns the end of the number, or nullptr if there is none (value is then unchanged).
+///
+/// The usual output (at most 19 significant digits, exponents within +-22 once normalized, a mantissa below 2^53) takes Clinger's fast
+/// path: one integer accumulation and one exact multiplication or division, which is correctly rounded. Anything else goes through strtod,
+/// on a copy on the stack below 64 characters. Doesn't allocate or depend on the locale on the fast path, unlike strtod and streams, and
+/// unlike std::from_chars for doubles is available on every standard library epcli builds with
+inline const char* parseDouble(const char* first, const char* last, double& value) {
+  const char* p = first;
+  const bool negative = (p != last && *p == '-');
+  if (p != last && (*p == '-' || *p == '+')) {
+    ++p;
+  }
+
+  std::uint64_t mantissa = 0;
+  int significantDigits = 0;
+  int exponent = 0;
+  bool anyDigit = false;
+  bool exact = true;
+  if (p != last && detail::isDigit(*p)) {
+    mantissa = static_cast<std::uint64_t>(*p - '0');
+    significantDigits = (mantissa != 0) ? 1 : 0;
+    anyDigit = true;
+    ++p;
+    detail::accumulateEightDigits(p, last, mantissa, significantDigits);
+  }
+  for (; p != last && detail::isDigit(*p); ++p) {
+    anyDigit = true;
+    if (significantDigits < 19) {
+      mantissa = mantissa * 10 + static_cast<std::uint64_t>(*p - '0');
+      significantDigits += (mantissa != 0) ? 1 : 0;
+    } else {
+      ++exponent;
+      exact = false;
+    }
+  }
+  if (p != last && *p == '.') {
+    ++p;
+    const int fastDigits = detail::accumulateEightDigits(p, last, mantissa, significantDigits);
+    exponent -= fastDigits;
+    anyDigit = anyDigit || fastDigits > 0;
+    for (; p != last && detail::isDigit(*p); ++p) {
+      anyDigit = true;
+      if (significantDigits < 19) {
+        mantissa = mantissa * 10 + static_cast<std::uint64_t>(*p - '0');
+        significantDigits += (mantissa != 0) ? 1 : 0;
+        --exponent;
+      } else {
+        exact = false;
+      }
+    }
+  }
+  if (!anyDigit) {
+    return nullptr;
+  }
+  if (p != last && (*p == 'e' || *p == 'E')) {
+    const char* q = p + 1;
+    const bool negativeExponent = (q != last && *q == '-');
+    if (q != last && (*q == '-' || *q == '+')) {
+      ++q;
+    }
+    // "1e" is 1 followed by "e", as for strtod
+    if (q != last && detail::isDigit(*q)) {
+      int parsedExponent = 0;
+      for (; q != last && detail::isDigit(*q); ++q) {
+        // Saturated: anything this large is 0 or infinity anyway, which strtod works out
+        parsedExponent = std::min(parsedExponent * 10 + (*q - '0'), 100000);
+      }
+      exponent += negativeExponent ? -parsedExponent : parsedExponent;
+      p = q;
+    }
+  }
+
+  if (mantissa == 0) {
+    value = negative ? -0.0 : 0.0;
+    return p;
+  }
+  if (exact && mantissa <= (std::uint64_t{1} << 53U) && exponent >= -22 && exponent <= 22) {
+    auto result = static_cast<double>(mantissa);
+    result = (exponent < 0) ? result / detail::exactPowersOfTen[-exponent] : result * detail::exactPowersOfTen[exponent];
+    value = negative ? -result : result;
+    return p;
+  }
+
+  const auto length = static_cast<std::size_t>(p - first);
+  std::array<char, 64> buffer{};
+  if (length < buffer.size()) {
+    std::memcpy(buffer.data(), first, length);
+    value = std::strtod(buffer.data(), nullptr);
+  } else {
+    value = std::strtod(std::string(first, p).c_str(), nullptr);
+  }
+  return p;
+}
+
+}  // namespace utilities
+
+#endif  // UTILITIES_FASTFLOAT_HPP
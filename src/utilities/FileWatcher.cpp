@@ -0,0 +1,216 @@
+#include "FileWatcher.hpp"
+
+#include "Hash.hpp"  // for fnv1a64
+
+#include <fmt/format.h>  // for format
+#include <fmt/std.h>     // for formatting std::filesystem::path // IWYU pragma: keep
+
+#include <fstream>      // for ifstream
+#include <iterator>     // for istreambuf_iterator
+#include <stdexcept>    // for runtime_error
+#include <string>       // for string
+#include <string_view>  // for string_view
+#include <utility>      // for move
+
+#if __linux__
+#  include <poll.h>         // for poll, pollfd, POLLIN
+#  include <sys/eventfd.h>  // for eventfd, EFD_CLOEXEC
+#  include <sys/inotify.h>  // for inotify_init1, inotify_add_watch, inotify_event, IN_*
+#  include <unistd.h>       // for read, write, close
+
+#  include <algorithm>     // for max
+#  include <array>         // for array
+#  include <cerrno>        // for errno, EINTR
+#  include <cstring>       // for memcpy
+#  include <system_error>  // for error_code, generic_category
+#else
+#  include <system_error>  // for error_code
+#  include <tuple>         // for tuple
+#endif
+
+namespace utilities {
+
+namespace {
+  std::optional<std::uint64_t> contentHash(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+      return std::nullopt;
+    }
+    const std::string text{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    return fnv1a64(text);
+  }
+
+#if !__linux__
+  using Stamp = std::optional<std::tuple<std::filesystem::file_time_type, std::uintmax_t>>;
+
+  std::vector<Stamp> modificationStamps(const std::vector<std::filesystem::path>& files) {
+    std::vector<Stamp> stamps;
+    stamps.reserve(files.size());
+    for (const auto& file : files) {
+      std::error_code ec;
+      const auto time = std::filesystem::last_write_time(file, ec);
+      const auto size = ec ? 0 : std::filesystem::file_size(file, ec);
+      stamps.push_back(ec ? std::nullopt : Stamp(std::tuple(time, size)));
+    }
+    return stamps;
+  }
+#endif
+}  // namespace
+
+FileWatcher::FileWatcher(std::vector<std::filesystem::path> files, std::chrono::milliseconds debounce, Callback onChange)
+  : m_debounce(debounce), m_onChange(std::move(onChange)) {
+  m_files.reserve(files.size());
+  for (auto& file : files) {
+    m_files.push_back(std::filesystem::absolute(file));
+    m_hashes.push_back(contentHash(m_files.back()));
+  }
+
+#if __linux__
+  const auto fail = [this](std::string message) {
+    message += std::error_code(errno, std::generic_category()).message();
+    if (m_inotifyFd >= 0) {
+      ::close(m_inotifyFd);
+    }
+    if (m_stopFd >= 0) {
+      ::close(m_stopFd);
+    }
+    throw std::runtime_error(message);
+  };
+  m_inotifyFd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);  // NOLINT(hicpp-signed-bitwise)
+  if (m_inotifyFd < 0) {
+    fail("Cannot watch the input files: ");
+  }
+  m_stopFd = ::eventfd(0, EFD_CLOEXEC);
+  if (m_stopFd < 0) {
+    fail("Cannot watch the input files: ");
+  }
+  for (const auto& file : m_files) {
+    // Adding the same directory again gives the same descriptor
+    const int wd = ::inotify_add_watch(m_inotifyFd, file.parent_path().c_str(),
+                                       IN_CLOSE_WRITE | IN_MODIFY | IN_MOVED_TO | IN_CREATE | IN_DELETE);  // NOLINT(hicpp-signed-bitwise)
+    if (wd < 0) {
+      fail(fmt::format("Cannot watch {}: ", file.parent_path()));
+    }
+    m_watches.emplace_back(wd, file.filename().string());
+  }
+#endif
+
+  m_thread = std::thread([this]() { watchLoop(); });
+}
+
+FileWatcher::~FileWatcher() {
+#if __linux__
+  const std::uint64_t one = 1;
+  [[maybe_unused]] const auto written = ::write(m_stopFd, &one, sizeof(one));
+#else
+  {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_stopRequested.notify_one();
+#endif
+  m_thread.join();
+#if __linux__
+  ::close(m_inotifyFd);
+  ::close(m_stopFd);
+#endif
+}
+
+void FileWatcher::checkContents() {
+  std::vector<std::filesystem::path> changed;
+  for (std::size_t i = 0; i < m_files.size(); ++i) {
+    auto hash = contentHash(m_files[i]);
+    if (hash && hash != m_hashes[i]) {
+      m_hashes[i] = hash;
+      changed.push_back(m_files[i]);
+    }
+  }
+  if (!changed.empty()) {
+    m_onChange(changed);
+  }
+}
+
+#if __linux__
+bool FileWatcher::drainEvents() {
+  bool relevant = false;
+  alignas(inotify_event) std::array<char, 16384> buffer{};
+  while (true) {
+    const auto length = ::read(m_inotifyFd, buffer.data(), buffer.size());
+    if (length <= 0) {
+      // EAGAIN: nothing left
+      return relevant;
+    }
+    for (std::size_t pos = 0; pos < static_cast<std::size_t>(length);) {
+      inotify_event event{};
+      std::memcpy(&event, buffer.data() + pos, sizeof(event));
+      // NUL-padded, absent for events on the directory itself
+      const std::string_view name = event.len > 0 ? std::string_view(buffer.data() + pos + sizeof(event)) : std::string_view();
+      pos += sizeof(event) + event.len;
+      // Events were lost, any file may have changed
+      if ((event.mask & IN_Q_OVERFLOW) != 0) {  // NOLINT(hicpp-signed-bitwise)
+        relevant = true;
+        continue;
+      }
+      for (const auto& [wd, fileName] : m_watches) {
+        relevant = relevant || (wd == event.wd && name == fileName);
+      }
+    }
+  }
+}
+
+void FileWatcher::watchLoop() {
+  std::array<pollfd, 2> fds{{{m_inotifyFd, POLLIN, 0}, {m_stopFd, POLLIN, 0}}};
+  // Set while a change is pending. Only the events that touch a file push it back: the outputs written next to the input while a run is
+  // in progress wake poll() too, and must not hold the change back
+  std::optional<std::chrono::steady_clock::time_point> deadline;
+  while (true) {
+    int timeout = -1;
+    if (deadline) {
+      const auto left = std::chrono::ceil<std::chrono::milliseconds>(*deadline - std::chrono::steady_clock::now());
+      timeout = static_cast<int>(std::max<std::chrono::milliseconds::rep>(left.count(), 0));
+    }
+    const int ready = ::poll(fds.data(), fds.size(), timeout);
+    if (ready < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return;
+    }
+    if (fds[1].revents != 0) {
+      return;
+    }
+    if (ready > 0 && drainEvents()) {
+      deadline = std::chrono::steady_clock::now() + m_debounce;
+    }
+    if (deadline && std::chrono::steady_clock::now() >= *deadline) {
+      deadline.reset();
+      checkContents();
+    }
+  }
+}
+#else
+void FileWatcher::watchLoop() {
+  auto stamps = modificationStamps(m_files);
+  std::unique_lock<std::mutex> lock(m_mutex);
+  const auto stopped = [this]() { return m_stop; };
+  while (!m_stopRequested.wait_for(lock, std::chrono::seconds(1), stopped)) {
+    auto current = modificationStamps(m_files);
+    if (current == stamps) {
+      continue;
+    }
+    // Until the save is over
+    while (current != stamps) {
+      stamps = std::move(current);
+      if (m_stopRequested.wait_for(lock, m_debounce, stopped)) {
+        return;
+      }
+      current = modificationStamps(m_files);
+    }
+    lock.unlock();
+    checkContents();
+    lock.lock();
+  }
+}
+#endif
+
+}  // namespace utilities
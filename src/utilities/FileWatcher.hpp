@@ -0,0 +1,69 @@
+#ifndef UTILITIES_FILEWATCHER_HPP
+#define UTILITIES_FILEWATCHER_HPP
+
+#include <chrono>      // for milliseconds
+#include <cstdint>     // for uint64_t
+#include <filesystem>  // for path
+#include <functional>  // for function
+#include <optional>    // for optional
+#include <string>      // for string
+#include <thread>      // for thread
+#include <utility>     // for pair
+#include <vector>      // for vector
+
+#if !__linux__
+#  include <condition_variable>  // for condition_variable
+#  include <mutex>               // for mutex
+#endif
+
+namespace utilities {
+
+/// Calls back when the content of one of a few files changed. Editors save in bursts (write, rename, touch), so a change is only reported
+/// once nothing happened to the files for the debounce delay, and only if their content hash differs from the last one reported: saving
+/// without edits, or a touch, is not a change.
+///
+/// Linux waits on inotify, watching the directories rather than the files, since saving through a rename replaces the watched inode.
+/// Elsewhere, the modification times are checked every second. The callback runs on the watcher thread
+class FileWatcher
+{
+ public:
+  /// Receives the files whose content changed
+  using Callback = std::function<void(const std::vector<std::filesystem::path>& changed)>;
+
+  /// Starts watching right away, the current contents being the reference. Throws std::runtime_error if the watch cannot be set up
+  FileWatcher(std::vector<std::filesystem::path> files, std::chrono::milliseconds debounce, Callback onChange);
+  FileWatcher(const FileWatcher&) = delete;
+  FileWatcher& operator=(const FileWatcher&) = delete;
+  /// Stops the watcher thread, waiting for a callback in progress
+  ~FileWatcher();
+
+ private:
+  void watchLoop();
+  // Hashes the files, calls back with those that changed. A file missing in the middle of a save is left for the next check
+  void checkContents();
+
+  std::vector<std::filesystem::path> m_files;
+  std::vector<std::optional<std::uint64_t>> m_hashes;
+  std::chrono::milliseconds m_debounce;
+  Callback m_onChange;
+
+#if __linux__
+  // Whether the pending inotify events touch one of the files
+  bool drainEvents();
+
+  int m_inotifyFd = -1;
+  // The watch descriptor of the directory of each file, and the file name in it
+  std::vector<std::pair<int, std::string>> m_watches;
+  // Written to by the destructor, to wake up the watcher thread
+  int m_stopFd = -1;
+#else
+  std::mutex m_mutex;
+  std::condition_variable m_stopRequested;
+  bool m_stop = false;
+#endif
+  std::thread m_thread;
+};
+
+}  // namespace utilities
+
+#endif  // UTILITIES_FILEWATCHER_HPP
@@ -0,0 +1,29 @@
+#ifndef UTILITIES_HASH_HPP
+#define UTILITIES_HASH_HPP
+
+#include <fmt/format.h>  // for format
+
+#include <cstdint>      // for uint64_t
+#include <string>       // for string
+#include <string_view>  // for string_view
+
+namespace utilities {
+
+/// 64-bit FNV-1a: fast, stable across platforms and runs (unlike std::hash), good enough for cache keys. Not cryptographic.
+/// Pass the previous result as seed to hash data in several pieces
+constexpr std::uint64_t fnv1a64(std::string_view data, std::uint64_t seed = 0xcbf29ce484222325ULL) {
+  std::uint64_t hash = seed;
+  for (const char c : data) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+inline std::string toHex(std::uint64_t hash) {
+  return fmt::format("{:016x}", hash);
+}
+
+}  // namespace utilities
+
+#endif  // UTILITIES_HASH_HPP
@@ -0,0 +1,107 @@
+#include "MappedFile.hpp"
+
+#include <fmt/format.h>  // for format
+#include <fmt/std.h>     // for formatting std::filesystem::path // IWYU pragma: keep
+
+#include <stdexcept>  // for runtime_error
+#include <string>     // for string
+
+#if _WIN32
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <windows.h>  // for CreateFileW, GetFileSizeEx, CreateFileMappingW, MapViewOfFile, UnmapViewOfFile, CloseHandle
+#else
+#  include <fcntl.h>     // for open, O_RDONLY, O_CLOEXEC
+#  include <sys/mman.h>  // for mmap, munmap, posix_madvise, MAP_FAILED
+#  include <sys/stat.h>  // for fstat
+#  include <unistd.h>    // for close
+
+#  include <cerrno>        // for errno
+#  include <system_error>  // for error_code, generic_category
+#endif
+
+namespace utilities {
+
+#if _WIN32
+MappedFile::MappedFile(const std::filesystem::path& path) {
+  HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    throw std::runtime_error(fmt::format("Cannot open {}, error {}", path, GetLastError()));
+  }
+  LARGE_INTEGER size;
+  if (GetFileSizeEx(file, &size) == 0) {
+    const auto error = GetLastError();
+    CloseHandle(file);
+    throw std::runtime_error(fmt::format("Cannot read the size of {}, error {}", path, error));
+  }
+  m_size = static_cast<std::size_t>(size.QuadPart);
+  if (m_size == 0) {
+    CloseHandle(file);
+    return;
+  }
+  // The view keeps the mapping and the file open once their handles are closed
+  HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(file);
+  if (mapping == nullptr) {
+    throw std::runtime_error(fmt::format("Cannot map {}, error {}", path, GetLastError()));
+  }
+  m_data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+  const auto error = GetLastError();
+  CloseHandle(mapping);
+  if (m_data == nullptr) {
+    throw std::runtime_error(fmt::format("Cannot map {}, error {}", path, error));
+  }
+}
+
+MappedFile::~MappedFile() {
+  if (m_data != nullptr) {
+    UnmapViewOfFile(m_data);
+  }
+}
+#else
+MappedFile::MappedFile(const std::filesystem::path& path) {
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);  // NOLINT(hicpp-signed-bitwise)
+  if (fd < 0) {
+    throw std::runtime_error(fmt::format("Cannot open {}: {}", path, std::error_code(errno, std::generic_category()).message()));
+  }
+  struct stat status = {};
+  if (::fstat(fd, &status) != 0) {
+    const auto error = std::error_code(errno, std::generic_category());
+    ::close(fd);
+    throw std::runtime_error(fmt::format("Cannot read the size of {}: {}", path, error.message()));
+  }
+  m_size = static_cast<std::size_t>(status.st_size);
+  if (m_size == 0) {
+    ::close(fd);
+    return;
+  }
+  // The mapping keeps the file open once fd is closed
+  void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  const auto error = std::error_code(errno, std::generic_category());
+  ::close(fd);
+  if (data == MAP_FAILED) {  // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+    throw std::runtime_error(fmt::format("Cannot map {}: {}", path, error.message()));
+  }
+  // Read front to back: the kernel can read ahead further
+  ::posix_madvise(data, m_size, POSIX_MADV_SEQUENTIAL);
+  m_data = static_cast<const char*>(data);
+}
+
+MappedFile::~MappedFile() {
+  if (m_data != nullptr) {
+    ::munmap(const_cast<char*>(m_data), m_size);  // NOLINT(cppcoreguidelines-pro-type-const-cast)
+  }
+}
+#endif
+
+std::string_view MappedFile::view() const {
+  return {m_data, m_size};
+}
+
+std::size_t MappedFile::size() const {
+  return m_size;
+}
+
+}  // namespace utilities
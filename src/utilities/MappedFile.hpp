@@ -0,0 +1,32 @@
+#ifndef UTILITIES_MAPPEDFILE_HPP
+#define UTILITIES_MAPPEDFILE_HPP
+
+#include <cstddef>      // for size_t
+#include <filesystem>   // for path
+#include <string_view>  // for string_view
+
+namespace utilities {
+
+/// A whole file mapped read-only: its contents are read straight from the page cache, without copying them into a buffer, and the pages
+/// are shared with every other process mapping the same file. The file must not be truncated while it is mapped: reading past its new end
+/// is a SIGBUS, not an exception
+class MappedFile
+{
+ public:
+  /// Throws std::runtime_error if the file cannot be opened or mapped. An empty file gives an empty view
+  explicit MappedFile(const std::filesystem::path& path);
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  ~MappedFile();
+
+  [[nodiscard]] std::string_view view() const;
+  [[nodiscard]] std::size_t size() const;
+
+ private:
+  const char* m_data = nullptr;
+  std::size_t m_size = 0;
+};
+
+}  // namespace utilities
+
+#endif  // UTILITIES_MAPPEDFILE_HPP
@@ -0,0 +1,216 @@
+#include "Metrics.hpp"
+
+#include <fmt/format.h>  // for format, format_to
+
+#include <algorithm>  // for find_if, is_sorted, lower_bound
+#include <cmath>      // for isinf, isnan
+#include <iterator>   // for back_inserter, distance, prev
+#include <stdexcept>  // for runtime_error
+#include <utility>    // for move
+
+namespace utilities::metrics {
+
+namespace {
+  bool isValidName(const std::string& name) {
+    if (name.empty()) {
+      return false;
+    }
+    auto isAlpha = [](char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_'; };
+    for (std::size_t i = 0; i < name.size(); ++i) {
+      const char c = name[i];
+      if (!isAlpha(c) && c != ':' && (i == 0 || c < '0' || c > '9')) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  std::string formatValue(double value) {
+    if (std::isnan(value)) {
+      return "NaN";
+    }
+    if (std::isinf(value)) {
+      return (value > 0) ? "+Inf" : "-Inf";
+    }
+    return fmt::format("{}", value);
+  }
+
+  // Escapes backslashes and newlines, plus double quotes in label values
+  std::string escape(const std::string& s, bool isLabelValue) {
+    std::string result;
+    result.reserve(s.size());
+    for (const char c : s) {
+      if (c == '\\') {
+        result += "\\\\";
+      } else if (c == '\n') {
+        result += "\\n";
+      } else if (c == '"' && isLabelValue) {
+        result += "\\\"";
+      } else {
+        result += c;
+      }
+    }
+    return result;
+  }
+
+  // {a="x",b="y"}, with an optional extra label (le for the histogram buckets)
+  std::string formatLabels(const Labels& labels, const char* extraName = nullptr, const std::string& extraValue = {}) {
+    if (labels.empty() && extraName == nullptr) {
+      return {};
+    }
+    std::string result = "{";
+    for (const auto& [name, value] : labels) {
+      if (result.size() > 1) {
+        result += ',';
+      }
+      result += fmt::format("{}=\"{}\"", name, escape(value, true));
+    }
+    if (extraName != nullptr) {
+      if (result.size() > 1) {
+        result += ',';
+      }
+      result += fmt::format("{}=\"{}\"", extraName, extraValue);
+    }
+    result += '}';
+    return result;
+  }
+}  // namespace
+
+Histogram::Histogram(std::vector<double> upperBounds)
+  : m_upperBounds(std::move(upperBounds)),
+    m_counts(std::make_unique<std::atomic<std::uint64_t>[]>(m_upperBounds.size() + 1)) {  // NOLINT(modernize-avoid-c-arrays)
+  if (!std::is_sorted(m_upperBounds.begin(), m_upperBounds.end())) {
+    throw std::runtime_error("Histogram bucket upper bounds must be sorted");
+  }
+}
+
+void Histogram::observe(double value) {
+  // Buckets are inclusive of their upper bound
+  const auto bucket = std::distance(m_upperBounds.begin(), std::lower_bound(m_upperBounds.begin(), m_upperBounds.end(), value));
+  m_counts[static_cast<std::size_t>(bucket)].fetch_add(1, std::memory_order_relaxed);
+  m_sum.fetch_add(value, std::memory_order_relaxed);
+}
+
+Histogram::Snapshot Histogram::snapshot() const {
+  Snapshot result;
+  result.upperBounds = m_upperBounds;
+  result.cumulativeCounts.reserve(m_upperBounds.size() + 1);
+  for (std::size_t i = 0; i <= m_upperBounds.size(); ++i) {
+    result.count += m_counts[i].load(std::memory_order_relaxed);
+    result.cumulativeCounts.push_back(result.count);
+  }
+  result.sum = m_sum.load(std::memory_order_relaxed);
+  return result;
+}
+
+std::vector<double> exponentialBuckets(double start, double factor, std::size_t count) {
+  std::vector<double> result;
+  result.reserve(count);
+  double bound = start;
+  for (std::size_t i = 0; i < count; ++i) {
+    result.push_back(bound);
+    bound *= factor;
+  }
+  return result;
+}
+
+Registry::Entry& Registry::entry(const std::string& name, const std::string& help, Type type, const Labels& labels) {
+  if (!isValidName(name)) {
+    throw std::runtime_error(fmt::format("Invalid metric name '{}'", name));
+  }
+  for (const auto& label : labels) {
+    if (!isValidName(label.first) || label.first.find(':') != std::string::npos || label.first == "le") {
+      throw std::runtime_error(fmt::format("Invalid label name '{}' for metric '{}'", label.first, name));
+    }
+  }
+
+  auto familyIt = std::find_if(m_families.begin(), m_families.end(), [&name](const Family& family) { return family.name == name; });
+  if (familyIt == m_families.end()) {
+    m_families.push_back(Family{name, help, type, {}});
+    familyIt = std::prev(m_families.end());
+  } else if (familyIt->type != type) {
+    throw std::runtime_error(fmt::format("Metric '{}' is already registered with another type", name));
+  }
+
+  auto& entries = familyIt->entries;
+  auto entryIt = std::find_if(entries.begin(), entries.end(), [&labels](const Entry& e) { return e.labels == labels; });
+  if (entryIt != entries.end()) {
+    return *entryIt;
+  }
+  entries.push_back(Entry{labels, nullptr, nullptr, nullptr, nullptr});
+  return entries.back();
+}
+
+Counter& Registry::counter(const std::string& name, const std::string& help, const Labels& labels) {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  auto& e = entry(name, help, Type::Counter, labels);
+  if (e.counter == nullptr) {
+    e.counter = std::make_unique<Counter>();
+  }
+  return *e.counter;
+}
+
+Gauge& Registry::gauge(const std::string& name, const std::string& help, const Labels& labels) {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  auto& e = entry(name, help, Type::Gauge, labels);
+  if (e.callback) {
+    throw std::runtime_error(fmt::format("Metric '{}' is already registered as a gauge callback", name));
+  }
+  if (e.gauge == nullptr) {
+    e.gauge = std::make_unique<Gauge>();
+  }
+  return *e.gauge;
+}
+
+Histogram& Registry::histogram(const std::string& name, const std::string& help, std::vector<double> upperBounds, const Labels& labels) {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  auto& e = entry(name, help, Type::Histogram, labels);
+  if (e.histogram == nullptr) {
+    e.histogram = std::make_unique<Histogram>(std::move(upperBounds));
+  }
+  return *e.histogram;
+}
+
+void Registry::gaugeCallback(const std::string& name, const std::string& help, std::function<double()> callback, const Labels& labels) {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  auto& e = entry(name, help, Type::Gauge, labels);
+  if (e.gauge != nullptr) {
+    throw std::runtime_error(fmt::format("Metric '{}' is already registered as a gauge", name));
+  }
+  e.callback = std::move(callback);
+}
+
+std::string Registry::exposition() const {
+  std::string result;
+  auto out = std::back_inserter(result);
+
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  for (const auto& family : m_families) {
+    fmt::format_to(out, "# HELP {} {}\n", family.name, escape(family.help, false));
+    const char* type = (family.type == Type::Counter) ? "counter" : ((family.type == Type::Histogram) ? "histogram" : "gauge");
+    fmt::format_to(out, "# TYPE {} {}\n", family.name, type);
+    for (const auto& e : family.entries) {
+      switch (family.type) {
+        case Type::Counter:
+          fmt::format_to(out, "{}{} {}\n", family.name, formatLabels(e.labels), e.counter->value());
+          break;
+        case Type::Gauge:
+          fmt::format_to(out, "{}{} {}\n", family.name, formatLabels(e.labels), formatValue(e.callback ? e.callback() : e.gauge->value()));
+          break;
+        case Type::Histogram: {
+          const auto snapshot = e.histogram->snapshot();
+          for (std::size_t i = 0; i < snapshot.cumulativeCounts.size(); ++i) {
+            const std::string le = (i < snapshot.upperBounds.size()) ? formatValue(snapshot.upperBounds[i]) : "+Inf";
+            fmt::format_to(out, "{}_bucket{} {}\n", family.name, formatLabels(e.labels, "le", le), snapshot.cumulativeCounts[i]);
+          }
+          fmt::format_to(out, "{}_sum{} {}\n", family.name, formatLabels(e.labels), formatValue(snapshot.sum));
+          fmt::format_to(out, "{}_count{} {}\n", family.name, formatLabels(e.labels), snapshot.count);
+          break;
+        }
+      }
+    }
+  }
+  return result;
+}
+
+}  // namespace utilities::metrics
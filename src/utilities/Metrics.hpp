@@ -0,0 +1,150 @@
+#ifndef UTILITIES_METRICS_HPP
+#define UTILITIES_METRICS_HPP
+
+#include <atomic>      // for atomic
+#include <chrono>      // for steady_clock, duration
+#include <cstddef>     // for size_t
+#include <cstdint>     // for uint64_t
+#include <functional>  // for function
+#include <memory>      // for unique_ptr
+#include <mutex>       // for mutex
+#include <string>      // for string
+#include <utility>     // for pair
+#include <vector>      // for vector
+
+namespace utilities::metrics {
+
+/// Counters, gauges and histograms exposed in the Prometheus text format (https://prometheus.io/docs/instrumenting/exposition_formats/).
+/// Updating a metric is a relaxed atomic operation, without any lock: only registering and exposing take the registry mutex
+
+using Labels = std::vector<std::pair<std::string, std::string>>;
+
+class Counter
+{
+ public:
+  void inc(std::uint64_t n = 1) {
+    m_value.fetch_add(n, std::memory_order_relaxed);
+  }
+  [[nodiscard]] std::uint64_t value() const {
+    return m_value.load(std::memory_order_relaxed);
+  }
+
+ private:
+  std::atomic<std::uint64_t> m_value = 0;
+};
+
+class Gauge
+{
+ public:
+  void set(double value) {
+    m_value.store(value, std::memory_order_relaxed);
+  }
+  void add(double delta) {
+    m_value.fetch_add(delta, std::memory_order_relaxed);
+  }
+  [[nodiscard]] double value() const {
+    return m_value.load(std::memory_order_relaxed);
+  }
+
+ private:
+  std::atomic<double> m_value = 0.0;
+};
+
+class Histogram
+{
+ public:
+  /// upperBounds must be sorted, the +Inf bucket is implicit
+  explicit Histogram(std::vector<double> upperBounds);
+
+  void observe(double value);
+
+  struct Snapshot
+  {
+    std::vector<double> upperBounds;
+    std::vector<std::uint64_t> cumulativeCounts;  // Per upper bound, then +Inf
+    std::uint64_t count = 0;
+    double sum = 0.0;
+  };
+  /// Buckets are read one by one while other threads may be observing, so the count can be off by the observations in flight
+  [[nodiscard]] Snapshot snapshot() const;
+
+ private:
+  std::vector<double> m_upperBounds;
+  std::unique_ptr<std::atomic<std::uint64_t>[]> m_counts;  // NOLINT(modernize-avoid-c-arrays)
+  std::atomic<double> m_sum = 0.0;
+};
+
+/// count buckets: start, start * factor, start * factor^2...
+std::vector<double> exponentialBuckets(double start, double factor, std::size_t count);
+
+/// Observes the seconds elapsed during its lifetime
+class ScopedTimer
+{
+ public:
+  explicit ScopedTimer(Histogram* histogram) : m_histogram(histogram) {
+    if (m_histogram != nullptr) {
+      m_start = std::chrono::steady_clock::now();
+    }
+  }
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+  ~ScopedTimer() {
+    if (m_histogram != nullptr) {
+      m_histogram->observe(std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count());
+    }
+  }
+
+ private:
+  Histogram* m_histogram;
+  std::chrono::steady_clock::time_point m_start;
+};
+
+/// Owns the metrics. Registering the same name and labels again returns the existing metric. References stay valid for the registry lifetime.
+/// Throws std::runtime_error on an invalid name, or a name already registered with another type
+class Registry
+{
+ public:
+  Counter& counter(const std::string& name, const std::string& help, const Labels& labels = {});
+  Gauge& gauge(const std::string& name, const std::string& help, const Labels& labels = {});
+  Histogram& histogram(const std::string& name, const std::string& help, std::vector<double> upperBounds, const Labels& labels = {});
+  /// A gauge computed when exposed, for values that are cheaper to derive on scrape than to maintain. Called with the registry mutex held
+  void gaugeCallback(const std::string& name, const std::string& help, std::function<double()> callback, const Labels& labels = {});
+
+  /// Text format 0.0.4
+  [[nodiscard]] std::string exposition() const;
+
+ private:
+  enum class Type
+  {
+    Counter,
+    Gauge,
+    Histogram,
+  };
+
+  struct Entry
+  {
+    Labels labels;
+    std::unique_ptr<Counter> counter;
+    std::unique_ptr<Gauge> gauge;
+    std::unique_ptr<Histogram> histogram;
+    std::function<double()> callback;
+  };
+
+  struct Family
+  {
+    std::string name;
+    std::string help;
+    Type type;
+    std::vector<Entry> entries;
+  };
+
+  // m_mutex must be held. Returns the entry with these labels, creating it (with nothing set) if needed
+  Entry& entry(const std::string& name, const std::string& help, Type type, const Labels& labels);
+
+  mutable std::mutex m_mutex;
+  std::vector<Family> m_families;  // In registration order
+};
+
+}  // namespace utilities::metrics
+
+#endif  // UTILITIES_METRICS_HPP
@@ -0,0 +1,235 @@
+#include "MetricsExporter.hpp"
+
+#include "Metrics.hpp"  // for Registry
+
+#include <fmt/format.h>  // for format
+
+#include <cstring>    // for memset
+#include <fstream>    // for ofstream
+#include <stdexcept>  // for runtime_error
+#include <string>     // for string
+#include <utility>    // for move
+
+#if _WIN32
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <winsock2.h>  // for socket, bind, listen, accept, recv, send, closesocket, WSAPoll, WSAStartup
+#  include <ws2tcpip.h>  // for socklen_t
+#else
+#  include <arpa/inet.h>   // for htonl, htons, ntohs
+#  include <netinet/in.h>  // for sockaddr_in, INADDR_LOOPBACK
+#  include <poll.h>        // for poll, pollfd
+#  include <sys/socket.h>  // for socket, bind, listen, accept, recv, send, setsockopt
+#  include <unistd.h>      // for close
+#endif
+
+namespace utilities::metrics {
+
+namespace {
+#if _WIN32
+  using SocketHandle = SOCKET;
+  constexpr SocketHandle invalidSocket = INVALID_SOCKET;
+
+  void closeSocket(SocketHandle s) {
+    closesocket(s);
+  }
+
+  int pollOne(SocketHandle s, int timeoutMs) {
+    WSAPOLLFD fd{s, POLLRDNORM, 0};
+    return WSAPoll(&fd, 1, timeoutMs);
+  }
+
+  // Started once for the process, and left to be cleaned up at exit
+  struct WinsockSession
+  {
+    WinsockSession() {
+      WSADATA data;
+      if (WSAStartup(MAKEWORD(2, 2), &data) != 0) {
+        throw std::runtime_error("Could not initialize Winsock");
+      }
+    }
+  };
+#else
+  using SocketHandle = int;
+  constexpr SocketHandle invalidSocket = -1;
+
+  void closeSocket(SocketHandle s) {
+    ::close(s);
+  }
+
+  int pollOne(SocketHandle s, int timeoutMs) {
+    pollfd fd{s, POLLIN, 0};
+    return ::poll(&fd, 1, timeoutMs);
+  }
+#endif
+
+#ifdef MSG_NOSIGNAL
+  constexpr int sendFlags = MSG_NOSIGNAL;  // A client hanging up must not SIGPIPE the whole application
+#else
+  constexpr int sendFlags = 0;
+#endif
+
+  // How often the accept loop checks whether it should stop
+  constexpr int pollIntervalMs = 200;
+
+  void sendAll(SocketHandle s, const std::string& data) {
+    std::size_t sent = 0;
+    while (sent < data.size()) {
+      const auto n = ::send(s, data.data() + sent, static_cast<int>(data.size() - sent), sendFlags);
+      if (n <= 0) {
+        return;
+      }
+      sent += static_cast<std::size_t>(n);
+    }
+  }
+
+  std::string httpResponse(const char* status, const char* contentType, const std::string& body) {
+    return fmt::format("HTTP/1.1 {}\r\nContent-Type: {}\r\nContent-Length: {}\r\nConnection: close\r\n\r\n{}", status, contentType, body.size(),
+                       body);
+  }
+}  // namespace
+
+TextfileExporter::TextfileExporter(const Registry& registry, std::filesystem::path outputPath, std::chrono::milliseconds interval)
+  : m_registry(registry), m_outputPath(std::move(outputPath)), m_interval(interval) {
+  // Fail early, on the calling thread, if the location isn't writable
+  writeNow();
+  m_thread = std::thread(&TextfileExporter::run, this);
+}
+
+TextfileExporter::~TextfileExporter() {
+  {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_cv.notify_one();
+  m_thread.join();
+  try {
+    writeNow();
+  } catch (const std::exception&) {  // NOLINT(bugprone-empty-catch)
+    // Nowhere to report it at this point, and the previous file is still in place
+  }
+}
+
+void TextfileExporter::writeNow() const {
+  const std::string content = m_registry.exposition();
+
+  // The textfile collector only reads *.prom, so the temporary file is ignored until renamed
+  std::filesystem::path tmpPath = m_outputPath;
+  tmpPath += ".tmp";
+  {
+    std::ofstream ofs(tmpPath, std::ios::trunc | std::ios::binary);
+    if (!ofs) {
+      throw std::runtime_error("Could not open metrics output at '" + tmpPath.string() + "'");
+    }
+    ofs.write(content.data(), static_cast<std::streamsize>(content.size()));
+    if (!ofs) {
+      throw std::runtime_error("Could not write metrics output at '" + tmpPath.string() + "'");
+    }
+  }
+  std::error_code ec;
+  std::filesystem::rename(tmpPath, m_outputPath, ec);
+  if (ec) {
+    throw std::runtime_error(fmt::format("Could not rename '{}' to '{}': {}", tmpPath.string(), m_outputPath.string(), ec.message()));
+  }
+}
+
+void TextfileExporter::run() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (!m_cv.wait_for(lock, m_interval, [this]() { return m_stop; })) {
+    lock.unlock();
+    try {
+      writeNow();
+    } catch (const std::exception&) {  // NOLINT(bugprone-empty-catch)
+      // Transient (full disk, directory being cleaned up...): retried on the next interval
+    }
+    lock.lock();
+  }
+}
+
+HttpExporter::HttpExporter(const Registry& registry, std::uint16_t port) : m_registry(registry) {
+#if _WIN32
+  static const WinsockSession winsock;
+#endif
+
+  const SocketHandle s = ::socket(AF_INET, SOCK_STREAM, 0);
+  if (s == invalidSocket) {
+    throw std::runtime_error("Could not create the metrics socket");
+  }
+
+  const int reuse = 1;
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  ::setsockopt(s, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+  sockaddr_in address;
+  std::memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = htons(port);
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  if (::bind(s, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || ::listen(s, 8) != 0) {
+    closeSocket(s);
+    throw std::runtime_error(fmt::format("Could not listen on 127.0.0.1:{} for metrics", port));
+  }
+
+  socklen_t length = sizeof(address);
+  ::getsockname(s, reinterpret_cast<sockaddr*>(&address), &length);  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+  m_port = ntohs(address.sin_port);
+
+  m_socket = static_cast<std::intptr_t>(s);
+  m_thread = std::thread(&HttpExporter::run, this);
+}
+
+HttpExporter::~HttpExporter() {
+  m_stop.store(true, std::memory_order_relaxed);
+  m_thread.join();
+  closeSocket(static_cast<SocketHandle>(m_socket));
+}
+
+void HttpExporter::run() {
+  const auto listening = static_cast<SocketHandle>(m_socket);
+  while (!m_stop.load(std::memory_order_relaxed)) {
+    if (pollOne(listening, pollIntervalMs) <= 0) {
+      continue;
+    }
+    const SocketHandle client = ::accept(listening, nullptr, nullptr);
+    if (client == invalidSocket) {
+      continue;
+    }
+    serve(static_cast<std::intptr_t>(client));
+    closeSocket(client);
+  }
+}
+
+void HttpExporter::serve(std::intptr_t client) const {
+  const auto s = static_cast<SocketHandle>(client);
+
+  // Requests are served one at a time, so a client that never sends anything must not hold the loop
+  std::string request;
+  constexpr std::size_t maxRequestSize = 8192;
+  char buffer[1024];  // NOLINT(modernize-avoid-c-arrays)
+  while (request.find("\r\n\r\n") == std::string::npos && request.size() < maxRequestSize) {
+    if (pollOne(s, 1000) <= 0) {
+      return;
+    }
+    const auto n = ::recv(s, buffer, static_cast<int>(sizeof(buffer)), 0);
+    if (n <= 0) {
+      return;
+    }
+    request.append(buffer, static_cast<std::size_t>(n));
+  }
+
+  const auto lineEnd = request.find("\r\n");
+  const std::string requestLine = request.substr(0, lineEnd);
+  const bool isGet = requestLine.rfind("GET ", 0) == 0;
+  const auto target = isGet ? requestLine.substr(4, requestLine.find(' ', 4) - 4) : std::string{};
+  if (!isGet) {
+    sendAll(s, httpResponse("405 Method Not Allowed", "text/plain", "Only GET is supported\n"));
+  } else if (target == "/metrics" || target.rfind("/metrics?", 0) == 0) {
+    sendAll(s, httpResponse("200 OK", "text/plain; version=0.0.4; charset=utf-8", m_registry.exposition()));
+  } else {
+    sendAll(s, httpResponse("404 Not Found", "text/plain", "Metrics are served at /metrics\n"));
+  }
+}
+
+}  // namespace utilities::metrics
@@ -0,0 +1,69 @@
+#ifndef UTILITIES_METRICS_EXPORTER_HPP
+#define UTILITIES_METRICS_EXPORTER_HPP
+
+#include <atomic>              // for atomic
+#include <chrono>              // for milliseconds
+#include <condition_variable>  // for condition_variable
+#include <cstdint>             // for uint16_t, intptr_t
+#include <filesystem>          // for path
+#include <mutex>               // for mutex
+#include <thread>              // for thread
+
+namespace utilities::metrics {
+
+class Registry;
+
+/// Rewrites a .prom file for the node_exporter textfile collector every interval, and once more on destruction.
+/// Written to a temporary file next to it then renamed over it, so a scrape never sees a partial file
+class TextfileExporter
+{
+ public:
+  TextfileExporter(const Registry& registry, std::filesystem::path outputPath, std::chrono::milliseconds interval);
+  TextfileExporter(const TextfileExporter&) = delete;
+  TextfileExporter& operator=(const TextfileExporter&) = delete;
+  ~TextfileExporter();
+
+  /// Throws std::runtime_error if the file can't be written
+  void writeNow() const;
+
+ private:
+  void run();
+
+  const Registry& m_registry;
+  std::filesystem::path m_outputPath;
+  std::chrono::milliseconds m_interval;
+
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  bool m_stop = false;
+  std::thread m_thread;
+};
+
+/// Serves the registry at http://127.0.0.1:<port>/metrics, one request at a time on its own thread. Only bound to the loopback interface.
+/// Port 0 picks a free port, see port(). Throws std::runtime_error if the port can't be bound
+class HttpExporter
+{
+ public:
+  HttpExporter(const Registry& registry, std::uint16_t port);
+  HttpExporter(const HttpExporter&) = delete;
+  HttpExporter& operator=(const HttpExporter&) = delete;
+  ~HttpExporter();
+
+  [[nodiscard]] std::uint16_t port() const {
+    return m_port;
+  }
+
+ private:
+  void run();
+  void serve(std::intptr_t client) const;
+
+  const Registry& m_registry;
+  std::intptr_t m_socket = -1;  // SOCKET on Windows, fd elsewhere
+  std::uint16_t m_port = 0;
+  std::atomic<bool> m_stop = false;
+  std::thread m_thread;
+};
+
+}  // namespace utilities::metrics
+
+#endif  // UTILITIES_METRICS_EXPORTER_HPP
@@ -0,0 +1,52 @@
+#include "Paths.hpp"
+
+#include <cstdlib>       // for getenv
+#include <system_error>  // for error_code
+
+namespace utilities {
+
+namespace {
+  std::filesystem::path fromEnv(const char* name) {
+    const char* value = std::getenv(name);  // NOLINT(concurrency-mt-unsafe)
+    if (value == nullptr || *value == '\0') {
+      return {};
+    }
+    return {value};
+  }
+
+  std::filesystem::path userCacheDirectory() {
+    if (auto dir = fromEnv("EPCLI_CACHE_DIR"); !dir.empty()) {
+      return dir;
+    }
+#if _WIN32
+    if (auto dir = fromEnv("LOCALAPPDATA"); !dir.empty()) {
+      return dir / "epcli";
+    }
+#elif __APPLE__
+    if (auto dir = fromEnv("HOME"); !dir.empty()) {
+      return dir / "Library" / "Caches" / "epcli";
+    }
+#else
+    if (auto dir = fromEnv("XDG_CACHE_HOME"); !dir.empty()) {
+      return dir / "epcli";
+    }
+    if (auto dir = fromEnv("HOME"); !dir.empty()) {
+      return dir / ".cache" / "epcli";
+    }
+#endif
+    return std::filesystem::temp_directory_path() / "epcli";
+  }
+}  // namespace
+
+std::filesystem::path cacheDirectory() {
+  std::filesystem::path dir = userCacheDirectory();
+  std::error_code ec;
+  std::filesystem::create_directories(dir, ec);
+  if (ec) {
+    dir = std::filesystem::temp_directory_path() / "epcli";
+    std::filesystem::create_directories(dir, ec);
+  }
+  return dir;
+}
+
+}  // namespace utilities
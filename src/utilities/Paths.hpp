@@ -0,0 +1,14 @@
+#ifndef UTILITIES_PATHS_HPP
+#define UTILITIES_PATHS_HPP
+
+#include <filesystem>  // for path
+
+namespace utilities {
+
+/// Where epcli keeps the data it can rebuild at will (index databases, parsed weather files...): $EPCLI_CACHE_DIR if set, otherwise the
+/// platform's user cache directory (eg: ~/.cache/epcli), falling back to the temp directory. It is created if it doesn't exist
+std::filesystem::path cacheDirectory();
+
+}  // namespace utilities
+
+#endif  // UTILITIES_PATHS_HPP
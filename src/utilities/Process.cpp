@@ -0,0 +1,118 @@
+#include "Process.hpp"
+
+#if _WIN32
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <windows.h>  // for GetCurrentProcess, GetCurrentProcessId, GetComputerNameA, GlobalMemoryStatusEx
+#  include <psapi.h>    // for GetProcessMemoryInfo, PROCESS_MEMORY_COUNTERS
+#elif __APPLE__
+#  include <mach/mach.h>  // for task_info, mach_task_self, MACH_TASK_BASIC_INFO, host_statistics64, HOST_VM_INFO64
+#  include <unistd.h>     // for gethostname, getpid
+#else
+#  include <unistd.h>  // for sysconf, gethostname, getpid
+
+#  include <exception>  // for exception
+#  include <fstream>    // for ifstream
+#  include <string>     // for string, stod
+#endif
+
+#include <array>  // for array
+
+#include <fmt/format.h>  // for format
+
+namespace utilities {
+
+std::size_t residentSetSize() {
+#if _WIN32
+  PROCESS_MEMORY_COUNTERS counters;
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) == 0) {
+    return 0;
+  }
+  return counters.WorkingSetSize;
+#elif __APPLE__
+  mach_task_basic_info info;
+  mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+  if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) != KERN_SUCCESS) {
+    return 0;
+  }
+  return info.resident_size;
+#else
+  // statm: size resident shared text lib data dt, in pages
+  std::ifstream ifs("/proc/self/statm");
+  std::size_t size = 0;
+  std::size_t resident = 0;
+  if (!(ifs >> size >> resident)) {
+    return 0;
+  }
+  return resident * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+std::size_t availableMemory() {
+#if _WIN32
+  MEMORYSTATUSEX status;
+  status.dwLength = sizeof(status);
+  if (GlobalMemoryStatusEx(&status) == 0) {
+    return 0;
+  }
+  return static_cast<std::size_t>(status.ullAvailPhys);
+#elif __APPLE__
+  vm_statistics64_data_t stats;
+  mach_msg_type_number_t count = HOST_VM_INFO64_COUNT;
+  if (host_statistics64(mach_host_self(), HOST_VM_INFO64, reinterpret_cast<host_info64_t>(&stats), &count) != KERN_SUCCESS) {
+    return 0;
+  }
+  // Inactive pages are reclaimed before anything gets swapped
+  return (static_cast<std::size_t>(stats.free_count) + stats.inactive_count) * vm_page_size;
+#else
+  std::ifstream ifs("/proc/meminfo");
+  std::string key;
+  std::size_t kiloBytes = 0;
+  std::string unit;
+  while (ifs >> key >> kiloBytes >> unit) {
+    if (key == "MemAvailable:") {
+      return kiloBytes * 1024;
+    }
+  }
+  return 0;
+#endif
+}
+
+double memoryPressure() {
+#if _WIN32 || __APPLE__
+  return -1.0;
+#else
+  // some avg10=0.00 avg60=0.00 avg300=0.00 total=0
+  std::ifstream ifs("/proc/pressure/memory");
+  std::string kind;
+  std::string avg10;
+  if (!(ifs >> kind >> avg10) || kind != "some" || avg10.rfind("avg10=", 0) != 0) {
+    return -1.0;
+  }
+  try {
+    return std::stod(avg10.substr(6));
+  } catch (const std::exception&) {
+    return -1.0;
+  }
+#endif
+}
+
+std::string nodeName() {
+  std::array<char, 256> host{};
+#if _WIN32
+  auto size = static_cast<DWORD>(host.size());
+  if (GetComputerNameA(host.data(), &size) == 0) {
+    host[0] = '\0';
+  }
+  const auto pid = static_cast<unsigned long>(GetCurrentProcessId());
+#else
+  if (gethostname(host.data(), host.size() - 1) != 0) {
+    host[0] = '\0';
+  }
+  const auto pid = static_cast<unsigned long>(getpid());
+#endif
+  return fmt::format("{}:{}", host[0] != '\0' ? host.data() : "unknown", pid);
+}
+
+}  // namespace utilities
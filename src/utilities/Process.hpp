@@ -0,0 +1,24 @@
+#ifndef UTILITIES_PROCESS_HPP
+#define UTILITIES_PROCESS_HPP
+
+#include <cstddef>  // for size_t
+#include <string>   // for string
+
+namespace utilities {
+
+/// Resident set size of the current process in bytes, 0 if it can't be determined
+std::size_t residentSetSize();
+
+/// Physical memory the system can hand out without swapping (Linux: MemAvailable), 0 if it can't be determined
+std::size_t availableMemory();
+
+/// Linux pressure stall information: the share of the last 10 seconds some tasks spent waiting for memory, in percent. -1 where the system
+/// doesn't report it
+double memoryPressure();
+
+/// <host name>:<pid>, to tell apart the processes sharing work through a file
+std::string nodeName();
+
+}  // namespace utilities
+
+#endif  // UTILITIES_PROCESS_HPP
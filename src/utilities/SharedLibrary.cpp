@@ -0,0 +1,55 @@
+#include "SharedLibrary.hpp"
+
+#include <fmt/format.h>  // for format
+
+#include <stdexcept>  // for runtime_error
+#include <string>     // for string
+
+#if _WIN32
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <windows.h>  // for LoadLibraryW, GetProcAddress, FreeLibrary, GetLastError
+#else
+#  include <dlfcn.h>  // for dlopen, dlsym, dlclose, dlerror
+#endif
+
+namespace utilities {
+
+SharedLibrary::SharedLibrary(const std::filesystem::path& path) : m_path(path) {
+#if _WIN32
+  m_handle = static_cast<void*>(LoadLibraryW(path.c_str()));
+  if (m_handle == nullptr) {
+    throw std::runtime_error(fmt::format("Could not load '{}': error {}", path.string(), GetLastError()));
+  }
+#else
+  // RTLD_LOCAL: plugins don't get to interpose symbols on each other
+  m_handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+  if (m_handle == nullptr) {
+    const char* err = dlerror();
+    throw std::runtime_error(fmt::format("Could not load '{}': {}", path.string(), (err != nullptr) ? err : "unknown error"));
+  }
+#endif
+}
+
+SharedLibrary::~SharedLibrary() {
+#if _WIN32
+  FreeLibrary(static_cast<HMODULE>(m_handle));
+#else
+  dlclose(m_handle);
+#endif
+}
+
+void* SharedLibrary::symbol(const char* name) const {
+#if _WIN32
+  return reinterpret_cast<void*>(GetProcAddress(static_cast<HMODULE>(m_handle), name));  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+#else
+  return dlsym(m_handle, name);
+#endif
+}
+
+const std::filesystem::path& SharedLibrary::path() const {
+  return m_path;
+}
+
+}  // namespace utilities
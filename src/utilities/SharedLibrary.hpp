@@ -0,0 +1,30 @@
+#ifndef UTILITIES_SHAREDLIBRARY_HPP
+#define UTILITIES_SHAREDLIBRARY_HPP
+
+#include <filesystem>  // for path
+
+namespace utilities {
+
+/// A shared library loaded at runtime (dlopen / LoadLibrary), unloaded on destruction
+class SharedLibrary
+{
+ public:
+  /// Throws std::runtime_error if the library cannot be loaded
+  explicit SharedLibrary(const std::filesystem::path& path);
+  SharedLibrary(const SharedLibrary&) = delete;
+  SharedLibrary& operator=(const SharedLibrary&) = delete;
+  ~SharedLibrary();
+
+  /// Returns nullptr if the symbol isn't exported
+  [[nodiscard]] void* symbol(const char* name) const;
+
+  [[nodiscard]] const std::filesystem::path& path() const;
+
+ private:
+  std::filesystem::path m_path;
+  void* m_handle = nullptr;
+};
+
+}  // namespace utilities
+
+#endif  // UTILITIES_SHAREDLIBRARY_HPP
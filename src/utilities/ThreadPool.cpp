@@ -0,0 +1,50 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>  // for max
+#include <utility>    // for move
+
+namespace utilities {
+
+ThreadPool::ThreadPool(unsigned numThreads) {
+  if (numThreads == 0) {
+    numThreads = std::max(1U, std::thread::hardware_concurrency());
+  }
+  m_workers.reserve(numThreads);
+  for (unsigned i = 0; i < numThreads; ++i) {
+    m_workers.emplace_back([this]() { workerLoop(); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopping = true;
+  }
+  m_condition.notify_all();
+  for (auto& worker : m_workers) {
+    worker.join();
+  }
+}
+
+unsigned ThreadPool::size() const {
+  return static_cast<unsigned>(m_workers.size());
+}
+
+void ThreadPool::workerLoop() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_condition.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+      if (m_tasks.empty()) {
+        // Stopping, and nothing left to do
+        return;
+      }
+      task = std::move(m_tasks.front());
+      m_tasks.pop_front();
+    }
+    task();
+  }
+}
+
+}  // namespace utilities
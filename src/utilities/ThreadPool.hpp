@@ -0,0 +1,56 @@
+#ifndef UTILITIES_THREADPOOL_HPP
+#define UTILITIES_THREADPOOL_HPP
+
+#include <condition_variable>  // for condition_variable
+#include <deque>               // for deque
+#include <functional>          // for function
+#include <future>              // for future, packaged_task
+#include <memory>              // for make_shared
+#include <mutex>               // for mutex, lock_guard
+#include <thread>              // for thread
+#include <type_traits>         // for invoke_result_t
+#include <utility>             // for forward
+#include <vector>              // for vector
+
+namespace utilities {
+
+/// A fixed size pool of worker threads that process tasks in FIFO order
+class ThreadPool
+{
+ public:
+  // numThreads = 0 means std::thread::hardware_concurrency()
+  explicit ThreadPool(unsigned numThreads = 0);
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // Finishes processing all the queued tasks, then joins the workers
+  ~ThreadPool();
+
+  [[nodiscard]] unsigned size() const;
+
+  template <typename F>
+  std::future<std::invoke_result_t<F>> submit(F&& f) {
+    // std::function needs to be copyable, and std::packaged_task isn't
+    auto task = std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>(std::forward<F>(f));
+    auto result = task->get_future();
+    {
+      const std::lock_guard<std::mutex> lock(m_mutex);
+      m_tasks.emplace_back([task]() { (*task)(); });
+    }
+    m_condition.notify_one();
+    return result;
+  }
+
+ private:
+  void workerLoop();
+
+  std::vector<std::thread> m_workers;
+  std::deque<std::function<void()>> m_tasks;
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  bool m_stopping = false;
+};
+
+}  // namespace utilities
+
+#endif  // UTILITIES_THREADPOOL_HPP
@@ -0,0 +1,207 @@
+#include "Trace.hpp"
+
+#include <fmt/format.h>  // for format_to, memory_buffer
+
+#include <array>      // for array
+#include <atomic>     // for atomic
+#include <cstddef>    // for size_t
+#include <cstdint>    // for int64_t
+#include <fstream>    // for ofstream
+#include <iterator>   // for back_inserter
+#include <memory>     // for unique_ptr, make_unique
+#include <mutex>      // for mutex, lock_guard
+#include <stdexcept>  // for runtime_error
+#include <vector>     // for vector
+
+namespace utilities::trace {
+
+namespace {
+  using Clock = std::chrono::steady_clock;
+
+  enum class EventType : char
+  {
+    Complete,
+    Counter,
+  };
+
+  struct Event
+  {
+    const char* name;
+    std::int64_t timestamp;  // ns since the epoch
+    std::int64_t duration;   // ns, Complete only
+    double value;            // Counter only
+    EventType type;
+  };
+
+  constexpr std::size_t chunkSize = 4096;
+
+  struct Chunk
+  {
+    std::array<Event, chunkSize> events;
+    // Published with release once the event is written, so the writer never waits on the reader
+    std::atomic<std::size_t> count = 0;
+    std::atomic<Chunk*> next = nullptr;
+  };
+
+  struct ThreadBuffer
+  {
+    explicit ThreadBuffer(int t_threadId) : threadId(t_threadId), head(new Chunk), tail(head) {}
+    ThreadBuffer(const ThreadBuffer&) = delete;
+    ThreadBuffer& operator=(const ThreadBuffer&) = delete;
+    ~ThreadBuffer() {
+      Chunk* chunk = head;
+      while (chunk != nullptr) {
+        Chunk* next = chunk->next.load(std::memory_order_relaxed);
+        delete chunk;
+        chunk = next;
+      }
+    }
+
+    // Writer side only
+    void append(const Event& event) {
+      std::size_t count = tail->count.load(std::memory_order_relaxed);
+      if (count == chunkSize) {
+        auto* chunk = new Chunk;
+        tail->next.store(chunk, std::memory_order_release);
+        tail = chunk;
+        count = 0;
+      }
+      tail->events[count] = event;
+      tail->count.store(count + 1, std::memory_order_release);
+    }
+
+    // Reader side, under g_registryMutex: the chunks before the last one are no longer written to, they are freed, and the events the
+    // last one already holds are skipped
+    void discard() {
+      Chunk* next = head->next.load(std::memory_order_acquire);
+      while (next != nullptr) {
+        delete head;
+        head = next;
+        next = head->next.load(std::memory_order_acquire);
+      }
+      skipped = head->count.load(std::memory_order_acquire);
+    }
+
+    int threadId;
+    std::atomic<const char*> name = nullptr;
+    // The writer only uses tail, head and skipped are only used under g_registryMutex
+    Chunk* head;
+    Chunk* tail;
+    std::size_t skipped = 0;
+  };
+
+  std::atomic<bool> g_enabled = false;
+  Clock::time_point g_epoch;
+
+  // Buffers outlive their threads, so that events recorded by threads that already exited still get written
+  std::mutex g_registryMutex;
+  std::vector<std::unique_ptr<ThreadBuffer>> g_buffers;
+
+  ThreadBuffer& localBuffer() {
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (buffer == nullptr) {
+      const std::lock_guard<std::mutex> lock(g_registryMutex);
+      g_buffers.emplace_back(std::make_unique<ThreadBuffer>(static_cast<int>(g_buffers.size()) + 1));
+      buffer = g_buffers.back().get();
+    }
+    return *buffer;
+  }
+
+  std::int64_t sinceEpoch(Clock::time_point t) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t - g_epoch).count();
+  }
+
+  void writeEscaped(fmt::memory_buffer& out, const char* s) {
+    for (; *s != '\0'; ++s) {
+      if (*s == '"' || *s == '\\') {
+        out.push_back('\\');
+      }
+      out.push_back(*s);
+    }
+  }
+}  // namespace
+
+void start() {
+  {
+    // The events of a previous recording are relative to its own epoch
+    const std::lock_guard<std::mutex> lock(g_registryMutex);
+    for (const auto& buffer : g_buffers) {
+      buffer->discard();
+    }
+  }
+  g_epoch = Clock::now();
+  g_enabled.store(true, std::memory_order_release);
+}
+
+bool isEnabled() {
+  return g_enabled.load(std::memory_order_acquire);
+}
+
+void setThreadName(const char* name) {
+  localBuffer().name.store(name, std::memory_order_release);
+}
+
+void complete(const char* name, Clock::time_point start, Clock::time_point end) {
+  const auto startNs = sinceEpoch(start);
+  localBuffer().append(Event{name, startNs, sinceEpoch(end) - startNs, 0.0, EventType::Complete});
+}
+
+void counter(const char* name, double value) {
+  localBuffer().append(Event{name, sinceEpoch(Clock::now()), 0, value, EventType::Counter});
+}
+
+void stopAndWrite(const std::filesystem::path& outputPath) {
+  g_enabled.store(false, std::memory_order_release);
+
+  std::ofstream ofs(outputPath, std::ios::trunc | std::ios::binary);
+  if (!ofs) {
+    throw std::runtime_error("Could not open trace output at '" + outputPath.string() + "'");
+  }
+
+  fmt::memory_buffer out;
+  auto it = std::back_inserter(out);
+  bool first = true;
+  auto separator = [&]() {
+    fmt::format_to(it, "{}\n", first ? "" : ",");
+    first = false;
+  };
+  auto flushIfLarge = [&]() {
+    if (out.size() > (1U << 20U)) {
+      ofs.write(out.data(), static_cast<std::streamsize>(out.size()));
+      out.clear();
+    }
+  };
+
+  fmt::format_to(it, "{{\"displayTimeUnit\": \"ms\", \"traceEvents\": [");
+
+  const std::lock_guard<std::mutex> lock(g_registryMutex);
+  for (const auto& buffer : g_buffers) {
+    if (const char* name = buffer->name.load(std::memory_order_acquire); name != nullptr) {
+      separator();
+      fmt::format_to(it, R"({{"ph": "M", "pid": 1, "tid": {}, "name": "thread_name", "args": {{"name": ")", buffer->threadId);
+      writeEscaped(out, name);
+      fmt::format_to(it, "\"}}}}");
+    }
+
+    for (const Chunk* chunk = buffer->head; chunk != nullptr; chunk = chunk->next.load(std::memory_order_acquire)) {
+      const std::size_t count = chunk->count.load(std::memory_order_acquire);
+      for (std::size_t i = (chunk == buffer->head) ? buffer->skipped : 0; i < count; ++i) {
+        const Event& event = chunk->events[i];
+        separator();
+        fmt::format_to(it, R"({{"pid": 1, "tid": {}, "ts": {:.3f}, "name": ")", buffer->threadId, static_cast<double>(event.timestamp) / 1000.0);
+        writeEscaped(out, event.name);
+        if (event.type == EventType::Complete) {
+          fmt::format_to(it, R"(", "ph": "X", "dur": {:.3f}}})", static_cast<double>(event.duration) / 1000.0);
+        } else {
+          fmt::format_to(it, R"(", "ph": "C", "args": {{"value": {}}}}})", event.value);
+        }
+        flushIfLarge();
+      }
+    }
+  }
+
+  fmt::format_to(it, "\n]}}\n");
+  ofs.write(out.data(), static_cast<std::streamsize>(out.size()));
+}
+
+}  // namespace utilities::trace
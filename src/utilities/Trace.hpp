@@ -0,0 +1,75 @@
+#ifndef UTILITIES_TRACE_HPP
+#define UTILITIES_TRACE_HPP
+
+#include <chrono>      // for steady_clock
+#include <filesystem>  // for path
+
+namespace utilities::trace {
+
+/// Lightweight tracing to the Chrome trace event format (chrome://tracing, https://ui.perfetto.dev).
+/// Each thread appends to its own buffer (chunked, never reallocated, published with release stores) so recording takes no lock.
+/// Names must be string literals: only the pointer is stored.
+/// Use the EPCLI_TRACE_* macros below, which compile to nothing unless EPCLI_ENABLE_TRACING is defined. When compiled in but not started,
+/// each of them costs one atomic load
+
+/// Whether the instrumentation was compiled in
+constexpr bool compiledIn() {
+#ifdef EPCLI_ENABLE_TRACING
+  return true;
+#else
+  return false;
+#endif
+}
+
+/// Starts recording, discarding any previous events
+void start();
+[[nodiscard]] bool isEnabled();
+/// Stops recording and writes everything recorded so far. Threads still running may lose their last events.
+/// Throws std::runtime_error if the file can't be written
+void stopAndWrite(const std::filesystem::path& outputPath);
+
+void setThreadName(const char* name);
+void complete(const char* name, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end);
+void counter(const char* name, double value);
+
+class ScopedSpan
+{
+ public:
+  explicit ScopedSpan(const char* name) : m_name(isEnabled() ? name : nullptr) {
+    if (m_name != nullptr) {
+      m_start = std::chrono::steady_clock::now();
+    }
+  }
+  ScopedSpan(const ScopedSpan&) = delete;
+  ScopedSpan& operator=(const ScopedSpan&) = delete;
+  ~ScopedSpan() {
+    if (m_name != nullptr) {
+      complete(m_name, m_start, std::chrono::steady_clock::now());
+    }
+  }
+
+ private:
+  const char* m_name;
+  std::chrono::steady_clock::time_point m_start;
+};
+
+}  // namespace utilities::trace
+
+#ifdef EPCLI_ENABLE_TRACING
+#  define EPCLI_TRACE_CONCAT_IMPL(a, b) a##b
+#  define EPCLI_TRACE_CONCAT(a, b) EPCLI_TRACE_CONCAT_IMPL(a, b)
+#  define EPCLI_TRACE_SCOPE(name) const utilities::trace::ScopedSpan EPCLI_TRACE_CONCAT(epcliTraceSpan, __LINE__)(name)
+#  define EPCLI_TRACE_COUNTER(name, value)                            \
+    do {                                                              \
+      if (utilities::trace::isEnabled()) {                            \
+        utilities::trace::counter(name, static_cast<double>(value)); \
+      }                                                               \
+    } while (false)
+#  define EPCLI_TRACE_THREAD_NAME(name) utilities::trace::setThreadName(name)
+#else
+#  define EPCLI_TRACE_SCOPE(name) static_cast<void>(0)
+#  define EPCLI_TRACE_COUNTER(name, value) static_cast<void>(0)
+#  define EPCLI_TRACE_THREAD_NAME(name) static_cast<void>(0)
+#endif
+
+#endif  // UTILITIES_TRACE_HPP
@@ -0,0 +1,117 @@
+#include "WorkStealingPool.hpp"
+
+#include "CpuTopology.hpp"  // for cpuPlacementOrder, pinCurrentThread
+
+#include <algorithm>  // for max
+#include <utility>    // for move
+
+namespace utilities {
+
+namespace {
+  // Which pool, and which of its queues, the current thread works for
+  thread_local const WorkStealingPool* currentPool = nullptr;
+  thread_local unsigned currentQueue = 0;
+}  // namespace
+
+WorkStealingPool::WorkStealingPool(unsigned numThreads, bool pinThreads) {
+  if (numThreads == 0) {
+    numThreads = std::max(1U, std::thread::hardware_concurrency());
+  }
+  m_queues.reserve(numThreads);
+  for (unsigned i = 0; i < numThreads; ++i) {
+    m_queues.emplace_back(std::make_unique<Queue>());
+  }
+  const std::vector<int> placement = pinThreads ? cpuPlacementOrder() : std::vector<int>{};
+  m_workers.reserve(numThreads);
+  for (unsigned i = 0; i < numThreads; ++i) {
+    // More workers than CPUs: they share them in the same order
+    const int cpu = placement.empty() ? -1 : placement[i % placement.size()];
+    m_workers.emplace_back([this, i, cpu]() { workerLoop(i, cpu); });
+  }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+  {
+    const std::lock_guard<std::mutex> lock(m_sleepMutex);
+    m_stopping = true;
+  }
+  m_wakeUp.notify_all();
+  for (auto& worker : m_workers) {
+    worker.join();
+  }
+}
+
+unsigned WorkStealingPool::size() const {
+  return static_cast<unsigned>(m_workers.size());
+}
+
+void WorkStealingPool::submit(std::function<void()> task) {
+  m_pending.fetch_add(1);
+  const unsigned index = currentPool == this ? currentQueue : m_nextQueue.fetch_add(1, std::memory_order_relaxed) % size();
+  {
+    const std::lock_guard<std::mutex> lock(m_queues[index]->mutex);
+    m_queues[index]->tasks.emplace_back(std::move(task));
+  }
+  {
+    // Under the lock, or a worker could check m_queued, then miss the notification before it waits
+    const std::lock_guard<std::mutex> lock(m_sleepMutex);
+    m_queued.fetch_add(1);
+  }
+  m_wakeUp.notify_one();
+}
+
+void WorkStealingPool::wait() {
+  std::unique_lock<std::mutex> lock(m_sleepMutex);
+  m_idle.wait(lock, [this]() { return m_pending.load() == 0; });
+}
+
+bool WorkStealingPool::tryPop(unsigned self, std::function<void()>& task) {
+  {
+    auto& own = *m_queues[self];
+    const std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.tasks.empty()) {
+      task = std::move(own.tasks.back());
+      own.tasks.pop_back();
+      return true;
+    }
+  }
+  const auto numQueues = static_cast<unsigned>(m_queues.size());
+  for (unsigned offset = 1; offset < numQueues; ++offset) {
+    auto& victim = *m_queues[(self + offset) % numQueues];
+    const std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.tasks.empty()) {
+      task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+void WorkStealingPool::workerLoop(unsigned self, int cpu) {
+  if (cpu >= 0) {
+    pinCurrentThread(cpu);
+  }
+  currentPool = this;
+  currentQueue = self;
+  while (true) {
+    std::function<void()> task;
+    if (tryPop(self, task)) {
+      m_queued.fetch_sub(1);
+      task();
+      if (m_pending.fetch_sub(1) == 1) {
+        const std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_idle.notify_all();
+      }
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(m_sleepMutex);
+    m_wakeUp.wait(lock, [this]() { return m_stopping || m_queued.load() > 0; });
+    if (m_stopping && m_queued.load() == 0) {
+      // Stopping, and nothing left to do
+      return;
+    }
+  }
+}
+
+}  // namespace utilities
@@ -0,0 +1,63 @@
+#ifndef UTILITIES_WORKSTEALINGPOOL_HPP
+#define UTILITIES_WORKSTEALINGPOOL_HPP
+
+#include <atomic>              // for atomic
+#include <condition_variable>  // for condition_variable
+#include <cstddef>             // for size_t
+#include <deque>               // for deque
+#include <functional>          // for function
+#include <memory>              // for unique_ptr
+#include <mutex>               // for mutex
+#include <thread>              // for thread
+#include <vector>              // for vector
+
+namespace utilities {
+
+/// A fixed size pool where each worker has its own queue: it takes its most recent task first, and when it runs dry steals the oldest task
+/// of another worker. Unlike ThreadPool, workers don't contend on a single lock, and tasks of very uneven length (simulations of 10s and
+/// of 10min) keep every worker busy until the end
+class WorkStealingPool
+{
+ public:
+  // numThreads = 0 means std::thread::hardware_concurrency(). pinThreads pins each worker to its own CPU, in cpuPlacementOrder()
+  explicit WorkStealingPool(unsigned numThreads = 0, bool pinThreads = false);
+  WorkStealingPool(const WorkStealingPool&) = delete;
+  WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+  // Finishes processing all the queued tasks, then joins the workers
+  ~WorkStealingPool();
+
+  [[nodiscard]] unsigned size() const;
+
+  /// From a worker, onto its own queue. From any other thread, round robin over the queues. The task must not throw
+  void submit(std::function<void()> task);
+
+  /// Blocks until every task submitted so far has run
+  void wait();
+
+ private:
+  struct Queue
+  {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  bool tryPop(unsigned self, std::function<void()>& task);
+  void workerLoop(unsigned self, int cpu);
+
+  std::vector<std::unique_ptr<Queue>> m_queues;
+  std::vector<std::thread> m_workers;
+  std::atomic<unsigned> m_nextQueue = 0;
+  /// Queued and not yet taken by a worker
+  std::atomic<std::size_t> m_queued = 0;
+  /// Submitted and not yet finished
+  std::atomic<std::size_t> m_pending = 0;
+  std::mutex m_sleepMutex;
+  std::condition_variable m_wakeUp;
+  std::condition_variable m_idle;
+  bool m_stopping = false;
+};
+
+}  // namespace utilities
+
+#endif  // UTILITIES_WORKSTEALINGPOOL_HPP
@@ -0,0 +1,470 @@
+#include "WeatherData.hpp"
+
+#include "../utilities/Hash.hpp"        // for fnv1a64, toHex
+#include "../utilities/MappedFile.hpp"  // for MappedFile
+#include "../utilities/Paths.hpp"       // for cacheDirectory
+#include "../utilities/Trace.hpp"       // for EPCLI_TRACE_SCOPE
+
+#include <fmt/format.h>  // for format
+#include <fmt/std.h>     // for formatting std::filesystem::path // IWYU pragma: keep
+
+#include <algorithm>     // for sort, min, max, copy_n
+#include <charconv>      // for from_chars
+#include <chrono>        // for duration_cast, nanoseconds
+#include <cmath>         // for isnan, floor
+#include <cstring>       // for memcpy
+#include <exception>     // for exception
+#include <fstream>       // for ofstream
+#include <limits>        // for numeric_limits
+#include <random>        // for random_device
+#include <stdexcept>     // for runtime_error
+#include <string_view>   // for string_view
+#include <system_error>  // for error_code, errc
+#include <utility>       // for pair
+
+namespace weather {
+
+namespace {
+  // Bump whenever the cache layout changes, so older ones get rebuilt
+  constexpr std::uint32_t cacheVersion = 1;
+  constexpr std::array<char, 8> cacheMagic = {'E', 'P', 'C', 'L', 'I', 'W', 'X', '\0'};
+
+  // The start of a cache file. It is followed by the months, days and hours (numRecords bytes each), padding to a multiple of 4, then
+  // numColumns columns of numRecords floats
+  struct CacheHeader
+  {
+    std::array<char, 8> magic = cacheMagic;
+    std::uint32_t version = cacheVersion;
+    std::uint32_t numRecords = 0;
+    std::uint64_t sourceSize = 0;
+    std::int64_t sourceModifiedTime = 0;
+    double latitude = 0.0;
+    double longitude = 0.0;
+    double timeZone = 0.0;
+    double elevation = 0.0;
+    std::uint32_t recordsPerHour = 1;
+    std::uint32_t numColumns = static_cast<std::uint32_t>(weather::numColumns);
+    // city, region, country and WMO station, each NUL-terminated
+    std::array<char, 256> names{};
+  };
+  static_assert(sizeof(CacheHeader) == 328);
+
+  std::size_t floatsOffset(std::size_t numRecords) {
+    return sizeof(CacheHeader) + (3 * numRecords + 3) / 4 * 4;
+  }
+
+  std::size_t cacheSize(std::size_t numRecords) {
+    return floatsOffset(numRecords) + numColumns * numRecords * sizeof(float);
+  }
+
+  // What the cache must have been built from
+  struct SourceIdentity
+  {
+    std::uint64_t size = 0;
+    std::int64_t modifiedTime = 0;
+  };
+
+  SourceIdentity sourceIdentity(const std::filesystem::path& epwPath) {
+    return {std::filesystem::file_size(epwPath),
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::filesystem::last_write_time(epwPath).time_since_epoch()).count()};
+  }
+
+  // Field index in a data line, and the value EPW uses for missing data (anything at or above it)
+  constexpr std::array<std::pair<std::size_t, float>, numColumns> columnFields = {{
+    {6, 99.9F},      // DryBulb
+    {7, 99.9F},      // DewPoint
+    {8, 999.0F},     // RelativeHumidity
+    {9, 999999.0F},  // Pressure
+    {13, 9999.0F},   // GlobalHorizontal
+    {14, 9999.0F},   // DirectNormal
+    {15, 9999.0F},   // DiffuseHorizontal
+    {20, 999.0F},    // WindDirection
+    {21, 999.0F},    // WindSpeed
+    {22, 99.0F},     // TotalSkyCover
+  }};
+  constexpr std::size_t minDataFields = 23;
+
+  std::string_view trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) {
+      s.remove_prefix(1);
+    }
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r')) {
+      s.remove_suffix(1);
+    }
+    return s;
+  }
+
+  template <typename T>
+  bool parseNumber(std::string_view field, T& value) {
+    field = trim(field);
+    if (!field.empty() && field.front() == '+') {
+      field.remove_prefix(1);
+    }
+    const auto [end, ec] = std::from_chars(field.data(), field.data() + field.size(), value);
+    return ec == std::errc() && end == field.data() + field.size() && !field.empty();
+  }
+
+  // Splits at commas into fields, up to fields.size(). Returns the number of fields found
+  template <std::size_t N>
+  std::size_t splitFields(std::string_view line, std::array<std::string_view, N>& fields) {
+    std::size_t count = 0;
+    while (count < N) {
+      const auto comma = line.find(',');
+      fields[count++] = line.substr(0, comma);
+      if (comma == std::string_view::npos) {
+        break;
+      }
+      line.remove_prefix(comma + 1);
+    }
+    return count;
+  }
+
+  void copyNames(const std::array<std::string_view, 4>& names, std::array<char, 256>& out) {
+    std::size_t pos = 0;
+    for (const auto name : names) {
+      const auto length = std::min(name.size(), out.size() / names.size() - 1);
+      std::copy_n(name.data(), length, out.data() + pos);
+      pos += length;
+      out[pos++] = '\0';
+    }
+  }
+
+  // Parses the EPW into the layout of a cache file
+  std::vector<char> buildCache(const std::filesystem::path& epwPath, const SourceIdentity& identity) {
+    EPCLI_TRACE_SCOPE("weather::buildCache");
+    const utilities::MappedFile file(epwPath);
+    std::string_view text = file.view();
+
+    CacheHeader header;
+    header.sourceSize = identity.size;
+    header.sourceModifiedTime = identity.modifiedTime;
+    std::vector<std::uint8_t> dates;  // month, day, hour for each record
+    std::array<std::vector<float>, numColumns> columns;
+    for (auto& column : columns) {
+      column.reserve(8760);
+    }
+
+    bool inData = false;
+    std::size_t lineNumber = 0;
+    std::array<std::string_view, minDataFields> fields;
+    while (!text.empty()) {
+      const auto eol = text.find('\n');
+      const std::string_view line = trim(text.substr(0, eol));
+      text.remove_prefix(eol == std::string_view::npos ? text.size() : eol + 1);
+      ++lineNumber;
+      if (line.empty()) {
+        continue;
+      }
+      const auto numFields = splitFields(line, fields);
+      if (!inData) {
+        // The header lines, up to DATA PERIODS
+        if (fields[0] == "LOCATION" && numFields >= 10) {
+          copyNames({trim(fields[1]), trim(fields[2]), trim(fields[3]), trim(fields[5])}, header.names);
+          parseNumber(fields[6], header.latitude);
+          parseNumber(fields[7], header.longitude);
+          parseNumber(fields[8], header.timeZone);
+          parseNumber(fields[9], header.elevation);
+        } else if (fields[0] == "DATA PERIODS") {
+          if (numFields < 3 || !parseNumber(fields[2], header.recordsPerHour) || header.recordsPerHour < 1 || header.recordsPerHour > 60) {
+            throw std::runtime_error(fmt::format("{}: line {}: invalid number of records per hour", epwPath, lineNumber));
+          }
+          inData = true;
+        }
+        continue;
+      }
+
+      if (numFields < minDataFields) {
+        throw std::runtime_error(fmt::format("{}: line {}: expected at least {} fields, found {}", epwPath, lineNumber, minDataFields, numFields));
+      }
+      std::array<unsigned, 3> date{};
+      for (std::size_t i = 0; i < date.size(); ++i) {
+        if (!parseNumber(fields[i + 1], date[i])) {
+          throw std::runtime_error(fmt::format("{}: line {}: invalid date '{}'", epwPath, lineNumber, fields[i + 1]));
+        }
+      }
+      if (date[0] < 1 || date[0] > 12 || date[1] < 1 || date[1] > 31 || date[2] < 1 || date[2] > 24) {
+        throw std::runtime_error(fmt::format("{}: line {}: invalid date {}/{} hour {}", epwPath, lineNumber, date[0], date[1], date[2]));
+      }
+      for (const auto part : date) {
+        dates.push_back(static_cast<std::uint8_t>(part));
+      }
+      for (std::size_t c = 0; c < numColumns; ++c) {
+        const auto [index, missing] = columnFields[c];
+        float value = 0.0F;
+        // Some generators leave the fields they don't have blank
+        if (!parseNumber(fields[index], value) || value >= missing) {
+          value = std::numeric_limits<float>::quiet_NaN();
+        }
+        columns[c].push_back(value);
+      }
+    }
+    if (!inData) {
+      throw std::runtime_error(fmt::format("{}: not an EPW file, there is no DATA PERIODS line", epwPath));
+    }
+    const std::size_t numRecords = columns[0].size();
+    if (numRecords == 0) {
+      throw std::runtime_error(fmt::format("{}: no weather data", epwPath));
+    }
+    header.numRecords = static_cast<std::uint32_t>(numRecords);
+
+    std::vector<char> bytes(cacheSize(numRecords));
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    // Columns rather than rows: a query reads only the columns it needs
+    for (std::size_t r = 0; r < numRecords; ++r) {
+      for (std::size_t part = 0; part < 3; ++part) {
+        bytes[sizeof(header) + part * numRecords + r] = static_cast<char>(dates[3 * r + part]);
+      }
+    }
+    for (std::size_t c = 0; c < numColumns; ++c) {
+      std::memcpy(bytes.data() + floatsOffset(numRecords) + c * numRecords * sizeof(float), columns[c].data(), numRecords * sizeof(float));
+    }
+    return bytes;
+  }
+
+  bool isUpToDate(const utilities::MappedFile& cache, const SourceIdentity& identity) {
+    if (cache.size() < sizeof(CacheHeader)) {
+      return false;
+    }
+    CacheHeader header;
+    std::memcpy(&header, cache.view().data(), sizeof(header));
+    return header.magic == cacheMagic && header.version == cacheVersion && header.numColumns == numColumns &&
+           header.sourceSize == identity.size && header.sourceModifiedTime == identity.modifiedTime &&
+           cache.size() == cacheSize(header.numRecords);
+  }
+
+  void writeCache(const std::vector<char>& bytes, const std::filesystem::path& cachePath) {
+    // Written under a unique name and renamed into place, so concurrent readers (other workers or epcli processes) never map a partial
+    // cache, and the pages of a replaced one stay valid for whoever still maps it
+    std::random_device rd;
+    std::filesystem::path tempPath = cachePath;
+    tempPath += fmt::format(".{:08x}{:08x}.tmp", rd(), rd());
+    try {
+      {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        if (!file.flush()) {
+          throw std::runtime_error(fmt::format("Cannot write {}", tempPath));
+        }
+      }
+      std::filesystem::rename(tempPath, cachePath);
+    } catch (...) {
+      std::error_code ec;
+      std::filesystem::remove(tempPath, ec);
+      throw;
+    }
+  }
+
+  double percentile(const std::vector<float>& sorted, double fraction) {
+    return sorted[static_cast<std::size_t>(std::floor(fraction * static_cast<double>(sorted.size() - 1)))];
+  }
+}  // namespace
+
+std::filesystem::path weatherCachePath(const std::filesystem::path& epwPath) {
+  const std::filesystem::path dir = utilities::cacheDirectory() / "weather";
+  std::error_code ec;
+  std::filesystem::create_directories(dir, ec);
+  // Keyed on the path only, so that an edited EPW replaces its stale cache instead of piling up new ones
+  return dir / (utilities::toHex(utilities::fnv1a64(std::filesystem::weakly_canonical(epwPath).string())) + ".epwc");
+}
+
+std::unique_ptr<WeatherData> WeatherData::open(const std::filesystem::path& epwPath) {
+  EPCLI_TRACE_SCOPE("WeatherData::open");
+  SourceIdentity identity;
+  try {
+    identity = sourceIdentity(epwPath);
+  } catch (const std::exception& e) {
+    throw std::runtime_error(fmt::format("Cannot read the weather file {}: {}", epwPath, e.what()));
+  }
+
+  std::unique_ptr<WeatherData> data(new WeatherData());
+  const auto cachePath = weatherCachePath(epwPath);
+  try {
+    auto cache = std::make_unique<utilities::MappedFile>(cachePath);
+    if (isUpToDate(*cache, identity)) {
+      data->m_mapped = std::move(cache);
+      data->m_fromCache = true;
+      data->attach(data->m_mapped->view().data());
+      return data;
+    }
+  } catch (const std::exception&) {
+    // No cache yet
+  }
+
+  auto bytes = buildCache(epwPath, identity);
+  try {
+    writeCache(bytes, cachePath);
+    data->m_mapped = std::make_unique<utilities::MappedFile>(cachePath);
+    data->attach(data->m_mapped->view().data());
+  } catch (const std::exception&) {
+    // Read-only cache directory, or a cache still mapped on Windows (which cannot be replaced): this run does without it
+    data->m_mapped.reset();
+    data->m_owned = std::move(bytes);
+    data->attach(data->m_owned.data());
+  }
+  return data;
+}
+
+WeatherData::~WeatherData() = default;
+
+void WeatherData::attach(const char* bytes) {
+  CacheHeader header;
+  std::memcpy(&header, bytes, sizeof(header));
+  m_bytes = bytes;
+  m_numRecords = header.numRecords;
+  m_recordsPerHour = header.recordsPerHour;
+  m_location.latitude = header.latitude;
+  m_location.longitude = header.longitude;
+  m_location.timeZone = header.timeZone;
+  m_location.elevation = header.elevation;
+  const char* name = header.names.data();
+  for (auto* field : {&m_location.city, &m_location.region, &m_location.country, &m_location.wmo}) {
+    *field = name;
+    name += field->size() + 1;
+  }
+}
+
+const Location& WeatherData::location() const {
+  return m_location;
+}
+
+std::size_t WeatherData::numRecords() const {
+  return m_numRecords;
+}
+
+unsigned WeatherData::recordsPerHour() const {
+  return m_recordsPerHour;
+}
+
+bool WeatherData::fromCache() const {
+  return m_fromCache;
+}
+
+std::span<const float> WeatherData::column(Column column) const {
+  // The mapping is page-aligned and the vector's buffer suitably aligned for any type, so the floats are aligned
+  const auto* values = reinterpret_cast<const float*>(  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    m_bytes + floatsOffset(m_numRecords) + static_cast<std::size_t>(column) * m_numRecords * sizeof(float));
+  return {values, m_numRecords};
+}
+
+std::span<const std::uint8_t> WeatherData::months() const {
+  return {reinterpret_cast<const std::uint8_t*>(m_bytes + sizeof(CacheHeader)), m_numRecords};  // NOLINT
+}
+
+std::span<const std::uint8_t> WeatherData::days() const {
+  return {reinterpret_cast<const std::uint8_t*>(m_bytes + sizeof(CacheHeader) + m_numRecords), m_numRecords};  // NOLINT
+}
+
+std::span<const std::uint8_t> WeatherData::hours() const {
+  return {reinterpret_cast<const std::uint8_t*>(m_bytes + sizeof(CacheHeader) + 2 * m_numRecords), m_numRecords};  // NOLINT
+}
+
+DesignConditions WeatherData::designConditions() const {
+  std::vector<float> sorted;
+  sorted.reserve(m_numRecords);
+  for (const float value : column(Column::DryBulb)) {
+    if (!std::isnan(value)) {
+      sorted.push_back(value);
+    }
+  }
+  if (sorted.empty()) {
+    constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+    return {nan, nan, nan, nan, nan, nan};
+  }
+  std::sort(sorted.begin(), sorted.end());
+  return {percentile(sorted, 0.004), percentile(sorted, 0.01), percentile(sorted, 0.996), percentile(sorted, 0.99), sorted.front(), sorted.back()};
+}
+
+DegreeDays WeatherData::degreeDays(double baseTemperature) const {
+  DegreeDays result;
+  const auto dryBulb = column(Column::DryBulb);
+  const auto monthValues = months();
+  const auto dayValues = days();
+  double sum = 0.0;
+  std::size_t count = 0;
+  const auto endDay = [&]() {
+    if (count > 0) {
+      const double mean = sum / static_cast<double>(count);
+      result.heating += std::max(0.0, baseTemperature - mean);
+      result.cooling += std::max(0.0, mean - baseTemperature);
+    }
+    sum = 0.0;
+    count = 0;
+  };
+  for (std::size_t i = 0; i < m_numRecords; ++i) {
+    if (i > 0 && (monthValues[i] != monthValues[i - 1] || dayValues[i] != dayValues[i - 1])) {
+      endDay();
+    }
+    if (!std::isnan(dryBulb[i])) {
+      sum += dryBulb[i];
+      ++count;
+    }
+  }
+  endDay();
+  return result;
+}
+
+std::array<MonthlyStats, 12> WeatherData::monthlyStats() const {
+  constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+  struct Sums
+  {
+    double dryBulb = 0.0;
+    std::size_t dryBulbCount = 0;
+    double relativeHumidity = 0.0;
+    std::size_t relativeHumidityCount = 0;
+    double windSpeed = 0.0;
+    std::size_t windSpeedCount = 0;
+  };
+  std::array<Sums, 12> sums{};
+  std::array<MonthlyStats, 12> stats{};
+  for (auto& month : stats) {
+    month.minDryBulb = std::numeric_limits<double>::infinity();
+    month.maxDryBulb = -std::numeric_limits<double>::infinity();
+  }
+
+  const auto dryBulb = column(Column::DryBulb);
+  const auto relativeHumidity = column(Column::RelativeHumidity);
+  const auto globalHorizontal = column(Column::GlobalHorizontal);
+  const auto windSpeed = column(Column::WindSpeed);
+  const auto monthValues = months();
+  for (std::size_t i = 0; i < m_numRecords; ++i) {
+    const std::size_t m = monthValues[i] - 1U;
+    auto& month = stats[m];
+    auto& sum = sums[m];
+    ++month.numRecords;
+    if (!std::isnan(dryBulb[i])) {
+      sum.dryBulb += dryBulb[i];
+      ++sum.dryBulbCount;
+      month.minDryBulb = std::min<double>(month.minDryBulb, dryBulb[i]);
+      month.maxDryBulb = std::max<double>(month.maxDryBulb, dryBulb[i]);
+    }
+    if (!std::isnan(relativeHumidity[i])) {
+      sum.relativeHumidity += relativeHumidity[i];
+      ++sum.relativeHumidityCount;
+    }
+    if (!std::isnan(globalHorizontal[i])) {
+      month.globalHorizontal += globalHorizontal[i];
+    }
+    if (!std::isnan(windSpeed[i])) {
+      sum.windSpeed += windSpeed[i];
+      ++sum.windSpeedCount;
+    }
+  }
+
+  for (std::size_t m = 0; m < stats.size(); ++m) {
+    auto& month = stats[m];
+    const auto& sum = sums[m];
+    const auto mean = [](double total, std::size_t count) { return count > 0 ? total / static_cast<double>(count) : nan; };
+    month.meanDryBulb = mean(sum.dryBulb, sum.dryBulbCount);
+    month.meanRelativeHumidity = mean(sum.relativeHumidity, sum.relativeHumidityCount);
+    month.meanWindSpeed = mean(sum.windSpeed, sum.windSpeedCount);
+    if (sum.dryBulbCount == 0) {
+      month.minDryBulb = nan;
+      month.maxDryBulb = nan;
+    }
+    // Each record holds the mean irradiance over its interval, in W/m2 (Wh/m2 for hourly data)
+    month.globalHorizontal /= static_cast<double>(m_recordsPerHour) * 1000.0;
+  }
+  return stats;
+}
+
+}  // namespace weather
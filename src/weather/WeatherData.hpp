@@ -0,0 +1,127 @@
+#ifndef WEATHER_WEATHERDATA_HPP
+#define WEATHER_WEATHERDATA_HPP
+
+#include <array>       // for array
+#include <cstddef>     // for size_t
+#include <cstdint>     // for uint8_t
+#include <filesystem>  // for path
+#include <memory>      // for unique_ptr
+#include <span>        // for span
+#include <string>      // for string
+#include <vector>      // for vector
+
+namespace utilities {
+class MappedFile;
+}
+
+namespace weather {
+
+/// The EPW fields kept in the cache, one column of floats each. Missing values (99.9, 999, 9999...) are NaN
+enum class Column : std::uint8_t
+{
+  DryBulb,            // C
+  DewPoint,           // C
+  RelativeHumidity,   // %
+  Pressure,           // Pa
+  GlobalHorizontal,   // Wh/m2
+  DirectNormal,       // Wh/m2
+  DiffuseHorizontal,  // Wh/m2
+  WindDirection,      // degrees
+  WindSpeed,          // m/s
+  TotalSkyCover,      // tenths
+};
+inline constexpr std::size_t numColumns = 10;
+
+struct Location
+{
+  std::string city;
+  std::string region;
+  std::string country;
+  std::string wmo;
+  double latitude = 0.0;
+  double longitude = 0.0;
+  double timeZone = 0.0;
+  double elevation = 0.0;
+};
+
+/// Extremes of the dry-bulb temperature, in C. The percentiles are taken on the data itself as ASHRAE defines its annual design
+/// conditions, since the DESIGN CONDITIONS line of an EPW is often empty
+struct DesignConditions
+{
+  double heating99_6 = 0.0;  // exceeded by 99.6% of the records
+  double heating99_0 = 0.0;
+  double cooling0_4 = 0.0;  // exceeded by 0.4% of the records
+  double cooling1_0 = 0.0;
+  double minimum = 0.0;
+  double maximum = 0.0;
+};
+
+/// In C.days, from the daily mean dry-bulb temperatures
+struct DegreeDays
+{
+  double heating = 0.0;
+  double cooling = 0.0;
+};
+
+struct MonthlyStats
+{
+  std::size_t numRecords = 0;
+  double meanDryBulb = 0.0;
+  double minDryBulb = 0.0;
+  double maxDryBulb = 0.0;
+  double meanRelativeHumidity = 0.0;
+  double globalHorizontal = 0.0;  // kWh/m2
+  double meanWindSpeed = 0.0;
+};
+
+/// An EPW file, parsed once into a compact columnar file in the epcli cache directory, and mapped from there: every later open (by another
+/// run, worker or epcli process) costs a stat and a mmap, and all of them share the same pages. The cache is keyed on the canonical path of
+/// the EPW, and rebuilt when its size or modification time changes. Immutable once opened, so thread-safe
+class WeatherData
+{
+ public:
+  /// Throws std::runtime_error if the EPW cannot be read or parsed. If the cache cannot be written, the parsed data is kept in memory
+  static std::unique_ptr<WeatherData> open(const std::filesystem::path& epwPath);
+
+  WeatherData(const WeatherData&) = delete;
+  WeatherData& operator=(const WeatherData&) = delete;
+  ~WeatherData();
+
+  [[nodiscard]] const Location& location() const;
+  [[nodiscard]] std::size_t numRecords() const;
+  [[nodiscard]] unsigned recordsPerHour() const;
+  /// Whether the cache was up to date, rather than (re)built from the EPW
+  [[nodiscard]] bool fromCache() const;
+
+  /// numRecords() values each, in file order
+  [[nodiscard]] std::span<const float> column(Column column) const;
+  [[nodiscard]] std::span<const std::uint8_t> months() const;
+  [[nodiscard]] std::span<const std::uint8_t> days() const;
+  /// 1 to 24, the hour ending at the record
+  [[nodiscard]] std::span<const std::uint8_t> hours() const;
+
+  [[nodiscard]] DesignConditions designConditions() const;
+  [[nodiscard]] DegreeDays degreeDays(double baseTemperature) const;
+  /// January first
+  [[nodiscard]] std::array<MonthlyStats, 12> monthlyStats() const;
+
+ private:
+  WeatherData() = default;
+  // Points into m_mapped, or m_owned when the cache could not be written
+  void attach(const char* bytes);
+
+  std::unique_ptr<utilities::MappedFile> m_mapped;
+  std::vector<char> m_owned;
+  Location m_location;
+  std::size_t m_numRecords = 0;
+  unsigned m_recordsPerHour = 1;
+  bool m_fromCache = false;
+  const char* m_bytes = nullptr;
+};
+
+/// Where the cache of an EPW is kept
+std::filesystem::path weatherCachePath(const std::filesystem::path& epwPath);
+
+}  // namespace weather
+
+#endif  // WEATHER_WEATHERDATA_HPP